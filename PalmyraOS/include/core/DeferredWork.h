@@ -0,0 +1,70 @@
+
+#pragma once
+
+#include "core/definitions.h"
+
+
+namespace PalmyraOS::kernel {
+
+    /**
+     * @class DeferredWork
+     * @brief Bottom halves for interrupt handlers (softirq-style work queue)
+     *
+     * IRQ handlers only acknowledge the device and schedule() the expensive part.
+     * Pending work runs in FIFO order when a hardware IRQ returns (runPending),
+     * with interrupts enabled, so the timer and other devices are not held off.
+     * On the system clock it runs before the scheduler, never after a task switch.
+     *
+     * Rules while a work item runs:
+     * - Interrupts are enabled; nested IRQs may schedule more work but never run it (no nesting)
+     * - Task switching is deferred until the pass ends (the scheduler checks isRunning())
+     * - A pass is bounded by MAX_ITEMS_PER_PASS; leftovers run on the next IRQ exit (at latest the next tick)
+     */
+    class DeferredWork {
+    public:
+        using Function                               = void (*)(void* context, uint32_t argument);
+
+        static constexpr uint32_t QUEUE_SIZE         = 256;  ///< Capacity of the work ring (power of two)
+        static constexpr uint32_t MAX_ITEMS_PER_PASS = 64;   ///< Work items executed per IRQ exit
+
+        /**
+         * @brief Queue a work item (safe from interrupt context)
+         * @param function Function to run
+         * @param context Opaque pointer passed to the function
+         * @param argument Small payload passed to the function (e.g. a scancode)
+         * @return False if the queue is full (the item is dropped and counted)
+         */
+        static bool schedule(Function function, void* context = nullptr, uint32_t argument = 0);
+
+        /**
+         * @brief Run pending work with interrupts enabled (called on hardware IRQ exit)
+         *
+         * Does nothing if a pass is already running or the queue is empty.
+         */
+        static void runPending();
+
+        [[nodiscard]] static bool isRunning() { return running_; }
+        [[nodiscard]] static bool hasPending() { return head_ != tail_; }
+
+        [[nodiscard]] static uint64_t getScheduledCount() { return scheduledCount_; }
+        [[nodiscard]] static uint64_t getExecutedCount() { return executedCount_; }
+        [[nodiscard]] static uint64_t getDroppedCount() { return droppedCount_; }
+
+    private:
+        struct WorkItem {
+            Function function;
+            void* context;
+            uint32_t argument;
+        };
+
+        static WorkItem queue_[QUEUE_SIZE];
+        static volatile uint32_t head_;  // Next item to run
+        static volatile uint32_t tail_;  // Next free slot
+        static volatile bool running_;
+
+        static uint64_t scheduledCount_;
+        static uint64_t executedCount_;
+        static uint64_t droppedCount_;
+    };
+
+}  // namespace PalmyraOS::kernel
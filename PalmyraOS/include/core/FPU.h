@@ -0,0 +1,82 @@
+
+#pragma once
+
+#include "core/Interrupts.h"
+#include "core/definitions.h"
+
+
+namespace PalmyraOS::kernel {
+
+    // Forward declarations
+    class Process;
+
+    /**
+     * @class FPU
+     * @brief Lazy x87/MMX/SSE context switching (FXSAVE areas and CR0.TS)
+     *
+     * The registers belong to one process at a time (the owner). On every task switch the
+     * scheduler sets CR0.TS unless the next process is the owner; the first FPU/SIMD instruction
+     * of another process then raises #NM (vector 0x07), which saves the owner's state, restores
+     * the current one and clears TS. Processes that never touch the FPU never fault and own no
+     * save area.
+     *
+     * Kernel code that runs on behalf of a process (syscalls, IRQ handlers) shares its FPU state:
+     * SIMD there must be bracketed with beginKernelUse()/endKernelUse(). Kernel-mode processes
+     * (e.g. the compositor) have their own state and can use SIMD freely.
+     */
+    class FPU {
+    public:
+        static constexpr uint32_t STATE_SIZE = 512;  ///< Size of an FXSAVE area
+
+        struct alignas(16) State {
+            uint8_t fxsaveArea[STATE_SIZE];
+        };
+
+        /// Per-process save area, allocated on the first #NM of the process
+        struct Context {
+            void* buffer{nullptr};  ///< Heap block (freed on kill)
+            State* state{nullptr};  ///< 16-byte aligned area inside buffer
+        };
+
+        /**
+         * @brief Configures CR0 (MP, NE, no EM), captures the initial state and installs the #NM handler
+         *
+         * Must run after enable_sse(). TS stays clear until the scheduler performs its first switch.
+         */
+        static void initialize();
+
+        /**
+         * @brief Called by the scheduler when switching to a process
+         * @param next Process that is about to run
+         */
+        static void onContextSwitch(Process* next);
+
+        /**
+         * @brief Drops the FPU state of a process that is being killed
+         * @param process Process being killed
+         */
+        static void releaseState(Process* process);
+
+        /**
+         * @brief Saves the owner's registers so that kernel code may use SIMD (interrupts must be disabled)
+         */
+        static void beginKernelUse();
+
+        /**
+         * @brief Ends a kernel SIMD section: the next FPU instruction of a process restores its state
+         */
+        static void endKernelUse();
+
+        [[nodiscard]] static uint64_t getRestoreCount() { return restoreCount_; }
+        [[nodiscard]] static uint64_t getSaveCount() { return saveCount_; }
+
+    private:
+        static uint32_t* handleDeviceNotAvailable(interrupts::CPURegisters* regs);
+
+        static State initialState_;  ///< Registers after FNINIT (loaded on a process's first FPU use)
+        static Process* owner_;      ///< Process whose state is in the registers (nullptr if none)
+        static uint64_t restoreCount_;
+        static uint64_t saveCount_;
+    };
+
+}  // namespace PalmyraOS::kernel
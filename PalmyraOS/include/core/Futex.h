@@ -0,0 +1,52 @@
+
+#pragma once
+
+#include "core/Locks.h"
+#include "core/definitions.h"
+
+
+namespace PalmyraOS::kernel {
+
+    /**
+     * @class Futex
+     * @brief Wait queues keyed by the physical address of a user word (futex system call)
+     *
+     * User locks stay in userspace while uncontended and only call into the kernel to sleep
+     * on a word or to wake its sleepers. Keying by physical address makes the same word in
+     * shared mappings (and in every thread of a process) meet in the same place.
+     *
+     * Sleepers are hashed into BUCKETS wait queues that several keys may share; the key of a
+     * sleeper is kept in Process::futexKey_, so a wake only picks the sleepers of its word.
+     */
+    class Futex {
+    public:
+        static constexpr uint32_t BUCKETS = 64;  ///< Wait queues (a power of two)
+
+        /**
+         * @brief Sleeps while *address holds the expected value, until a wake() on the same word
+         * @param address User word, validated by the caller
+         * @param expected Value the caller saw: the check and the sleep are atomic
+         * @param deadlineTick SystemClock tick to give up at (0: no deadline)
+         * @return 0 once woken, -EAGAIN if the word changed, -ETIMEDOUT, -EFAULT if the word is not mapped
+         */
+        static int wait(const uint32_t* address, uint32_t expected, uint64_t deadlineTick);
+
+        /**
+         * @brief Wakes up to count sleepers of a word, oldest first
+         * @return Number of processes woken, -EFAULT if the word is not mapped
+         */
+        static int wake(const uint32_t* address, uint32_t count);
+
+    private:
+        /// Physical address of a word of the current process (0 if it is not mapped)
+        [[nodiscard]] static uint32_t keyOf(const uint32_t* address);
+
+        [[nodiscard]] static WaitQueue& bucketOf(uint32_t key);
+
+        /// wakeMatching() filter: the sleeper waits on the key (it is marked as woken)
+        static bool claimSleeper(Process* process, uintptr_t key);
+
+        static WaitQueue buckets_[BUCKETS];
+    };
+
+}  // namespace PalmyraOS::kernel
@@ -224,6 +224,12 @@ namespace PalmyraOS::kernel::GDT {
         // Update the kernel stack pointer in TSS (used for privilege level switches)
         void setKernelStack(uint32_t esp);
 
+        // Address of the kernel stack pointer in the TSS (SYSENTER_ESP points here, see sysenter_entry)
+        [[nodiscard]] inline uint32_t getKernelStackAddress() const { return (uint32_t) &tss_entry + offsetof(tss_entry_t, esp0); }
+
+        // Rewrite the user TLS descriptor (set_thread_area); takes effect once the selector is reloaded
+        void setThreadLocalStorage(uint32_t base, uint32_t limitRaw, Granularity granularity);
+
         // Function to retrieve the kernel code segment selector
         // Returns: Index into GDT with TI=GDT, RPL=Ring0
         [[nodiscard]] inline SegmentSelector getKernelCodeSegmentSelector() const {
@@ -259,18 +265,26 @@ namespace PalmyraOS::kernel::GDT {
             return SegmentSelector(offset);
         }
 
+        // Function to retrieve the thread-local storage segment selector (loaded into GS by user space)
+        // Returns: Index into GDT with TI=GDT, RPL=Ring3
+        [[nodiscard]] inline SegmentSelector getThreadLocalStorageSegmentSelector() const {
+            uint16_t offset = ((uint32_t) &thread_local_storage_descriptor - (uint32_t) this);
+            return SegmentSelector(offset | static_cast<uint16_t>(PrivilegeLevel::Ring3));
+        }
+
     private:
         // Initialize the Task State Segment with the given stack pointer
         void initializeTSS(uint32_t esp);
 
     public:
         // Global Descriptor Table entries (must be in this order)
-        SegmentDescriptor null_segment_selector;         // Null segment descriptor (mandatory first entry)
-        SegmentDescriptor kernel_code_segment_selector;  // Kernel code segment descriptor (Ring 0)
-        SegmentDescriptor kernel_data_segment_selector;  // Kernel data segment descriptor (Ring 0)
-        SegmentDescriptor user_code_segment_selector;    // User space code segment descriptor (Ring 3)
-        SegmentDescriptor user_data_segment_selector;    // User space data segment descriptor (Ring 3)
-        SegmentDescriptor task_state_descriptor;         // Task State Segment descriptor
+        SegmentDescriptor null_segment_selector;            // Null segment descriptor (mandatory first entry)
+        SegmentDescriptor kernel_code_segment_selector;     // Kernel code segment descriptor (Ring 0)
+        SegmentDescriptor kernel_data_segment_selector;     // Kernel data segment descriptor (Ring 0)
+        SegmentDescriptor user_code_segment_selector;       // User space code segment descriptor (Ring 3)
+        SegmentDescriptor user_data_segment_selector;       // User space data segment descriptor (Ring 3)
+        SegmentDescriptor task_state_descriptor;            // Task State Segment descriptor
+        SegmentDescriptor thread_local_storage_descriptor;  // Per-thread TLS data segment (Ring 3), rewritten on task switch
         // TSS Entry
         tss_entry_t tss_entry{0};  // Task State Segment, initially all zeros
 
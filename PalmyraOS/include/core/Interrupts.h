@@ -102,6 +102,7 @@ namespace PalmyraOS::kernel::interrupts {
         PICManager();
         void enableInterrupts();   // Enables hardware interrupts.
         void disableInterrupts();  // Enables hardware interrupts.
+        void unmaskIRQ(uint8_t irq);  // Unmasks a single IRQ line (0-15).
         inline ports::BytePort& getMasterPicCommand() { return masterPicCommand; };
         inline ports::BytePort& getSlavePicCommand() { return slavePicCommand; };
         inline ports::BytePort& getMasterPicData() { return masterPicData; };
@@ -123,8 +124,38 @@ namespace PalmyraOS::kernel::interrupts {
 
         static void enableInterrupts();
         static void disableInterrupts();
+
+        /**
+         * @brief Disable interrupts and return the previous EFLAGS (for code called with and without IF)
+         * @return EFLAGS before interrupts were disabled, to be passed to restoreInterrupts()
+         */
+        static uint32_t saveAndDisableInterrupts();
+
+        /**
+         * @brief Re-enable interrupts if they were enabled in the saved EFLAGS
+         * @param flags Value returned by saveAndDisableInterrupts()
+         */
+        static void restoreInterrupts(uint32_t flags);
+
         static void setInterruptHandler(uint8_t interrupt_number, InterruptHandler interrupt_handler);
 
+        /**
+         * @brief Enable delivery of a legacy ISA/PCI IRQ line on vector 0x20 + irq
+         *
+         * Routes through the I/O APIC when it is active, otherwise unmasks the line on the 8259 PIC.
+         */
+        static void enableIRQ(uint8_t irq);
+
+        /**
+         * @brief Install a handler for a PCI INTx line and enable its delivery
+         *
+         * With the I/O APIC the line is routed level-triggered (lines 16-23 are GSIs on vectors 0x30-0x37),
+         * otherwise only lines 0-15 can be unmasked on the 8259 PIC.
+         *
+         * @return The vector the device interrupts on, or 0 if the line cannot be delivered
+         */
+        static uint8_t enablePCIInterrupt(uint8_t line, InterruptHandler handler);
+
         REMOVE_COPY(InterruptController);
 
     public:
@@ -0,0 +1,42 @@
+
+#pragma once
+
+#include "core/definitions.h"
+
+
+namespace PalmyraOS::kernel {
+
+    // Forward declarations
+    class PagingDirectory;
+
+    /**
+     * @class LocalPage
+     * @brief A zeroed page private to each user process, at the same address in all of them
+     *
+     * Internal applications run the SDK from the kernel image, so the SDK's globals are shared
+     * by every process. State that has to be per process (the SDK allocator) lives in this page
+     * instead. Its address is a frame reserved at boot that nothing else maps; each user process
+     * gets a fresh frame behind it (threads share the one of their leader).
+     */
+    class LocalPage {
+    public:
+        /**
+         * @brief Reserves the address of the page
+         * @return False if no frame could be reserved
+         */
+        static bool initialize();
+
+        /**
+         * @brief Maps a fresh zeroed frame at the address into a user paging directory
+         * @param directory Directory of a user-mode process
+         * @return The frame (to be registered with the process), nullptr if none could be allocated
+         */
+        static void* mapInto(PagingDirectory* directory);
+
+        [[nodiscard]] static void* getAddress() { return address_; }
+
+    private:
+        static void* address_;
+    };
+
+}  // namespace PalmyraOS::kernel
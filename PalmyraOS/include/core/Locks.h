@@ -0,0 +1,150 @@
+
+#pragma once
+
+#include "core/definitions.h"
+
+
+namespace PalmyraOS::kernel {
+
+    // Forward declarations
+    class Process;
+
+    /**
+     * @class SpinLock
+     * @brief Busy-wait lock that also disables interrupts (usable from IRQ handlers and bottom halves)
+     *
+     * Protects short critical sections shared with interrupt context (heap, input and socket queues).
+     * The holder must not sleep. The kernel is uniprocessor: with interrupts disabled nobody else can
+     * hold the lock, so finding it taken means recursion and panics instead of spinning forever.
+     */
+    class SpinLock {
+    public:
+        SpinLock() = default;
+        REMOVE_COPY(SpinLock);
+
+        void lock();
+        void unlock();
+
+        [[nodiscard]] bool isLocked() const { return locked_; }
+
+    private:
+        volatile uint32_t locked_{0};
+        uint32_t flags_{0};  ///< EFLAGS of the holder before lock()
+    };
+
+    /**
+     * @class WaitQueue
+     * @brief FIFO of sleeping processes, linked through Process::waitNext_ (no allocation)
+     *
+     * All methods must be called with interrupts disabled. A process sleeps in at most one queue;
+     * Process::kill removes it from that queue.
+     */
+    class WaitQueue {
+    public:
+        WaitQueue() = default;
+        REMOVE_COPY(WaitQueue);
+
+        /**
+         * @brief Puts the current process to sleep until wakeOne()/wakeAll() picks it
+         * @param deadlineTick SystemClock tick at which to give up and leave the queue (0: no deadline)
+         *
+         * Switches to another process; on return interrupts are still disabled.
+         */
+        void sleep(uint64_t deadlineTick = 0);
+
+        /**
+         * @brief Makes the oldest sleeper ready
+         * @return False if no process was woken
+         */
+        bool wakeOne();
+
+        /**
+         * @brief Makes all sleepers ready
+         */
+        void wakeAll();
+
+        /**
+         * @brief Makes the oldest sleepers accepted by a filter ready, the others keep sleeping (queues shared by several keys)
+         * @param count Maximum number of processes to wake
+         * @param match Called with each sleeper and the argument, true wakes the sleeper
+         * @return Number of processes woken
+         */
+        uint32_t wakeMatching(uint32_t count, bool (*match)(Process* process, uintptr_t argument), uintptr_t argument);
+
+        /**
+         * @brief Removes a process without waking it (used when the process is killed)
+         */
+        void remove(Process* process);
+
+        [[nodiscard]] bool isEmpty() const { return head_ == nullptr; }
+
+    private:
+        Process* pop();
+
+        Process* head_{nullptr};
+        Process* tail_{nullptr};
+    };
+
+    /**
+     * @class Mutex
+     * @brief Sleeping lock for process context (syscalls, kernel threads)
+     *
+     * Contended lock() puts the caller to sleep instead of stopping the scheduler, so only
+     * processes that need the same resource wait. Must not be used from interrupt context.
+     */
+    class Mutex {
+    public:
+        Mutex() = default;
+        REMOVE_COPY(Mutex);
+
+        void lock();
+        [[nodiscard]] bool tryLock();
+        void unlock();
+
+        [[nodiscard]] bool isLocked() const { return locked_; }
+        [[nodiscard]] Process* getOwner() const { return owner_; }
+
+    private:
+        volatile bool locked_{false};
+        Process* owner_{nullptr};  ///< Holder (nullptr while locked before the scheduler started)
+        WaitQueue waiters_;
+    };
+
+    /**
+     * @class Semaphore
+     * @brief Counting semaphore with a wait queue (down() sleeps while the count is zero)
+     *
+     * up() may be called from interrupt context, down() only from process context.
+     */
+    class Semaphore {
+    public:
+        explicit Semaphore(uint32_t count = 0) : count_(count) {}
+        REMOVE_COPY(Semaphore);
+
+        void down();
+        [[nodiscard]] bool tryDown();
+        void up();
+
+        [[nodiscard]] uint32_t getCount() const { return count_; }
+
+    private:
+        volatile uint32_t count_;
+        WaitQueue waiters_;
+    };
+
+    /**
+     * @class LockGuard
+     * @brief Scoped lock for SpinLock and Mutex
+     */
+    template<typename Lock>
+    class LockGuard {
+    public:
+        explicit LockGuard(Lock& lock) : lock_(lock) { lock_.lock(); }
+        ~LockGuard() { lock_.unlock(); }
+        REMOVE_COPY(LockGuard);
+
+    private:
+        Lock& lock_;
+    };
+
+}  // namespace PalmyraOS::kernel
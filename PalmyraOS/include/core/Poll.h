@@ -0,0 +1,122 @@
+
+#pragma once
+
+#include "core/definitions.h"
+#include "core/memory/KernelHeapAllocator.h"
+
+
+namespace PalmyraOS::kernel {
+
+    // Forward declarations
+    class Process;
+    class PollSource;
+
+    /**
+     * @class PollWatcher
+     * @brief Node linked into a PollSource, told when the readiness of its descriptor changes
+     *
+     * Watchers are linked intrusively, so notifying never allocates and works from interrupt context.
+     */
+    class PollWatcher {
+    public:
+        /**
+         * @brief The source may have become ready for some of the events (POLLIN, POLLOUT, ...)
+         *
+         * Called with interrupts disabled, possibly from a bottom half: must not sleep or allocate.
+         */
+        virtual void notify(uint32_t events) = 0;
+
+        /**
+         * @brief The source is being destroyed (its descriptor was closed); already unlinked
+         */
+        virtual void detach() {}
+
+        [[nodiscard]] PollSource* getSource() const { return source_; }
+
+    protected:
+        PollWatcher() = default;
+        ~PollWatcher() = default;
+
+    private:
+        friend class PollSource;
+
+        PollSource* source_{nullptr};  ///< Source the watcher is linked into (nullptr if none)
+        PollWatcher* next_{nullptr};   ///< Next watcher of that source
+    };
+
+    /**
+     * @class PollSource
+     * @brief Per-descriptor list of watchers (poll() callers, epoll entries) to tell about readiness changes
+     *
+     * The owner calls notify() whenever data arrives or space frees up. Sources that never
+     * change readiness (regular files) have none and are always ready.
+     */
+    class PollSource {
+    public:
+        PollSource() = default;
+        ~PollSource();
+        REMOVE_COPY(PollSource);
+
+        void addWatcher(PollWatcher* watcher);
+        void removeWatcher(PollWatcher* watcher);
+
+        /**
+         * @brief Tells every watcher that the source may be ready for the events (safe in interrupt context)
+         */
+        void notify(uint32_t events);
+
+    private:
+        PollWatcher* head_{nullptr};
+    };
+
+    /**
+     * @class PollTable
+     * @brief Watchers of one poll() call, registered on every polled descriptor while its caller sleeps
+     *
+     * sleep() returns when a watched source notifies, when the deadline passes, or right away if a
+     * notification arrived since the last sleep. Process::kill detaches the table of a killed sleeper.
+     */
+    class PollTable {
+    public:
+        explicit PollTable(Process* process);
+        ~PollTable();
+        REMOVE_COPY(PollTable);
+
+        /**
+         * @brief Starts watching a source
+         * @return False if out of memory
+         */
+        [[nodiscard]] bool watch(PollSource* source);
+
+        /**
+         * @brief Sleeps until a watched source notifies or the tick is reached (0: no deadline)
+         *
+         * Must be called with interrupts disabled; they are still disabled on return.
+         */
+        void sleep(uint64_t deadlineTick);
+
+        /**
+         * @brief Unlinks and frees all watchers
+         */
+        void detachAll();
+
+    private:
+        class Entry final : public PollWatcher {
+        public:
+            explicit Entry(PollTable* table) : table_(table) {}
+            void notify(uint32_t events) override;
+            void detach() override;
+
+        private:
+            PollTable* table_;
+        };
+
+        void wake();
+
+        Process* process_;
+        KVector<Entry*> entries_;
+        volatile bool notified_{false};  ///< A source notified since the last sleep()
+        volatile bool sleeping_{false};  ///< The process sleeps in sleep() (only then may it be made ready)
+    };
+
+}  // namespace PalmyraOS::kernel
@@ -0,0 +1,72 @@
+
+#pragma once
+
+#include "core/Interrupts.h"
+#include "core/definitions.h"
+
+
+namespace PalmyraOS::kernel {
+
+    /**
+     * @brief Ring of the latest sampled EIPs of one process (or of the kernel)
+     *
+     * Written only by the timer interrupt and read with interrupts disabled, so neither
+     * side ever waits for the other. Older samples are overwritten.
+     */
+    struct ProfileSamples {
+        uint32_t total;     ///< Samples taken so far (the ring keeps the latest `capacity`)
+        uint32_t capacity;  ///< Slots in eips
+        uint32_t eips[];    ///< Sampled instruction pointers
+    };
+
+    /**
+     * @class Profiler
+     * @brief Sampling CPU profiler driven by the timer interrupt
+     *
+     * Every tick records the interrupted EIP into the samples of the current process
+     * (/proc/<pid>/profile) and, when the CPU was in ring 0, into the kernel samples
+     * (/proc/kprofile). Reading a profile aggregates its samples per function of the
+     * kernel symbol table (embedded at link time, see scripts/ksyms.py); addresses
+     * outside the kernel image (ELF programs) are listed as they are.
+     */
+    class Profiler {
+    public:
+        static constexpr uint32_t PROCESS_PAGES = 1;  ///< Samples of one process: ~1000 ticks
+        static constexpr uint32_t KERNEL_PAGES  = 4;  ///< Kernel samples: ~4000 ticks
+
+        /**
+         * @brief Attaches to the timer and creates /proc/kprofile
+         *
+         * Must run before TaskManager::initialize(), so that samples are taken before the scheduler switches away.
+         */
+        static void initialize();
+
+        /**
+         * @brief Allocates an empty sample ring of PROCESS_PAGES pages
+         * @return nullptr if out of memory (the process is then not profiled)
+         */
+        [[nodiscard]] static ProfileSamples* createSamples();
+
+        static void destroySamples(ProfileSamples* samples);
+
+        /**
+         * @brief Formats a profile: samples per function, most frequent first
+         * @return Bytes copied to buffer, starting at offset of the text
+         */
+        static size_t readProfile(const ProfileSamples* samples, char* buffer, size_t size, size_t offset);
+
+        /**
+         * @brief Finds the kernel function containing an address
+         * @param start Set to the address of the function
+         * @return Its name, or nullptr outside the kernel code
+         */
+        [[nodiscard]] static const char* lookupSymbol(uint32_t address, uint32_t& start);
+
+    private:
+        static uint32_t* handleTick(interrupts::CPURegisters* regs);
+        static void record(ProfileSamples* samples, uint32_t eip);
+
+        static ProfileSamples* kernelSamples_;
+    };
+
+}  // namespace PalmyraOS::kernel
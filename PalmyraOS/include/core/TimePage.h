@@ -0,0 +1,49 @@
+
+#pragma once
+
+#include "core/Interrupts.h"
+#include "core/definitions.h"
+#include "palmyraOS/shared/time/TimePage.h"
+
+
+namespace PalmyraOS::kernel {
+
+    // Forward declarations
+    class PagingDirectory;
+
+    /**
+     * @class TimePage
+     * @brief Kernel side of the shared time page (syscall-free clock_gettime)
+     *
+     * One physical page, identity mapped like all kernel memory. User processes get it read-only
+     * (mapInto); kernel-mode processes read it through the kernel directory. The timer interrupt
+     * advances it on every tick, writing through the user mappings as well, which relies on CR0.WP
+     * being clear.
+     */
+    class TimePage {
+    public:
+        static constexpr uint32_t TSC_SHIFT = 24;  ///< Fixed-point shift of the TSC multiplier
+
+        /**
+         * @brief Allocates the page, anchors the wall clock to the RTC and attaches to the timer
+         * @return False if the page could not be allocated
+         */
+        static bool initialize();
+
+        /**
+         * @brief Maps the page read-only into a user paging directory
+         * @param directory Directory of a user-mode process
+         */
+        static void mapInto(PagingDirectory* directory);
+
+        [[nodiscard]] static const types::TimePageData* getPage() { return page_; }
+
+    private:
+        static uint32_t* handleTick(interrupts::CPURegisters* regs);
+        static void updateCalibration();
+
+        static types::TimePageData* page_;
+        static uint32_t calibratedMHz_;  ///< CPU frequency the multiplier was computed for
+    };
+
+}  // namespace PalmyraOS::kernel
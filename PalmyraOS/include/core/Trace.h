@@ -0,0 +1,115 @@
+
+#pragma once
+
+#include "core/definitions.h"
+
+// ============================================================================
+// TRACEPOINTS
+// ============================================================================
+// TRACE(event, arg0, arg1) appends a binary record (TSC, pid, event, two
+// arguments) to the trace ring. While an event is disabled a tracepoint costs
+// one load and one branch; comment out TRACEPOINTS to compile them all away.
+
+#define TRACEPOINTS
+
+#ifdef TRACEPOINTS
+#define TRACE(event, ...) PalmyraOS::kernel::Trace::record(PalmyraOS::kernel::TraceEvent::event, ##__VA_ARGS__)
+#else
+#define TRACE(event, ...)  // Disabled when TRACEPOINTS is not defined
+#endif
+
+
+namespace PalmyraOS::kernel {
+
+    /**
+     * @brief Events that tracepoints can record (arguments in the comments)
+     */
+    enum class TraceEvent : uint8_t {
+        ContextSwitch,  ///< previous pid, next pid
+        SyscallEnter,   ///< syscall number
+        SyscallExit,    ///< syscall number, result
+        IrqEnter,       ///< vector
+        IrqExit,        ///< vector
+        PageFault,      ///< faulting address, error code
+        BlockIoStart,   ///< logical block address, sectors (bit 31: write)
+        BlockIoEnd,     ///< logical block address, 1 on success
+        PacketRx,       ///< frame length
+        PacketTx,       ///< frame length
+        Count
+    };
+
+    /// Event names, as listed in the /proc/trace header
+    constexpr const char* TRACE_EVENT_NAMES[] = {
+            "context_switch",
+            "syscall_enter",
+            "syscall_exit",
+            "irq_enter",
+            "irq_exit",
+            "page_fault",
+            "block_io_start",
+            "block_io_end",
+            "packet_rx",
+            "packet_tx",
+    };
+    static_assert(sizeof(TRACE_EVENT_NAMES) / sizeof(TRACE_EVENT_NAMES[0]) == static_cast<uint32_t>(TraceEvent::Count), "Name every trace event");
+
+    struct TraceRecord {
+        uint64_t tsc;   ///< CPU::getTSC() at the tracepoint
+        uint32_t pid;   ///< Current process (NO_PID before the scheduler starts)
+        uint8_t event;  ///< TraceEvent
+        uint8_t reserved[3];
+        uint32_t arg0;
+        uint32_t arg1;
+    };
+
+    /**
+     * @class Trace
+     * @brief Binary ring of kernel events with TSC timestamps (one CPU, one ring)
+     *
+     * Records are written with interrupts disabled and never block; the oldest are
+     * overwritten. /proc/trace lists the ring as fixed-width hexadecimal lines after a
+     * '#' header (see scripts/trace_to_json.py). A read at offset 0 takes a snapshot,
+     * so the following reads of the same pass see consistent records.
+     *
+     * Writing "on", "off" or "clear" to /proc/trace controls recording (off at boot),
+     * as does a hexadecimal mask of the events to record.
+     */
+    class Trace {
+    public:
+        static constexpr uint32_t RING_PAGES = 32;          ///< ~5400 records
+        static constexpr uint32_t NO_PID     = 0xFFFFFFFF;  ///< Pid of records taken outside any process
+
+        /**
+         * @brief Allocates the ring and its snapshot, creates /proc/trace
+         * @return False if out of memory (tracepoints then stay disabled)
+         */
+        static bool initialize();
+
+        /// Events recorded from now on (bit n: TraceEvent n; ignored without a ring)
+        static void setMask(uint32_t mask) { mask_ = ring_ ? mask : 0; }
+
+        static inline void record(TraceEvent event, uint32_t arg0 = 0, uint32_t arg1 = 0) {
+            if (__builtin_expect((mask_ >> static_cast<uint32_t>(event)) & 1, 0)) write(event, arg0, arg1);
+        }
+
+    private:
+        static void write(TraceEvent event, uint32_t arg0, uint32_t arg1);
+        static size_t read(char* buffer, size_t size, size_t offset);
+        static size_t control(const char* buffer, size_t size, size_t offset);
+        static void takeSnapshot();
+
+        static constexpr uint32_t HEADER_SIZE = 512;
+
+        static uint32_t mask_;             ///< Enabled events (bit n: TraceEvent n)
+        static TraceRecord* ring_;         ///< RING_PAGES kernel pages
+        static uint32_t capacity_;         ///< Records in the ring
+        static uint32_t head_;             ///< Slot of the next record
+        static uint64_t total_;            ///< Records written since the last clear
+        static TraceRecord* snapshot_;     ///< Copy of the ring read by /proc/trace, oldest record first
+        static uint32_t snapshotCount_;    ///< Records in the snapshot
+        static uint64_t snapshotTotal_;    ///< total_ when the snapshot was taken
+        static char header_[HEADER_SIZE];  ///< Header of the snapshot
+        static uint32_t headerLength_;
+    };
+
+}  // namespace PalmyraOS::kernel
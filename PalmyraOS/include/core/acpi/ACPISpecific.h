@@ -77,6 +77,15 @@ namespace PalmyraOS::kernel::acpi {
         uint16_t flags;                  // MPS INTI flags
     } __attribute__((packed));
 
+    /**
+     * @brief MADT Entry: Local APIC Address Override
+     */
+    struct MADTLocalAPICAddressOverride {
+        MADTEntryHeader header;
+        uint16_t reserved;
+        uint64_t localAPICAddress;  // 64-bit physical address of local APIC
+    } __attribute__((packed));
+
     /**
      * @brief Fixed ACPI Description Table (FADT)
      *
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "core/Interrupts.h"
+#include "core/definitions.h"
+
+namespace PalmyraOS::kernel {
+
+    /**
+     * @class APIC
+     * @brief Local APIC and I/O APIC driver (discovered through the ACPI MADT)
+     *
+     * Replaces the legacy 8259 PIC path when available:
+     * - Local APIC: MMIO end-of-interrupt and a periodic timer calibrated against HPET
+     * - I/O APIC: redirection of ISA IRQs (honouring MADT source overrides) and PCI GSIs
+     *
+     * Usage follows the HPET pattern:
+     * 1. initialize()   - parse the MADT (before paging, no MMIO access)
+     * 2. map getLocalAPICAddress()/getIOAPICAddress() by identity in virtual memory
+     * 3. enable()       - mask the PIC, enable the Local APIC, program the I/O APIC
+     * 4. calibrateTimer() and SystemClock::setFrequency() to move the tick to the LAPIC timer
+     *
+     * If any step fails the kernel keeps running on the PIC/PIT.
+     */
+    class APIC {
+    public:
+        /**
+         * @brief Local APIC register offsets (memory-mapped, 32-bit aligned on 16 bytes)
+         */
+        enum class LocalRegister : uint32_t {
+            ID                = 0x020,  // Local APIC ID
+            Version           = 0x030,  // Local APIC Version
+            TaskPriority      = 0x080,  // Task Priority Register (TPR)
+            EndOfInterrupt    = 0x0B0,  // EOI (write-only)
+            SpuriousVector    = 0x0F0,  // Spurious Interrupt Vector Register
+            ErrorStatus       = 0x280,  // Error Status Register
+            LVTTimer          = 0x320,  // LVT Timer
+            LVTLint0          = 0x350,  // LVT LINT0 (legacy ExtINT from the PIC)
+            LVTLint1          = 0x360,  // LVT LINT1 (usually NMI)
+            LVTError          = 0x370,  // LVT Error
+            TimerInitialCount = 0x380,  // Timer Initial Count
+            TimerCurrentCount = 0x390,  // Timer Current Count (read-only)
+            TimerDivideConfig = 0x3E0,  // Timer Divide Configuration
+        };
+
+        static constexpr uint32_t IA32_APIC_BASE_MSR    = 0x1B;
+        static constexpr uint32_t IA32_APIC_BASE_ENABLE = 1 << 11;
+
+        static constexpr uint8_t IRQ_VECTOR_BASE        = 0x20;  ///< Vector of ISA IRQ0 / GSI 0
+        static constexpr uint8_t IRQ_VECTOR_COUNT       = 24;    ///< GSIs 0-23 map to vectors 0x20-0x37
+        static constexpr uint8_t TIMER_VECTOR           = 0x20;  ///< LAPIC timer shares the system clock vector
+        static constexpr uint8_t SPURIOUS_VECTOR        = 0xFF;
+
+        static constexpr uint8_t MAX_IO_APICS           = 4;
+        static constexpr uint8_t ISA_IRQ_COUNT          = 16;
+
+        /**
+         * @brief Parse the MADT (Local APIC address, I/O APICs, ISA source overrides)
+         *
+         * Does NOT touch any APIC register; the MMIO regions must be mapped first.
+         *
+         * @return True if a Local APIC and at least one I/O APIC were found
+         */
+        static bool initialize();
+
+        /**
+         * @brief Switch interrupt delivery from the 8259 PIC to the APICs
+         *
+         * Masks the PIC, software-enables the Local APIC and routes ISA IRQs 0-15
+         * (except the cascade) through the I/O APIC to vectors 0x20-0x2F.
+         *
+         * @return True if the APICs are now delivering interrupts
+         */
+        static bool enable();
+
+        [[nodiscard]] static bool isInitialized() { return initialized_; }
+        [[nodiscard]] static bool isEnabled() { return enabled_; }
+
+        [[nodiscard]] static uintptr_t getLocalAPICAddress() { return localAPICAddress_; }
+        [[nodiscard]] static uint8_t getIOAPICCount() { return ioApicCount_; }
+        [[nodiscard]] static uintptr_t getIOAPICAddress(uint8_t index);
+
+        /**
+         * @brief Signal end of interrupt to the Local APIC (single MMIO write)
+         */
+        static inline void sendEOI() { localBase_[static_cast<uint32_t>(LocalRegister::EndOfInterrupt) / 4] = 0; }
+
+        /**
+         * @brief Route an ISA IRQ (0-15) to a vector, applying MADT source overrides
+         */
+        static bool routeIRQ(uint8_t irq, uint8_t vector);
+
+        /**
+         * @brief Route a Global System Interrupt to a vector on the owning I/O APIC
+         *
+         * @param levelTriggered True for level-triggered (PCI), false for edge (ISA)
+         * @param activeLow True for active-low polarity (PCI), false for active-high (ISA)
+         */
+        static bool routeGSI(uint32_t gsi, uint8_t vector, bool levelTriggered, bool activeLow);
+
+        /**
+         * @brief Route a PCI INTx line (the Interrupt Line register) to a vector
+         *
+         * Lines 0-15 go through the MADT override of that ISA IRQ, higher lines are GSIs (16-23 on the first I/O APIC).
+         * Flags that conform to the bus take the PCI defaults: level-triggered, active-low.
+         */
+        static bool routePCIInterrupt(uint8_t line, uint8_t vector);
+
+        /**
+         * @brief Mask the I/O APIC line of an ISA IRQ
+         */
+        static void maskIRQ(uint8_t irq);
+
+        /**
+         * @brief Translate an ISA IRQ into its GSI (identity unless overridden by the MADT)
+         */
+        [[nodiscard]] static uint32_t getGSIForIRQ(uint8_t irq);
+
+        /**
+         * @brief Measure the Local APIC timer rate against HPET
+         *
+         * @param measurementTimeMs Measurement window in milliseconds
+         * @return True if a usable rate was measured
+         */
+        static bool calibrateTimer(uint32_t measurementTimeMs = 10);
+
+        [[nodiscard]] static bool isTimerCalibrated() { return timerFrequency_ != 0; }
+
+        /**
+         * @brief Get the (divided) Local APIC timer input frequency in Hz
+         */
+        [[nodiscard]] static uint32_t getTimerFrequency() { return timerFrequency_; }
+
+        /**
+         * @brief Program the Local APIC timer in periodic mode on TIMER_VECTOR
+         *
+         * The PIT line is masked at the I/O APIC, so the LAPIC timer becomes the only tick source.
+         *
+         * @param frequency Interrupts per second
+         * @return False if not calibrated or the frequency is out of range
+         */
+        static bool setTimerFrequency(uint32_t frequency);
+
+    private:
+        struct IOAPICInfo {
+            uint8_t id;
+            volatile uint32_t* base;
+            uint32_t gsiBase;
+            uint32_t entryCount;
+        };
+
+        static uint32_t readLocal(LocalRegister reg);
+        static void writeLocal(LocalRegister reg, uint32_t value);
+
+        static uint32_t readIOAPIC(const IOAPICInfo& ioApic, uint8_t reg);
+        static void writeIOAPIC(const IOAPICInfo& ioApic, uint8_t reg, uint32_t value);
+        static IOAPICInfo* findIOAPIC(uint32_t gsi);
+
+        static uint32_t* handleSpuriousInterrupt(interrupts::CPURegisters* regs);
+
+        static bool initialized_;
+        static bool enabled_;
+        static uintptr_t localAPICAddress_;
+        static volatile uint32_t* localBase_;
+        static uint8_t localAPICID_;
+        static uint32_t timerFrequency_;
+
+        static IOAPICInfo ioApics_[MAX_IO_APICS];
+        static uint8_t ioApicCount_;
+
+        static uint32_t isaGSI_[ISA_IRQ_COUNT];    // ISA IRQ -> GSI
+        static uint16_t isaFlags_[ISA_IRQ_COUNT];  // MPS INTI flags (polarity/trigger)
+    };
+
+}  // namespace PalmyraOS::kernel
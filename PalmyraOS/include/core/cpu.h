@@ -16,9 +16,13 @@ namespace PalmyraOS::kernel {
 
         /**
          * @brief Get the current value of the Time Stamp Counter.
-         * @return The current value of the TSC.
+         * @return The current value of the TSC (read once: both halves belong to the same instant).
          */
-        static uint64_t getTSC();
+        static inline uint64_t getTSC() {
+            uint32_t low, high;
+            asm volatile("rdtsc" : "=a"(low), "=d"(high));
+            return (static_cast<uint64_t>(high) << 32) | low;
+        }
 
         /**
          * @brief Delays execution by the specified number of CPU ticks.
@@ -172,6 +176,43 @@ namespace PalmyraOS::kernel {
          */
         static bool isSHAAvailable();
 
+        /**
+         * @brief Check if the CPU has an on-chip Local APIC.
+         * @return True if the APIC is available, false otherwise.
+         */
+        static bool isAPICAvailable();
+
+        /**
+         * @brief Check if the CPU supports SYSENTER/SYSEXIT (SEP, excluding early Pentium Pro parts).
+         * @return True if fast system calls are available, false otherwise.
+         */
+        static bool isSysenterAvailable();
+
+        /**
+         * @brief Program the SYSENTER MSRs (CS, ESP, EIP).
+         *
+         * SS, the user CS and the user SS are derived by the CPU from the code selector,
+         * so the GDT must be ordered kernel code, kernel data, user code, user data.
+         * @param kernelCodeSelector Kernel code segment selector.
+         * @param stackPointer Value loaded into ESP on SYSENTER.
+         * @param entryPoint Kernel entry stub.
+         */
+        static void initializeSysenter(uint16_t kernelCodeSelector, uint32_t stackPointer, void (*entryPoint)());
+
+        /**
+         * @brief Read a Model Specific Register (RDMSR).
+         * @param msr The MSR index.
+         * @return The 64-bit value of the MSR.
+         */
+        static uint64_t readMSR(uint32_t msr);
+
+        /**
+         * @brief Write a Model Specific Register (WRMSR).
+         * @param msr The MSR index.
+         * @param value The 64-bit value to write.
+         */
+        static void writeMSR(uint32_t msr, uint64_t value);
+
         static uint32_t getCPUFrequency() { return CPU_frequency_; }
         static uint32_t getHSCFrequency() { return HSC_frequency_; }
 
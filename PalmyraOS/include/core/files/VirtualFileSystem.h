@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "core/Locks.h"
 #include "core/files/VirtualFileSystemBase.h"
 #include "palmyraOS/unistd.h"  // fd_t
 #include <bits/std_function.h>
@@ -86,6 +87,9 @@ namespace PalmyraOS::kernel::vfs {
     /**
      * @class VirtualFileSystem
      * @brief Main class for managing the virtual file system.
+     *
+     * The path-based methods serialize tree walks and dentry changes with treeLock_ (a Mutex:
+     * process context only). Returned inode pointers are not protected by the lock.
      */
     class VirtualFileSystem {
     public:
@@ -180,9 +184,12 @@ namespace PalmyraOS::kernel::vfs {
         static bool removeInodeByPath(const KString& path);
 
     private:
+        static bool setInodeByPathUnlocked(const KString& path, InodeBase* inode);
+
         static InodeBase* rootNode_;     ///< Root inode of the virtual file system.
         static InodeBase* deviceInode_;  ///< Inode for the /dev directory.
         static InodeBase* binaryInode_;  ///< Inode for the /bin directory.
+        static Mutex treeLock_;          ///< Serializes path lookups and dentry changes.
     };
 
 
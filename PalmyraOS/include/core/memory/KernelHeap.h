@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "core/Locks.h"
 #include "palmyraOS/shared/memory/Heap.h"
 
 
@@ -11,5 +12,13 @@ namespace PalmyraOS::kernel {
         ~HeapManager();
         void* allocateMemory(size_t size) final;
         void freePage(void* address) final;
+
+    protected:
+        // The kernel heap is shared by processes, bottom halves and IRQ handlers
+        void lock() final { lock_.lock(); }
+        void unlock() final { lock_.unlock(); }
+
+    private:
+        SpinLock lock_;
     };
 }  // namespace PalmyraOS::kernel
\ No newline at end of file
@@ -0,0 +1,81 @@
+
+#pragma once
+
+#include "core/Locks.h"
+#include "core/definitions.h"
+#include "core/memory/KernelHeapAllocator.h"
+
+
+namespace PalmyraOS::kernel {
+
+    // Forward declarations
+    namespace vfs {
+        class InodeBase;
+    }
+
+    /**
+     * @class PageCache
+     * @brief File pages shared between the processes that map them (demand-paged ELF images)
+     *
+     * A page is read from the file on first use and kept in one identity-mapped frame, keyed by
+     * (inode number, page index). Every mapping holds a reference; the cache holds one more while
+     * the page is indexed, so the next process spawned from the same file finds it without I/O.
+     * Writing, truncating or deleting the file drops the index entries; frames still mapped by
+     * running processes are freed when their last mapping goes away. Files pinned by running
+     * processes (their executable) are not modified at all, like ETXTBSY on Linux.
+     */
+    class PageCache {
+    public:
+        /**
+         * @brief Publishes /proc/pagecache (hits, misses, cached pages)
+         */
+        static void initialize();
+
+        /**
+         * @brief Returns the frame holding a file page, reading it on a miss
+         * @param inode File to read from
+         * @param pageIndex Page index in the file (offset >> PAGE_BITS)
+         * @return Frame with one more reference (release() it), or nullptr if out of memory
+         */
+        static void* acquire(vfs::InodeBase* inode, uint32_t pageIndex);
+
+        /**
+         * @brief Like acquire(), but never reads: returns nullptr if the page is not cached
+         */
+        static void* lookup(vfs::InodeBase* inode, uint32_t pageIndex);
+
+        /**
+         * @brief Drops a reference taken by acquire() or lookup()
+         */
+        static void release(void* frame);
+
+        /**
+         * @brief Forgets all cached pages of a file (its content changed)
+         */
+        static void invalidate(vfs::InodeBase* inode);
+
+        /**
+         * @brief Marks a file as the image of one more running process (it keeps faulting pages in)
+         */
+        static void pinFile(vfs::InodeBase* inode);
+        static void unpinFile(vfs::InodeBase* inode);
+
+        /**
+         * @brief Checks whether a running process executes the file (it must not be written or deleted)
+         */
+        [[nodiscard]] static bool isFilePinned(vfs::InodeBase* inode);
+
+    private:
+        static uint64_t makeKey(vfs::InodeBase* inode, uint32_t pageIndex);
+        static void dropReference(void* frame);
+        static size_t readStatistics(char* buffer, size_t size, size_t offset);
+
+        static KMap<uint64_t, void*> pages_;       ///< (inode number << 32 | page index) -> frame
+        static KMap<void*, uint32_t> references_;  ///< frame -> mappings (+1 while indexed)
+        static KMap<size_t, uint32_t> pinned_;     ///< inode number -> running processes
+        static Mutex lock_;
+        static uint64_t hits_;
+        static uint64_t misses_;
+    };
+
+}  // namespace PalmyraOS::kernel
@@ -52,6 +52,11 @@ namespace PalmyraOS::kernel {
          */
         static void freeFrame(void* frame);
 
+        /**
+         * @brief Frees a run of contiguous frames (whole bitmap words are cleared at once).
+         * @param frame Pointer to the first frame of the run.
+         * @param num The number of frames to free.
+         */
         static void freeFrames(void* frame, uint32_t num);
 
         /**
@@ -130,6 +130,13 @@ namespace PalmyraOS::kernel {
          */
         void freePage(void* pageAddress);  // give it virtual address
 
+        /**
+         * @brief Frees virtually contiguous pages, releasing physically contiguous frames in batches
+         * @param pageAddress Virtual address of the first page
+         * @param numPages Number of pages to free
+         */
+        void freePages(void* pageAddress, size_t numPages);
+
         /**
          * @brief Returns the page directory
          * @return uint32_t* Pointer to the page directory
@@ -177,6 +184,13 @@ namespace PalmyraOS::kernel {
          */
         bool isAddressValid(void* address);
 
+        /**
+         * @brief Checks if a virtual address is mapped to a present page that user mode may access
+         * @param address The virtual address to validate
+         * @return bool True if both the table and the page carry the user flag
+         */
+        bool isUserAccessible(void* address);
+
         void* getPhysicalAddress(void* address);
 
         /**
@@ -278,6 +292,10 @@ namespace PalmyraOS::kernel {
     public:
         /**
          * @brief Handles page fault interrupts
+         *
+         * Lazily backed pages are mapped and the access retried. An invalid access from user
+         * mode terminates the faulting process (and its threads); one from kernel mode panics.
+         *
          * @param regs Pointer to CPU registers at the time of the fault
          */
         static uint32_t* handlePageFault(interrupts::CPURegisters* regs);
@@ -288,6 +306,16 @@ namespace PalmyraOS::kernel {
          */
         static void setSecondaryPageFaultHandler(PageFaultHandler handler);
 
+    private:
+        /// Access and cause of a fault from its error code, e.g. "write, not mapped"
+        [[nodiscard]] static const char* describeFault(uint32_t errorCode);
+
+        /// Logs the fault, terminates the thread group of the current process with exitCode and switches away
+        static uint32_t* terminateFaultingProcess(interrupts::CPURegisters* regs, uint32_t faultingAddress, int exitCode);
+
+        /// Panics with a compact crash record (registers, address, process)
+        static void reportKernelFault(interrupts::CPURegisters* regs, uint32_t faultingAddress);
+
     private:
         static PagingDirectory* currentPageDirectory_;  ///< Pointer to the current page directory
         static PageFaultHandler secondaryHandler_;      ///< Pointer to the secondary page fault handler
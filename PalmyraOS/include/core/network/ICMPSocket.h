@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/Locks.h"
 #include "core/memory/KernelHeapAllocator.h"
 #include "core/network/ProtocolSocket.h"
 
@@ -47,6 +48,7 @@ namespace PalmyraOS::kernel {
         size_t sendto(const char* buffer, size_t length, uint32_t destIP, uint16_t destPort) override;  // destPort ignored
         size_t recvfrom(char* buffer, size_t length, uint32_t* srcIP, uint16_t* srcPort) override;      // srcPort always 0
         int getBytesAvailable() const override;
+        [[nodiscard]] bool hasPendingData() const override;
         int close() override;
 
         [[nodiscard]] bool isBound() const override;
@@ -132,6 +134,7 @@ namespace PalmyraOS::kernel {
 
         // Receive queue - MUST be heap-allocated (KQueue pattern)
         KQueue<Packet>* receiveQueue_;
+        mutable SpinLock queueLock_;  ///< Receive queue is filled from the network bottom half
 
         static constexpr size_t MAX_QUEUE_SIZE = 64;  ///< Maximum packets in queue
 
@@ -233,12 +233,12 @@ namespace PalmyraOS::kernel {
          * 5. Clear interrupt flags by writing them back to CSR0
          *
          * **Processing Details:**
-         * - RINT calls processReceivedPackets() to walk RX ring
+         * - The RX ring walk (processReceivedPackets) is deferred to a bottom half (DeferredWork)
          * - TINT just clears flag (no TX buffer cleanup yet)
          * - ERR logs error for debugging
          *
          * @note Called from interrupt handler (ISR context)
-         * @note Must be fast (<100µs typical with 8 packets)
+         * @note Only acknowledges the NIC; ARP/IPv4/UDP processing runs with interrupts enabled
          * @note Statistics updated automatically
          *
          * @see handleInterrupt() in NetworkInterface (base class)
@@ -457,9 +457,12 @@ namespace PalmyraOS::kernel {
         /// @brief Initialize descriptor rings with correct values and ownership flags
         void initializeDescriptors();
 
-        /// @brief Process received packets from RX ring (called from ISR)
+        /// @brief Process received packets from RX ring (called from the receive bottom half)
         void processReceivedPackets();
 
+        /// @brief Receive bottom half (DeferredWork::Function, context is the driver)
+        static void receiveWork(void* context, uint32_t argument);
+
         /**
          * @brief Interrupt handler trampoline (static for ISR registration)
          *
@@ -499,6 +502,8 @@ namespace PalmyraOS::kernel {
         // **Ring Management**
         uint8_t currentTx_;  ///< Next TX descriptor to use (round-robin, 0-7)
         uint8_t currentRx_;  ///< Next RX descriptor to process (round-robin, 0-7)
+
+        volatile bool receiveWorkPending_{false};  ///< Receive bottom half already queued
     };
 
 }  // namespace PalmyraOS::kernel
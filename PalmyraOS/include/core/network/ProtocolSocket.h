@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/Poll.h"
 #include <cstddef>  // size_t
 #include <cstdint>  // uint32_t
 
@@ -74,6 +75,11 @@ namespace PalmyraOS::kernel {
          */
         virtual int getBytesAvailable() const                                                        = 0;
 
+        /**
+         * @brief Check if a packet is queued (also true for an empty datagram)
+         */
+        [[nodiscard]] virtual bool hasPendingData() const                                            = 0;
+
         /**
          * @brief Close the socket
          * @return 0 on success, negative error code on failure
@@ -162,9 +168,18 @@ namespace PalmyraOS::kernel {
          */
         virtual int shutdown(int how)                                                                = 0;
 
+        // ==================== Readiness ====================
+
+        /**
+         * @brief Watchers of this socket (poll/epoll), notified with POLLIN when a packet is queued
+         */
+        [[nodiscard]] PollSource& getPollSource() { return pollSource_; }
+
     protected:
         ProtocolSocket() = default;
 
+        PollSource pollSource_;  ///< Notified by the receive path (interrupt context)
+
     private:
         // Prevent copying
         ProtocolSocket(const ProtocolSocket&)            = delete;
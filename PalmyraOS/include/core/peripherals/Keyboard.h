@@ -32,15 +32,12 @@ namespace PalmyraOS::kernel {
         static void waitForOutputBufferFull();
 
         static uint32_t* handleInterrupt(interrupts::CPURegisters* regs);
+        static void processScancode(void* context, uint32_t scancode);  // bottom half (DeferredWork)
 
     private:
-        static constexpr size_t bufferSize = 10;
         static ports::BytePort commandPort_;
         static ports::BytePort dataPort_;
 
-        static size_t buffer_last_index_;
-        static char buffer_[bufferSize];
-
         static bool isShiftPressed_;
         static bool isCtrlPressed_;
         static bool isAltPressed_;
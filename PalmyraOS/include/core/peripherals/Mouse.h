@@ -15,6 +15,7 @@ namespace PalmyraOS::kernel {
 
     private:
         static uint32_t* handleInterrupt(interrupts::CPURegisters* regs);
+        static void processPacket(void* context, uint32_t packet);  // bottom half (DeferredWork)
         static bool expectACK();
 
         static void waitForInputBufferEmpty();
@@ -6,6 +6,9 @@
 
 namespace PalmyraOS::kernel {
 
+    // Forward declarations
+    class PollSource;
+
     /**
      * @class Descriptor
      * @brief Abstract base class for all file descriptors (files, pipes, sockets, etc.)
@@ -28,12 +31,14 @@ namespace PalmyraOS::kernel {
         enum class Kind : uint8_t {
             File,   ///< Regular file or directory (seekable)
             Pipe,   ///< Pipe (not seekable, unidirectional)
-            Socket  ///< Network socket (not seekable, bidirectional)
+            Socket,  ///< Network socket (not seekable, bidirectional)
+            Epoll,   ///< epoll interest list (readable when an entry is ready)
+            IoRing   ///< Submission/completion rings for batched system calls
         };
 
         /**
          * @brief Get the type of this descriptor
-         * @return The descriptor kind (File, Pipe, or Socket)
+         * @return The descriptor kind (File, Pipe, Socket, Epoll or IoRing)
          */
         [[nodiscard]] virtual Kind kind() const               = 0;
 
@@ -68,6 +73,20 @@ namespace PalmyraOS::kernel {
          */
         virtual ~Descriptor()                                 = default;
 
+        /**
+         * @brief Get the current readiness of this descriptor
+         * @return POLLIN, POLLOUT, POLLHUP, ... (palmyraOS/poll.h)
+         *
+         * Default implementation reports readable and writable (regular files never block)
+         */
+        [[nodiscard]] virtual uint32_t poll();
+
+        /**
+         * @brief Get the source that notifies poll()/epoll watchers when the readiness changes
+         * @return The source, or nullptr if the readiness never changes (poll() is always answered at once)
+         */
+        [[nodiscard]] virtual PollSource* getPollSource() { return nullptr; }
+
         // ==================== Memory Management (Freestanding C++) ====================
 
         /// @brief Custom operator new for freestanding environment (global heap allocation)
@@ -47,10 +47,10 @@ namespace PalmyraOS::kernel {
 
         /**
          * @brief Allocate a new file descriptor for a descriptor object
-         * @param descriptor Heap-allocated descriptor (ownership transferred)
-         * @return The allocated file descriptor number
+         * @param descriptor Heap-allocated descriptor (ownership transferred on success)
+         * @return The allocated file descriptor number, or -EMFILE if the table is full (RLIMIT_NOFILE)
          * 
-         * The table takes ownership of the descriptor pointer.
+         * The table takes ownership of the descriptor pointer; on failure the caller still owns it.
          * The descriptor will be deleted when release() is called or the table is destroyed.
          * 
          * Example:
@@ -70,6 +70,24 @@ namespace PalmyraOS::kernel {
          */
         void release(fd_t fd);
 
+        /**
+         * @brief Install a descriptor at a given file descriptor number (like dup2)
+         * @param fd The file descriptor number (0, 1, 2 redirect the standard streams)
+         * @param descriptor Heap-allocated descriptor (ownership transferred)
+         * 
+         * A descriptor already open at fd is released first.
+         * Later allocations never return fd.
+         */
+        void install(fd_t fd, Descriptor* descriptor);
+
+        /**
+         * @brief Release all descriptors
+         * 
+         * Called when the process exits, so that peers (the other end of a pipe)
+         * see the close without waiting for the process slot to be recycled.
+         */
+        void releaseAll();
+
         /**
          * @brief Get the descriptor associated with a file descriptor
          * @param fd The file descriptor
@@ -93,9 +111,16 @@ namespace PalmyraOS::kernel {
          */
         [[nodiscard]] size_t count() const;
 
+        /**
+         * @brief Set the maximum number of open descriptors (RLIMIT_NOFILE)
+         * @param limit Maximum checked by allocate(); descriptors already open stay open
+         */
+        void setLimit(size_t limit) { limit_ = limit; }
+
     private:
         KMap<fd_t, Descriptor*> table_;  ///< Map of file descriptors to descriptors
         fd_t nextFd_;                    ///< Next file descriptor to allocate
+        size_t limit_;                   ///< Maximum number of open descriptors
     };
 
 }  // namespace PalmyraOS::kernel
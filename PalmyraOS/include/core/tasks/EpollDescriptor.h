@@ -0,0 +1,128 @@
+
+#pragma once
+
+#include "core/Locks.h"
+#include "core/Poll.h"
+#include "core/memory/KernelHeapAllocator.h"  // KMap
+#include "core/tasks/Descriptor.h"
+#include "palmyraOS/poll.h"  // epoll_event
+#include "palmyraOS/unistd.h"  // fd_t
+
+namespace PalmyraOS::kernel {
+
+    /**
+     * @class EpollDescriptor
+     * @brief Interest list of descriptors with a ready list (epoll_create/epoll_ctl/epoll_wait)
+     *
+     * Every registered descriptor gets an entry watching its PollSource. A notification appends
+     * the entry to the ready list and wakes epoll_wait() sleepers, so waiting costs nothing per
+     * descriptor and collecting only visits entries that became ready.
+     *
+     * Trigger modes:
+     * - Level-triggered (default): a reported entry goes back to the ready list and is reported
+     *   again until its descriptor is no longer ready
+     * - Edge-triggered (EPOLLET): reported once per notification (new data, space freed)
+     * - EPOLLONESHOT: disabled after one report until EPOLL_CTL_MOD re-arms it
+     *
+     * Closing a registered descriptor removes its entry (like the last close on Linux).
+     * The epoll descriptor is itself pollable: readable while its ready list is not empty.
+     */
+    class EpollDescriptor final : public Descriptor {
+    public:
+        EpollDescriptor() = default;
+
+        /**
+         * @brief Unregisters all entries and wakes sleepers (they find the descriptor closed)
+         */
+        ~EpollDescriptor() override;
+
+        // ===== Descriptor interface implementation =====
+
+        [[nodiscard]] Kind kind() const override;
+
+        /// @brief Not supported (-EINVAL): events are collected with epoll_wait()
+        size_t read(char* buffer, size_t size) override;
+
+        /// @brief Not supported (-EINVAL)
+        size_t write(const char* buffer, size_t size) override;
+
+        /// @brief Not supported (-ENOTTY)
+        int ioctl(int request, void* arg) override;
+
+        /**
+         * @brief POLLIN while an entry is ready
+         */
+        [[nodiscard]] uint32_t poll() override;
+
+        [[nodiscard]] PollSource* getPollSource() override { return &pollSource_; }
+
+        // ===== epoll_ctl =====
+
+        /**
+         * @brief Registers a descriptor (EPOLL_CTL_ADD)
+         * @return 0, -EEXIST if already registered, -EPERM if its readiness never changes (regular files)
+         */
+        int add(fd_t fd, Descriptor* target, const epoll_event& event);
+
+        /**
+         * @brief Changes the events and data of a registered descriptor, re-arming EPOLLONESHOT (EPOLL_CTL_MOD)
+         * @return 0, or -ENOENT if not registered
+         */
+        int modify(fd_t fd, const epoll_event& event);
+
+        /**
+         * @brief Unregisters a descriptor (EPOLL_CTL_DEL)
+         * @return 0, or -ENOENT if not registered
+         */
+        int remove(fd_t fd);
+
+        // ===== epoll_wait =====
+
+        /**
+         * @brief Moves up to maxEvents ready entries to events, without sleeping
+         * @return Number of events stored
+         */
+        uint32_t collect(epoll_event* events, uint32_t maxEvents);
+
+        /**
+         * @brief Sleeps until an entry becomes ready or the tick is reached (0: no deadline)
+         *
+         * The descriptor may be closed by another thread meanwhile: look it up again afterwards.
+         */
+        void sleep(uint64_t deadlineTick);
+
+    private:
+        class Entry final : public PollWatcher {
+        public:
+            Entry(EpollDescriptor* owner, fd_t fd, Descriptor* target, const epoll_event& event);
+
+            void notify(uint32_t events) override;
+            void detach() override;
+
+            /// Events reported even if not requested
+            static constexpr uint32_t ALWAYS_REPORTED = POLLERR | POLLHUP;
+
+            EpollDescriptor* owner_;
+            fd_t fd_;
+            Descriptor* target_;
+            uint32_t events_;            ///< EPOLLIN, EPOLLOUT, ... plus EPOLLET / EPOLLONESHOT
+            uint64_t data_;              ///< Returned as is in epoll_event::data
+            bool armed_{true};           ///< False after an EPOLLONESHOT report
+            bool queued_{false};         ///< Linked in the ready list
+            Entry* readyNext_{nullptr};  ///< Next entry in the ready list
+        };
+
+        /// Appends an entry to the ready list and wakes sleepers (interrupt context allowed)
+        void markReady(Entry* entry);
+
+        /// Removes an entry from the ready list
+        void unlinkReady(Entry* entry);
+
+        KMap<fd_t, Entry*> entries_;  ///< Interest list
+        Entry* readyHead_{nullptr};   ///< Ready list, oldest first
+        Entry* readyTail_{nullptr};   ///< Last ready entry
+        WaitQueue waiters_;           ///< epoll_wait() sleepers
+        PollSource pollSource_;       ///< Watchers of this epoll descriptor (nested poll/epoll)
+    };
+
+}  // namespace PalmyraOS::kernel
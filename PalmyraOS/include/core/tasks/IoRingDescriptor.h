@@ -0,0 +1,69 @@
+
+#pragma once
+
+#include "core/tasks/Descriptor.h"
+#include "palmyraOS/io_uring.h"
+
+namespace PalmyraOS::kernel {
+
+    /**
+     * @class IoRingDescriptor
+     * @brief Submission and completion rings shared with the process (io_uring_setup/io_uring_enter)
+     *
+     * The rings live in process pages that are identity-mapped, so the kernel reaches them in
+     * any address space. Only the head and tail indices are read from shared memory: the ring
+     * sizes are kept here, and every submission entry is copied before it runs, so the process
+     * cannot make the kernel index outside the rings by scribbling over them.
+     *
+     * The pages are released with the process (like thread stacks), not on close().
+     */
+    class IoRingDescriptor final : public Descriptor {
+    public:
+        IoRingDescriptor(io_uring_rings* rings, uint32_t sqEntries, uint32_t cqEntries);
+
+        // ===== Descriptor interface implementation =====
+
+        [[nodiscard]] Kind kind() const override;
+
+        /// @brief Not supported (-EINVAL): operations are submitted with io_uring_enter()
+        size_t read(char* buffer, size_t size) override;
+
+        /// @brief Not supported (-EINVAL)
+        size_t write(const char* buffer, size_t size) override;
+
+        /// @brief Not supported (-ENOTTY)
+        int ioctl(int request, void* arg) override;
+
+        // ===== Rings =====
+
+        /**
+         * @brief Takes the oldest pending submission entry
+         * @param entry Output: copy of the entry
+         * @return False if there is none, or if no completion slot is free to report it
+         */
+        [[nodiscard]] bool takeSubmission(io_uring_sqe& entry);
+
+        /**
+         * @brief Appends a completion (a slot is free: takeSubmission() checked it)
+         */
+        void complete(uint64_t userData, int32_t result);
+
+        /**
+         * @brief Bytes needed for the header and both rings
+         */
+        [[nodiscard]] static uint32_t ringSize(uint32_t sqEntries, uint32_t cqEntries);
+
+        /**
+         * @brief Fills the header of freshly allocated rings
+         */
+        static void initializeRings(io_uring_rings* rings, uint32_t sqEntries, uint32_t cqEntries);
+
+    private:
+        io_uring_rings* rings_;
+        io_uring_sqe* sqes_;
+        io_uring_cqe* cqes_;
+        uint32_t sqEntries_;  ///< Power of two
+        uint32_t cqEntries_;  ///< Power of two
+    };
+
+}  // namespace PalmyraOS::kernel
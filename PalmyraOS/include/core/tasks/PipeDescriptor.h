@@ -0,0 +1,139 @@
+
+#pragma once
+
+#include "core/Locks.h"
+#include "core/Poll.h"
+#include "core/definitions.h"
+#include "core/memory/PhysicalMemory.h"  // PAGE_SIZE
+#include "core/tasks/Descriptor.h"
+#include "palmyraOS/unistd.h"  // PIPE_BUF
+
+namespace PalmyraOS::kernel {
+
+    // Forward declarations
+    class PipeDescriptor;
+
+    /**
+     * @class Pipe
+     * @brief Fixed-capacity ring buffer shared by the read and write ends of a pipe
+     *
+     * Data is copied in bulk (at most two memcpy per call, one on each side of the wrap).
+     * A reader sleeps while the ring is empty and a writer while it is full, so a fast
+     * producer is held back by a slow consumer instead of growing a buffer.
+     *
+     * Semantics follow POSIX:
+     * - Reading an empty pipe without writers returns 0 (end of file)
+     * - Writing to a pipe without readers fails with -EPIPE (there are no signals)
+     * - Writes of at most PIPE_ATOMIC bytes are never interleaved with other writes
+     *
+     * The pipe is freed when its last end is closed and no caller is still inside read() or write().
+     */
+    class Pipe {
+    public:
+        static constexpr uint32_t BUFFER_PAGES = 4;                         ///< Size of the ring in pages
+        static constexpr uint32_t CAPACITY     = BUFFER_PAGES * PAGE_SIZE;  ///< Size of the ring in bytes
+        static constexpr uint32_t PIPE_ATOMIC  = PIPE_BUF;                  ///< Largest write that is never split
+
+        /**
+         * @brief Creates a pipe with its two ends
+         * @param nonBlocking Ends return -EAGAIN instead of sleeping (O_NONBLOCK)
+         * @return False if out of memory (nothing is allocated then)
+         */
+        [[nodiscard]] static bool create(bool nonBlocking, PipeDescriptor** readEnd, PipeDescriptor** writeEnd);
+
+        size_t read(char* buffer, size_t size, bool nonBlocking);
+        size_t write(const char* buffer, size_t size, bool nonBlocking);
+
+        /**
+         * @brief Readiness of one end: POLLIN/POLLHUP for the read end, POLLOUT/POLLERR for the write end
+         */
+        [[nodiscard]] uint32_t poll(bool readEnd) const;
+
+        /// Links a new end (an opened or duplicated descriptor)
+        void attach(PipeDescriptor* end);
+
+        /// Unlinks a closed end, waking the other side when its last peer goes away
+        void detach(PipeDescriptor* end);
+
+        /// Accounts a caller out of read()/write(); Process::kill calls it for a caller that never returned
+        void leave(Process* process);
+
+    private:
+        explicit Pipe(char* buffer);
+        ~Pipe();
+        REMOVE_COPY(Pipe);
+
+        /// Tells the watchers of every read end (readEnds true) or write end about new readiness
+        void notifyEnds(bool readEnds, uint32_t events);
+
+        /// Accounts the current process in as a caller of read()/write()
+        void enter();
+
+        /// Frees the pipe once no end and no caller is left
+        void releaseIfUnused();
+
+        char* buffer_;                   ///< BUFFER_PAGES kernel pages
+        uint32_t head_{0};               ///< Offset of the next byte to read
+        uint32_t count_{0};              ///< Bytes stored
+        uint32_t readers_{0};            ///< Open read ends
+        uint32_t writers_{0};            ///< Open write ends
+        uint32_t users_{0};              ///< Callers inside read()/write() (they may sleep past the last close)
+        PipeDescriptor* ends_{nullptr};  ///< All open ends
+        WaitQueue readWaiters_;          ///< Readers waiting for data
+        WaitQueue writeWaiters_;         ///< Writers waiting for space
+    };
+
+    /**
+     * @class PipeDescriptor
+     * @brief One end of a pipe (read or write only)
+     *
+     * Every end owns its PollSource, so closing it detaches exactly the poll()/epoll
+     * watchers registered on that descriptor while the pipe lives on.
+     */
+    class PipeDescriptor final : public Descriptor {
+    public:
+        PipeDescriptor(Pipe* pipe, bool readEnd, bool nonBlocking);
+
+        /**
+         * @brief Closes this end (the pipe is freed with its last end)
+         */
+        ~PipeDescriptor() override;
+
+        // ===== Descriptor interface implementation =====
+
+        [[nodiscard]] Kind kind() const override;
+
+        /// @brief Reads up to size bytes, sleeping while the pipe is empty (-EBADF on the write end)
+        size_t read(char* buffer, size_t size) override;
+
+        /// @brief Writes all bytes, sleeping while the pipe is full (-EBADF on the read end)
+        size_t write(const char* buffer, size_t size) override;
+
+        /// @brief Not supported (-ENOTTY)
+        int ioctl(int request, void* arg) override;
+
+        [[nodiscard]] uint32_t poll() override;
+
+        [[nodiscard]] PollSource* getPollSource() override { return &pollSource_; }
+
+        // ===== Pipe ends =====
+
+        /**
+         * @brief Opens another descriptor on the same end (given to a spawned process)
+         * @return The new end, or nullptr if out of memory
+         */
+        [[nodiscard]] PipeDescriptor* duplicate() const;
+
+        [[nodiscard]] bool isReadEnd() const { return readEnd_; }
+
+    private:
+        friend class Pipe;
+
+        Pipe* pipe_;
+        bool readEnd_;
+        bool nonBlocking_;               ///< O_NONBLOCK: -EAGAIN instead of sleeping
+        PipeDescriptor* next_{nullptr};  ///< Next end of the same pipe
+        PollSource pollSource_;          ///< Watchers of this end
+    };
+
+}  // namespace PalmyraOS::kernel
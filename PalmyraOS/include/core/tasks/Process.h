@@ -3,10 +3,12 @@
 
 #include <elf.h>
 
+#include "core/FPU.h"
 #include "core/Interrupts.h"
 #include "core/definitions.h"
 #include "core/memory/KernelHeapAllocator.h"
 #include "core/tasks/DescriptorTable.h"
+#include "core/tasks/RunQueue.h"
 #include "core/tasks/auxv.h"
 
 
@@ -15,18 +17,71 @@ namespace PalmyraOS::kernel {
     // Forward declarations
     class TaskManager;
     class PagingDirectory;
-
-    // Maximum number of processes supported
+    class WaitQueue;
+    class PollTable;
+    class Pipe;
+    struct ProfileSamples;
+    class StreamBuffer;
+    namespace vfs {
+        class InodeBase;
+    }
+
+    // Default capacity of the process table (see TaskManager::initialize)
     constexpr uint32_t MAX_PROCESSES             = 512;
     constexpr uint32_t PROCESS_KERNEL_STACK_SIZE = 10;
     constexpr uint32_t PROCESS_USER_STACK_SIZE   = 128;
 
+    /**
+     * @brief PT_LOAD segment of an ELF image, mapped page by page on first access
+     */
+    struct ImageSegment {
+        uint32_t start;       ///< p_vaddr rounded down to a page
+        uint32_t end;         ///< p_vaddr + p_memsz rounded up to a page
+        uint32_t vaddr;       ///< p_vaddr
+        uint32_t fileOffset;  ///< p_offset
+        uint32_t fileSize;    ///< p_filesz (the rest up to p_memsz is zero-filled)
+        bool writable;        ///< PF_W: file pages are mapped copy-on-write
+    };
+
     struct ProcessDebug {
         uint32_t entryEip       = 0;
         uint32_t lastWorkingEip = 0;
         uint32_t argvBlock      = 0;
     };
 
+    /**
+     * @brief CPU time and scheduling latency in TSC cycles, accounted at every switch and system call
+     */
+    struct SchedStats {
+        static constexpr uint32_t LATENCY_BUCKETS = 16;  ///< Bucket 0: under 1 us, bucket i: under 2^i us, the last one: the rest
+
+        uint64_t userCycles               = 0;   ///< Running in user mode
+        uint64_t kernelCycles             = 0;   ///< Running in the kernel (system calls, kernel processes)
+        uint64_t waitCycles               = 0;   ///< Ready but not running (scheduling latency)
+        uint64_t maxWaitCycles            = 0;   ///< Longest single wait
+        uint32_t runs                     = 0;   ///< Times switched in
+        uint32_t voluntarySwitches        = 0;   ///< Gave up the CPU: slept, yielded or exited
+        uint32_t involuntarySwitches      = 0;   ///< Preempted by the scheduler
+        uint32_t latency[LATENCY_BUCKETS] = {};  ///< Waits per bucket
+
+        uint64_t accountedTsc = 0;  ///< CPU time is charged up to here (while running)
+        uint64_t readyTsc     = 0;  ///< Became ready at (0: not waiting for the CPU)
+        uint32_t kernelDepth  = 0;  ///< System calls in progress (nested when the kernel calls sched_yield)
+    };
+
+    /**
+     * @brief Resource limits of a thread group (setrlimit), inherited by the processes it spawns
+     *
+     * Usage is measured where it is already counted (pages of the process, size of the
+     * descriptor table, CPU cycles charged by the scheduler), so every check is O(1).
+     */
+    struct ResourceLimits {
+        rlimit limits[RLIMIT_NLIMITS];  ///< Indexed by RLIMIT_*, RLIM_INFINITY when unlimited
+        uint64_t cpuLimitCycles = 0;    ///< RLIMIT_CPU soft limit in TSC cycles (0: unlimited)
+
+        ResourceLimits();
+    };
+
     /**
      * @enum EFlags
      * @brief Enum class representing the CPU EFlags register bits.
@@ -91,10 +146,24 @@ namespace PalmyraOS::kernel {
 
         /**
          * @enum Priority
-         * @brief Enum class representing the execution priority of a process.
+         * @brief Enum class representing the execution priority of a process (sets the initial nice value, see priorityToNice).
          */
         enum class Priority : uint32_t { VeryLow = 1, Low = 2, Medium = 5, High = 7, VeryHigh = 10 };
 
+        /**
+         * @enum Policy
+         * @brief Scheduling class (values match SCHED_OTHER, SCHED_FIFO and SCHED_RR).
+         *
+         * Real-time processes always run before normal ones, the highest real-time priority first.
+         * FIFO runs until it blocks, yields or a higher real-time priority becomes ready; RoundRobin
+         * additionally rotates with equal priorities every REALTIME_TIME_SLICE ticks.
+         */
+        enum class Policy : uint32_t { Normal = 0, FIFO = 1, RoundRobin = 2 };
+
+        static constexpr uint32_t REALTIME_PRIORITY_MIN = 1;   ///< Lowest real-time priority
+        static constexpr uint32_t REALTIME_PRIORITY_MAX = 99;  ///< Highest real-time priority
+        static constexpr uint32_t REALTIME_TIME_SLICE   = 10;  ///< Ticks of a RoundRobin slice
+
         /**
          * @struct Arguments
          * @brief Struct representing the arguments to be passed to a process.
@@ -105,6 +174,16 @@ namespace PalmyraOS::kernel {
             char** argv;              ///< Argument values
         };
 
+        /**
+         * @struct ThreadLocalStorage
+         * @brief TLS segment of a thread (set_thread_area), loaded into the GDT on every switch.
+         */
+        struct ThreadLocalStorage {
+            uint32_t base     = 0;        ///< Linear base address of the TLS block
+            uint32_t limitRaw = 0xFFFFF;  ///< 20-bit segment limit
+            bool limitInPages = true;     ///< Limit granularity (4KB pages or bytes)
+        };
+
     public:
         /**
          * @brief Constructs a Process object.
@@ -119,19 +198,33 @@ namespace PalmyraOS::kernel {
          */
         Process(ProcessEntry entryPoint, uint32_t pid, Mode mode, Priority priority, uint32_t argc, char* const* argv, char* const* envp, bool isInternal);
 
+        /**
+         * @brief Constructs a thread inside the thread group of an existing process.
+         *
+         * The thread shares the address space, descriptors, windows and heap of the leader,
+         * but owns its kernel stack. It resumes at the given context with eax = 0.
+         *
+         * @param leader Thread group leader
+         * @param tid Thread ID (allocated from the PID space)
+         * @param context CPU state to resume from (the clone() caller's registers)
+         * @param userStackPointer Top of the user stack provided by the caller
+         */
+        Process(Process& leader, uint32_t tid, const interrupts::CPURegisters& context, uint32_t userStackPointer);
+
         /**
          * @brief Destructor for Process.
          */
         ~Process() = default;
 
         /**
-         * @brief Terminates the process with the given exit code.
+         * @brief Terminates the process with the given exit code and queues it for the reaper.
          * @param exitCode Exit code for the process
          */
         void terminate(int exitCode);
 
         /**
-         * @brief Kills the process.
+         * @brief Kills the process (called by the reaper with interrupts enabled).
+         * Frees pages in physically contiguous runs and closes windows; the state becomes Killed last.
          * Note: This cannot be called within the process stack, as memory will be freed!
          */
         void kill();
@@ -151,6 +244,14 @@ namespace PalmyraOS::kernel {
          */
         void deregisterPages(void* physicalAddress, size_t count);
 
+        /**
+         * @brief Unmaps and frees a region returned by mmap (munmap)
+         * @param address Start of the region
+         * @param count Number of pages, which must cover the whole region
+         * @return False if the range is not exactly one mmap region of the thread group
+         */
+        bool unmapPages(void* address, size_t count);
+
         /**
          * @brief Allocates pages for the process.
          * @param count Number of pages to allocate.
@@ -165,6 +266,62 @@ namespace PalmyraOS::kernel {
          */
         void* allocatePagesAt(void* virtual_address, size_t count);
 
+        /**
+         * @brief Resolves a page fault inside the ELF image (demand paging and copy-on-write)
+         *
+         * Pages whose content is a whole file page are mapped read-only from the PageCache and
+         * shared with every other process running the same file; a write to one of them in a
+         * writable segment replaces it with a private copy. Other pages (segment edges, bss)
+         * are private from the start.
+         *
+         * @param address Faulting virtual address
+         * @param write True if the access was a write
+         * @return False if the address is outside the image or the access is not allowed
+         */
+        bool handleImageFault(uint32_t address, bool write);
+
+        /**
+         * @brief Resolves a page fault in the process's own memory
+         *
+         * Entry point of every lazily backed region: today the ELF image (handleImageFault).
+         * A false return means the access is invalid and the process has to be terminated.
+         *
+         * @param address Faulting virtual address
+         * @param write True if the access was a write
+         * @return True if the page is now mapped and the access can be retried
+         */
+        bool handlePageFault(uint32_t address, bool write);
+
+        /**
+         * @brief Checks RLIMIT_AS before count more pages are mapped into the thread group
+         * @return True if the pages fit in the limit
+         */
+        [[nodiscard]] bool canAllocatePages(size_t count);
+
+        /**
+         * @brief Gets a resource limit of the thread group
+         * @param resource RLIMIT_CPU, RLIMIT_STACK, RLIMIT_NOFILE or RLIMIT_AS
+         */
+        [[nodiscard]] const rlimit& getResourceLimit(int resource) { return getThreadGroupLeader()->limits_.limits[resource]; }
+
+        /**
+         * @brief Sets a resource limit of the thread group (validated by the caller)
+         * @param resource RLIMIT_CPU, RLIMIT_STACK, RLIMIT_NOFILE or RLIMIT_AS
+         * @param limit Soft and hard limits
+         */
+        void setResourceLimit(int resource, const rlimit& limit);
+
+        /**
+         * @brief Copies the resource limits of the process that spawns this one
+         */
+        void inheritResourceLimits(Process& parent);
+
+        /**
+         * @brief Checks the CPU time of the thread group against RLIMIT_CPU
+         * @return True once the soft limit is used up
+         */
+        [[nodiscard]] bool hasExceededCpuLimit();
+
         /**
          * @brief Gets the execution mode of the process.
          * @return Execution mode
@@ -179,9 +336,14 @@ namespace PalmyraOS::kernel {
 
         /**
          * @brief Sets the state of the process.
-         * @param state New state of the process
+         * @param state New state of the process (Ready after Waiting starts the wait for the CPU, the run queue follows)
+         */
+        void setState(State state);
+
+        /**
+         * @brief Initial nice value of a priority (Medium is 0, VeryHigh -10, VeryLow 10)
          */
-        void setState(State state) { state_ = state; }
+        [[nodiscard]] static int32_t priorityToNice(Priority priority);
 
         /**
          * @brief Gets the Process ID.
@@ -189,6 +351,44 @@ namespace PalmyraOS::kernel {
          */
         [[nodiscard]] uint32_t getPid() const { return pid_; }
 
+        [[nodiscard]] Policy getPolicy() const { return policy_; }
+        [[nodiscard]] uint32_t getRealtimePriority() const { return realtimePriority_; }
+        [[nodiscard]] bool isRealtime() const { return policy_ != Policy::Normal; }
+        [[nodiscard]] int32_t getNice() const { return nice_; }
+
+        /**
+         * @brief Gets the leader of the thread group (the process itself unless it is a thread).
+         * @return Process owning the shared resources
+         */
+        [[nodiscard]] Process* getThreadGroupLeader() { return threadGroupLeader_ ? threadGroupLeader_ : this; }
+
+        /**
+         * @brief Gets the thread group ID (the PID seen by getpid()).
+         * @return PID of the thread group leader
+         */
+        [[nodiscard]] uint32_t getThreadGroupId() const { return threadGroupLeader_ ? threadGroupLeader_->pid_ : pid_; }
+
+        /**
+         * @brief Checks whether this entry is a thread of another process.
+         * @return true for threads created by clone()
+         */
+        [[nodiscard]] bool isThread() const { return threadGroupLeader_ != nullptr; }
+
+        /**
+         * @brief Gets the descriptor table shared by the thread group.
+         * @return Descriptor table of the thread group leader
+         */
+        [[nodiscard]] DescriptorTable& getDescriptorTable() { return getThreadGroupLeader()->descriptorTable_; }
+
+        /**
+         * @brief Gets the ring behind a standard stream of the thread group (used while fd 0-2 are not redirected).
+         * @return stdin_, stdout_ or stderr_ of the group leader, nullptr for other descriptors
+         */
+        [[nodiscard]] StreamBuffer* getStandardStream(int fd) {
+            Process* leader = getThreadGroupLeader();
+            return fd == 0 ? leader->stdin_ : fd == 1 ? leader->stdout_ : fd == 2 ? leader->stderr_ : nullptr;
+        }
+
         /**
          * @brief Gets the Process ID.
          * @return Process ID
@@ -292,14 +492,42 @@ namespace PalmyraOS::kernel {
         /**
          * @brief Builds auxiliary vector for ELF process initialization
          * @param elfHeader Pointer to loaded ELF header
-         * @param programHeaders Pointer to program headers array
+         * @param programHeadersAddress Address of the program headers in the process (AT_PHDR, 0 if not mapped)
          */
-        void buildAuxiliaryVectorForELF(const Elf32_Ehdr* elfHeader, const Elf32_Phdr* programHeaders);
+        void buildAuxiliaryVectorForELF(const Elf32_Ehdr* elfHeader, uint32_t programHeadersAddress);
 
         void captureCommandlineArguments(uint32_t argc, char* const* argv);
 
         void initializeProcessInVFS();
 
+        /**
+         * @brief Removes /proc/<pid> and its entries (before the slot is recycled)
+         */
+        void removeProcessFromVFS();
+
+        /**
+         * @brief Finds the image segment containing a virtual address
+         * @return nullptr if the address is not part of the image
+         */
+        [[nodiscard]] const ImageSegment* findImageSegment(uint32_t address) const;
+
+        /**
+         * @brief Maps a whole file page shared (read-only, referenced in sharedPages_)
+         * @param frame Frame returned by the PageCache (the reference moves to the process)
+         * @param page Page-aligned virtual address
+         */
+        void mapSharedPage(void* frame, uint32_t page);
+
+        /**
+         * @brief Maps the cached neighbours of a shared page that are not mapped yet (no I/O)
+         */
+        void mapAroundSharedPage(const ImageSegment& segment, uint32_t page);
+
+        /**
+         * @brief Allocates a private page of the image, filled from the file and zero-padded
+         */
+        bool mapPrivatePage(const ImageSegment& segment, uint32_t page);
+
 
     public:
         friend class TaskManager;
@@ -309,12 +537,20 @@ namespace PalmyraOS::kernel {
         State state_;                       ///< State of the process
         Mode mode_;                         ///< Execution mode of the process
         Priority priority_;                 ///< Priority of the process
+        Policy policy_{Policy::Normal};     ///< Scheduling class
+        uint32_t realtimePriority_{0};      ///< 1..99 for real-time policies, 0 otherwise
         interrupts::CPURegisters stack_{};  ///< CPU context stack
         int exitCode_{-1};                  ///< Return value of the process
         KVector<void*> physicalPages_;      ///< Holds physical pages to used by the process
-        KVector<char> stdin_;               ///< proc/self/fd/0
-        KVector<char> stdout_;              ///< proc/self/fd/1
-        KVector<char> stderr_;              ///< proc/self/fd/2
+        StreamBuffer* stdin_{nullptr};      ///< proc/self/fd/0
+        StreamBuffer* stdout_{nullptr};     ///< proc/self/fd/1
+        StreamBuffer* stderr_{nullptr};     ///< proc/self/fd/2
+
+        /// Fair class (see RunQueue): the process with the smallest vruntime_ runs next
+        int32_t nice_{0};                               ///< -20..19, selects the weight (RunQueue::weightOf)
+        uint64_t vruntime_{0};                          ///< CPU cycles scaled by NICE_0_WEIGHT / weight
+        uint64_t sliceStartTsc_{0};                     ///< TSC when the process was last switched in
+        uint32_t runQueueIndex_{RunQueue::NOT_QUEUED};  ///< Position in the run queue (queued iff Ready)
 
         /// Command-line metadata (captured at process creation)
         KString commandName_;               ///< Program name (argv[0]), e.g., "terminal.elf"
@@ -333,14 +569,45 @@ namespace PalmyraOS::kernel {
         KVector<uint32_t> windows_;        ///< List of windows allocated
         DescriptorTable descriptorTable_;  ///< Descriptor table for all I/O operations (files, pipes, sockets)
         ProcessDebug debug_;
+        ProfileSamples* profileSamples_{nullptr};  ///< EIPs sampled by the Profiler (/proc/<pid>/profile)
 
         uint64_t upTime_{0};
-        uint64_t cpuTimeTicks_{0};
+        SchedStats schedStats_;  ///< Precise CPU time and scheduling latency (/proc/<pid>/sched)
         uint64_t startTime_{0};
 
+        /// ELF image, mapped on demand (see handleImageFault)
+        vfs::InodeBase* image_{nullptr};       ///< Executable file (nullptr for builtins)
+        KVector<ImageSegment> imageSegments_;  ///< PT_LOAD segments
+        KVector<void*> sharedPages_;           ///< PageCache frames mapped by the process (not in physicalPages_)
+
         uint32_t initial_brk = 0;
         uint32_t current_brk = 0;
         uint32_t max_brk     = 0;
+
+        KMap<uint32_t, uint32_t> mappings_;  ///< mmap regions: start address -> pages (munmap)
+
+        ResourceLimits limits_;  ///< setrlimit (leader only)
+        uint64_t cpuCycles_{0};  ///< CPU time of the whole thread group (leader only, RLIMIT_CPU)
+
+        /// Threads (clone): resources above are owned by the leader, threads only own their kernel stack
+        Process* threadGroupLeader_{nullptr};  ///< Leader of the thread group (nullptr for the leader itself)
+        uint32_t threadCount_{0};              ///< Number of live threads in the group (leader only)
+        uint32_t* clearChildTid_{nullptr};     ///< CLONE_CHILD_CLEARTID: zeroed when the thread exits
+        ThreadLocalStorage tls_{};             ///< TLS segment of this thread
+
+        FPU::Context fpu_{};  ///< x87/SSE save area (lazily allocated, see FPU)
+
+        /// Sleeping on a kernel lock (see Locks.h) or in poll() (see Poll.h)
+        WaitQueue* waitQueue_{nullptr};  ///< Queue the process sleeps in (nullptr if none)
+        Process* waitNext_{nullptr};     ///< Next sleeper in that queue
+        PollTable* pollTable_{nullptr};  ///< Watchers of the poll() the process sleeps in (nullptr if none)
+        uint64_t wakeupTick_{0};         ///< End of a timed sleep (0 if none, see TaskManager::setWakeupTick)
+        uint32_t futexKey_{0};           ///< Physical address of the futex word slept on (0 if none or woken, see Futex)
+        Pipe* pipe_{nullptr};            ///< Pipe whose read()/write() the process is inside (nullptr if none, see Pipe::leave)
+
+        /// User memory the kernel is about to touch on behalf of a system call: a fault in [start, end) fails it with -EFAULT
+        uint32_t userCopyStart_{0};  ///< First address of the window
+        uint32_t userCopyEnd_{0};    ///< End of the window (equal to the start: no window open)
     };
 
 
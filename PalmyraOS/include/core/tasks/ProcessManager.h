@@ -12,13 +12,24 @@ namespace PalmyraOS::kernel {
     /**
      * @class TaskManager
      * @brief Class for managing tasks (processes) in the operating system.
+     *
+     * The process table is a generational slot map: a slot holds one Process for its whole life
+     * (pointers stay valid), reaped slots are recycled through a free list, and a PID encodes
+     * its slot and the slot's generation (pid = generation * capacity + slot), so that
+     * getProcess() is O(1) and never returns a newer process for a stale PID.
      */
     class TaskManager {
     public:
         /**
          * @brief Initializes the TaskManager.
+         * @param capacity Number of slots in the process table (processes and threads)
          */
-        static void initialize();
+        static void initialize(uint32_t capacity = MAX_PROCESSES);
+
+        /**
+         * @brief Number of slots in the process table
+         */
+        [[nodiscard]] static uint32_t getCapacity();
 
         /**
          * @brief Executes a builtin (internal) executable as a new process
@@ -34,7 +45,11 @@ namespace PalmyraOS::kernel {
 
         /**
          * @brief Loads and executes an ELF binary as a new process
-         * @param elfFileContent ELF file data
+         *
+         * Only the headers are read here. The PT_LOAD segments are mapped on first access
+         * (Process::handleImageFault), sharing the file pages of other instances.
+         *
+         * @param image ELF file
          * @param mode Execution mode
          * @param priority Process priority
          * @param argc Argument count
@@ -42,7 +57,104 @@ namespace PalmyraOS::kernel {
          * @param envp Environment variables
          * @return Pointer to the created process
          */
-        static Process* execv_elf(KVector<uint8_t>& elfFileContent, Process::Mode mode, Process::Priority priority, uint32_t argc, char* const* argv, char* const* envp);
+        static Process* execv_elf(vfs::InodeBase* image, Process::Mode mode, Process::Priority priority, uint32_t argc, char* const* argv, char* const* envp);
+
+        /**
+         * @brief Creates a thread sharing the address space and resources of a process
+         * @param leader Thread group leader
+         * @param context CPU state the thread resumes from (the clone() caller's registers)
+         * @param userStackPointer Top of the thread's user stack
+         * @return Pointer to the created thread, or nullptr if the process table is full
+         */
+        static Process* newThread(Process* leader, const interrupts::CPURegisters& context, uint32_t userStackPointer);
+
+        /**
+         * @brief Terminates every live thread of a thread group (the leader is left untouched)
+         * @param leader Thread group leader
+         * @param exitCode Exit code for the threads
+         */
+        static void terminateThreadGroup(Process* leader, int exitCode);
+
+        /**
+         * @brief Hands a terminated process to the reaper (safe from interrupt and syscall context)
+         * @param process Process that just became Terminated
+         */
+        static void queueForReaping(Process* process);
+
+        /**
+         * @brief Reaper thread: releases terminated processes with interrupts enabled
+         *
+         * Runs as a kernel-mode process and sleeps (Waiting) while the queue is empty.
+         * Leaders with live threads are deferred until the threads are reaped;
+         * reaped slots are recycled by later process creation.
+         */
+        static int reaper(uint32_t argc, char** argv);
+
+        /**
+         * @brief Changes the scheduling class of a process (sched_setscheduler)
+         * @param process Target process or thread
+         * @param policy New scheduling class
+         * @param realtimePriority 1..99 for FIFO/RoundRobin, 0 for Normal
+         * @return False if the priority does not fit the policy
+         */
+        static bool setScheduler(Process* process, Process::Policy policy, uint32_t realtimePriority);
+
+        /**
+         * @brief Changes the nice value of a process (setpriority), clamped to -20..19
+         * @param process Target process or thread (the fair class uses it, real-time processes keep it for later)
+         */
+        static void setNice(Process* process, int32_t nice);
+
+        /**
+         * @brief Keeps the fair run queue in step with a state change (called by Process::setState)
+         *
+         * A fair process is queued exactly while it is Ready. A woken sleeper is placed at most half
+         * a scheduling latency behind the queue, a new process at the queue's minimum virtual runtime.
+         * @param process Process whose state just changed
+         * @param previous State before the change
+         */
+        static void updateRunQueue(Process* process, Process::State previous);
+
+        /**
+         * @brief Makes a Waiting process ready at a SystemClock tick unless something wakes it earlier (timeouts)
+         * @param process Process about to sleep (or that just woke up)
+         * @param deadlineTick Tick to wake up at, 0 to cancel
+         */
+        static void setWakeupTick(Process* process, uint64_t deadlineTick);
+
+        /**
+         * @brief Charges the CPU time so far to the current process and counts the time until exitSystemCall() as kernel time
+         */
+        static void enterSystemCall();
+
+        /**
+         * @brief Charges the time since enterSystemCall() to the kernel time of the current process
+         */
+        static void exitSystemCall();
+
+        /**
+         * @brief Checks whether a kernel fault at address hit the user-copy window of the current process (see Process::userCopyStart_)
+         *
+         * Only then may the fault end the system call with -EFAULT; outside of an atomic section, so that switching away is possible.
+         */
+        [[nodiscard]] static bool isInUserCopy(uint32_t address);
+
+        /**
+         * @brief Scheduling statistics up to now, including the running slice of the current process
+         * @param process Process to look at, nullptr for the whole system
+         */
+        [[nodiscard]] static SchedStats getSchedStats(const Process* process);
+
+        /**
+         * @brief Lists statistics as "name: value" lines in microseconds (/proc/<pid>/sched, /proc/schedstat)
+         * @return Bytes written (without the null terminator)
+         */
+        static size_t formatSchedStats(const SchedStats& stats, char* buffer, size_t size);
+
+        /**
+         * @brief Converts TSC cycles to microseconds
+         */
+        [[nodiscard]] static uint64_t cyclesToMicroseconds(uint64_t cycles);
 
         /**
          * @brief Gets the current running process.
@@ -51,9 +163,15 @@ namespace PalmyraOS::kernel {
         static Process* getCurrentProcess();
 
         /**
-         * @brief Gets a process by its PID.
+         * @brief Checks whether the scheduler has started running processes.
+         * @return False during early boot (getCurrentProcess() is not valid yet)
+         */
+        [[nodiscard]] static bool hasCurrentProcess() { return currentProcessIndex_ != INVALID_SLOT; }
+
+        /**
+         * @brief Gets a process by its PID in O(1).
          * @param pid Process ID
-         * @return Pointer to the process
+         * @return Pointer to the process, or nullptr if the PID is unknown or its slot was recycled
          */
         static Process* getProcess(uint32_t pid);
 
@@ -71,6 +189,62 @@ namespace PalmyraOS::kernel {
         static uint32_t* interruptHandler(interrupts::CPURegisters*);
 
     private:
+        /**
+         * @brief Picks the process to run next
+         *
+         * The highest-priority ready real-time process wins (equal priorities in round-robin order
+         * after the current slot), otherwise the fair process with the smallest virtual runtime.
+         * @param skip Slot to pass over unless nothing else is ready (a yielding process)
+         * @return Slot of the next process (the current slot if nothing is ready)
+         */
+        static uint32_t selectNextProcess(uint32_t skip);
+
+        /**
+         * @brief Checks for a ready real-time process at or above a priority (preemption test)
+         */
+        static bool isRealtimeReady(uint32_t minimumPriority);
+
+        /**
+         * @brief Checks whether the running fair process has used its share of the scheduling period
+         *
+         * Its ideal slice is the latency (stretched to min granularity per ready process) split by weight.
+         * It is preempted after that slice, or after the min granularity once it leads the queue by a slice.
+         */
+        static bool shouldPreemptFair(const Process& current, uint64_t now);
+
+        /**
+         * @brief Contents of /proc/sched_tunables ("name: value" lines), writes take "name value"
+         */
+        static size_t readSchedTunables(char* buffer, size_t size, size_t offset);
+        static size_t writeSchedTunables(const char* buffer, size_t size, size_t offset);
+
+        /**
+         * @brief Makes Waiting processes whose wake-up tick has passed ready (called once nextWakeupTick_ is reached)
+         */
+        static void wakeTimedSleepers(uint64_t now);
+
+        /**
+         * @brief Charges the TSC cycles since the last accounting to the user or kernel time of a process
+         */
+        static void chargeCpuTime(Process& process, uint64_t now);
+
+        /**
+         * @brief Accounts a context switch: CPU time and switch kind of the previous process, scheduling latency of the next
+         * @param previous Process giving up the CPU (nullptr for the first switch)
+         * @param voluntary The previous process slept, yielded or exited (otherwise it was preempted)
+         */
+        static void accountSwitch(Process* previous, Process& next, bool voluntary);
+
+        /**
+         * @brief Adds one wait for the CPU to the latency statistics
+         */
+        static void recordWait(SchedStats& stats, uint64_t cycles);
+
+        /**
+         * @brief Contents of /proc/schedstat
+         */
+        static size_t readSchedStat(char* buffer, size_t size, size_t offset);
+
         /**
          * @brief Internal process factory (used by execv_builtin and execv_elf)
          * @param entryPoint Entry point function (nullptr for ELF processes)
@@ -85,10 +259,42 @@ namespace PalmyraOS::kernel {
         static Process*
         newProcess(Process::ProcessEntry entryPoint, Process::Mode mode, Process::Priority priority, uint32_t argc, char* const* argv, char* const* envp, bool isInternal);
 
-        static KVector<Process> processes_;    ///< Vector of processes
-        static uint32_t currentProcessIndex_;  ///< Index of the current process
-        static uint32_t atomicSectionLevel_;   ///< Level of atomic section nesting
-        static uint32_t pid_count;             ///< Counter for assigning PIDs
+        /**
+         * @brief Constructs a process in a fresh slot, or in the oldest reaped slot once the table is full
+         *
+         * The PID (slot and generation) is passed as the second constructor argument.
+         * @return Pointer to the created process, or nullptr if no slot is available
+         */
+        template <typename First, typename... Rest>
+        static Process* emplaceProcess(First&& first, Rest&&... rest);
+
+        static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+        static KVector<Process> processes_;     ///< Slots (reserved to capacity_, so elements never move)
+        static KVector<uint32_t> generations_;  ///< Generation of each slot, bumped when the slot is recycled
+        static uint32_t capacity_;              ///< Number of slots
+        static uint32_t currentProcessIndex_;   ///< Slot of the current process
+        static uint32_t atomicSectionLevel_;    ///< Level of atomic section nesting
+
+        /// Reaper (rings of slots with capacity_ entries, a process is queued at most once)
+        static KVector<uint32_t> reapQueue_;  ///< Terminated processes awaiting kill()
+        static volatile uint32_t reapHead_;   ///< Next process to reap
+        static volatile uint32_t reapTail_;   ///< Next free entry
+        static KVector<uint32_t> freeSlots_;  ///< Reaped slots, oldest first
+        static uint32_t freeSlotsHead_;       ///< Next slot to recycle
+        static uint32_t freeSlotsTail_;       ///< Next free entry
+        static uint32_t reaperIndex_;         ///< Slot of the reaper thread (INVALID_SLOT if not running)
+
+        /// Timed sleeps (poll/epoll timeouts)
+        static uint64_t nextWakeupTick_;  ///< Earliest Process::wakeupTick_ (UINT64_MAX if none)
+
+        /// Accounting of every process since boot (/proc/schedstat)
+        static SchedStats systemStats_;
+
+        /// Fair class (SCHED_OTHER), tunable through /proc/sched_tunables
+        static RunQueue runQueue_;                    ///< Ready fair processes (the running one is not queued)
+        static uint32_t schedLatencyMicroseconds_;    ///< Period in which every ready fair process runs once
+        static uint32_t minGranularityMicroseconds_;  ///< Shortest slice before a fair process can be preempted
     };
 
 
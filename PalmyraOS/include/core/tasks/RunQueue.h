@@ -0,0 +1,67 @@
+
+#pragma once
+
+#include "core/definitions.h"
+#include "core/memory/KernelHeapAllocator.h"
+
+namespace PalmyraOS::kernel {
+
+    // Forward declarations
+    class Process;
+
+    /**
+     * @class RunQueue
+     * @brief Ready processes of the fair (SCHED_OTHER) class, as a binary min-heap ordered by virtual runtime
+     *
+     * Every process stores its position in the heap (Process::runQueueIndex_), so it can be
+     * removed in O(log n) when it stops being ready. The heap is reserved up front, so no
+     * operation allocates: all of them run with interrupts disabled, from the scheduler.
+     *
+     * The running process is not queued. minVruntime_ follows the smallest virtual runtime of
+     * the queue and the running process without ever going back; woken and new processes are
+     * placed relative to it, so a long sleep does not buy a long monopoly of the CPU.
+     */
+    class RunQueue {
+    public:
+        static constexpr uint32_t NOT_QUEUED    = 0xFFFFFFFF;  ///< Process::runQueueIndex_ of a process outside the queue
+        static constexpr uint32_t NICE_0_WEIGHT = 1024;        ///< Weight of nice 0: its virtual runtime advances with real time
+
+        RunQueue() = default;
+        REMOVE_COPY(RunQueue);
+
+        /// Allocates room for every slot of the process table
+        void reserve(uint32_t capacity);
+
+        void enqueue(Process* process);
+        void dequeue(Process* process);
+
+        /**
+         * @brief The process with the smallest virtual runtime
+         * @param skip Process to pass over (a yielding one), nullptr for none
+         * @return nullptr if no other process is queued
+         */
+        [[nodiscard]] Process* first(const Process* skip = nullptr) const;
+
+        /// Advances minVruntime_ towards the smallest of the queue and the running fair process (nullptr if none)
+        void updateMinVruntime(const Process* running);
+
+        [[nodiscard]] uint64_t getMinVruntime() const { return minVruntime_; }
+        [[nodiscard]] uint32_t getTotalWeight() const { return totalWeight_; }
+        [[nodiscard]] uint32_t size() const { return heap_.size(); }
+
+        /**
+         * @brief Load weight of a nice value (-20..19), each step about 10% of CPU share (Linux table)
+         */
+        [[nodiscard]] static uint32_t weightOf(int32_t nice);
+
+    private:
+        void siftUp(uint32_t index);
+        void siftDown(uint32_t index);
+        void place(uint32_t index, Process* process);
+
+        KVector<Process*> heap_;   ///< Min-heap on Process::vruntime_
+        uint32_t totalWeight_{0};  ///< Sum of the weights of the queued processes
+        uint64_t minVruntime_{0};  ///< Monotonic floor of the virtual runtimes
+    };
+
+}  // namespace PalmyraOS::kernel
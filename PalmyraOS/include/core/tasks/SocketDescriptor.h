@@ -93,6 +93,17 @@ namespace PalmyraOS::kernel {
          */
         int ioctl(int request, void* arg) override;
 
+        /**
+         * @brief Socket readiness
+         * @return POLLIN if a datagram is queued, POLLOUT always (datagrams never block on send)
+         */
+        [[nodiscard]] uint32_t poll() override;
+
+        /**
+         * @brief Watchers notified by the protocol socket when a datagram is queued
+         */
+        [[nodiscard]] PollSource* getPollSource() override;
+
         // ==================== Socket-Specific Operations ====================
 
         /**
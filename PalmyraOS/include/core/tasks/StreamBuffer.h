@@ -0,0 +1,77 @@
+
+#pragma once
+
+#include "core/Locks.h"
+#include "core/Poll.h"
+#include "core/definitions.h"
+#include "core/memory/PhysicalMemory.h"  // PAGE_SIZE
+#include "core/kernel.h"                 // SystemClockFrequency
+
+namespace PalmyraOS::kernel {
+
+    /**
+     * @class StreamBuffer
+     * @brief Bounded ring buffer behind the standard streams of a process (/proc/<pid>/stdin, stdout, stderr)
+     *
+     * Unlike a pipe, the writer of a stream does not know whether anybody reads it: most
+     * programs print to stdout while nobody listens. The ring therefore only holds a
+     * writer back while a reader follows the stream (it read within the last READER_TIMEOUT
+     * ticks); otherwise the oldest bytes are overwritten and counted as dropped, so output
+     * can never grow without bound or stall a process forever.
+     *
+     * Reads consume: a reader sleeps while the ring is empty and sees end of file (0) once
+     * the stream is closed and drained. The ring pages are only allocated on the first write.
+     */
+    class StreamBuffer {
+    public:
+        static constexpr uint32_t BUFFER_PAGES   = 2;                         ///< Size of the ring in pages
+        static constexpr uint32_t CAPACITY       = BUFFER_PAGES * PAGE_SIZE;  ///< Size of the ring in bytes
+        static constexpr uint32_t READER_TIMEOUT = SystemClockFrequency;      ///< Ticks a reader is considered to follow the stream
+
+        StreamBuffer() = default;
+        ~StreamBuffer();
+        REMOVE_COPY(StreamBuffer);
+
+        /**
+         * @brief Reads up to size bytes, sleeping while the stream is empty and open
+         * @return Bytes read, 0 at end of file, -EAGAIN if nonBlocking and empty
+         */
+        size_t read(char* buffer, size_t size, bool nonBlocking);
+
+        /**
+         * @brief Appends all bytes, sleeping while the ring is full and a reader follows
+         * @return size (bytes nobody waited for are dropped instead of failing), -EPIPE once closed
+         */
+        size_t write(const char* buffer, size_t size);
+
+        /**
+         * @brief No more data: wakes everybody, readers see end of file once the ring is drained
+         */
+        void close();
+
+        /**
+         * @brief Readiness: POLLIN with data, POLLOUT while a write would not sleep, POLLHUP once closed
+         */
+        [[nodiscard]] uint32_t poll() const;
+
+        [[nodiscard]] PollSource* getPollSource() { return &pollSource_; }
+
+        /// Bytes overwritten before anybody read them
+        [[nodiscard]] uint64_t getDropped() const { return dropped_; }
+
+    private:
+        /// A reader read or waited recently: writers wait for it instead of dropping data
+        [[nodiscard]] bool hasFollowingReader() const;
+
+        char* buffer_{nullptr};   ///< BUFFER_PAGES kernel pages (allocated by the first write)
+        uint32_t head_{0};        ///< Offset of the next byte to read
+        uint32_t count_{0};       ///< Bytes stored
+        bool closed_{false};      ///< The owner is gone: no more writes
+        uint64_t readerTick_{0};  ///< SystemClock tick of the last read (0: never read)
+        uint64_t dropped_{0};     ///< Bytes overwritten before being read
+        WaitQueue readWaiters_;   ///< Readers waiting for data
+        WaitQueue writeWaiters_;  ///< Writers waiting for a following reader to make space
+        PollSource pollSource_;   ///< poll() callers waiting on the stream
+    };
+
+}  // namespace PalmyraOS::kernel
@@ -3,6 +3,10 @@
 
 #include "core/Interrupts.h"
 #include "core/memory/KernelHeapAllocator.h"
+#include "core/tasks/Process.h"
+
+struct user_desc;
+struct io_uring_sqe;
 
 
 namespace PalmyraOS::kernel {
@@ -11,19 +15,68 @@ namespace PalmyraOS::kernel {
         using SystemCallHandler = void (*)(interrupts::CPURegisters* regs);
 
     public:
+        static constexpr uint32_t DENSE_TABLE_SIZE     = 512;         ///< Syscall numbers below this are dispatched by index
+        static constexpr uint32_t SPARSE_TABLE_SIZE    = 9;           ///< PalmyraOS-specific numbers (INT_*, posix_spawn)
+        static constexpr uint32_t MAX_POLL_DESCRIPTORS = 1024;        ///< Largest nfds accepted by poll()
+        static constexpr uint32_t SYSENTER_FRAME       = 0x53595345;  ///< Error code of frames built by sysenter_entry (interrupts.asm)
+
         static void initialize();
 
         static uint32_t* handleInterrupt(interrupts::CPURegisters* regs);
 
     private:
+        struct SystemCallEntry {
+            SystemCallHandler handler;
+            const char* name;
+        };
+
+        struct SparseEntry {
+            uint32_t number;
+            SystemCallEntry entry;
+        };
+
+        /// Dense dispatch table, built at compile time (unused numbers have a null handler)
+        struct DispatchTable {
+            SystemCallEntry dense[DENSE_TABLE_SIZE];
+            SparseEntry sparse[SPARSE_TABLE_SIZE];
+        };
+
+        /// Per-syscall statistics, dense numbers first, then the sparse entries
+        struct SystemCallStats {
+            uint64_t count;
+            uint64_t cycles;  ///< Cumulative TSC cycles spent in the handler
+        };
+
+        static const SystemCallEntry* lookup(uint32_t number, uint32_t& statsIndex);
+
+        /// Runs the handler of regs->eax and counts it in the statistics (false if the number is unknown)
+        static bool dispatch(interrupts::CPURegisters* regs);
+        static size_t readStatistics(char* buffer, size_t size, size_t offset);
+
         static bool isValidAddress(void* addr);
 
+        /// SYSENTER frames: pops the return address off the user stack (false if the stack is not user memory)
+        static bool loadSysenterReturn(interrupts::CPURegisters* regs);
+        static bool loadThreadArea(user_desc* userDescriptor, Process::ThreadLocalStorage& tls);
+
         /* POSIX Interrupts */
         static void handleExit(interrupts::CPURegisters* regs);
+        static void handleExitGroup(interrupts::CPURegisters* regs);
         static void handleGetPid(interrupts::CPURegisters* regs);
+        static void handleGetTid(interrupts::CPURegisters* regs);
+        static void handleClone(interrupts::CPURegisters* regs);
         static void handleYield(interrupts::CPURegisters* regs);
+        static void handleSchedSetScheduler(interrupts::CPURegisters* regs);
+        static void handleSchedGetScheduler(interrupts::CPURegisters* regs);
+        static void handleGetPriority(interrupts::CPURegisters* regs);
+        static void handleSetPriority(interrupts::CPURegisters* regs);
+        static void handleGetRlimit(interrupts::CPURegisters* regs);
+        static void handleSetRlimit(interrupts::CPURegisters* regs);
+        static void handleFutex(interrupts::CPURegisters* regs);
         static void handleMmap(interrupts::CPURegisters* regs);
+        static void handleMunmap(interrupts::CPURegisters* regs);
         static void handleGetTime(interrupts::CPURegisters* regs);
+        static void handleGetTimePage(interrupts::CPURegisters* regs);
         static void handleClockNanoSleep64(interrupts::CPURegisters* regs);
 
         static void handleOpen(interrupts::CPURegisters* regs);
@@ -46,6 +99,7 @@ namespace PalmyraOS::kernel {
         static void handleNextKeyboardEvent(interrupts::CPURegisters* regs);
         static void handleNextMouseEvent(interrupts::CPURegisters* regs);
         static void handleGetWindowStatus(interrupts::CPURegisters* regs);
+        static void handleWaitWindowEvents(interrupts::CPURegisters* regs);
 
         static void handleWaitPID(interrupts::CPURegisters* regs);
 
@@ -62,7 +116,25 @@ namespace PalmyraOS::kernel {
         static void handleGetsockname(interrupts::CPURegisters* regs);
         static void handleGetpeername(interrupts::CPURegisters* regs);
         static void handleShutdown(interrupts::CPURegisters* regs);
+
+        /* I/O multiplexing */
+        static void handlePoll(interrupts::CPURegisters* regs);
+        static void handleEpollCreate(interrupts::CPURegisters* regs);
+        static void handleEpollCreate1(interrupts::CPURegisters* regs);
+        static void handleEpollCtl(interrupts::CPURegisters* regs);
+        static void handleEpollWait(interrupts::CPURegisters* regs);
+
+        /* Pipes */
+        static void handlePipe(interrupts::CPURegisters* regs);
+        static void handlePipe2(interrupts::CPURegisters* regs);
+
+        /* Batched system calls */
+        static void handleIoUringSetup(interrupts::CPURegisters* regs);
+        static void handleIoUringEnter(interrupts::CPURegisters* regs);
+        static int32_t runRingEntry(const io_uring_sqe& entry, int32_t openedFd);
+
         static void handleSpawn(interrupts::CPURegisters* regs);
+        static void handleGetLocalPage(interrupts::CPURegisters* regs);
 
         static void handleBrk(interrupts::CPURegisters* regs);
         static void handleSetThreadArea(interrupts::CPURegisters* regs);
@@ -74,7 +146,8 @@ namespace PalmyraOS::kernel {
 
         static void handleReboot(interrupts::CPURegisters* regs);
 
-        static KMap<uint32_t, SystemCallHandler> systemCallHandlers_;
+        static const DispatchTable dispatchTable_;
+        static SystemCallStats stats_[DENSE_TABLE_SIZE + SPARSE_TABLE_SIZE];
     };
 
 
@@ -2,11 +2,14 @@
 
 #pragma once
 
+#include "core/Locks.h"
 #include "core/definitions.h"
 #include "core/memory/KernelHeapAllocator.h"
 
 #include "palmyraOS/input.h"
 
+struct palmyra_window_status;  // palmyraOS/unistd.h
+
 
 namespace PalmyraOS::kernel {
 
@@ -31,8 +34,9 @@ namespace PalmyraOS::kernel {
          * @param y The y-coordinate of the window.
          * @param width The width of the window.
          * @param height The height of the window.
+         * @param events Event rings shared with the owning process (nullptr: events are dropped).
          */
-        explicit Window(uint32_t* buffer, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+        explicit Window(uint32_t* buffer, uint32_t x, uint32_t y, uint32_t width, uint32_t height, WindowEvents* events);
 
         [[nodiscard]] inline uint32_t getID() const { return id_; }
 
@@ -43,6 +47,12 @@ namespace PalmyraOS::kernel {
 
         MouseEvent popMouseEvent();
 
+        /**
+         * @brief Refreshes the shared position, focus and cursor and, if events were queued since the
+         *        last call, advances the sequence word and wakes the threads sleeping in waitWindowEvents.
+         */
+        void publishEvents(int mouseX, int mouseY, bool isLeftDown, bool isActive);
+
         void setPosition(uint32_t x, uint32_t y);
         std::pair<uint32_t, uint32_t> getPosition();
         std::pair<uint32_t, uint32_t> getSize();
@@ -64,17 +74,28 @@ namespace PalmyraOS::kernel {
         bool visible_{true};  ///< Visibility status of the window.
         bool isMovable_{true};
 
-        KQueue<KeyboardEvent> keyboardsEvents_;
-        KQueue<MouseEvent> mouseEvents_;
+        WindowEvents* events_;  ///< Event rings in the pages of the owning process (cleared on close)
+        bool hasNewEvents_{false};
         friend class WindowManager;
     };
 
     /**
      * @class WindowManager
      * @brief Manages the creation, destruction, and compositing of windows in the PalmyraOS kernel.
+     *
+     * Locking: the window list, focus, dragging and the per-window event rings are protected by
+     * windowsLock_ (a Mutex, so a syscall racing the compositor sleeps instead of stopping the
+     * scheduler). Input drivers only push raw events under inputLock_; the compositor applies them.
+     * Methods below the public API section expect windowsLock_ to be held.
+     *
+     * Events reach processes through the WindowEvents rings of their windows; the compositor
+     * is the only producer and never blocks, so a process that stops reading only loses its
+     * own events.
      */
     class WindowManager {
     public:
+        static constexpr uint32_t REALTIME_PRIORITY = 50;  ///< SCHED_FIFO priority of the compositor thread
+
         /**
          * @brief Initializes the window manager.
          */
@@ -87,9 +108,11 @@ namespace PalmyraOS::kernel {
          * @param y The y-coordinate of the window.
          * @param width The width of the window.
          * @param height The height of the window.
-         * @return Pointer to the created Window object.
+         * @param movable Whether the window can be dragged with the mouse.
+         * @param events Event rings shared with the process (zeroed by the caller).
+         * @return ID of the created window (0 on failure).
          */
-        static Window* requestWindow(uint32_t* buffer, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+        static uint32_t requestWindow(uint32_t* buffer, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool movable, WindowEvents* events);
 
         /**
          * @brief Closes the window with the specified ID.
@@ -112,10 +135,26 @@ namespace PalmyraOS::kernel {
 
         static MouseEvent popMouseEvent(uint32_t id);
 
-        static void setActiveWindow(uint32_t id);
+        /**
+         * @brief Sleeps until a window of the current process has unread events.
+         * @param id The ID of the window.
+         * @param deadlineTick SystemClock tick to give up at (0: no deadline).
+         * @return 0 if events are available, -ETIMEDOUT, or -EINVAL if no window has this ID.
+         */
+        static int waitForEvents(uint32_t id, uint64_t deadlineTick);
+
+        /**
+         * @brief Reads the position, size and focus of a window.
+         * @param id The ID of the window.
+         * @param status Receives the window status.
+         * @return False if no window has this ID.
+         */
+        static bool getWindowStatus(uint32_t id, palmyra_window_status& status);
 
         static uint32_t getActiveWindowId();
 
+        static void setActiveWindow(uint32_t id);
+
         static void composeWindow(FrameBuffer& buffer, const Window& window);
 
         static void renderMouseCursor();
@@ -130,6 +169,8 @@ namespace PalmyraOS::kernel {
 
         static void forwardMouseEvents();
         static void forwardKeyboardEvents();
+        static void publishEvents();
+        static void cycleActiveWindow();
         static void updateMousePosition(const MouseEvent& event, int screenWidth, int screenHeight);
         static void updateMouseButtonState(const MouseEvent& event);
         static void startDragging();
@@ -162,6 +203,9 @@ namespace PalmyraOS::kernel {
         // Dragging state
         static DragState dragState_;
         static bool sortingNeeded_;
+
+        static Mutex windowsLock_;   ///< Protects the window list and everything reachable from it
+        static SpinLock inputLock_;  ///< Protects the raw input queues (filled by the input bottom halves)
     };
 
 
@@ -37,7 +37,9 @@
 #define EPIPE 32     /* Broken pipe */
 #define EDOM 33      /* Math argument out of domain of func */
 #define ERANGE 34    /* Math result not representable */
+#define ENOSYS 38    /* Function not implemented */
 #define ENOTEMPTY 39 /* Directory not empty */
+#define ECANCELED 125 /* Operation canceled */
 
 /* Socket-specific error codes (POSIX-compatible) */
 #define EMSGSIZE 90      /* Message too long */
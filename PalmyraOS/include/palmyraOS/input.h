@@ -21,4 +21,77 @@ struct MouseEvent {
     bool isRightDown  = false;
     bool isMiddleDown = false;
     bool isEvent      = false;  // if event, it was queued, if false, only position and left key are valid.
-};
\ No newline at end of file
+};
+
+/*
+ * Shared event rings of a window
+ *
+ * initializeWindow() places a WindowEvents block in pages shared by the process and the
+ * compositor. Each ring has a single producer (the compositor, which advances tail); events
+ * are consumed by the process directly and by the next_key_event/next_mouse_event system
+ * calls, which claim the head with a compare-and-swap. Neither side locks: a frame without
+ * input reads two counters and makes no system call.
+ *
+ * Counters only grow (wrapping at 2^32); a ring is full when tail - head == INPUT_RING_SIZE,
+ * and events arriving then are counted in dropped instead of overwriting unread ones.
+ * The position, focus and cursor fields are refreshed by the compositor every frame.
+ */
+
+#define INPUT_RING_SIZE 256  // Events per ring (a power of two)
+
+struct KeyboardEventRing {
+    uint32_t head;     // Next event to read (claimed by the consumers)
+    uint32_t tail;     // Next free slot (written by the compositor)
+    uint32_t dropped;  // Events lost to a full ring
+    uint32_t reserved;
+    KeyboardEvent events[INPUT_RING_SIZE];
+};
+
+struct MouseEventRing {
+    uint32_t head;     // Next event to read (claimed by the consumers)
+    uint32_t tail;     // Next free slot (written by the compositor)
+    uint32_t dropped;  // Events lost to a full ring
+    uint32_t reserved;
+    MouseEvent events[INPUT_RING_SIZE];
+};
+
+struct WindowEvents {
+    uint32_t sequence;  // Advanced after each batch of events (futex word of waitWindowEvents)
+    uint32_t isActive;  // The window has the keyboard focus
+    int32_t x;          // Window position on the screen
+    int32_t y;
+    MouseEvent cursor;  // Cursor position in window coordinates and left button
+    KeyboardEventRing keyboard;
+    MouseEventRing mouse;
+};
+
+// Producer side: false (and counted as dropped) if the ring is full
+template<typename Ring, typename Event>
+inline bool pushInputEvent(Ring& ring, const Event& event) {
+    uint32_t tail = ring.tail;
+    if (tail - __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE) >= INPUT_RING_SIZE) {
+        ring.dropped++;
+        return false;
+    }
+
+    ring.events[tail & (INPUT_RING_SIZE - 1)] = event;
+    __atomic_store_n(&ring.tail, tail + 1, __ATOMIC_RELEASE);  // Publish the event after writing it
+    return true;
+}
+
+// Consumer side: false if the ring is empty
+template<typename Ring, typename Event>
+inline bool popInputEvent(Ring& ring, Event& event) {
+    uint32_t head = __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE);
+    while (head != __atomic_load_n(&ring.tail, __ATOMIC_ACQUIRE)) {
+        // Copy first, then claim: if another consumer took the slot meanwhile, the copy is discarded and head reloaded
+        event = ring.events[head & (INPUT_RING_SIZE - 1)];
+        if (__atomic_compare_exchange_n(&ring.head, &head, head + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return true;
+    }
+    return false;
+}
+
+template<typename Ring>
+inline bool isInputRingEmpty(const Ring& ring) {
+    return ring.head == __atomic_load_n(&ring.tail, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Submission/completion rings for batched system calls (simplified io_uring)
+ *
+ * io_uring_setup() places both rings in pages shared by the process and the kernel.
+ * The process fills submission entries and advances sq_tail; one io_uring_enter()
+ * runs them in order and appends one completion per entry (result and user_data).
+ * A batch of N operations costs one trap instead of N.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==================== Operations ====================
+
+#define IORING_OP_NOP 0       // Completes with 0
+#define IORING_OP_READ 1      // read(fd, addr, len)
+#define IORING_OP_WRITE 2     // write(fd, addr, len)
+#define IORING_OP_OPEN 3      // open(addr, len = flags)
+#define IORING_OP_CLOSE 4     // close(fd)
+#define IORING_OP_SENDTO 5    // sendto(fd, addr, len, arg = flags, addr2 = dest_addr, addr3 = addrlen)
+#define IORING_OP_RECVFROM 6  // recvfrom(fd, addr, len, arg = flags, addr2 = src_addr, addr3 = &addrlen)
+#define IORING_OP_GETDENTS 7  // getdents(fd, addr, len)
+
+// ==================== Entry Flags ====================
+
+// Use the descriptor returned by the latest IORING_OP_OPEN of the same io_uring_enter() call,
+// so open, read and close of one file fit in a single batch (-ECANCELED if that open failed)
+#define IOSQE_OPENED_FD (1u << 0)
+
+#define IORING_MAX_ENTRIES 256  // Largest submission ring (the completion ring is twice as large)
+
+#define IORING_ENTER_GETEVENTS (1u << 0)  // Accepted by io_uring_enter (operations always complete before it returns)
+
+// ==================== Structures ====================
+
+// Submission queue entry
+struct io_uring_sqe {
+    uint8_t opcode;      // IORING_OP_*
+    uint8_t flags;       // IOSQE_*
+    uint16_t reserved;   // Must be 0
+    int32_t fd;          // Descriptor (ignored with IOSQE_OPENED_FD)
+    uint32_t addr;       // Buffer or path
+    uint32_t len;        // Buffer length (open: flags)
+    uint32_t arg;        // sendto/recvfrom: flags
+    uint32_t addr2;      // sendto/recvfrom: socket address
+    uint32_t addr3;      // sendto: address length, recvfrom: pointer to the address length
+    uint32_t reserved2;  // Must be 0
+    uint64_t user_data;  // Returned as is in the completion
+};
+
+// Completion queue entry
+struct io_uring_cqe {
+    uint64_t user_data;  // From the submission entry
+    int32_t res;         // Result of the operation (negative error code on failure)
+    uint32_t flags;      // Reserved
+};
+
+// Shared ring header: head and tail indices run freely, the slot is index & (entries - 1)
+struct io_uring_rings {
+    volatile uint32_t sq_head;  // Written by the kernel: next submission to run
+    volatile uint32_t sq_tail;  // Written by the process: next submission slot to fill
+    volatile uint32_t cq_head;  // Written by the process: next completion to read
+    volatile uint32_t cq_tail;  // Written by the kernel: next completion slot to fill
+    uint32_t sq_entries;        // Submission slots (power of two)
+    uint32_t cq_entries;        // Completion slots (power of two)
+    uint32_t sqes_offset;       // Byte offset of the io_uring_sqe array from this header
+    uint32_t cqes_offset;       // Byte offset of the io_uring_cqe array from this header
+};
+
+struct io_uring_params {
+    uint32_t sq_entries;           // Output: submission slots (entries rounded up to a power of two)
+    uint32_t cq_entries;           // Output: completion slots
+    uint32_t flags;                // Must be 0 (no kernel polling thread)
+    struct io_uring_rings* rings;  // Output: shared rings (released with the process)
+};
+
+// ==================== Helpers ====================
+
+/**
+ * @brief Returns the next free submission entry (zeroed), or nullptr if the ring is full.
+ *
+ * The entry is handed to the kernel by io_uring_submit().
+ */
+struct io_uring_sqe* io_uring_get_sqe(struct io_uring_rings* rings);
+
+/**
+ * @brief Runs the submission entries filled since the last call.
+ * @return Number of entries run, or negative error code
+ */
+int io_uring_submit(int ring_fd, struct io_uring_rings* rings);
+
+/**
+ * @brief Returns the oldest unread completion, or nullptr if there is none.
+ *
+ * Call io_uring_cqe_seen() once done with it.
+ */
+struct io_uring_cqe* io_uring_peek_cqe(struct io_uring_rings* rings);
+
+/**
+ * @brief Releases the completion returned by io_uring_peek_cqe().
+ */
+void io_uring_cqe_seen(struct io_uring_rings* rings);
+
+#ifdef __cplusplus
+}
+#endif
@@ -28,6 +28,18 @@ namespace PalmyraOS::SDK {
         [[nodiscard]] uint32_t* getFrontBuffer() const;
         [[nodiscard]] const char* getTitle() const;
 
+        /// Position and focus, read from the shared event block (no system call)
+        [[nodiscard]] palmyra_window_status getStatus() const;
+
+        /// Next queued keyboard event (isValid is false if there is none)
+        KeyboardEvent nextKeyboardEvent();
+
+        /// Next queued mouse event, or the current cursor with isEvent false if there is none
+        MouseEvent nextMouseEvent();
+
+        /// Sleeps until events are queued (0: do not sleep, negative: no limit); 0 if there are some, -ETIMEDOUT otherwise
+        int waitForEvents(int timeoutMs = -1);
+
     private:
         palmyra_window window_info_{};
         uint32_t window_id_{0};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+/* POSIX-compatible poll and Linux-compatible epoll structures and constants */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==================== poll() Events ====================
+
+#define POLLIN 0x001    // Data to read
+#define POLLPRI 0x002   // Urgent data to read
+#define POLLOUT 0x004   // Writing will not block
+#define POLLERR 0x008   // Error condition (always reported)
+#define POLLHUP 0x010   // Peer closed (always reported)
+#define POLLNVAL 0x020  // fd is not open (always reported)
+
+struct pollfd {
+    int32_t fd;       // Descriptor to watch (negative: ignored)
+    int16_t events;   // Requested events
+    int16_t revents;  // Returned events
+};
+
+typedef uint32_t nfds_t;
+
+// ==================== epoll ====================
+
+#define EPOLLIN POLLIN
+#define EPOLLPRI POLLPRI
+#define EPOLLOUT POLLOUT
+#define EPOLLERR POLLERR
+#define EPOLLHUP POLLHUP
+#define EPOLLONESHOT (1u << 30)  // Disable the entry after one event (re-arm with EPOLL_CTL_MOD)
+#define EPOLLET (1u << 31)       // Edge-triggered: report only when readiness changes
+
+#define EPOLL_CTL_ADD 1  // Register a descriptor
+#define EPOLL_CTL_DEL 2  // Remove a descriptor
+#define EPOLL_CTL_MOD 3  // Change the events or data of a registered descriptor
+
+#define EPOLL_CLOEXEC 0x80000  // Accepted by epoll_create1 (there is no exec() to close on)
+
+typedef union epoll_data {
+    void* ptr;
+    int32_t fd;
+    uint32_t u32;
+    uint64_t u64;
+} epoll_data_t;
+
+// Packed like on Linux i386 (12 bytes)
+struct __attribute__((packed)) epoll_event {
+    uint32_t events;    // EPOLL* flags
+    epoll_data_t data;  // Returned as is by epoll_wait
+};
+
+#ifdef __cplusplus
+}
+#endif
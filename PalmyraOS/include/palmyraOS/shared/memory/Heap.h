@@ -99,6 +99,17 @@ namespace PalmyraOS::types {
 
         virtual void freePage(void* address)          = 0;
 
+        void* allocUnlocked(uint32_t size, bool page_align);
+        void freeUnlocked(void* p);
+
+    protected:
+        /**
+         * @brief Serialization hooks around alloc() and free() (no-ops for single-threaded heaps).
+         */
+        virtual void lock() {}
+        virtual void unlock() {}
+
+    private:
 
         DEFINE_DEFAULT_MOVE(HeapManagerBase);
         REMOVE_COPY(HeapManagerBase);
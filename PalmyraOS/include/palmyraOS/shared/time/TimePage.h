@@ -0,0 +1,73 @@
+
+#pragma once
+
+#include <cstdint>
+
+
+namespace PalmyraOS::types {
+
+    /**
+     * @brief Layout of the shared time page (vDSO-style, one read-only page mapped into every process)
+     *
+     * The timer interrupt is the only writer. Readers use the sequence counter as a seqlock:
+     * it is odd while an update is in progress and changes on every update, so a reader retries
+     * until it copied the fields between two identical even values.
+     *
+     * Monotonic time = nanoseconds + TSC cycles since tscBase scaled by tscMultiplier >> tscShift,
+     * clamped to one tick so that the value never passes the next tick's update.
+     */
+    struct TimePageData {
+        volatile uint32_t sequence;   ///< Seqlock counter (odd while the kernel is writing)
+        uint32_t nanosecondsPerTick;  ///< Length of the current timer period
+        uint64_t ticks;               ///< Timer ticks since the page was initialized
+        uint64_t nanoseconds;         ///< Monotonic time at the last tick
+        uint64_t tscBase;             ///< TSC value at the last tick
+        uint32_t tscMultiplier;       ///< ns = (cycles * tscMultiplier) >> tscShift (0 if the TSC is not calibrated)
+        uint32_t tscShift;            ///< See tscMultiplier
+        uint64_t realtimeOffset;      ///< Wall-clock time in ns since the epoch at nanoseconds == 0
+    };
+
+    /**
+     * @brief Reads a consistent snapshot of the time page
+     * @param page The shared time page
+     * @param realtimeOffset Receives the wall-clock offset (may be nullptr)
+     * @return Monotonic time in nanoseconds
+     */
+    inline uint64_t readTimePage(const TimePageData* page, uint64_t* realtimeOffset) {
+        uint64_t nanoseconds;
+        uint64_t offset;
+
+        while (true) {
+            uint32_t sequence = page->sequence;
+            if (sequence & 1) continue;
+            asm volatile("" ::: "memory");
+
+            nanoseconds                 = page->nanoseconds;
+            offset                      = page->realtimeOffset;
+            uint64_t tscBase            = page->tscBase;
+            uint32_t tscMultiplier      = page->tscMultiplier;
+            uint32_t tscShift           = page->tscShift;
+            uint32_t nanosecondsPerTick = page->nanosecondsPerTick;
+
+            uint32_t low, high;
+            asm volatile("rdtsc" : "=a"(low), "=d"(high));
+            uint64_t cycles = ((static_cast<uint64_t>(high) << 32) | low) - tscBase;
+
+            asm volatile("" ::: "memory");
+            if (page->sequence != sequence) continue;
+
+            // Interpolate inside the current tick (the clamps keep the product within 64 bits)
+            if (tscMultiplier && nanosecondsPerTick) {
+                if (cycles > 0xFFFFFFFF) cycles = 0xFFFFFFFF;
+                uint64_t elapsed = (cycles * tscMultiplier) >> tscShift;
+                if (elapsed >= nanosecondsPerTick) elapsed = nanosecondsPerTick - 1;
+                nanoseconds += elapsed;
+            }
+            break;
+        }
+
+        if (realtimeOffset) *realtimeOffset = offset;
+        return nanoseconds;
+    }
+
+}  // namespace PalmyraOS::types
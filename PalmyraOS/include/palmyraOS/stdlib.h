@@ -7,10 +7,21 @@
 #include "libs/stdlib.h"
 
 
+/**
+ * @brief Allocates size bytes (8-byte aligned, thread-safe).
+ *
+ * Small requests come from per-size-class free lists; requests above 32 KiB are mapped on their own.
+ */
 void* malloc(size_t size);
 
 void free(void* ptr);
 
-// TODO void* calloc(size_t num, size_t size);
+/**
+ * @brief Allocates zeroed memory for num elements of size bytes (nullptr if the product overflows).
+ */
+void* calloc(size_t num, size_t size);
 
-// TODO void* realloc(void* ptr, size_t size);
+/**
+ * @brief Resizes a block, in place while it fits the size class of the block.
+ */
+void* realloc(void* ptr, size_t size);
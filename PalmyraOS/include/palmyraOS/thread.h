@@ -0,0 +1,141 @@
+/*
+ * Part of the API of PalmyraOS
+ * Minimal pthread-like threads built on clone()
+ * */
+
+
+#pragma once
+
+#include <cstdint>
+
+#define THREAD_STACK_SIZE (64 * 1024)  // Default user stack of a thread (bytes)
+
+typedef int (*thread_entry_t)(void* arg);
+
+struct thread_t {
+    uint32_t tid;   // Thread ID (also valid for waitpid)
+    void* stack;    // Base of the thread's user stack
+    uint32_t size;  // Size of the thread's user stack
+};
+
+/**
+ * @brief Starts a new thread in the calling process.
+ *
+ * The thread shares the address space, file descriptors and windows of the process
+ * and runs entry(arg) on its own stack. Returning from entry exits the thread only.
+ *
+ * @param thread Receives the thread handle.
+ * @param entry Function executed by the thread; its return value is the exit code.
+ * @param arg Argument passed to entry.
+ * @param stackSize Size of the thread's user stack (0 for THREAD_STACK_SIZE).
+ * @return 0 on success, or a negative error code on failure.
+ */
+int thread_create(thread_t* thread, thread_entry_t entry, void* arg, uint32_t stackSize = 0);
+
+/**
+ * @brief Waits for a thread to finish and releases its stack.
+ *
+ * @param thread Handle returned by thread_create.
+ * @param exitCode Receives the value returned by the thread's entry (may be nullptr).
+ * @return 0 on success, or a negative error code on failure.
+ */
+int thread_join(const thread_t& thread, int* exitCode);
+
+/**
+ * @brief Terminates the calling thread (other threads keep running).
+ *
+ * @param exitCode Exit code reported to thread_join.
+ */
+[[noreturn]] void thread_exit(int exitCode);
+
+/**
+ * @brief Retrieves the thread ID of the calling thread.
+ */
+uint32_t thread_self();
+
+/*
+ * Synchronization built on futex(): the fast paths are single atomic operations in userspace,
+ * the kernel is only entered to sleep on contention and to wake sleepers. All of them work
+ * between threads, and between processes when placed in shared memory.
+ */
+
+#define THREAD_MUTEX_INITIALIZER {0}
+#define THREAD_COND_INITIALIZER {0}
+
+struct thread_mutex_t {
+    volatile uint32_t state;  // 0: unlocked, 1: locked, 2: locked and somebody may sleep on it
+};
+
+struct thread_cond_t {
+    volatile uint32_t sequence;  // Bumped by every signal, sleepers wait for it to change
+};
+
+struct thread_sem_t {
+    volatile uint32_t value;    // Available count
+    volatile uint32_t waiters;  // Threads about to sleep or sleeping (post only enters the kernel for them)
+};
+
+/**
+ * @brief Initializes a mutex as unlocked (same as THREAD_MUTEX_INITIALIZER).
+ */
+void thread_mutex_init(thread_mutex_t* mutex);
+
+/**
+ * @brief Locks a mutex, sleeping while another thread holds it. Not recursive.
+ */
+void thread_mutex_lock(thread_mutex_t* mutex);
+
+/**
+ * @brief Locks a mutex if it is free.
+ * @return 0 on success, or -EBUSY if it is held.
+ */
+int thread_mutex_trylock(thread_mutex_t* mutex);
+
+/**
+ * @brief Unlocks a mutex held by the calling thread, waking one sleeper if there may be any.
+ */
+void thread_mutex_unlock(thread_mutex_t* mutex);
+
+/**
+ * @brief Initializes a condition variable (same as THREAD_COND_INITIALIZER).
+ */
+void thread_cond_init(thread_cond_t* cond);
+
+/**
+ * @brief Unlocks the mutex, sleeps until the condition is signalled, then locks the mutex again.
+ *
+ * Wake-ups may be spurious: callers re-check their predicate in a loop.
+ */
+void thread_cond_wait(thread_cond_t* cond, thread_mutex_t* mutex);
+
+/**
+ * @brief Wakes one thread waiting on the condition.
+ */
+void thread_cond_signal(thread_cond_t* cond);
+
+/**
+ * @brief Wakes all threads waiting on the condition.
+ */
+void thread_cond_broadcast(thread_cond_t* cond);
+
+/**
+ * @brief Initializes a counting semaphore.
+ * @param value Initial count
+ */
+void thread_sem_init(thread_sem_t* sem, uint32_t value);
+
+/**
+ * @brief Takes one from the count, sleeping while it is zero.
+ */
+void thread_sem_wait(thread_sem_t* sem);
+
+/**
+ * @brief Takes one from the count if it is not zero.
+ * @return 0 on success, or -EAGAIN if the count is zero.
+ */
+int thread_sem_trywait(thread_sem_t* sem);
+
+/**
+ * @brief Adds one to the count, waking a sleeper if there is any.
+ */
+void thread_sem_post(thread_sem_t* sem);
@@ -37,12 +37,22 @@ struct rtc_time {
  *
  * This function fills in the given timespec structure with the current time of the specified clock.
  *
- * @param clk_id The clock ID. CLOCK_MONOTONIC is currently supported.
+ * CLOCK_MONOTONIC and CLOCK_REALTIME are read from the shared time page without a system call.
+ *
+ * @param clk_id The clock ID. CLOCK_MONOTONIC and CLOCK_REALTIME are supported.
  * @param tp Pointer to a timespec structure where the current time will be stored.
  * @return int Returns 0 on success, or a negative value on error.
  */
 int clock_gettime(uint32_t clk_id, timespec* tp);
 
+/**
+ * @brief Returns the wall-clock time in seconds since the epoch (CLOCK_REALTIME).
+ *
+ * @param tloc If not null, also receives the result.
+ * @return uint64_t Seconds since 1970-01-01, or (uint64_t) -1 on error.
+ */
+uint64_t time(uint64_t* tloc);
+
 /**
  * @brief Suspends the execution of the calling thread for a specified duration.
  *
@@ -29,9 +29,14 @@ typedef int32_t ssize_t;  // Signed size type for read/write return values
 #define INT_NEXT_KEY_EVENT 9502
 #define INT_NEXT_MOUSE_EVENT 9503
 #define INT_GET_WINDOW_STATUS 9504
+#define INT_WAIT_WINDOW_EVENTS 9505  // sleep until a window has input (or a timeout in milliseconds)
+
+// 955X Time
+#define INT_GET_TIME_PAGE 9550  // address of the shared read-only time page (0 if unavailable)
 
 // 96XX Processes
 #define POSIX_INT_POSIX_SPAWN 9600  // posix_spawn (in linux, it's not its own syscall)
+#define INT_GET_LOCAL_PAGE 9601     // address of the zeroed page private to each process (0 if unavailable)
 
 
 /* POSIX Interrupts */
@@ -47,20 +52,40 @@ typedef int32_t ssize_t;  // Signed size type for read/write return values
 #define POSIX_INT_GET_PID 20
 #define POSIX_INT_MKDIR 39
 #define POSIX_INT_RMDIR 40
+#define POSIX_INT_PIPE 42
 #define POSIX_INT_BRK 45
 #define POSIX_INT_IOCTL 54
+#define POSIX_INT_SETRLIMIT 75
 #define POSIX_INT_REBOOT 88  // Linux compatible reboot syscall
 #define POSIX_INT_MMAP 90
+#define POSIX_INT_MUNMAP 91
+#define POSIX_INT_GETPRIORITY 96
+#define POSIX_INT_SETPRIORITY 97
+#define POSIX_INT_CLONE 120  // threads only (CLONE_VM | CLONE_THREAD)
+#define POSIX_INT_SCHED_SETSCHEDULER 156
+#define POSIX_INT_SCHED_GETSCHEDULER 157
 #define POSIX_INT_YIELD 158
+#define POSIX_INT_POLL 168
+#define POSIX_INT_GETRLIMIT 191  // ugetrlimit
 #define POSIX_INT_GETUID 199
 #define POSIX_INT_GETGID 200
 #define POSIX_INT_GETEUID32 201
 #define POSIX_INT_GETEGID32 202
+#define POSIX_INT_GETTID 224
 
 #define POSIX_INT_GETTIME 228  // time.h (in linux, dependent on version)
+#define POSIX_INT_FUTEX 240
 #define POSIX_INT_SETTHREADAREA 243
+#define POSIX_INT_EXIT_GROUP 252
+#define POSIX_INT_EPOLL_CREATE 254
+#define POSIX_INT_EPOLL_CTL 255
+#define POSIX_INT_EPOLL_WAIT 256
 #define POSIX_INT_CLOCK_NANOSLEEP_32 267  // NOT SUPPORTED
+#define POSIX_INT_EPOLL_CREATE1 329
+#define POSIX_INT_PIPE2 331
 #define POSIX_INT_CLOCK_NANOSLEEP_64 407
+#define POSIX_INT_IO_URING_SETUP 425
+#define POSIX_INT_IO_URING_ENTER 426
 
 /* From Linux */
 #define LINUX_INT_GETDENTS 141
@@ -132,6 +157,13 @@ typedef int32_t ssize_t;  // Signed size type for read/write return values
 /* File positioning flags */
 #define O_APPEND 0x400  // All write operations append to the end of the file, regardless of lseek() calls (TODO)
 
+/* Status flags (pipe2) */
+#define O_NONBLOCK 0x800   // Return -EAGAIN instead of sleeping when no data or space is available
+#define O_CLOEXEC 0x80000  // Accepted for compatibility (there is no exec() to close on)
+
+/* Pipes */
+#define PIPE_BUF 4096  // Writes of at most this many bytes to a pipe are never interleaved with other writes
+
 /* Constants for Arch Prctl */
 // https://github.com/torvalds/linux/blob/master/arch/x86/include/uapi/asm/prctl.h
 #define ARCH_SET_GS 0x1001
@@ -139,6 +171,65 @@ typedef int32_t ssize_t;  // Signed size type for read/write return values
 #define ARCH_GET_FS 0x1003  // Get FS segment base
 #define ARCH_GET_GS 0x1004
 
+/* Constants for clone (Linux compatible) */
+#define CLONE_VM 0x00000100              // Share the address space
+#define CLONE_FS 0x00000200              // Share filesystem information
+#define CLONE_FILES 0x00000400           // Share the descriptor table
+#define CLONE_SIGHAND 0x00000800         // Share signal handlers
+#define CLONE_THREAD 0x00010000          // Same thread group (getpid() returns the leader's PID)
+#define CLONE_SYSVSEM 0x00040000         // Share System V semaphores
+#define CLONE_SETTLS 0x00080000          // Set the TLS segment from a user_desc
+#define CLONE_PARENT_SETTID 0x00100000   // Store the TID at ptid in the parent
+#define CLONE_CHILD_CLEARTID 0x00200000  // Clear ctid when the thread exits
+#define CLONE_CHILD_SETTID 0x01000000    // Store the TID at ctid in the child
+
+/* Scheduling policies for sched_setscheduler (Linux compatible) */
+#define SCHED_OTHER 0  // Time-shared (default)
+#define SCHED_FIFO 1   // Real-time, runs until it blocks, yields or is preempted by a higher priority
+#define SCHED_RR 2     // Real-time, round-robin among equal priorities
+
+struct sched_param {
+    int sched_priority;  // 1..99 for SCHED_FIFO/SCHED_RR, 0 for SCHED_OTHER
+};
+
+/* futex operations (Linux compatible) */
+#define FUTEX_WAIT 0            // Sleep while the word holds the expected value
+#define FUTEX_WAKE 1            // Wake up to val sleepers of the word
+#define FUTEX_PRIVATE_FLAG 128  // Accepted and ignored: words are always keyed by physical address
+
+/* Targets of getpriority/setpriority (only single processes are supported) */
+#define PRIO_PROCESS 0
+#define PRIO_MIN -20  // Largest share of the CPU
+#define PRIO_MAX 20   // Nice values are below this
+
+/* Resources of getrlimit/setrlimit (Linux numbering, only these are supported) */
+#define RLIMIT_CPU 0     // CPU time of the process in seconds
+#define RLIMIT_STACK 3   // Size of the main stack in bytes (it cannot exceed the stack allocated at creation)
+#define RLIMIT_NOFILE 7  // Open descriptors, standard streams included
+#define RLIMIT_AS 9      // Memory mapped by the process in bytes
+#define RLIMIT_NLIMITS 10
+#define RLIM_INFINITY 0xFFFFFFFF
+
+typedef uint32_t rlim_t;
+
+struct rlimit {
+    rlim_t rlim_cur;  // Soft limit: the one enforced
+    rlim_t rlim_max;  // Hard limit: ceiling for rlim_cur, can only be lowered
+};
+
+/* Thread-local storage descriptor for set_thread_area (Linux asm/ldt.h layout) */
+struct user_desc {
+    unsigned int entry_number;  // GDT entry, or -1 to let the kernel choose
+    unsigned int base_addr;
+    unsigned int limit;
+    unsigned int seg_32bit : 1;
+    unsigned int contents : 2;
+    unsigned int read_exec_only : 1;
+    unsigned int limit_in_pages : 1;
+    unsigned int seg_not_present : 1;
+    unsigned int useable : 1;
+};
+
 typedef uint32_t fd_t;
 
 
@@ -206,6 +297,25 @@ int32_t lseek(fd_t fd, int32_t offset, int whence);
  */
 void* mmap(void* addr, uint32_t length, int prot, int flags, int fd, uint32_t offset);
 
+/**
+ * @brief Unmaps a region returned by mmap.
+ *
+ * @param addr The start of the region, as returned by mmap.
+ * @param length The length given to mmap (regions are only unmapped as a whole).
+ * @return 0 on success, -EINVAL if the range is not exactly one mapping.
+ */
+int munmap(void* addr, uint32_t length);
+
+/**
+ * @brief Returns the process-local page.
+ *
+ * The page is zeroed at process creation and lies at the same address in every process, but each
+ * process has its own; the SDK keeps its per-process state there (e.g. the allocator of malloc).
+ *
+ * @return The address of the page, or nullptr for kernel-mode processes.
+ */
+void* getLocalPage();
+
 // PalmyraOS specific, returns id of the window
 struct palmyra_window {
     uint32_t x;
@@ -214,6 +324,7 @@ struct palmyra_window {
     uint32_t height;
     bool movable;
     char title[50];
+    WindowEvents* events;  // Set by initializeWindow: event rings shared with the compositor
 };
 
 struct palmyra_window_status {
@@ -239,6 +350,15 @@ MouseEvent nextMouseEvent(uint32_t windowID);
 
 palmyra_window_status getStatus(uint32_t windowID);
 
+/**
+ * @brief Sleeps until the window has unread events in its shared rings.
+ *
+ * @param windowID The ID of the window.
+ * @param timeoutMs Milliseconds to wait at most (0: do not sleep, negative: no limit).
+ * @return 0 if events are available, -ETIMEDOUT, or -EINVAL if the window is not owned by the process.
+ */
+int waitWindowEvents(uint32_t windowID, int timeoutMs);
+
 
 /**
  * @brief Yields the processor, allowing other threads to run.
@@ -250,6 +370,96 @@ palmyra_window_status getStatus(uint32_t windowID);
  */
 int sched_yield();
 
+/**
+ * @brief Sets the scheduling policy and real-time priority of a thread.
+ *
+ * Real-time threads (SCHED_FIFO, SCHED_RR) always run before SCHED_OTHER threads and preempt
+ * them within one timer tick. A real-time thread calling sched_yield() gives up the rest of the
+ * current tick to all other threads, including lower classes.
+ *
+ * @param pid Thread ID, or 0 for the calling thread
+ * @param policy SCHED_OTHER, SCHED_FIFO or SCHED_RR
+ * @param param Priority (1..99 for real-time policies, 0 for SCHED_OTHER)
+ * @return 0 on success, or a negative error code (-ESRCH, -EINVAL) on failure.
+ */
+int sched_setscheduler(uint32_t pid, int policy, const struct sched_param* param);
+
+/**
+ * @brief Gets the scheduling policy of a thread.
+ *
+ * @param pid Thread ID, or 0 for the calling thread
+ * @return The policy (SCHED_OTHER, SCHED_FIFO or SCHED_RR), or a negative error code on failure.
+ */
+int sched_getscheduler(uint32_t pid);
+
+/**
+ * @brief Sleeps on or wakes up the sleepers of a 32-bit word (fast userspace locks).
+ *
+ * FUTEX_WAIT sleeps only while *uaddr still equals val (checked atomically with going to sleep)
+ * and may return early, so callers re-check their condition in a loop. Words are matched by
+ * physical address: threads and processes sharing a mapping meet on the same word.
+ *
+ * @param uaddr 4-byte aligned word
+ * @param op FUTEX_WAIT or FUTEX_WAKE (optionally with FUTEX_PRIVATE_FLAG)
+ * @param val Expected value (FUTEX_WAIT) or maximum number of sleepers to wake (FUTEX_WAKE)
+ * @param timeout Relative timeout for FUTEX_WAIT, nullptr to sleep without one
+ * @return FUTEX_WAIT: 0 once woken, -EAGAIN if the word changed, -ETIMEDOUT. FUTEX_WAKE: number woken.
+ *         A negative error code (-EINVAL, -EFAULT, -ENOSYS) on failure.
+ */
+int futex(uint32_t* uaddr, int op, uint32_t val, const struct timespec* timeout);
+
+/**
+ * @brief Gets the nice value of a thread.
+ *
+ * SCHED_OTHER threads share the CPU in proportion to a weight set by their nice value:
+ * each step is worth about 10%, so a thread at nice 0 gets about 1.25 times the CPU of one at nice 1.
+ *
+ * @param which PRIO_PROCESS
+ * @param who Thread ID, or 0 for the calling thread
+ * @return The nice value (-20..19), or a negative error code minus 20 (below -20) on failure.
+ */
+int getpriority(int which, uint32_t who);
+
+/**
+ * @brief Sets the nice value of a thread (clamped to -20..19).
+ *
+ * @param which PRIO_PROCESS
+ * @param who Thread ID, or 0 for the calling thread
+ * @param prio New nice value
+ * @return 0 on success, or a negative error code (-ESRCH, -EINVAL) on failure.
+ */
+int setpriority(int which, uint32_t who, int prio);
+
+/**
+ * @brief Adds to the nice value of the calling thread.
+ *
+ * @param inc Increment (negative values raise the share of the CPU)
+ * @return The new nice value, or a value below -20 on failure (see getpriority).
+ */
+int nice(int inc);
+
+/**
+ * @brief Gets a resource limit of the calling process.
+ *
+ * @param resource RLIMIT_CPU, RLIMIT_STACK, RLIMIT_NOFILE or RLIMIT_AS
+ * @param rlim Receives the soft and hard limits (RLIM_INFINITY if unlimited)
+ * @return 0 on success, or a negative error code (-EINVAL, -EFAULT) on failure.
+ */
+int getrlimit(int resource, struct rlimit* rlim);
+
+/**
+ * @brief Sets a resource limit of the calling process (inherited by the processes it spawns).
+ *
+ * Allocations beyond RLIMIT_AS fail (mmap, brk, faults in the image terminate the process),
+ * descriptors beyond RLIMIT_NOFILE fail with -EMFILE, and a process is terminated with
+ * EXIT_CPU_LIMIT past RLIMIT_CPU or EXIT_PAGE_FAULT when its stack grows past RLIMIT_STACK.
+ *
+ * @param resource RLIMIT_CPU, RLIMIT_STACK, RLIMIT_NOFILE or RLIMIT_AS
+ * @param rlim New limits: rlim_cur may not exceed rlim_max
+ * @return 0 on success, or a negative error code (-EINVAL, -EPERM when raising the hard limit, -EFAULT) on failure.
+ */
+int setrlimit(int resource, const struct rlimit* rlim);
+
 /**
  * @brief Opens a file or device.
  *
@@ -295,30 +505,62 @@ struct linux_dirent {
 
 int getdents(unsigned int fd, linux_dirent* dirp, unsigned int count);
 
+#define SPAWN_MAX_FILE_ACTIONS 8  // dup2 actions per posix_spawn() call
+
+/**
+ * @brief Descriptors handed to a spawned process (simplified POSIX file actions).
+ *
+ * Only dup2 actions on pipe descriptors are supported: the child gets its own descriptor on the
+ * same end of the pipe, so pipelines (producer stdout -> consumer stdin) work without fork().
+ */
+typedef struct {
+    uint32_t count;  // Actions in use
+    struct {
+        int32_t fd;     // Descriptor of the caller (a pipe end)
+        int32_t newfd;  // Descriptor number in the child (0, 1, 2 redirect its standard streams)
+    } dup2[SPAWN_MAX_FILE_ACTIONS];
+} posix_spawn_file_actions_t;
+
+int posix_spawn_file_actions_init(posix_spawn_file_actions_t* actions);
+int posix_spawn_file_actions_destroy(posix_spawn_file_actions_t* actions);
+
+/**
+ * @brief Makes descriptor fd of the caller available as newfd in the spawned process.
+ * @return 0 on success, -EINVAL for negative descriptors, -ENOMEM if all actions are in use
+ */
+int posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t* actions, int fd, int newfd);
+
 /**
  * @brief Starts a new process by spawning the specified ELF file.
  *
  * This function is a simplified variant of the POSIX `posix_spawn` function.
- * It spawns a new process to execute the specified ELF file. The `file_actions`
- * and `attrp` parameters are provided for compatibility with the POSIX standard,
- * but they are not used or implemented in this version.
+ * It spawns a new process to execute the specified ELF file. The `attrp`
+ * parameter is provided for compatibility with the POSIX standard, but it is
+ * not used or implemented in this version.
  *
  * @param pid A pointer to a variable where the process ID of the new process will be stored.
  *            This will be of type `uint32_t` rather than the typical `pid_t` used in POSIX.
  * @param path The path to the ELF file to be executed.
- * @param file_actions Reserved for compatibility, but not used or implemented in this function.
+ * @param file_actions Pipe ends to install in the new process (nullptr for none).
  * @param attrp Reserved for compatibility, but not used or implemented in this function.
  * @param argv A null-terminated array of argument strings passed to the new program.
  * @param envp A null-terminated array of environment variables passed to the new program.
  * @return 0 on success, or a negative error code on failure.
  */
-int posix_spawn(uint32_t* pid, const char* path, void* file_actions, void* attrp, char* const argv[], char* const envp[]);
+int posix_spawn(uint32_t* pid, const char* path, const posix_spawn_file_actions_t* file_actions, void* attrp, char* const argv[], char* const envp[]);
+
+/// Exit status of a process terminated by an invalid memory access (128 + SIGSEGV, as shells report it)
+#define EXIT_PAGE_FAULT 139
+
+/// Exit status of a process terminated for exceeding RLIMIT_CPU (128 + SIGXCPU)
+#define EXIT_CPU_LIMIT 152
 
 /**
  * @brief Waits for a specific process to change state.
  *
  * @param pid The process ID of the child process to wait for.
- * @param status A pointer to an integer where the exit status of the child process will be stored.
+ * @param status A pointer to an integer where the exit status of the child process will be stored
+ *               (EXIT_PAGE_FAULT if it was terminated by an invalid memory access).
  * @param options Options for controlling the behavior of the wait.
  * @return The process ID of the child that changed state, or -1 if an error occurred.
  */
@@ -328,8 +570,46 @@ int arch_prctl(int code, unsigned long addr);
 
 int brk(void* end_data_segment);
 
+/**
+ * @brief Sets the thread-local storage segment of the calling thread.
+ *
+ * On success u_info->entry_number holds the GDT entry; load it into GS as (entry_number << 3) | 3.
+ *
+ * @param u_info TLS descriptor (entry_number -1 lets the kernel choose)
+ * @return 0 on success, or a negative error code on failure.
+ */
 int set_thread_area(struct user_desc* u_info);
 
+/**
+ * @brief Creates a thread in the calling process (Linux i386 argument order).
+ *
+ * Only thread creation is supported: flags must contain CLONE_VM | CLONE_THREAD.
+ * The new thread returns 0 from the syscall on child_stack; the caller receives the TID.
+ * Use thread_create() from palmyraOS/thread.h instead of calling this directly.
+ *
+ * @param flags CLONE_* flags
+ * @param child_stack Top of the new thread's stack
+ * @param ptid Receives the TID when CLONE_PARENT_SETTID is set
+ * @param tls TLS descriptor applied to the thread when CLONE_SETTLS is set
+ * @param ctid Receives the TID (CLONE_CHILD_SETTID) and is zeroed on exit (CLONE_CHILD_CLEARTID)
+ * @return TID of the new thread, or a negative error code on failure.
+ */
+int clone(uint32_t flags, void* child_stack, uint32_t* ptid, struct user_desc* tls, uint32_t* ctid);
+
+/**
+ * @brief Retrieves the thread identifier (TID) of the calling thread.
+ *
+ * @return The TID of the calling thread (equals get_pid() for the main thread).
+ */
+uint32_t gettid();
+
+/**
+ * @brief Terminates all threads of the calling process with the specified exit code.
+ *
+ * @param exitCode The exit code to be returned to the operating system.
+ */
+void exit_group(uint32_t exitCode);
+
 uint32_t getuid();
 uint32_t getgid();
 uint32_t geteuid32();
@@ -565,3 +845,113 @@ int accept(int sockfd, struct sockaddr* addr, uint32_t* addrlen);
  * @return 0 on success, or negative error code on failure
  */
 int shutdown(int sockfd, int how);
+
+// ==================== I/O Multiplexing (structures in palmyraOS/poll.h) ====================
+
+// Forward declarations
+struct pollfd;
+struct epoll_event;
+struct io_uring_params;
+
+/**
+ * @brief Waits until one of several descriptors is ready for I/O.
+ *
+ * Sockets and pipes wake the caller as soon as data or space arrives; regular files are always ready.
+ *
+ * @param fds Descriptors and requested events (POLLIN, POLLOUT); revents is filled in
+ * @param nfds Number of entries in fds
+ * @param timeout Milliseconds to wait at most, 0 to return at once, negative to wait forever
+ * @return Number of entries with non-zero revents (0 on timeout), or negative error code
+ */
+int poll(struct pollfd* fds, uint32_t nfds, int timeout);
+
+/**
+ * @brief Creates an epoll interest list.
+ *
+ * @param size Ignored, but must be positive (Linux compatibility)
+ * @return Descriptor of the interest list, or negative error code
+ */
+int epoll_create(int size);
+
+/**
+ * @brief Creates an epoll interest list.
+ *
+ * @param flags 0 or EPOLL_CLOEXEC
+ * @return Descriptor of the interest list, or negative error code
+ */
+int epoll_create1(int flags);
+
+/**
+ * @brief Adds, changes or removes a descriptor of an epoll interest list.
+ *
+ * Level-triggered by default: epoll_wait() reports a descriptor as long as it is ready.
+ * With EPOLLET it is reported once per change (new data), so the caller must drain it.
+ * Only descriptors whose readiness changes (sockets, pipes, epoll) can be added (-EPERM otherwise).
+ *
+ * @param epfd Interest list from epoll_create()
+ * @param op EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ * @param fd Descriptor to watch
+ * @param event Events (EPOLLIN, EPOLLOUT, EPOLLET, EPOLLONESHOT) and user data (ignored for DEL)
+ * @return 0 on success, or negative error code
+ */
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event* event);
+
+/**
+ * @brief Waits for events on an epoll interest list.
+ *
+ * @param epfd Interest list from epoll_create()
+ * @param events Output: ready descriptors (events and the data given to epoll_ctl)
+ * @param maxevents Capacity of events (must be positive)
+ * @param timeout Milliseconds to wait at most, 0 to return at once, negative to wait forever
+ * @return Number of events stored (0 on timeout), or negative error code
+ */
+int epoll_wait(int epfd, struct epoll_event* events, int maxevents, int timeout);
+
+// ==================== Pipes ====================
+
+/**
+ * @brief Creates a pipe: bytes written to pipefd[1] are read from pipefd[0].
+ *
+ * Reads sleep while the pipe is empty and return 0 once every write end is closed.
+ * Writes sleep while it is full and fail with -EPIPE once every read end is closed.
+ * Writes of at most PIPE_BUF bytes are never interleaved with other writes.
+ *
+ * @param pipefd Output: read end, then write end
+ * @return 0 on success, or negative error code
+ */
+int pipe(int pipefd[2]);
+
+/**
+ * @brief Creates a pipe with flags.
+ *
+ * @param pipefd Output: read end, then write end
+ * @param flags O_NONBLOCK (return -EAGAIN instead of sleeping) and/or O_CLOEXEC (ignored)
+ * @return 0 on success, or negative error code
+ */
+int pipe2(int pipefd[2], int flags);
+
+// ==================== Batched System Calls (structures in palmyraOS/io_uring.h) ====================
+
+/**
+ * @brief Creates submission and completion rings shared with the kernel.
+ *
+ * @param entries Submission slots (1 to IORING_MAX_ENTRIES, rounded up to a power of two)
+ * @param params Input: flags (must be 0); output: ring sizes and the address of the shared rings
+ * @return Descriptor of the rings, or negative error code
+ */
+int io_uring_setup(uint32_t entries, struct io_uring_params* params);
+
+/**
+ * @brief Runs pending submission entries in order, appending one completion each.
+ *
+ * Operations run synchronously, so their completions are ready when the call returns
+ * (min_complete is only accepted for compatibility). Stops early when the completion
+ * ring is full: read completions and call again.
+ *
+ * @param fd Descriptor from io_uring_setup()
+ * @param to_submit Maximum number of entries to run
+ * @param min_complete Ignored
+ * @param flags 0 or IORING_ENTER_GETEVENTS
+ * @return Number of entries run, or negative error code
+ */
+int io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags);
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+namespace PalmyraOS::Userland::tests::MallocBenchmark {
+    int main(uint32_t argc, char** argv);
+}
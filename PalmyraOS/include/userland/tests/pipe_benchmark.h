@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+namespace PalmyraOS::Userland::tests::PipeBenchmark {
+    int main(uint32_t argc, char** argv);
+}
@@ -21,4 +21,6 @@
 
 
 #include "userland/tests/events.h"
+#include "userland/tests/malloc_benchmark.h"
+#include "userland/tests/pipe_benchmark.h"
 #include "userland/tests/udp_echo_server.h"
\ No newline at end of file
@@ -0,0 +1,55 @@
+
+#include "core/DeferredWork.h"
+#include "core/Interrupts.h"
+
+
+// Globals
+PalmyraOS::kernel::DeferredWork::WorkItem PalmyraOS::kernel::DeferredWork::queue_[QUEUE_SIZE] = {};
+volatile uint32_t PalmyraOS::kernel::DeferredWork::head_                                    = 0;
+volatile uint32_t PalmyraOS::kernel::DeferredWork::tail_                                    = 0;
+volatile bool PalmyraOS::kernel::DeferredWork::running_                                     = false;
+uint64_t PalmyraOS::kernel::DeferredWork::scheduledCount_                                   = 0;
+uint64_t PalmyraOS::kernel::DeferredWork::executedCount_                                    = 0;
+uint64_t PalmyraOS::kernel::DeferredWork::droppedCount_                                     = 0;
+
+static_assert((PalmyraOS::kernel::DeferredWork::QUEUE_SIZE & (PalmyraOS::kernel::DeferredWork::QUEUE_SIZE - 1)) == 0, "QUEUE_SIZE must be a power of two");
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+bool PalmyraOS::kernel::DeferredWork::schedule(Function function, void* context, uint32_t argument) {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();  // called with and without IF
+
+    // Full: drop rather than block in interrupt context
+    if (tail_ - head_ >= QUEUE_SIZE) {
+        droppedCount_++;
+        InterruptController::restoreInterrupts(flags);
+        return false;
+    }
+
+    queue_[tail_ & (QUEUE_SIZE - 1)] = {function, context, argument};
+    tail_                            = tail_ + 1;
+    scheduledCount_++;
+
+    InterruptController::restoreInterrupts(flags);
+    return true;
+}
+
+void PalmyraOS::kernel::DeferredWork::runPending() {
+    // Called from primary_isr_handler with interrupts disabled
+    if (running_ || head_ == tail_) return;
+    running_ = true;
+
+    for (uint32_t executed = 0; executed < MAX_ITEMS_PER_PASS && head_ != tail_; ++executed) {
+        WorkItem item = queue_[head_ & (QUEUE_SIZE - 1)];
+        head_         = head_ + 1;
+
+        // Run the bottom half with interrupts enabled
+        asm volatile("sti" ::: "memory");
+        item.function(item.context, item.argument);
+        asm volatile("cli" ::: "memory");
+
+        executedCount_++;
+    }
+
+    running_ = false;
+}
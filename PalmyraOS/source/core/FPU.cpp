@@ -0,0 +1,124 @@
+
+#include "core/FPU.h"
+#include "core/kernel.h"
+#include "core/peripherals/Logger.h"
+#include "core/tasks/ProcessManager.h"
+
+#include "libs/memory.h"
+#include "palmyraOS/errono.h"
+
+
+// Globals
+PalmyraOS::kernel::FPU::State PalmyraOS::kernel::FPU::initialState_ = {};
+PalmyraOS::kernel::Process* PalmyraOS::kernel::FPU::owner_          = nullptr;
+uint64_t PalmyraOS::kernel::FPU::restoreCount_                      = 0;
+uint64_t PalmyraOS::kernel::FPU::saveCount_                         = 0;
+
+namespace {
+    constexpr uint32_t CR0_MP = 1 << 1;  // Monitor co-processor (WAIT honours TS)
+    constexpr uint32_t CR0_EM = 1 << 2;  // Emulation (must be clear for SSE)
+    constexpr uint32_t CR0_TS = 1 << 3;  // Task switched (next FPU instruction raises #NM)
+    constexpr uint32_t CR0_NE = 1 << 5;  // Native x87 error reporting
+
+    inline uint32_t readCR0() {
+        uint32_t value;
+        asm volatile("mov %%cr0, %0" : "=r"(value));
+        return value;
+    }
+
+    inline void writeCR0(uint32_t value) { asm volatile("mov %0, %%cr0" ::"r"(value) : "memory"); }
+
+    inline void setTaskSwitched() { writeCR0(readCR0() | CR0_TS); }
+
+    inline void clearTaskSwitched() { asm volatile("clts" ::: "memory"); }
+
+    inline void fxsave(PalmyraOS::kernel::FPU::State* state) { asm volatile("fxsave (%0)" ::"r"(state->fxsaveArea) : "memory"); }
+
+    inline void fxrstor(const PalmyraOS::kernel::FPU::State* state) { asm volatile("fxrstor (%0)" ::"r"(state->fxsaveArea) : "memory"); }
+}  // namespace
+
+void PalmyraOS::kernel::FPU::initialize() {
+    // Use the FPU natively and let WAIT/FWAIT fault on TS as well
+    writeCR0((readCR0() & ~(CR0_EM | CR0_TS)) | CR0_MP | CR0_NE);
+
+    // Capture a clean state: default x87 control word and MXCSR (all SIMD exceptions masked)
+    uint32_t mxcsr = 0x1F80;
+    asm volatile("fninit\n\t"
+                 "ldmxcsr %0" ::"m"(mxcsr)
+                 : "memory");
+    fxsave(&initialState_);
+
+    interrupts::InterruptController::setInterruptHandler(0x07, &handleDeviceNotAvailable);
+}
+
+void PalmyraOS::kernel::FPU::onContextSwitch(Process* next) {
+    // The owner's registers are still loaded: no need to fault
+    if (next == owner_) clearTaskSwitched();
+    else setTaskSwitched();
+}
+
+void PalmyraOS::kernel::FPU::releaseState(Process* process) {
+    uint32_t flags = interrupts::InterruptController::saveAndDisableInterrupts();
+
+    // The registers hold garbage now, the next user restores its own state
+    if (owner_ == process) owner_ = nullptr;
+
+    void* buffer         = process->fpu_.buffer;
+    process->fpu_.buffer = nullptr;
+    process->fpu_.state  = nullptr;
+
+    interrupts::InterruptController::restoreInterrupts(flags);
+
+    if (buffer) heapManager.free(buffer);
+}
+
+void PalmyraOS::kernel::FPU::beginKernelUse() {
+    clearTaskSwitched();
+    if (owner_ && owner_->fpu_.state) {
+        fxsave(owner_->fpu_.state);
+        saveCount_++;
+    }
+    owner_ = nullptr;
+}
+
+void PalmyraOS::kernel::FPU::endKernelUse() {
+    // Nobody owns the registers: force a restore on the next FPU instruction
+    setTaskSwitched();
+}
+
+uint32_t* PalmyraOS::kernel::FPU::handleDeviceNotAvailable(interrupts::CPURegisters* regs) {
+    clearTaskSwitched();
+
+    void* frame      = regs;
+    Process* current = TaskManager::getCurrentProcess();
+    if (owner_ == current) return static_cast<uint32_t*>(frame);
+
+    // Save the previous owner
+    if (owner_ && owner_->fpu_.state) {
+        fxsave(owner_->fpu_.state);
+        saveCount_++;
+    }
+    owner_ = nullptr;
+
+    // First FPU use of this process: allocate its save area and start from a clean state
+    if (!current->fpu_.state) {
+        void* buffer = heapManager.alloc(sizeof(State) + alignof(State));
+        if (!buffer) {
+            // Like a failed page fault: only the process that needed the memory goes
+            LOG_ERROR("FPU: Out of memory for the FPU state of PID %d, terminating it", current->getPid());
+            current->getThreadGroupLeader()->terminate(-ENOMEM);
+            current->terminate(-ENOMEM);
+            return TaskManager::interruptHandler(regs);
+        }
+
+        current->fpu_.buffer = buffer;
+        current->fpu_.state  = reinterpret_cast<State*>((reinterpret_cast<uint32_t>(buffer) + alignof(State) - 1) & ~(alignof(State) - 1));
+        memcpy(current->fpu_.state, &initialState_, sizeof(State));
+    }
+
+    fxrstor(current->fpu_.state);
+    owner_ = current;
+    restoreCount_++;
+
+    return static_cast<uint32_t*>(frame);
+}
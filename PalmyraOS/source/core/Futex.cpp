@@ -0,0 +1,67 @@
+
+#include "core/Futex.h"
+#include "core/Interrupts.h"
+#include "core/memory/paging.h"
+#include "core/tasks/ProcessManager.h"
+
+#include "palmyraOS/errono.h"
+
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+PalmyraOS::kernel::WaitQueue PalmyraOS::kernel::Futex::buckets_[BUCKETS];
+
+int PalmyraOS::kernel::Futex::wait(const uint32_t* address, uint32_t expected, uint64_t deadlineTick) {
+    uint32_t key = keyOf(address);
+    if (key == 0) return -EFAULT;
+
+    // The kernel directory is active: read the word at the physical address it is keyed by (aligned, so within one page)
+    auto* word     = reinterpret_cast<const volatile uint32_t*>(key);
+
+    // Uniprocessor: with interrupts disabled no waker can run between the check and the sleep
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+    if (*word != expected) {
+        InterruptController::restoreInterrupts(flags);
+        return -EAGAIN;
+    }
+
+    // wake() clears the key: still set after the sleep means the deadline passed
+    Process* current   = TaskManager::getCurrentProcess();
+    current->futexKey_ = key;
+    bucketOf(key).sleep(deadlineTick);
+    bool timedOut      = current->futexKey_ != 0;
+    current->futexKey_ = 0;
+
+    InterruptController::restoreInterrupts(flags);
+    return timedOut ? -ETIMEDOUT : 0;
+}
+
+int PalmyraOS::kernel::Futex::wake(const uint32_t* address, uint32_t count) {
+    uint32_t key = keyOf(address);
+    if (key == 0) return -EFAULT;
+
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+    uint32_t woken = bucketOf(key).wakeMatching(count, &claimSleeper, key);
+    InterruptController::restoreInterrupts(flags);
+
+    return static_cast<int>(woken);
+}
+
+uint32_t PalmyraOS::kernel::Futex::keyOf(const uint32_t* address) {
+    auto* directory = TaskManager::getCurrentProcess()->pagingDirectory_;
+    return reinterpret_cast<uint32_t>(directory->getPhysicalAddress(const_cast<uint32_t*>(address)));
+}
+
+PalmyraOS::kernel::WaitQueue& PalmyraOS::kernel::Futex::bucketOf(uint32_t key) {
+    // Words are 4-byte aligned: drop the low bits, then fold the page number into the index
+    uint32_t hash = (key >> 2) ^ (key >> 12);
+    return buckets_[hash & (BUCKETS - 1)];
+}
+
+bool PalmyraOS::kernel::Futex::claimSleeper(Process* process, uintptr_t key) {
+    if (process->futexKey_ != key) return false;
+
+    // A cleared key tells wait() that it was woken rather than timed out
+    process->futexKey_ = 0;
+    return true;
+}
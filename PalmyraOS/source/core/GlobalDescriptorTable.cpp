@@ -121,6 +121,19 @@ GlobalDescriptorTable::GlobalDescriptorTable(uint32_t InitialKernelStackPointer)
               .defaultOperand32 = true,               // 32-bit TSS
               .isLongMode       = false,
               .isAvailableSW    = false,
+      }),
+      // Thread-local storage segment: user data segment until a thread calls set_thread_area
+      thread_local_storage_descriptor(SegmentDescriptor::SegmentDescriptorInput{
+              .base             = 0,
+              .limitRaw         = 0xFFFFF,  // Full 4GB with granularity
+              .segmentKind      = SegmentKind::CodeData,
+              .codeDataType     = CodeDataType::Data_ReadWrite,
+              .privilege        = PrivilegeLevel::Ring3,  // User mode
+              .presence         = Presence::Present,
+              .granularity      = Granularity::Page,  // 4KB page granularity
+              .defaultOperand32 = true,               // 32-bit mode
+              .isLongMode       = false,
+              .isAvailableSW    = false,
       }) {
     // Global Descriptor Table Segments
     DescriptorPointer gdt_p{};
@@ -142,3 +155,18 @@ void GlobalDescriptorTable::initializeTSS(uint32_t esp) {
 void GlobalDescriptorTable::setKernelStack(uint32_t esp) {
     tss_entry.esp0 = esp;  // Update kernel stack pointer in TSS
 }
+
+void GlobalDescriptorTable::setThreadLocalStorage(uint32_t base, uint32_t limitRaw, Granularity granularity) {
+    thread_local_storage_descriptor = SegmentDescriptor(SegmentDescriptor::SegmentDescriptorInput{
+            .base             = base,
+            .limitRaw         = limitRaw,
+            .segmentKind      = SegmentKind::CodeData,
+            .codeDataType     = CodeDataType::Data_ReadWrite,
+            .privilege        = PrivilegeLevel::Ring3,
+            .presence         = Presence::Present,
+            .granularity      = granularity,
+            .defaultOperand32 = true,
+            .isLongMode       = false,
+            .isAvailableSW    = false,
+    });
+}
@@ -1,6 +1,9 @@
 
 
 #include "core/Interrupts.h"
+#include "core/DeferredWork.h"
+#include "core/Trace.h"
+#include "core/acpi/APIC.h"
 #include "core/kernel.h"
 #include "core/memory/paging.h"
 #include "core/panic.h"
@@ -46,7 +49,16 @@ extern "C" void InterruptServiceRoutine_0x2C();  // Mouse
 extern "C" void InterruptServiceRoutine_0x2D();
 extern "C" void InterruptServiceRoutine_0x2E();
 extern "C" void InterruptServiceRoutine_0x2F();
+extern "C" void InterruptServiceRoutine_0x30();  // I/O APIC GSI 16
+extern "C" void InterruptServiceRoutine_0x31();  // I/O APIC GSI 17
+extern "C" void InterruptServiceRoutine_0x32();  // I/O APIC GSI 18
+extern "C" void InterruptServiceRoutine_0x33();  // I/O APIC GSI 19
+extern "C" void InterruptServiceRoutine_0x34();  // I/O APIC GSI 20
+extern "C" void InterruptServiceRoutine_0x35();  // I/O APIC GSI 21
+extern "C" void InterruptServiceRoutine_0x36();  // I/O APIC GSI 22
+extern "C" void InterruptServiceRoutine_0x37();  // I/O APIC GSI 23
 extern "C" void InterruptServiceRoutine_0x80();
+extern "C" void InterruptServiceRoutine_0xFF();  // Local APIC spurious
 /// endregion
 
 
@@ -73,8 +85,15 @@ extern "C" uint32_t* primary_isr_handler(PalmyraOS::kernel::interrupts::CPURegis
     bool isPICAvailable = InterruptController::activePicManager != nullptr;
     if (!isPICAvailable) PalmyraOS::kernel::kernelPanic("PIC Manager is not activated.");
 
+    // With the APIC active, acknowledge with a single MMIO write (the 8259 is masked)
+    if (APIC::isEnabled()) {
+        if (registers->intNo >= APIC::IRQ_VECTOR_BASE && registers->intNo < APIC::IRQ_VECTOR_BASE + APIC::IRQ_VECTOR_COUNT) {
+            APIC::sendEOI();
+            handled = true;
+        }
+    }
     // Check if there is an active PIC manager and the interrupt is from an IRQ (0x20 to 0x2F)
-    if (isPICAvailable && registers->intNo >= 0x20 && registers->intNo < 0x30) {
+    else if (isPICAvailable && registers->intNo >= 0x20 && registers->intNo < 0x30) {
         // Check if the interrupt is from the slave PIC (IRQs 8-15, corresponding to vectors 0x28 to 0x2F)
         if (registers->intNo >= 0x28) {
             // Send EOI to the slave PIC
@@ -87,7 +106,19 @@ extern "C" uint32_t* primary_isr_handler(PalmyraOS::kernel::interrupts::CPURegis
 
     // Check secondary handlers array if a handler exists for this particular interrupt number
     if (secondary_interrupt_handlers[registers->intNo] != nullptr) {
-        auto newStackPointer = secondary_interrupt_handlers[registers->intNo](registers);
+        // Hardware interrupts only (system calls and exceptions have their own tracepoints)
+        uint32_t vector = registers->intNo;
+
+        // Bottom halves run on the stack of the interrupted task: before the system clock handler, which may switch tasks
+        if (handled && vector == APIC::TIMER_VECTOR) DeferredWork::runPending();
+
+        if (handled) TRACE(IrqEnter, vector);
+        auto newStackPointer = secondary_interrupt_handlers[vector](registers);
+        if (handled) TRACE(IrqExit, vector);
+
+        // ... and on the way out of any IRQ that did not switch tasks, with interrupts enabled
+        if (handled && newStackPointer == reinterpret_cast<uint32_t*>(registers)) DeferredWork::runPending();
+
         return newStackPointer - 1;
     }
 
@@ -181,6 +212,15 @@ void PalmyraOS::kernel::interrupts::PICManager::disableInterrupts() {
     slavePicData.write(MASK_ALL_INTERRUPTS);
 }
 
+void PalmyraOS::kernel::interrupts::PICManager::unmaskIRQ(uint8_t irq) {
+    // IRQ 0-7: Master PIC, IRQ 8-15: Slave PIC (cascaded through IRQ2)
+    if (irq >= 8) {
+        slavePicData.write(slavePicData.read() & ~(1 << (irq - 8)));
+        masterPicData.write(masterPicData.read() & ~(1 << 2));
+    }
+    else { masterPicData.write(masterPicData.read() & ~(1 << irq)); }
+}
+
 /// endregion
 
 
@@ -219,6 +259,15 @@ PalmyraOS::kernel::interrupts::InterruptController::InterruptController(GDT::Glo
     idtHandler.setDescriptor(0x2D, codeSegment, &InterruptServiceRoutine_0x2D, 0, GateType::InterruptGate);
     idtHandler.setDescriptor(0x2E, codeSegment, &InterruptServiceRoutine_0x2E, 0, GateType::InterruptGate);
     idtHandler.setDescriptor(0x2F, codeSegment, &InterruptServiceRoutine_0x2F, 0, GateType::InterruptGate);
+    idtHandler.setDescriptor(0x30, codeSegment, &InterruptServiceRoutine_0x30, 0, GateType::InterruptGate);
+    idtHandler.setDescriptor(0x31, codeSegment, &InterruptServiceRoutine_0x31, 0, GateType::InterruptGate);
+    idtHandler.setDescriptor(0x32, codeSegment, &InterruptServiceRoutine_0x32, 0, GateType::InterruptGate);
+    idtHandler.setDescriptor(0x33, codeSegment, &InterruptServiceRoutine_0x33, 0, GateType::InterruptGate);
+    idtHandler.setDescriptor(0x34, codeSegment, &InterruptServiceRoutine_0x34, 0, GateType::InterruptGate);
+    idtHandler.setDescriptor(0x35, codeSegment, &InterruptServiceRoutine_0x35, 0, GateType::InterruptGate);
+    idtHandler.setDescriptor(0x36, codeSegment, &InterruptServiceRoutine_0x36, 0, GateType::InterruptGate);
+    idtHandler.setDescriptor(0x37, codeSegment, &InterruptServiceRoutine_0x37, 0, GateType::InterruptGate);
+    idtHandler.setDescriptor(0xFF, codeSegment, &InterruptServiceRoutine_0xFF, 0, GateType::InterruptGate);
 
     // Desired Privilege Level (DPL) 3, so that it can be invoked by User Processes
     idtHandler.setDescriptor(0x80, codeSegment, &InterruptServiceRoutine_0x80, 3, GateType::InterruptGate);
@@ -237,10 +286,48 @@ void PalmyraOS::kernel::interrupts::InterruptController::enableInterrupts() {
 
 void PalmyraOS::kernel::interrupts::InterruptController::disableInterrupts() { disable_interrupts(); }
 
+uint32_t PalmyraOS::kernel::interrupts::InterruptController::saveAndDisableInterrupts() {
+    uint32_t flags;
+    asm volatile("pushf\n\t"
+                 "pop %0\n\t"
+                 "cli"
+                 : "=r"(flags)
+                 :
+                 : "memory");
+    return flags;
+}
+
+void PalmyraOS::kernel::interrupts::InterruptController::restoreInterrupts(uint32_t flags) {
+    if (flags & (1 << 9)) asm volatile("sti" ::: "memory");  // IF
+}
+
 void PalmyraOS::kernel::interrupts::InterruptController::setInterruptHandler(uint8_t interrupt_number, InterruptHandler interrupt_handler) {
     secondary_interrupt_handlers[interrupt_number] = interrupt_handler;
 }
 
+void PalmyraOS::kernel::interrupts::InterruptController::enableIRQ(uint8_t irq) {
+    if (irq >= 16) return;
+    if (APIC::isEnabled()) APIC::routeIRQ(irq, APIC::IRQ_VECTOR_BASE + irq);
+    else if (activePicManager) activePicManager->unmaskIRQ(irq);
+}
+
+uint8_t PalmyraOS::kernel::interrupts::InterruptController::enablePCIInterrupt(uint8_t line, InterruptHandler handler) {
+    uint8_t limit = APIC::isEnabled() ? APIC::IRQ_VECTOR_COUNT : 16;
+    if (line == 0 || line >= limit) return 0;
+
+    // Install the handler before the line can fire
+    uint8_t vector = APIC::IRQ_VECTOR_BASE + line;
+    setInterruptHandler(vector, handler);
+
+    if (APIC::isEnabled()) {
+        if (APIC::routePCIInterrupt(line, vector)) return vector;
+        setInterruptHandler(vector, nullptr);
+        return 0;
+    }
+    if (activePicManager) activePicManager->unmaskIRQ(line);
+    return vector;
+}
+
 /// endregion
 
 
@@ -277,7 +364,9 @@ const char* interruptName(uint32_t intNo) {
     if (intNo == 0x2D) return "IRQ13 FPU/Coprocessor/Interrupt for CPU to Communicate with FPU";
     if (intNo == 0x2E) return "IRQ14 Primary ATA Hard Disk";
     if (intNo == 0x2F) return "IRQ15 Secondary ATA Hard Disk";
+    if (intNo >= 0x30 && intNo < 0x38) return "I/O APIC GSI 16-23";
     if (intNo == 0x80) return "System Call";
+    if (intNo == 0xFF) return "Local APIC Spurious";
     return "Unknown Interrupt";
 }
 
@@ -0,0 +1,31 @@
+
+#include "core/LocalPage.h"
+#include "core/kernel.h"
+#include "core/memory/paging.h"
+#include "core/peripherals/Logger.h"
+
+#include "libs/memory.h"
+
+
+// Globals
+void* PalmyraOS::kernel::LocalPage::address_ = nullptr;
+
+bool PalmyraOS::kernel::LocalPage::initialize() {
+    // Kept allocated and unused: no identity mapping can ever land on this address
+    address_ = kernelPagingDirectory_ptr->allocatePage();
+    if (!address_) return false;
+
+    LOG_INFO("Process-local page at 0x%X", address_);
+    return true;
+}
+
+void* PalmyraOS::kernel::LocalPage::mapInto(PagingDirectory* directory) {
+    if (!address_) return nullptr;
+
+    void* frame = kernelPagingDirectory_ptr->allocatePage();
+    if (!frame) return nullptr;
+    memset(frame, 0, PAGE_SIZE);
+
+    directory->mapPage(frame, address_, PageFlags::Present | PageFlags::ReadWrite | PageFlags::UserSupervisor);
+    return frame;
+}
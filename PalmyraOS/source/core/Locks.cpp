@@ -0,0 +1,197 @@
+
+#include "core/Locks.h"
+#include "core/DeferredWork.h"
+#include "core/Interrupts.h"
+#include "core/panic.h"
+#include "core/tasks/ProcessManager.h"
+
+#include "palmyraOS/unistd.h"  // sched_yield()
+
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+namespace {
+    /// Sleeping is only possible in process context once the scheduler runs
+    void assertCanSleep(const char* lockName) {
+        if (!PalmyraOS::kernel::TaskManager::hasCurrentProcess()) PalmyraOS::kernel::kernelPanic("%s: contended before the scheduler started", lockName);
+        if (PalmyraOS::kernel::DeferredWork::isRunning()) PalmyraOS::kernel::kernelPanic("%s: cannot sleep in a bottom half", lockName);
+    }
+}  // namespace
+
+void PalmyraOS::kernel::SpinLock::lock() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    // Uniprocessor: nobody can release the lock while we hold the CPU with interrupts off
+    if (__atomic_exchange_n(&locked_, 1, __ATOMIC_ACQUIRE)) kernelPanic("SpinLock: recursive acquisition");
+    flags_ = flags;
+}
+
+void PalmyraOS::kernel::SpinLock::unlock() {
+    uint32_t flags = flags_;
+    __atomic_store_n(&locked_, 0, __ATOMIC_RELEASE);
+    InterruptController::restoreInterrupts(flags);
+}
+
+void PalmyraOS::kernel::WaitQueue::sleep(uint64_t deadlineTick) {
+    Process* current    = TaskManager::getCurrentProcess();
+
+    current->waitNext_  = nullptr;
+    current->waitQueue_ = this;
+    if (tail_) tail_->waitNext_ = current;
+    else head_ = current;
+    tail_ = current;
+
+    // The scheduler skips Waiting processes: we resume here once a waker sets us Ready
+    current->setState(Process::State::Waiting);
+    if (deadlineTick == 0) {
+        sched_yield();
+        return;
+    }
+
+    // Timed out: nobody popped us, leave the queue ourselves (it may be gone if we were popped)
+    TaskManager::setWakeupTick(current, deadlineTick);
+    sched_yield();
+    TaskManager::setWakeupTick(current, 0);
+    if (current->waitQueue_ == this) remove(current);
+}
+
+PalmyraOS::kernel::Process* PalmyraOS::kernel::WaitQueue::pop() {
+    Process* process = head_;
+    if (!process) return nullptr;
+
+    head_ = process->waitNext_;
+    if (!head_) tail_ = nullptr;
+    process->waitNext_  = nullptr;
+    process->waitQueue_ = nullptr;
+    return process;
+}
+
+bool PalmyraOS::kernel::WaitQueue::wakeOne() {
+    // Terminated sleepers are dropped: they will never take the resource
+    while (Process* process = pop()) {
+        if (process->getState() != Process::State::Waiting) continue;
+        process->setState(Process::State::Ready);
+        return true;
+    }
+    return false;
+}
+
+void PalmyraOS::kernel::WaitQueue::wakeAll() {
+    while (wakeOne()) {}
+}
+
+uint32_t PalmyraOS::kernel::WaitQueue::wakeMatching(uint32_t count, bool (*match)(Process* process, uintptr_t argument), uintptr_t argument) {
+    uint32_t woken    = 0;
+    Process* previous = nullptr;
+    Process* entry    = head_;
+    while (entry && woken < count) {
+        Process* next = entry->waitNext_;
+
+        // Terminated sleepers are dropped like in wakeOne(), non-matching ones stay in place
+        bool waiting = entry->getState() == Process::State::Waiting;
+        if (waiting && !match(entry, argument)) {
+            previous = entry;
+            entry    = next;
+            continue;
+        }
+
+        if (previous) previous->waitNext_ = next;
+        else head_ = next;
+        if (tail_ == entry) tail_ = previous;
+        entry->waitNext_  = nullptr;
+        entry->waitQueue_ = nullptr;
+
+        if (waiting) {
+            entry->setState(Process::State::Ready);
+            woken++;
+        }
+        entry = next;
+    }
+    return woken;
+}
+
+void PalmyraOS::kernel::WaitQueue::remove(Process* process) {
+    Process* previous = nullptr;
+    for (Process* entry = head_; entry; previous = entry, entry = entry->waitNext_) {
+        if (entry != process) continue;
+
+        if (previous) previous->waitNext_ = entry->waitNext_;
+        else head_ = entry->waitNext_;
+        if (tail_ == entry) tail_ = previous;
+
+        entry->waitNext_  = nullptr;
+        entry->waitQueue_ = nullptr;
+        return;
+    }
+}
+
+void PalmyraOS::kernel::Mutex::lock() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    // unlock() hands the mutex to nobody in particular: re-check after every wake-up
+    while (locked_) {
+        assertCanSleep("Mutex");
+        if (owner_ == TaskManager::getCurrentProcess()) kernelPanic("Mutex: recursive acquisition by PID %d", owner_->getPid());
+        waiters_.sleep();
+    }
+
+    locked_ = true;
+    owner_  = TaskManager::hasCurrentProcess() ? TaskManager::getCurrentProcess() : nullptr;
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+bool PalmyraOS::kernel::Mutex::tryLock() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    bool acquired = !locked_;
+    if (acquired) {
+        locked_ = true;
+        owner_  = TaskManager::hasCurrentProcess() ? TaskManager::getCurrentProcess() : nullptr;
+    }
+
+    InterruptController::restoreInterrupts(flags);
+    return acquired;
+}
+
+void PalmyraOS::kernel::Mutex::unlock() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    locked_ = false;
+    owner_  = nullptr;
+    waiters_.wakeOne();
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+void PalmyraOS::kernel::Semaphore::down() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    while (count_ == 0) {
+        assertCanSleep("Semaphore");
+        waiters_.sleep();
+    }
+    count_ = count_ - 1;
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+bool PalmyraOS::kernel::Semaphore::tryDown() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    bool acquired = count_ > 0;
+    if (acquired) count_ = count_ - 1;
+
+    InterruptController::restoreInterrupts(flags);
+    return acquired;
+}
+
+void PalmyraOS::kernel::Semaphore::up() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    count_ = count_ + 1;
+    waiters_.wakeOne();
+
+    InterruptController::restoreInterrupts(flags);
+}
+
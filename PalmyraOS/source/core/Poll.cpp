@@ -0,0 +1,109 @@
+
+#include "core/Poll.h"
+#include "core/Interrupts.h"
+#include "core/kernel.h"
+#include "core/tasks/ProcessManager.h"
+
+#include "palmyraOS/unistd.h"  // sched_yield()
+
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+PalmyraOS::kernel::PollSource::~PollSource() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    // Watchers outlive the descriptor: unlink them first, they may free themselves in detach()
+    while (PollWatcher* watcher = head_) {
+        head_            = watcher->next_;
+        watcher->next_   = nullptr;
+        watcher->source_ = nullptr;
+        watcher->detach();
+    }
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+void PalmyraOS::kernel::PollSource::addWatcher(PollWatcher* watcher) {
+    uint32_t flags   = InterruptController::saveAndDisableInterrupts();
+
+    watcher->source_ = this;
+    watcher->next_   = head_;
+    head_            = watcher;
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+void PalmyraOS::kernel::PollSource::removeWatcher(PollWatcher* watcher) {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    for (PollWatcher** link = &head_; *link; link = &(*link)->next_) {
+        if (*link != watcher) continue;
+        *link            = watcher->next_;
+        watcher->next_   = nullptr;
+        watcher->source_ = nullptr;
+        break;
+    }
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+void PalmyraOS::kernel::PollSource::notify(uint32_t events) {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+    for (PollWatcher* watcher = head_; watcher; watcher = watcher->next_) watcher->notify(events);
+    InterruptController::restoreInterrupts(flags);
+}
+
+PalmyraOS::kernel::PollTable::PollTable(Process* process) : process_(process) { process_->pollTable_ = this; }
+
+PalmyraOS::kernel::PollTable::~PollTable() {
+    detachAll();
+    process_->pollTable_ = nullptr;
+}
+
+bool PalmyraOS::kernel::PollTable::watch(PollSource* source) {
+    auto* entry = heapManager.createInstance<Entry>(this);
+    if (!entry) return false;
+
+    entries_.push_back(entry);
+    source->addWatcher(entry);
+    return true;
+}
+
+void PalmyraOS::kernel::PollTable::sleep(uint64_t deadlineTick) {
+    // A notification between the readiness check and now must not be lost
+    if (!notified_) {
+        sleeping_ = true;
+        process_->setState(Process::State::Waiting);
+        if (deadlineTick) TaskManager::setWakeupTick(process_, deadlineTick);
+        sched_yield();
+        if (deadlineTick) TaskManager::setWakeupTick(process_, 0);
+        sleeping_ = false;
+    }
+    notified_ = false;
+}
+
+void PalmyraOS::kernel::PollTable::detachAll() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    for (Entry* entry: entries_) {
+        if (entry->getSource()) entry->getSource()->removeWatcher(entry);
+        heapManager.free(entry);
+    }
+    KVector<Entry*>().swap(entries_);
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+void PalmyraOS::kernel::PollTable::wake() {
+    notified_ = true;
+
+    // Outside sleep() the process may be Waiting on something else (a mutex taken while checking readiness)
+    if (sleeping_ && process_->getState() == Process::State::Waiting) process_->setState(Process::State::Ready);
+}
+
+void PalmyraOS::kernel::PollTable::Entry::notify(uint32_t events) { table_->wake(); }
+
+void PalmyraOS::kernel::PollTable::Entry::detach() {
+    // The descriptor was closed: poll() reports POLLNVAL for it
+    table_->wake();
+}
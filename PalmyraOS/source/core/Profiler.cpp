@@ -0,0 +1,145 @@
+
+#include "core/Profiler.h"
+#include "core/SystemClock.h"
+#include "core/files/VirtualFileSystem.h"
+#include "core/kernel.h"
+#include "core/tasks/ProcessManager.h"
+
+#include "libs/memory.h"
+#include "libs/stdio.h"
+#include "libs/string.h"
+
+#include <algorithm>
+
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+// Kernel symbol table (section .ksyms, see linker.ld and scripts/ksyms.py)
+extern "C" uint8_t __mem_ksyms_start[];
+extern "C" uint8_t __mem_ksyms_end[];
+
+// Globals
+PalmyraOS::kernel::ProfileSamples* PalmyraOS::kernel::Profiler::kernelSamples_ = nullptr;
+
+namespace {
+    constexpr uint32_t KSYMS_MAGIC       = 0x4D59534B;  // 'KSYM'
+    constexpr uint32_t MAX_PROFILE_LINES = 64;          // Functions listed per profile
+    constexpr uint32_t MAX_SYMBOL_LENGTH = 160;         // Longer names are cut
+
+    struct SymbolTableHeader {
+        uint32_t magic;
+        uint32_t count;
+    };
+
+    struct SymbolTableEntry {
+        uint32_t address;
+        uint32_t nameOffset;  // From the start of the table
+    };
+
+    // Samples of one function (or of one address outside the kernel code)
+    struct ProfileLine {
+        uint32_t start;
+        uint32_t count;
+        const char* name;  // nullptr: not a kernel function
+    };
+
+    PalmyraOS::kernel::ProfileSamples* allocateSamples(uint32_t pages) {
+        auto* samples = static_cast<PalmyraOS::kernel::ProfileSamples*>(PalmyraOS::kernel::kernelPagingDirectory_ptr->allocatePages(pages));
+        if (!samples) return nullptr;
+
+        samples->total    = 0;
+        samples->capacity = (pages * PalmyraOS::kernel::PAGE_SIZE - sizeof(PalmyraOS::kernel::ProfileSamples)) / sizeof(uint32_t);
+        return samples;
+    }
+}  // namespace
+
+void PalmyraOS::kernel::Profiler::initialize() {
+    kernelSamples_ = allocateSamples(KERNEL_PAGES);
+    SystemClock::attachHandler(&handleTick);
+
+    auto profileNode = kernel::heapManager.createInstance<vfs::FunctionInode>(
+            [](char* buffer, size_t size, size_t offset) -> size_t { return readProfile(kernelSamples_, buffer, size, offset); }, nullptr, nullptr);
+    if (profileNode) vfs::VirtualFileSystem::setInodeByPath(KString("/proc/kprofile"), profileNode);
+}
+
+PalmyraOS::kernel::ProfileSamples* PalmyraOS::kernel::Profiler::createSamples() { return allocateSamples(PROCESS_PAGES); }
+
+void PalmyraOS::kernel::Profiler::destroySamples(ProfileSamples* samples) {
+    if (samples) kernelPagingDirectory_ptr->freePages(samples, PROCESS_PAGES);
+}
+
+uint32_t* PalmyraOS::kernel::Profiler::handleTick(interrupts::CPURegisters* regs) {
+    // Attached before the scheduler: the current process is the one that was interrupted
+    if ((regs->cs & 0x3) == 0) record(kernelSamples_, regs->eip);
+    if (TaskManager::hasCurrentProcess()) record(TaskManager::getCurrentProcess()->profileSamples_, regs->eip);
+
+    void* frame = regs;
+    return static_cast<uint32_t*>(frame);
+}
+
+void PalmyraOS::kernel::Profiler::record(ProfileSamples* samples, uint32_t eip) {
+    if (!samples) return;
+    samples->eips[samples->total % samples->capacity] = eip;
+    samples->total++;
+}
+
+const char* PalmyraOS::kernel::Profiler::lookupSymbol(uint32_t address, uint32_t& start) {
+    if (address < reinterpret_cast<uint32_t>(&__mem_text_start) || address >= reinterpret_cast<uint32_t>(&__mem_text_end)) return nullptr;
+
+    const auto* header = reinterpret_cast<const SymbolTableHeader*>(__mem_ksyms_start);
+    if (__mem_ksyms_end - __mem_ksyms_start < static_cast<int>(sizeof(SymbolTableHeader)) || header->magic != KSYMS_MAGIC) return nullptr;
+
+    // Last symbol at or below the address (entries are sorted by address)
+    const auto* entries = reinterpret_cast<const SymbolTableEntry*>(header + 1);
+    uint32_t low        = 0;
+    uint32_t high       = header->count;
+    while (low < high) {
+        uint32_t middle = (low + high) / 2;
+        if (entries[middle].address <= address) low = middle + 1;
+        else high = middle;
+    }
+    if (low == 0) return nullptr;
+
+    start = entries[low - 1].address;
+    return reinterpret_cast<const char*>(__mem_ksyms_start + entries[low - 1].nameOffset);
+}
+
+size_t PalmyraOS::kernel::Profiler::readProfile(const ProfileSamples* samples, char* buffer, size_t size, size_t offset) {
+    if (!samples) return 0;
+
+    // Snapshot the ring: the timer cannot add samples meanwhile
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+    uint32_t total = samples->total;
+    uint32_t count = total < samples->capacity ? total : samples->capacity;
+    KVector<uint32_t> eips(samples->eips, samples->eips + count);
+    InterruptController::restoreInterrupts(flags);
+
+    // Consecutive addresses of one function end up next to each other
+    std::sort(eips.begin(), eips.end());
+    KVector<ProfileLine> lines;
+    for (uint32_t eip: eips) {
+        uint32_t start   = eip;
+        const char* name = lookupSymbol(eip, start);
+        if (!lines.empty() && lines.back().start == start) lines.back().count++;
+        else lines.push_back({start, 1, name});
+    }
+    std::sort(lines.begin(), lines.end(), [](const ProfileLine& a, const ProfileLine& b) { return a.count > b.count; });
+
+    // Columns: samples, share of the window in tenths of a percent, function
+    KVector<char> text(128 + MAX_PROFILE_LINES * (MAX_SYMBOL_LENGTH + 32));
+    size_t length = snprintf(text.data(), text.size(), "# samples %u, window %u, functions %u\n", total, count, lines.size());
+    for (uint32_t i = 0; i < lines.size() && i < MAX_PROFILE_LINES; ++i) {
+        char name[MAX_SYMBOL_LENGTH];
+        if (lines[i].name) strncpy(name, lines[i].name, sizeof(name) - 1);
+        else snprintf(name, sizeof(name), "0x%X", lines[i].start);
+        name[sizeof(name) - 1] = '\0';
+
+        uint32_t permille = lines[i].count * 1000 / count;
+        length += snprintf(text.data() + length, text.size() - length, "%u %u.%u %s\n", lines[i].count, permille / 10, permille % 10, name);
+    }
+
+    if (offset >= length) return 0;
+    size_t copied = length - offset < size ? length - offset : size;
+    memcpy(buffer, text.data() + offset, copied);
+    return copied;
+}
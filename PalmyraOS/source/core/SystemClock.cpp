@@ -1,5 +1,6 @@
 
 #include "core/SystemClock.h"
+#include "core/acpi/APIC.h"
 #include "core/panic.h"
 
 
@@ -21,6 +22,13 @@ void PalmyraOS::kernel::SystemClock::initialize(uint32_t frequency) {
 
 bool PalmyraOS::kernel::SystemClock::setFrequency(uint32_t frequency) {
     if (frequency < 1) return false;
+
+    // Prefer the calibrated Local APIC timer (same vector), it masks the PIT line itself
+    if (APIC::isTimerCalibrated() && APIC::setTimerFrequency(frequency)) {
+        frequency_ = frequency;
+        return true;
+    }
+
     frequency_       = frequency;
     uint16_t divisor = PIT_FREQUENCY_MUL / frequency_ / PIT_FREQUENCY_DIV;
     if (divisor == 0) {
@@ -0,0 +1,66 @@
+
+#include "core/TimePage.h"
+#include "core/SystemClock.h"
+#include "core/cpu.h"
+#include "core/kernel.h"
+#include "core/memory/paging.h"
+#include "core/peripherals/Logger.h"
+#include "core/peripherals/RTC.h"
+
+#include "libs/memory.h"
+
+
+// Globals
+PalmyraOS::types::TimePageData* PalmyraOS::kernel::TimePage::page_ = nullptr;
+uint32_t PalmyraOS::kernel::TimePage::calibratedMHz_               = 0;
+
+bool PalmyraOS::kernel::TimePage::initialize() {
+    page_ = static_cast<types::TimePageData*>(kernelPagingDirectory_ptr->allocatePage());
+    if (!page_) return false;
+    memset(page_, 0, PAGE_SIZE);
+
+    page_->nanosecondsPerTick = 1'000'000'000 / SystemClock::getFrequency();
+    page_->tscBase            = CPU::getTSC();
+    page_->realtimeOffset     = RTC::now() * 1'000'000'000ULL;
+    updateCalibration();
+
+    SystemClock::attachHandler(&handleTick);
+
+    LOG_INFO("Time page at 0x%X (%u ns per tick, TSC multiplier %u >> %u)", page_, page_->nanosecondsPerTick, page_->tscMultiplier, TSC_SHIFT);
+    return true;
+}
+
+void PalmyraOS::kernel::TimePage::mapInto(PagingDirectory* directory) {
+    if (!page_) return;
+    directory->mapPage(page_, page_, PageFlags::Present | PageFlags::UserSupervisor);
+}
+
+void PalmyraOS::kernel::TimePage::updateCalibration() {
+    // The CPU frequency is re-measured during boot: follow it
+    uint32_t mhz = CPU::getCPUFrequency();
+    if (mhz == calibratedMHz_) return;
+
+    // ns per cycle = 1000 / MHz, in fixed point (fits 32 bits above ~4 MHz)
+    page_->tscMultiplier = mhz >= 4 ? static_cast<uint32_t>((1000ULL << TSC_SHIFT) / mhz) : 0;
+    page_->tscShift      = TSC_SHIFT;
+    calibratedMHz_       = mhz;
+}
+
+uint32_t* PalmyraOS::kernel::TimePage::handleTick(interrupts::CPURegisters* regs) {
+    // Interrupts are disabled: readers can only observe the odd sequence on another CPU
+    page_->sequence = page_->sequence + 1;
+    asm volatile("" ::: "memory");
+
+    // Account the period that just ended, then prepare the next one (the frequency may change)
+    page_->ticks++;
+    page_->nanoseconds += page_->nanosecondsPerTick;
+    page_->nanosecondsPerTick = 1'000'000'000 / SystemClock::getFrequency();
+    page_->tscBase            = CPU::getTSC();
+    updateCalibration();
+
+    asm volatile("" ::: "memory");
+    page_->sequence = page_->sequence + 1;
+
+    void* frame     = regs;
+    return static_cast<uint32_t*>(frame);
+}
@@ -0,0 +1,161 @@
+
+#include "core/Trace.h"
+#include "core/Interrupts.h"
+#include "core/cpu.h"
+#include "core/files/VirtualFileSystem.h"
+#include "core/kernel.h"
+#include "core/peripherals/Logger.h"
+#include "core/tasks/ProcessManager.h"
+
+#include "libs/memory.h"
+#include "libs/stdio.h"
+#include "libs/stdlib.h"
+#include "libs/string.h"
+
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+// Globals
+uint32_t PalmyraOS::kernel::Trace::mask_                            = 0;
+PalmyraOS::kernel::TraceRecord* PalmyraOS::kernel::Trace::ring_     = nullptr;
+uint32_t PalmyraOS::kernel::Trace::capacity_                        = 0;
+uint32_t PalmyraOS::kernel::Trace::head_                            = 0;
+uint64_t PalmyraOS::kernel::Trace::total_                           = 0;
+PalmyraOS::kernel::TraceRecord* PalmyraOS::kernel::Trace::snapshot_ = nullptr;
+uint32_t PalmyraOS::kernel::Trace::snapshotCount_                   = 0;
+uint64_t PalmyraOS::kernel::Trace::snapshotTotal_                   = 0;
+char PalmyraOS::kernel::Trace::header_[HEADER_SIZE]                 = {0};
+uint32_t PalmyraOS::kernel::Trace::headerLength_                    = 0;
+
+namespace {
+    // "tsc pid event arg0 arg1\n", every field in fixed-width hexadecimal
+    constexpr uint32_t LINE_LENGTH = 16 + 1 + 8 + 1 + 2 + 1 + 8 + 1 + 8 + 1;
+
+    char* writeHex(char* out, uint64_t value, uint32_t digits) {
+        for (uint32_t i = 0; i < digits; ++i) out[digits - 1 - i] = "0123456789abcdef"[(value >> (4 * i)) & 0xF];
+        out[digits] = ' ';
+        return out + digits + 1;
+    }
+
+    void formatLine(char* line, const PalmyraOS::kernel::TraceRecord& record) {
+        char* out = line;
+        out       = writeHex(out, record.tsc, 16);
+        out       = writeHex(out, record.pid, 8);
+        out       = writeHex(out, record.event, 2);
+        out       = writeHex(out, record.arg0, 8);
+        out       = writeHex(out, record.arg1, 8);
+        out[-1]   = '\n';
+    }
+}  // namespace
+
+bool PalmyraOS::kernel::Trace::initialize() {
+    ring_     = static_cast<TraceRecord*>(kernelPagingDirectory_ptr->allocatePages(RING_PAGES));
+    snapshot_ = static_cast<TraceRecord*>(kernelPagingDirectory_ptr->allocatePages(RING_PAGES));
+    if (!ring_ || !snapshot_) {
+        if (ring_) kernelPagingDirectory_ptr->freePages(ring_, RING_PAGES);
+        if (snapshot_) kernelPagingDirectory_ptr->freePages(snapshot_, RING_PAGES);
+        ring_     = nullptr;
+        snapshot_ = nullptr;
+        return false;
+    }
+    capacity_ = RING_PAGES * PAGE_SIZE / sizeof(TraceRecord);
+
+    auto node = kernel::heapManager.createInstance<vfs::FunctionInode>(&read, &control, nullptr);
+    if (node) vfs::VirtualFileSystem::setInodeByPath(KString("/proc/trace"), node);
+
+    LOG_INFO("Trace ring at 0x%X (%u records)", ring_, capacity_);
+    return true;
+}
+
+void PalmyraOS::kernel::Trace::write(TraceEvent event, uint32_t arg0, uint32_t arg1) {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    TraceRecord& record = ring_[head_];
+    record.tsc          = CPU::getTSC();
+    record.pid          = TaskManager::hasCurrentProcess() ? TaskManager::getCurrentProcess()->getPid() : NO_PID;
+    record.event        = static_cast<uint8_t>(event);
+    record.arg0         = arg0;
+    record.arg1         = arg1;
+    head_               = head_ + 1 == capacity_ ? 0 : head_ + 1;
+    total_++;
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+void PalmyraOS::kernel::Trace::takeSnapshot() {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    // Oldest record first: once the ring has wrapped, the oldest one is at the head
+    snapshotTotal_ = total_;
+    if (total_ < capacity_) {
+        snapshotCount_ = head_;
+        memcpy(snapshot_, ring_, head_ * sizeof(TraceRecord));
+    }
+    else {
+        snapshotCount_ = capacity_;
+        memcpy(snapshot_, ring_ + head_, (capacity_ - head_) * sizeof(TraceRecord));
+        memcpy(snapshot_ + capacity_ - head_, ring_, head_ * sizeof(TraceRecord));
+    }
+
+    InterruptController::restoreInterrupts(flags);
+
+    // Header: format, clock and event names for the host script
+    uint64_t lost = snapshotTotal_ - snapshotCount_;
+    headerLength_ = snprintf(header_,
+                             HEADER_SIZE,
+                             "# palmyra-trace 1\n# cpu_mhz %u\n# records %u lost %llu\n# columns tsc pid event arg0 arg1\n",
+                             CPU::getCPUFrequency(),
+                             snapshotCount_,
+                             lost);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(TraceEvent::Count); ++i) {
+        headerLength_ += snprintf(header_ + headerLength_, HEADER_SIZE - headerLength_, "# event %u %s\n", i, TRACE_EVENT_NAMES[i]);
+    }
+}
+
+size_t PalmyraOS::kernel::Trace::read(char* buffer, size_t size, size_t offset) {
+    if (!ring_) return 0;
+    if (offset == 0) takeSnapshot();
+
+    size_t copied = 0;
+
+    // Header
+    if (offset < headerLength_) {
+        copied = headerLength_ - offset < size ? headerLength_ - offset : size;
+        memcpy(buffer, header_ + offset, copied);
+    }
+
+    // Records: line i starts at headerLength_ + i * LINE_LENGTH
+    char line[LINE_LENGTH];
+    while (copied < size) {
+        size_t position = offset + copied - headerLength_;
+        uint32_t index  = position / LINE_LENGTH;
+        if (index >= snapshotCount_) break;
+
+        formatLine(line, snapshot_[index]);
+        size_t column = position % LINE_LENGTH;
+        size_t length = LINE_LENGTH - column < size - copied ? LINE_LENGTH - column : size - copied;
+        memcpy(buffer + copied, line + column, length);
+        copied += length;
+    }
+    return copied;
+}
+
+size_t PalmyraOS::kernel::Trace::control(const char* buffer, size_t size, size_t offset) {
+    char command[16] = {0};
+    memcpy(command, buffer, size < sizeof(command) - 1 ? size : sizeof(command) - 1);
+    for (char* end = command; *end; ++end) {
+        if (*end == '\n' || *end == ' ') *end = '\0';
+    }
+
+    if (strcmp(command, "on") == 0) setMask((1u << static_cast<uint32_t>(TraceEvent::Count)) - 1);
+    else if (strcmp(command, "off") == 0) setMask(0);
+    else if (strcmp(command, "clear") == 0) {
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        head_          = 0;
+        total_         = 0;
+        InterruptController::restoreInterrupts(flags);
+    }
+    else setMask(static_cast<uint32_t>(strtol(command, nullptr, 16)));
+
+    return size;
+}
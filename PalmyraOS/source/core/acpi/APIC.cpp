@@ -0,0 +1,324 @@
+#include "core/acpi/APIC.h"
+#include "core/acpi/ACPI.h"
+#include "core/acpi/HPET.h"
+#include "core/cpu.h"
+#include "core/peripherals/Logger.h"
+
+namespace PalmyraOS::kernel {
+
+    // I/O APIC indirect register access
+    constexpr uint32_t IOAPIC_REGSEL            = 0x00 / 4;  // Register select (index)
+    constexpr uint32_t IOAPIC_WINDOW            = 0x10 / 4;  // Data window
+    constexpr uint8_t IOAPIC_REG_VERSION        = 0x01;      // Bits 16-23: max redirection entry
+    constexpr uint8_t IOAPIC_REG_REDIRECTION    = 0x10;      // Redirection table (2 registers per entry)
+
+    // Redirection entry / LVT bits
+    constexpr uint32_t APIC_ACTIVE_LOW          = 1 << 13;
+    constexpr uint32_t APIC_LEVEL_TRIGGERED     = 1 << 15;
+    constexpr uint32_t APIC_MASKED              = 1 << 16;
+    constexpr uint32_t APIC_TIMER_PERIODIC      = 1 << 17;
+    constexpr uint32_t APIC_SOFTWARE_ENABLE     = 1 << 8;
+
+    // Timer divide configuration: divide by 16
+    constexpr uint32_t APIC_TIMER_DIVIDE_BY_16  = 0x03;
+
+    // MPS INTI flags (MADT interrupt source override)
+    constexpr uint16_t INTI_POLARITY_MASK       = 0x03;
+    constexpr uint16_t INTI_POLARITY_ACTIVE_LOW = 0x03;
+    constexpr uint16_t INTI_TRIGGER_MASK        = 0x0C;
+    constexpr uint16_t INTI_TRIGGER_LEVEL       = 0x0C;
+
+    // Static member initialization
+    bool APIC::initialized_                     = false;
+    bool APIC::enabled_                         = false;
+    uintptr_t APIC::localAPICAddress_           = 0;
+    volatile uint32_t* APIC::localBase_         = nullptr;
+    uint8_t APIC::localAPICID_                  = 0;
+    uint32_t APIC::timerFrequency_              = 0;
+    uint8_t APIC::ioApicCount_                  = 0;
+    APIC::IOAPICInfo APIC::ioApics_[MAX_IO_APICS]{};
+    uint32_t APIC::isaGSI_[ISA_IRQ_COUNT]{};
+    uint16_t APIC::isaFlags_[ISA_IRQ_COUNT]{};
+
+    /// region Initialization
+
+    bool APIC::initialize() {
+        if (initialized_) {
+            LOG_WARN("APIC: Already initialized");
+            return true;
+        }
+
+        if (!CPU::isAPICAvailable()) {
+            LOG_WARN("APIC: CPU has no on-chip Local APIC");
+            return false;
+        }
+
+        if (!ACPI::isInitialized() || ACPI::getMADT() == nullptr) {
+            LOG_WARN("APIC: MADT not available");
+            return false;
+        }
+
+        const auto* madt  = ACPI::getMADT();
+        localAPICAddress_ = madt->localAPICAddress;
+
+        // ISA IRQs are identity-mapped to GSIs unless overridden
+        for (uint8_t irq = 0; irq < ISA_IRQ_COUNT; ++irq) {
+            isaGSI_[irq]   = irq;
+            isaFlags_[irq] = 0;
+        }
+
+        const uint8_t* entryPtr = madt->getEntriesStart();
+        const uint8_t* endPtr   = entryPtr + madt->getEntriesLength();
+
+        while (entryPtr < endPtr) {
+            const auto* entryHeader = reinterpret_cast<const acpi::MADTEntryHeader*>(entryPtr);
+            if (entryHeader->length == 0) break;  // malformed table, avoid looping forever
+
+            if (entryHeader->type == acpi::MADTEntryType::IOAPIC) {
+                const auto* entry = reinterpret_cast<const acpi::MADTIOAPIC*>(entryPtr);
+                if (ioApicCount_ < MAX_IO_APICS) {
+                    IOAPICInfo& ioApic = ioApics_[ioApicCount_++];
+                    ioApic.id          = entry->ioApicID;
+                    ioApic.base        = reinterpret_cast<volatile uint32_t*>(static_cast<uintptr_t>(entry->ioApicAddress));
+                    ioApic.gsiBase     = entry->globalSystemInterruptBase;
+                    ioApic.entryCount  = 0;  // read from the version register once mapped
+                }
+                else { LOG_WARN("APIC: Ignoring I/O APIC %u (max %u)", entry->ioApicID, MAX_IO_APICS); }
+            }
+            else if (entryHeader->type == acpi::MADTEntryType::InterruptSourceOverride) {
+                const auto* entry = reinterpret_cast<const acpi::MADTInterruptOverride*>(entryPtr);
+                if (entry->bus == 0 && entry->source < ISA_IRQ_COUNT) {
+                    isaGSI_[entry->source]   = entry->globalSystemInterrupt;
+                    isaFlags_[entry->source] = entry->flags;
+                }
+            }
+            else if (entryHeader->type == acpi::MADTEntryType::LocalAPICAddressOverride) {
+                const auto* entry = reinterpret_cast<const acpi::MADTLocalAPICAddressOverride*>(entryPtr);
+                localAPICAddress_ = static_cast<uintptr_t>(entry->localAPICAddress);
+            }
+
+            entryPtr += entryHeader->length;
+        }
+
+        if (localAPICAddress_ == 0 || ioApicCount_ == 0) {
+            LOG_WARN("APIC: Incomplete MADT (Local APIC 0x%X, %u I/O APICs)", localAPICAddress_, ioApicCount_);
+            return false;
+        }
+
+        LOG_INFO("APIC: Local APIC at 0x%08X, %u I/O APIC(s)", localAPICAddress_, ioApicCount_);
+        for (uint8_t irq = 0; irq < ISA_IRQ_COUNT; ++irq) {
+            if (isaGSI_[irq] != irq || isaFlags_[irq] != 0) { LOG_INFO("APIC: ISA IRQ %u -> GSI %u (Flags: 0x%04X)", irq, isaGSI_[irq], isaFlags_[irq]); }
+        }
+
+        initialized_ = true;
+        return true;
+    }
+
+    uintptr_t APIC::getIOAPICAddress(uint8_t index) {
+        if (index >= ioApicCount_) return 0;
+        return reinterpret_cast<uintptr_t>(ioApics_[index].base);
+    }
+
+    bool APIC::enable() {
+        if (!initialized_) {
+            LOG_ERROR("APIC: Not initialized");
+            return false;
+        }
+        if (enabled_) return true;
+
+        auto* picManager = interrupts::InterruptController::activePicManager;
+        if (picManager == nullptr) {
+            LOG_ERROR("APIC: Interrupt controller not initialized");
+            return false;
+        }
+
+        // Stop the 8259 from delivering anything; from now on it only exists as a fallback
+        picManager->disableInterrupts();
+
+        // Hardware-enable the Local APIC (it may have been disabled by firmware)
+        uint64_t apicBase = CPU::readMSR(IA32_APIC_BASE_MSR);
+        CPU::writeMSR(IA32_APIC_BASE_MSR, apicBase | IA32_APIC_BASE_ENABLE);
+
+        localBase_   = reinterpret_cast<volatile uint32_t*>(localAPICAddress_);
+        localAPICID_ = static_cast<uint8_t>(readLocal(LocalRegister::ID) >> 24);
+
+        // Accept all priorities, mask legacy LINT0 (ExtINT from the PIC), errors and the timer
+        writeLocal(LocalRegister::TaskPriority, 0);
+        writeLocal(LocalRegister::LVTLint0, APIC_MASKED);
+        writeLocal(LocalRegister::LVTError, APIC_MASKED);
+        writeLocal(LocalRegister::LVTTimer, APIC_MASKED);
+
+        // Software-enable the Local APIC with its spurious vector
+        interrupts::InterruptController::setInterruptHandler(SPURIOUS_VECTOR, &handleSpuriousInterrupt);
+        writeLocal(LocalRegister::SpuriousVector, APIC_SOFTWARE_ENABLE | SPURIOUS_VECTOR);
+
+        // Discover and mask every redirection entry
+        for (uint8_t i = 0; i < ioApicCount_; ++i) {
+            IOAPICInfo& ioApic = ioApics_[i];
+            ioApic.entryCount  = ((readIOAPIC(ioApic, IOAPIC_REG_VERSION) >> 16) & 0xFF) + 1;
+            for (uint32_t entry = 0; entry < ioApic.entryCount; ++entry) {
+                writeIOAPIC(ioApic, IOAPIC_REG_REDIRECTION + entry * 2, APIC_MASKED);
+                writeIOAPIC(ioApic, IOAPIC_REG_REDIRECTION + entry * 2 + 1, 0);
+            }
+            LOG_INFO("APIC: I/O APIC %u: GSI %u-%u", ioApic.id, ioApic.gsiBase, ioApic.gsiBase + ioApic.entryCount - 1);
+        }
+
+        // Mirror the PIC layout: ISA IRQ n -> vector 0x20 + n (IRQ2 is the PIC cascade and never fires)
+        for (uint8_t irq = 0; irq < ISA_IRQ_COUNT; ++irq) {
+            if (irq == 2) continue;
+            routeIRQ(irq, IRQ_VECTOR_BASE + irq);
+        }
+
+        enabled_ = true;
+        LOG_INFO("APIC: Enabled (Local APIC ID %u, version 0x%X), 8259 PIC masked", localAPICID_, readLocal(LocalRegister::Version) & 0xFF);
+        return true;
+    }
+
+    /// endregion
+
+    /// region I/O APIC Routing
+
+    bool APIC::routeIRQ(uint8_t irq, uint8_t vector) {
+        if (irq >= ISA_IRQ_COUNT) return false;
+
+        // ISA defaults: edge-triggered, active-high (bus conforming)
+        uint16_t flags      = isaFlags_[irq];
+        bool activeLow      = (flags & INTI_POLARITY_MASK) == INTI_POLARITY_ACTIVE_LOW;
+        bool levelTriggered = (flags & INTI_TRIGGER_MASK) == INTI_TRIGGER_LEVEL;
+
+        return routeGSI(isaGSI_[irq], vector, levelTriggered, activeLow);
+    }
+
+    bool APIC::routeGSI(uint32_t gsi, uint8_t vector, bool levelTriggered, bool activeLow) {
+        IOAPICInfo* ioApic = findIOAPIC(gsi);
+        if (ioApic == nullptr) {
+            LOG_WARN("APIC: No I/O APIC handles GSI %u", gsi);
+            return false;
+        }
+
+        uint32_t entry = gsi - ioApic->gsiBase;
+        uint32_t low   = vector;  // fixed delivery, physical destination, unmasked
+        if (levelTriggered) low |= APIC_LEVEL_TRIGGERED;
+        if (activeLow) low |= APIC_ACTIVE_LOW;
+
+        // Write the destination first so the entry is never live with a stale target
+        writeIOAPIC(*ioApic, IOAPIC_REG_REDIRECTION + entry * 2 + 1, static_cast<uint32_t>(localAPICID_) << 24);
+        writeIOAPIC(*ioApic, IOAPIC_REG_REDIRECTION + entry * 2, low);
+        return true;
+    }
+
+    bool APIC::routePCIInterrupt(uint8_t line, uint8_t vector) {
+        uint32_t gsi   = line;
+        uint16_t flags = 0;
+        if (line < ISA_IRQ_COUNT) {
+            gsi   = isaGSI_[line];
+            flags = isaFlags_[line];
+        }
+
+        // Only an explicit override may make a PCI line edge-triggered or active-high
+        uint16_t polarity   = flags & INTI_POLARITY_MASK;
+        uint16_t trigger    = flags & INTI_TRIGGER_MASK;
+        bool activeLow      = polarity == 0 || polarity == INTI_POLARITY_ACTIVE_LOW;
+        bool levelTriggered = trigger == 0 || trigger == INTI_TRIGGER_LEVEL;
+
+        return routeGSI(gsi, vector, levelTriggered, activeLow);
+    }
+
+    void APIC::maskIRQ(uint8_t irq) {
+        if (irq >= ISA_IRQ_COUNT) return;
+
+        IOAPICInfo* ioApic = findIOAPIC(isaGSI_[irq]);
+        if (ioApic == nullptr) return;
+
+        uint8_t reg = IOAPIC_REG_REDIRECTION + (isaGSI_[irq] - ioApic->gsiBase) * 2;
+        writeIOAPIC(*ioApic, reg, readIOAPIC(*ioApic, reg) | APIC_MASKED);
+    }
+
+    uint32_t APIC::getGSIForIRQ(uint8_t irq) {
+        if (irq >= ISA_IRQ_COUNT) return irq;
+        return isaGSI_[irq];
+    }
+
+    APIC::IOAPICInfo* APIC::findIOAPIC(uint32_t gsi) {
+        for (uint8_t i = 0; i < ioApicCount_; ++i) {
+            if (gsi >= ioApics_[i].gsiBase && gsi < ioApics_[i].gsiBase + ioApics_[i].entryCount) return &ioApics_[i];
+        }
+        return nullptr;
+    }
+
+    /// endregion
+
+    /// region Local APIC Timer
+
+    bool APIC::calibrateTimer(uint32_t measurementTimeMs) {
+        if (!enabled_) {
+            LOG_ERROR("APIC: Not enabled");
+            return false;
+        }
+        if (!HPET::isInitialized()) {
+            LOG_WARN("APIC: HPET not available, cannot calibrate LAPIC timer");
+            return false;
+        }
+
+        // One-shot, masked, counting down from the maximum
+        writeLocal(LocalRegister::TimerDivideConfig, APIC_TIMER_DIVIDE_BY_16);
+        writeLocal(LocalRegister::LVTTimer, APIC_MASKED);
+
+        uint64_t hpetStart = HPET::readCounter();
+        writeLocal(LocalRegister::TimerInitialCount, 0xFFFFFFFF);
+        HPET::delayMicroseconds(measurementTimeMs * 1000);
+        uint32_t remaining = readLocal(LocalRegister::TimerCurrentCount);
+        uint64_t elapsedNs = HPET::getElapsedNanoseconds(hpetStart);
+
+        writeLocal(LocalRegister::TimerInitialCount, 0);  // stop
+
+        uint32_t elapsedTicks = 0xFFFFFFFF - remaining;
+        if (elapsedNs == 0 || elapsedTicks == 0 || remaining == 0) {
+            LOG_ERROR("APIC: Timer calibration failed (ticks=%u, ns=%llu)", elapsedTicks, elapsedNs);
+            return false;
+        }
+
+        timerFrequency_ = static_cast<uint32_t>((static_cast<uint64_t>(elapsedTicks) * 1000000000ULL) / elapsedNs);
+        LOG_INFO("APIC: Timer calibrated against HPET: %u Hz (bus / 16)", timerFrequency_);
+        return true;
+    }
+
+    bool APIC::setTimerFrequency(uint32_t frequency) {
+        if (!isTimerCalibrated() || frequency == 0 || frequency > timerFrequency_) return false;
+
+        // The LAPIC timer replaces the PIT as the system tick
+        maskIRQ(0);
+
+        writeLocal(LocalRegister::TimerDivideConfig, APIC_TIMER_DIVIDE_BY_16);
+        writeLocal(LocalRegister::LVTTimer, APIC_TIMER_PERIODIC | TIMER_VECTOR);
+        writeLocal(LocalRegister::TimerInitialCount, timerFrequency_ / frequency);
+        return true;
+    }
+
+    /// endregion
+
+    /// region Register Access
+
+    uint32_t APIC::readLocal(LocalRegister reg) { return localBase_[static_cast<uint32_t>(reg) / 4]; }
+
+    void APIC::writeLocal(LocalRegister reg, uint32_t value) { localBase_[static_cast<uint32_t>(reg) / 4] = value; }
+
+    uint32_t APIC::readIOAPIC(const IOAPICInfo& ioApic, uint8_t reg) {
+        ioApic.base[IOAPIC_REGSEL] = reg;
+        return ioApic.base[IOAPIC_WINDOW];
+    }
+
+    void APIC::writeIOAPIC(const IOAPICInfo& ioApic, uint8_t reg, uint32_t value) {
+        ioApic.base[IOAPIC_REGSEL] = reg;
+        ioApic.base[IOAPIC_WINDOW] = value;
+    }
+
+    uint32_t* APIC::handleSpuriousInterrupt(interrupts::CPURegisters* regs) {
+        // Spurious interrupts must not be acknowledged with an EOI
+        void* frame = regs;
+        return static_cast<uint32_t*>(frame);
+    }
+
+    /// endregion
+
+}  // namespace PalmyraOS::kernel
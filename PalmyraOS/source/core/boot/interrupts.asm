@@ -158,5 +158,87 @@ InterruptServiceRoutine_NoErrorCode 0x2C        ; IRQ12 Mouse
 InterruptServiceRoutine_NoErrorCode 0x2D        ; IRQ13 FPU / coprocessor / inter-processor
 InterruptServiceRoutine_NoErrorCode 0x2E        ; IRQ14 primary ATA channel
 InterruptServiceRoutine_NoErrorCode 0x2F        ; IRQ15 secondary ATA channel
+InterruptServiceRoutine_NoErrorCode 0x30        ; I/O APIC GSI 16 (PCI)
+InterruptServiceRoutine_NoErrorCode 0x31        ; I/O APIC GSI 17 (PCI)
+InterruptServiceRoutine_NoErrorCode 0x32        ; I/O APIC GSI 18 (PCI)
+InterruptServiceRoutine_NoErrorCode 0x33        ; I/O APIC GSI 19 (PCI)
+InterruptServiceRoutine_NoErrorCode 0x34        ; I/O APIC GSI 20 (PCI)
+InterruptServiceRoutine_NoErrorCode 0x35        ; I/O APIC GSI 21 (PCI)
+InterruptServiceRoutine_NoErrorCode 0x36        ; I/O APIC GSI 22 (PCI)
+InterruptServiceRoutine_NoErrorCode 0x37        ; I/O APIC GSI 23 (PCI)
 
-InterruptServiceRoutine_NoErrorCode 0x80        ; System call (trap)
\ No newline at end of file
+InterruptServiceRoutine_NoErrorCode 0x80        ; System call (trap)
+InterruptServiceRoutine_NoErrorCode 0xFF        ; Local APIC spurious interrupt
+
+
+; --------------------- BEGIN: SYSENTER ---------------------
+
+; Fast system calls (SYSENTER/SYSEXIT), used by palmyra_syscall in unistd.cpp.
+; SYSENTER saves nothing: the caller passes eax = syscall number, ebx/ecx/edx/esi/edi = arguments,
+; ebp = user stack pointer and [ebp] = return address (ecx/edx are clobbered on return).
+; The stub builds the frame `int 0x80` would push from ring 3, so handlers and task switching are unchanged.
+; It never reads user memory: eip is left zero and userEsp points at the return address, which
+; SystemCallsManager::handleInterrupt loads once it has checked that the stack is user memory.
+; Frames are tagged in the error code: a tagged frame returns with SYSEXIT, any other with iret
+; (e.g. when the scheduler resumes a process that was interrupted).
+
+SYSENTER_FRAME equ 0x53595345  ; error code of frames built by sysenter_entry
+
+global sysenter_entry:function
+
+sysenter_entry:
+    mov esp, [esp]              ; SYSENTER_ESP is the address of TSS.esp0: load the kernel stack of the current task
+
+    push dword 0x23             ; ss        user data selector (RPL 3)
+    push ebp                    ; userEsp   user stack, return address still on it
+    pushfd                      ; eflags    (SYSENTER cleared IF)
+    or dword [esp], 0x200
+    push dword 0x1B             ; cs        user code selector (RPL 3)
+    push dword 0                ; eip       loaded by the handler from [userEsp]
+    push dword SYSENTER_FRAME   ; error code
+    push dword 0x80             ; interrupt number
+
+    pusha                       ; same layout as _primary_isr_handler (CPURegisters)
+    push_data_segment
+
+    mov ax, 16
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+
+    mov eax, cr3
+    push eax
+
+    push esp
+    call primary_isr_handler
+
+    mov esp, eax                ; the handler may have switched tasks
+    add esp, 4
+
+    pop eax                     ; Pop cr3
+    mov ebx, cr3
+    cmp eax, ebx
+    je .skipCR3Write
+    mov cr3, eax
+
+.skipCR3Write:
+    pop_data_segment
+    popa
+
+    cmp dword [esp + 4], SYSENTER_FRAME
+    jne .returnWithIret
+
+    mov edx, [esp + 8]          ; eip for SYSEXIT
+    mov ecx, [esp + 20]         ; user esp for SYSEXIT
+    add esp, 16                 ; skip intNo, error code, eip, cs: eflags on top
+    and dword [esp], ~0x200     ; keep IF clear until the sti below
+    popfd
+    sti                         ; takes effect after sysexit (interrupt shadow)
+    sysexit
+
+.returnWithIret:
+    add esp, 8                  ; Clean up the `error code` and `interrupt number` from the stack
+    iret
+
+; ---------------------- END: SYSENTER ----------------------
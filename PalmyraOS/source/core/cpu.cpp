@@ -12,12 +12,6 @@ uint32_t PalmyraOS::kernel::CPU::CPU_frequency_ = 0;
 uint32_t PalmyraOS::kernel::CPU::HSC_frequency_ = 0;
 
 
-uint64_t PalmyraOS::kernel::CPU::getTSC() {
-    uint32_t low  = read_tsc_low();
-    uint32_t high = read_tsc_high();
-    return (static_cast<uint64_t>(high) << 32) | low;
-}
-
 void PalmyraOS::kernel::CPU::delay(uint64_t cpu_ticks) {
     uint64_t end = getTSC() + cpu_ticks;
     while (getTSC() < end);
@@ -182,6 +176,42 @@ bool PalmyraOS::kernel::CPU::isSHAAvailable() {
     return result.ebx & (1 << 29);
 }
 
+bool PalmyraOS::kernel::CPU::isAPICAvailable() {
+    auto result = cpuid(1, 0);
+    return result.edx & (1 << 9);
+}
+
+bool PalmyraOS::kernel::CPU::isSysenterAvailable() {
+    auto result     = cpuid(1, 0);
+    uint32_t family = (result.eax >> 8) & 0xF;
+    uint32_t model  = (result.eax >> 4) & 0xF;
+    uint32_t step   = result.eax & 0xF;
+
+    // The Pentium Pro reports SEP without supporting it
+    if (family == 6 && model < 3 && step < 3) return false;
+    return result.edx & (1 << 11);
+}
+
+void PalmyraOS::kernel::CPU::initializeSysenter(uint16_t kernelCodeSelector, uint32_t stackPointer, void (*entryPoint)()) {
+    constexpr uint32_t IA32_SYSENTER_CS  = 0x174;
+    constexpr uint32_t IA32_SYSENTER_ESP = 0x175;
+    constexpr uint32_t IA32_SYSENTER_EIP = 0x176;
+
+    writeMSR(IA32_SYSENTER_CS, kernelCodeSelector);
+    writeMSR(IA32_SYSENTER_ESP, stackPointer);
+    writeMSR(IA32_SYSENTER_EIP, reinterpret_cast<uint32_t>(entryPoint));
+}
+
+uint64_t PalmyraOS::kernel::CPU::readMSR(uint32_t msr) {
+    uint32_t low, high;
+    __asm__ volatile("rdmsr" : "=a"(low), "=d"(high) : "c"(msr));
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+void PalmyraOS::kernel::CPU::writeMSR(uint32_t msr, uint64_t value) {
+    __asm__ volatile("wrmsr" : : "c"(msr), "a"(static_cast<uint32_t>(value)), "d"(static_cast<uint32_t>(value >> 32)));
+}
+
 uint32_t PalmyraOS::kernel::CPU::detectCpuFrequency() {
     /*
      * Here we measure the difference between the System Clock (ticks)
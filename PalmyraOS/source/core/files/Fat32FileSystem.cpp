@@ -1,6 +1,7 @@
 
 #include "core/files/Fat32FileSystem.h"
 #include "core/files/VirtualFileSystemBase.h"
+#include "core/memory/PageCache.h"
 #include "core/peripherals/Logger.h"
 #include "libs/memory.h"
 
@@ -131,9 +132,16 @@ bool PalmyraOS::kernel::vfs::FAT32Directory::deleteFile(const KString& name) {
     dirDentry.firstClusterHigh = static_cast<uint16_t>((directoryStartCluster_ >> 16) & 0xFFFF);
     DirectoryEntry parentDirEntry(0, directoryStartCluster_, KString("."), dirDentry);
 
+    // Running processes keep reading their executable on demand
+    auto* file = InodeBase::getDentry(name);
+    if (file && PageCache::isFilePinned(file)) return false;
+
     bool success = parentPartition_.deleteFile(parentDirEntry, name);
     if (!success) return false;
 
+    // Cached pages of the file can no longer be reached by a new lookup
+    if (file) PageCache::invalidate(file);
+
     InodeBase::removeDentry(name);
     return true;
 }
@@ -185,6 +193,9 @@ size_t PalmyraOS::kernel::vfs::FAT32Archive::read(char* buffer, size_t size, siz
 }
 
 size_t PalmyraOS::kernel::vfs::FAT32Archive::write(const char* buffer, size_t size, size_t offset) {
+    // The executable of a running process is busy (its pages are read on demand)
+    if (PageCache::isFilePinned(this)) return 0;
+
     // Convert buffer to KVector for FAT32Partition compatibility
     KVector<uint8_t> data(size);
     memcpy(data.data(), buffer, size);
@@ -192,6 +203,9 @@ size_t PalmyraOS::kernel::vfs::FAT32Archive::write(const char* buffer, size_t si
     // Delegate to partition-level write with offset
     bool success = parentPartition_.writeAtOffset(directoryEntry_, data, offset);
 
+    // New processes must read the new content (running instances keep the pages they mapped)
+    PageCache::invalidate(this);
+
     if (!success) {
         return 0;  // Write failed, return 0 bytes written
     }
@@ -206,10 +220,12 @@ size_t PalmyraOS::kernel::vfs::FAT32Archive::write(const char* buffer, size_t si
 int PalmyraOS::kernel::vfs::FAT32Archive::truncate(size_t newSize) {
     // For now support truncating to zero only
     if (newSize != 0) return -1;
+    if (PageCache::isFilePinned(this)) return -1;
 
     KVector<uint8_t> empty;
     bool ok = parentPartition_.write(directoryEntry_, empty);
     if (!ok) return -1;
+    PageCache::invalidate(this);
 
     // Update cached size and metadata locally
     InodeBase::size_ = 0;
@@ -58,6 +58,7 @@ namespace PalmyraOS::kernel::vfs {
     InodeBase* VirtualFileSystem::rootNode_    = nullptr;
     InodeBase* VirtualFileSystem::deviceInode_ = nullptr;
     InodeBase* VirtualFileSystem::binaryInode_ = nullptr;
+    Mutex VirtualFileSystem::treeLock_;
 
     InodeBase* VirtualFileSystem::traversePath(InodeBase& rootInode, const KVector<KString>& components) {
         InodeBase* currentInode = &rootInode;  // Start from the given root inode
@@ -77,7 +78,12 @@ namespace PalmyraOS::kernel::vfs {
         return currentInode;
     }
 
-    InodeBase* VirtualFileSystem::getInodeByPath(InodeBase& rootInode, const KString& path) { return traversePath(rootInode, path.split('/', true)); }
+    InodeBase* VirtualFileSystem::getInodeByPath(InodeBase& rootInode, const KString& path) {
+        KVector<KString> components = path.split('/', true);
+
+        LockGuard<Mutex> guard(treeLock_);
+        return traversePath(rootInode, components);
+    }
 
     InodeBase* VirtualFileSystem::getInodeByPath(const KString& path) {
         // Ensure the root node is initialized before proceeding
@@ -93,6 +99,11 @@ namespace PalmyraOS::kernel::vfs {
         // Ensure the root node is initialized before proceeding
         if (!rootNode_) kernelPanic("Called %s before initializing rootNode_", __PRETTY_FUNCTION__);
 
+        LockGuard<Mutex> guard(treeLock_);
+        return setInodeByPathUnlocked(path, inode);
+    }
+
+    bool VirtualFileSystem::setInodeByPathUnlocked(const KString& path, InodeBase* inode) {
         // Split the path into components using '/' as delimiter
         KVector<KString> components = path.split('/', true);
         if (components.empty()) return false;
@@ -116,6 +127,8 @@ namespace PalmyraOS::kernel::vfs {
         KVector<KString> components = path.split('/', true);
         if (components.empty()) return nullptr;
 
+        LockGuard<Mutex> guard(treeLock_);
+
         // Find the parent directory if it exists and is a directory
         InodeBase* currentInode = getParentDirectory(rootNode_, components);
         if (!currentInode) return nullptr;
@@ -124,7 +137,7 @@ namespace PalmyraOS::kernel::vfs {
         auto directory = kernel::heapManager.createInstance<InodeBase>(InodeBase::Type::Directory, mode, userId, groupId);
 
         // Set the new directory inode at the specified path
-        if (!setInodeByPath(path, directory)) {
+        if (!setInodeByPathUnlocked(path, directory)) {
             // Free the directory inode if setting it in the path failed
             kernel::heapManager.free(directory);
             return nullptr;
@@ -136,8 +149,14 @@ namespace PalmyraOS::kernel::vfs {
     InodeBase* VirtualFileSystem::getRootInode() { return rootNode_; }
 
     KVector<std::pair<KString, InodeBase*>> VirtualFileSystem::getContent(const KString& path) {
+        // Ensure the root node is initialized before proceeding
+        if (!rootNode_) kernelPanic("Called %s before initializing rootNode_", __PRETTY_FUNCTION__);
+
+        KVector<KString> components = path.split('/', true);
+        LockGuard<Mutex> guard(treeLock_);
+
         // Retrieve the inode at the specified path
-        InodeBase* inode = getInodeByPath(path);
+        InodeBase* inode = traversePath(*rootNode_, components);
 
         // Ensure the inode is a directory
         if (!inode || inode->getType() != InodeBase::Type::Directory) {
@@ -150,14 +169,22 @@ namespace PalmyraOS::kernel::vfs {
     }
 
     InodeBase::Type VirtualFileSystem::getType(const KString& path) {
+        // Ensure the root node is initialized before proceeding
+        if (!rootNode_) kernelPanic("Called %s before initializing rootNode_", __PRETTY_FUNCTION__);
+
+        KVector<KString> components = path.split('/', true);
+        LockGuard<Mutex> guard(treeLock_);
+
         // Retrieve the inode at the specified path
-        InodeBase* inode = getInodeByPath(path);
+        InodeBase* inode = traversePath(*rootNode_, components);
 
         // Return the type of the inode, or Invalid if not found
         return inode ? inode->getType() : InodeBase::Type::Invalid;
     }
 
     bool VirtualFileSystem::removeInodeByPath(const KString& path) {
+        LockGuard<Mutex> guard(treeLock_);
+
         // Find the parent directory inode
         InodeBase* parentInode = getParentDirectory(rootNode_, path.split('/', true));
 
@@ -3,6 +3,7 @@
 #include "core/Display.h"
 #include "core/acpi/ACPI.h"
 #include "core/acpi/ACPISpecific.h"
+#include "core/acpi/APIC.h"
 #include "core/acpi/HPET.h"
 #include "core/acpi/PowerManagement.h"
 #include "core/cpu.h"
@@ -401,6 +402,19 @@ bool PalmyraOS::kernel::initializeVirtualMemory(const Multiboot2::MultibootInfo&
         else { LOG_WARN("HPET initialized but physical address is NULL"); }
     }
 
+    // Map Local APIC and I/O APIC registers if discovered in the MADT (uncached MMIO)
+    if (APIC::isInitialized()) {
+        void* lapicAddr = reinterpret_cast<void*>(APIC::getLocalAPICAddress());
+        kernel::kernelPagingDirectory_ptr->mapPages(lapicAddr, lapicAddr, 1, PageFlags::Present | PageFlags::ReadWrite | PageFlags::CacheDisabled);
+        LOG_INFO("Mapping Local APIC registers by identity: 1 page at 0x%p", lapicAddr);
+
+        for (uint8_t i = 0; i < APIC::getIOAPICCount(); ++i) {
+            void* ioApicAddr = reinterpret_cast<void*>(APIC::getIOAPICAddress(i));
+            kernel::kernelPagingDirectory_ptr->mapPages(ioApicAddr, ioApicAddr, 1, PageFlags::Present | PageFlags::ReadWrite | PageFlags::CacheDisabled);
+            LOG_INFO("Mapping I/O APIC registers by identity: 1 page at 0x%p", ioApicAddr);
+        }
+    }
+
     // Map PCIe configuration space if available (get actual address from ACPI MCFG table)
     if (ACPI::isInitialized() && ACPI::getMCFG() != nullptr) {
         const auto* mcfg       = ACPI::getMCFG();
@@ -1180,6 +1194,10 @@ void PalmyraOS::kernel::initializeBinaries() {
     registerBuiltin("/bin/clock.elf", reinterpret_cast<vfs::BuiltinExecutableInode::EntryPoint>(PalmyraOS::Userland::builtin::KernelClock::main));
 
     registerBuiltin("/bin/udp_echo.elf", reinterpret_cast<vfs::BuiltinExecutableInode::EntryPoint>(PalmyraOS::Userland::tests::UDPEchoServer::main));
+
+    registerBuiltin("/bin/pipebench.elf", reinterpret_cast<vfs::BuiltinExecutableInode::EntryPoint>(PalmyraOS::Userland::tests::PipeBenchmark::main));
+
+    registerBuiltin("/bin/mallocbench.elf", reinterpret_cast<vfs::BuiltinExecutableInode::EntryPoint>(PalmyraOS::Userland::tests::MallocBenchmark::main));
 }
 
 bool PalmyraOS::kernel::reboot() {
@@ -0,0 +1,124 @@
+
+#include "core/memory/PageCache.h"
+#include "core/files/VirtualFileSystem.h"
+#include "core/kernel.h"
+#include "core/memory/paging.h"
+#include "core/panic.h"
+
+#include "libs/memory.h"
+#include "libs/stdio.h"
+
+
+// Globals
+PalmyraOS::kernel::KMap<uint64_t, void*> PalmyraOS::kernel::PageCache::pages_;
+PalmyraOS::kernel::KMap<void*, uint32_t> PalmyraOS::kernel::PageCache::references_;
+PalmyraOS::kernel::KMap<size_t, uint32_t> PalmyraOS::kernel::PageCache::pinned_;
+PalmyraOS::kernel::Mutex PalmyraOS::kernel::PageCache::lock_;
+uint64_t PalmyraOS::kernel::PageCache::hits_   = 0;
+uint64_t PalmyraOS::kernel::PageCache::misses_ = 0;
+
+void PalmyraOS::kernel::PageCache::initialize() {
+    auto statsNode = kernel::heapManager.createInstance<vfs::FunctionInode>(&readStatistics, nullptr, nullptr);
+    if (statsNode) vfs::VirtualFileSystem::setInodeByPath(KString("/proc/pagecache"), statsNode);
+}
+
+uint64_t PalmyraOS::kernel::PageCache::makeKey(vfs::InodeBase* inode, uint32_t pageIndex) {
+    // Inode numbers are never reused, unlike inode addresses
+    return (static_cast<uint64_t>(inode->getInodeNumber()) << 32) | pageIndex;
+}
+
+void* PalmyraOS::kernel::PageCache::acquire(vfs::InodeBase* inode, uint32_t pageIndex) {
+    LockGuard<Mutex> guard(lock_);
+
+    uint64_t key = makeKey(inode, pageIndex);
+    auto it      = pages_.find(key);
+    if (it != pages_.end()) {
+        hits_++;
+        references_[it->second]++;
+        return it->second;
+    }
+
+    misses_++;
+    void* frame = kernelPagingDirectory_ptr->allocatePage();
+    if (!frame) return nullptr;
+
+    // The tail of the last page (past the end of the file) reads as zeros
+    size_t bytesRead = inode->read(static_cast<char*>(frame), PAGE_SIZE, static_cast<size_t>(pageIndex) << PAGE_BITS);
+    if (bytesRead < PAGE_SIZE) memset(static_cast<uint8_t*>(frame) + bytesRead, 0, PAGE_SIZE - bytesRead);
+
+    // One reference for the index, one for the caller
+    pages_[key]        = frame;
+    references_[frame] = 2;
+    return frame;
+}
+
+void* PalmyraOS::kernel::PageCache::lookup(vfs::InodeBase* inode, uint32_t pageIndex) {
+    LockGuard<Mutex> guard(lock_);
+
+    auto it = pages_.find(makeKey(inode, pageIndex));
+    if (it == pages_.end()) return nullptr;
+
+    hits_++;
+    references_[it->second]++;
+    return it->second;
+}
+
+void PalmyraOS::kernel::PageCache::release(void* frame) {
+    LockGuard<Mutex> guard(lock_);
+    dropReference(frame);
+}
+
+void PalmyraOS::kernel::PageCache::invalidate(vfs::InodeBase* inode) {
+    LockGuard<Mutex> guard(lock_);
+
+    // Keys of one inode are contiguous: [inode << 32, (inode + 1) << 32)
+    auto first = pages_.lower_bound(makeKey(inode, 0));
+    auto last  = first;
+    while (last != pages_.end() && (last->first >> 32) == inode->getInodeNumber()) {
+        dropReference(last->second);
+        ++last;
+    }
+    pages_.erase(first, last);
+}
+
+void PalmyraOS::kernel::PageCache::pinFile(vfs::InodeBase* inode) {
+    LockGuard<Mutex> guard(lock_);
+    pinned_[inode->getInodeNumber()]++;
+}
+
+void PalmyraOS::kernel::PageCache::unpinFile(vfs::InodeBase* inode) {
+    LockGuard<Mutex> guard(lock_);
+
+    auto it = pinned_.find(inode->getInodeNumber());
+    if (it == pinned_.end()) return;
+    if (--it->second == 0) pinned_.erase(it);
+}
+
+bool PalmyraOS::kernel::PageCache::isFilePinned(vfs::InodeBase* inode) {
+    LockGuard<Mutex> guard(lock_);
+    return pinned_.find(inode->getInodeNumber()) != pinned_.end();
+}
+
+void PalmyraOS::kernel::PageCache::dropReference(void* frame) {
+    auto it = references_.find(frame);
+    if (it == references_.end()) kernelPanic("PageCache: release of unknown frame 0x%X", frame);
+
+    if (--it->second > 0) return;
+    references_.erase(it);
+    kernelPagingDirectory_ptr->freePage(frame);
+}
+
+size_t PalmyraOS::kernel::PageCache::readStatistics(char* buffer, size_t size, size_t offset) {
+    char text[128];
+    size_t length = 0;
+    {
+        LockGuard<Mutex> guard(lock_);
+        length = snprintf(text, sizeof(text), "hits %llu\nmisses %llu\ncached %u\nframes %u\n", hits_, misses_, pages_.size(), references_.size());
+    }
+
+    if (offset >= length) return 0;
+    size_t count = length - offset;
+    if (count > size) count = size;
+    memcpy(buffer, text + offset, count);
+    return count;
+}
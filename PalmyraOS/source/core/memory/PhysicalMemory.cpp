@@ -134,8 +134,16 @@ void* PalmyraOS::kernel::PhysicalMemory::allocateFrames(uint32_t num) {
 void PalmyraOS::kernel::PhysicalMemory::freeFrames(void* frame, uint32_t num) {
     // Calculate the starting frame index from the frame address
     uint32_t firstFrame = (uint32_t) frame >> PAGE_BITS;
-
-    for (int i = 0; i < num; ++i) { unmarkFrame(firstFrame + i); }
+    uint32_t lastFrame  = firstFrame + num;
+    uint32_t current    = firstFrame;
+
+    // Unaligned head, then whole 32-frame words, then the tail
+    while (current < lastFrame && OFFSET_FROM_BIT(current) != 0) unmarkFrame(current++);
+    while (current + 32 <= lastFrame) {
+        frameBits_[INDEX_FROM_BIT(current)] = 0;
+        current += 32;
+    }
+    while (current < lastFrame) unmarkFrame(current++);
 
     allocatedFrames_ -= num;  // Reduce allocated frame count
     freeFramesCount_ += num;  // Increase free frame count
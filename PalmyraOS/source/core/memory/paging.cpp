@@ -3,9 +3,12 @@
 #include "core/kernel.h"
 #include "core/memory/PhysicalMemory.h"
 #include "core/panic.h"
+#include "core/Trace.h"
 #include "core/peripherals/Logger.h"
 #include "core/tasks/ProcessManager.h"
 #include "libs/memory.h"
+#include "palmyraOS/errono.h"
+#include "palmyraOS/unistd.h"  // EXIT_PAGE_FAULT
 
 // External functions from assembly (paging.asm)
 extern "C" void set_page_directory(uint32_t*);
@@ -277,6 +280,15 @@ bool PalmyraOS::kernel::PagingDirectory::isAddressValid(void* address) {
     return true;
 }
 
+bool PalmyraOS::kernel::PagingDirectory::isUserAccessible(void* address) {
+    if (!isAddressValid(address)) return false;
+
+    auto virtualAddr    = (uint32_t) address;
+    uint32_t tableIndex = virtualAddr >> 22;
+    uint32_t pageIndex  = (virtualAddr >> 12) & 0x3FF;
+    return pageDirectory_[tableIndex].user && pageTables_[tableIndex][pageIndex].user;
+}
+
 void* PalmyraOS::kernel::PagingDirectory::getPhysicalAddress(void* address) {
     if (address == nullptr) return nullptr;
 
@@ -343,6 +355,39 @@ void PalmyraOS::kernel::PagingDirectory::freePage(void* pageAddress) {
     unmapPage(pageAddress);
 }
 
+void PalmyraOS::kernel::PagingDirectory::freePages(void* pageAddress, size_t numPages) {
+    if (pageAddress == nullptr || numPages == 0) return;
+
+    // Physically contiguous run collected so far (released with a single freeFrames)
+    uint32_t runStart  = 0;
+    uint32_t runLength = 0;
+
+    for (size_t i = 0; i < numPages; ++i) {
+        auto virtualAddr    = (uint32_t) pageAddress + (i << PAGE_BITS);
+        uint32_t tableIndex = virtualAddr >> 22;
+        uint32_t pageIndex  = (virtualAddr >> 12) & 0x3FF;
+
+        if (!pageDirectory_[tableIndex].present) kernelPanic("Attempted to free a page from a non-present table");
+
+        PageTableEntry* entry = &pageTables_[tableIndex][pageIndex];
+        if (!entry->present) kernelPanic("Attempted to free a non-present page");
+
+        uint32_t physicalAddr = entry->physicalAddress << 12;
+
+        // Flush the pending run when this frame does not extend it
+        if (runLength > 0 && physicalAddr != runStart + (runLength << PAGE_BITS)) {
+            PhysicalMemory::freeFrames((void*) runStart, runLength);
+            runLength = 0;
+        }
+        if (runLength == 0) runStart = physicalAddr;
+        runLength++;
+
+        unmapPage((void*) virtualAddr);
+    }
+
+    PhysicalMemory::freeFrames((void*) runStart, runLength);
+}
+
 void PalmyraOS::kernel::PagingDirectory::mapPages(void* physicalAddr, void* virtualAddr, uint32_t numPages, PalmyraOS::kernel::PageFlags flags) {
     for (int i = 0; i < numPages; ++i) {
         auto physicalAddr_ = (uint32_t) physicalAddr + (i * PAGE_SIZE);
@@ -419,97 +464,105 @@ void* PalmyraOS::kernel::PagingManager::allocatePages(size_t numPages) {
 void PalmyraOS::kernel::PagingManager::setSecondaryPageFaultHandler(PageFaultHandler handler) { secondaryHandler_ = handler; }
 
 uint32_t* PalmyraOS::kernel::PagingManager::handlePageFault(interrupts::CPURegisters* regs) {
-
-    // Original page fault handling code
+    void* frame = regs;  // Returned unchanged: retry the faulting instruction
     uint32_t faultingAddress;
     asm volatile("mov %%cr2, %0" : "=r"(faultingAddress));
+    TRACE(PageFault, faultingAddress, regs->errorCode);
 
     bool present          = regs->errorCode & 0x1;
     bool write            = regs->errorCode & 0x2;
     bool userMode         = regs->errorCode & 0x4;
-    bool reserved         = regs->errorCode & 0x8;
     bool instructionFetch = regs->errorCode & 0x10;
 
-    if (secondaryHandler_) { secondaryHandler_(regs, faultingAddress, present, write, userMode, instructionFetch); }
-    else {
-        // Fetch current process
-        auto& currentProcess = *TaskManager::getCurrentProcess();
-        auto pid             = currentProcess.getPid();
-        auto userStack       = currentProcess.getUserStack();
-        bool stackOverflow   = currentProcess.checkStackOverflow();
-
-        // Get Indices
-        uint32_t tableIndex  = (uint32_t) faultingAddress >> 22;
-        uint32_t pageIndex   = ((uint32_t) faultingAddress >> 12) & 0x3FF;
-
-        // Kernel Paging Directory
-        auto _kernelTable    = currentPageDirectory_->getTable(tableIndex);
-        auto* kernelTable    = currentPageDirectory_->getTable(tableIndex, PageFlags::UserSupervisor);
-        auto* kernelEntry    = (PageTableEntry*) &kernelTable[pageIndex];
-
-        // User Paging Directory
-        auto* procPDir       = currentProcess.getPagingDirectory();
-        auto _userTable      = procPDir->getTable(tableIndex);
-        uint32_t* userTable  = procPDir->getTable(tableIndex, PageFlags::UserSupervisor);
-        auto* userEntry      = (PageTableEntry*) &userTable[pageIndex];
-
-        // Handle page fault by triggering a kernel panic  TODO (for example, crash current process)
-        kernelPanic("Page Fault (0x%X) (0x%X) at 0x%X\n"
-                    "System: CR3: 0x%X, Kernel CR3: 0x%X\n"
-                    "--------------------------\n"
-                    "isPresent: %s\n"
-                    "isWrite: %s\n"
-                    "isUser: %s\n"
-                    "isInstructionFetch: %s\n"
-                    "Faulting Instruction: 0x%X\n"
-                    "---USER / KERNEL---------\n"
-                    "Process: %d\n"
-                    "PageTable has User Privileges: %s / %s\n"
-                    "PageTable Physical Address   : 0x%X / 0x%X\n"
-                    "Page Address                 : 0x%X / 0x%X\n"
-                    "Page is present              : %s / %s\n"
-                    "Page has User Privileges     : %s / %s\n"
-                    "Page has RW Privileges       : %s / %s\n"
-                    "Page Physical Address        : 0x%X / 0x%X\n"
-                    "--------------------------\n"
-                    "User Stack: 0x%X\n"
-                    "Stack Overflow: %s\n"
-                    "Process entry EIP: 0x%X\n"
-                    "Process last EIP : 0x%X\n"
-                    "argvBlock        : 0x%X\n",
-                    regs->intNo,
-                    regs->errorCode,
-                    faultingAddress,
-                    currentPageDirectory_->getDirectory(),
-                    kernel::kernelPagingDirectory_ptr->getDirectory(),
-                    (present ? "YES" : "NO"),
-                    (write ? "YES" : "NO"),
-                    (userMode ? "YES" : "NO"),
-                    (instructionFetch ? "YES" : "NO"),
-                    regs->eip,
-                    pid,
-                    (_userTable.user ? "YES" : "NO "),
-                    (_kernelTable.user ? "YES" : "NO"),
-                    (_userTable.tableAddress << 12),
-                    (_kernelTable.tableAddress << 12),
-                    (userEntry),
-                    (kernelEntry),
-                    (userEntry->present ? "YES" : "NO "),
-                    (kernelEntry->present ? "YES" : "NO"),
-                    (userEntry->user ? "YES" : "NO "),
-                    (kernelEntry->user ? "YES" : "NO"),
-                    (userEntry->rw ? "YES" : "NO "),
-                    (kernelEntry->rw ? "YES" : "NO"),
-                    (userEntry->physicalAddress << 12),
-                    (kernelEntry->physicalAddress << 12),
-                    userStack,
-                    (stackOverflow ? "YES" : "NO"),
-                    currentProcess.debug_.entryEip,
-                    currentProcess.debug_.lastWorkingEip,
-                    currentProcess.debug_.argvBlock);
+    // Lazily backed pages are mapped here (only faults taken in the process's own directory)
+    if (TaskManager::hasCurrentProcess()) {
+        auto* process = TaskManager::getCurrentProcess();
+        if (regs->cr3 == reinterpret_cast<uint32_t>(process->getPagingDirectory()->getDirectory()) && process->handlePageFault(faultingAddress, write)) {
+            return static_cast<uint32_t*>(frame);
+        }
+    }
+
+    if (secondaryHandler_) {
+        secondaryHandler_(regs, faultingAddress, present, write, userMode, instructionFetch);
+        return static_cast<uint32_t*>(frame);
+    }
+
+    // An invalid access of user code only costs its own process
+    if (userMode && TaskManager::hasCurrentProcess()) return terminateFaultingProcess(regs, faultingAddress, EXIT_PAGE_FAULT);
+
+    // A user address inside an explicit user-copy window: the caller pays, as for isValidAddress() failures. Anything else is a kernel bug
+    if (TaskManager::isInUserCopy(faultingAddress)) return terminateFaultingProcess(regs, faultingAddress, -EFAULT);
+
+    reportKernelFault(regs, faultingAddress);
+    return static_cast<uint32_t*>(frame);
+}
+
+const char* PalmyraOS::kernel::PagingManager::describeFault(uint32_t errorCode) {
+    bool present = errorCode & 0x1;
+    if (errorCode & 0x10) return present ? "execute, protection" : "execute, not mapped";
+    if (errorCode & 0x2) return present ? "write, protection" : "write, not mapped";
+    return present ? "read, protection" : "read, not mapped";
+}
+
+uint32_t* PalmyraOS::kernel::PagingManager::terminateFaultingProcess(interrupts::CPURegisters* regs, uint32_t faultingAddress, int exitCode) {
+    auto* process = TaskManager::getCurrentProcess();
+    LOG_ERROR("Process %d (%s) terminated: page fault at 0x%X (%s) by EIP 0x%X",
+              process->getPid(),
+              process->getCommandName().c_str(),
+              faultingAddress,
+              describeFault(regs->errorCode),
+              regs->eip);
+
+    // Like exit_group: the whole thread group goes, and waitpid() reports the exit code
+    process->getThreadGroupLeader()->terminate(exitCode);
+    process->terminate(exitCode);
+
+    // Never return to the faulting instruction
+    return TaskManager::interruptHandler(regs);
+}
+
+void PalmyraOS::kernel::PagingManager::reportKernelFault(interrupts::CPURegisters* regs, uint32_t faultingAddress) {
+    // Kept short: the record has to fit on the panic screen and in one log line
+    int pid             = -1;
+    const char* command = "none";
+    uint32_t userStack  = 0;
+    if (TaskManager::hasCurrentProcess()) {
+        auto* process = TaskManager::getCurrentProcess();
+        pid           = static_cast<int>(process->getPid());
+        command       = process->getCommandName().c_str();
+        userStack     = process->getUserStack();
     }
 
-    return (uint32_t*) regs;
+    bool mapped = kernelPagingDirectory_ptr && kernelPagingDirectory_ptr->isAddressValid(reinterpret_cast<void*>(faultingAddress));
+    LOG_ERROR("Kernel page fault at 0x%X (%s) by EIP 0x%X, CR3 0x%X, PID %d", faultingAddress, describeFault(regs->errorCode), regs->eip, regs->cr3, pid);
+
+    kernelPanic("Page Fault in kernel mode\n"
+                "Address: 0x%X (%s), mapped in the kernel directory: %s\n"
+                "EIP: 0x%X  CS: 0x%X  EFLAGS: 0x%X  Error: 0x%X\n"
+                "CR3: 0x%X  Kernel CR3: 0x%X\n"
+                "EAX: 0x%X  EBX: 0x%X  ECX: 0x%X  EDX: 0x%X\n"
+                "ESI: 0x%X  EDI: 0x%X  EBP: 0x%X  ESP: 0x%X\n"
+                "Process: %d (%s)  User stack: 0x%X\n",
+                faultingAddress,
+                describeFault(regs->errorCode),
+                mapped ? "YES" : "NO",
+                regs->eip,
+                regs->cs,
+                regs->eflags,
+                regs->errorCode,
+                regs->cr3,
+                kernelPagingDirectory_ptr ? reinterpret_cast<uint32_t>(kernelPagingDirectory_ptr->getDirectory()) : 0,
+                regs->eax,
+                regs->ebx,
+                regs->ecx,
+                regs->edx,
+                regs->esi,
+                regs->edi,
+                regs->ebp,
+                regs->esp,
+                pid,
+                command,
+                userStack);
 }
 
 bool PalmyraOS::kernel::PagingManager::isEnabled() { return is_paging_enabled(); }
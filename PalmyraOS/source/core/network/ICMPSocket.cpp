@@ -4,6 +4,7 @@
 #include "core/peripherals/Logger.h"
 #include "libs/memory.h"
 #include "palmyraOS/errono.h"
+#include "palmyraOS/poll.h"
 #include "palmyraOS/socket.h"
 
 namespace PalmyraOS::kernel {
@@ -124,18 +125,23 @@ namespace PalmyraOS::kernel {
             return -EBADF;
         }
 
-        // Check if data available
-        if (receiveQueue_->empty()) {
-            if (nonBlocking_) {
-                return -EAGAIN;
+        // Pop packet from queue (the data is copied after releasing the lock)
+        Packet pkt;
+        {
+            LockGuard<SpinLock> guard(queueLock_);
+
+            // Check if data available
+            if (receiveQueue_->empty()) {
+                if (nonBlocking_) {
+                    return -EAGAIN;
+                }
+                // Blocking mode - return 0 for now (would need sleep/wake mechanism)
+                return 0;
             }
-            // Blocking mode - return 0 for now (would need sleep/wake mechanism)
-            return 0;
-        }
 
-        // Pop packet from queue
-        Packet pkt = std::move(receiveQueue_->front());
-        receiveQueue_->pop();
+            pkt = std::move(receiveQueue_->front());
+            receiveQueue_->pop();
+        }
 
         // Copy data to buffer
         size_t copySize = (pkt.size < length) ? pkt.size : length;
@@ -150,12 +156,18 @@ namespace PalmyraOS::kernel {
     }
 
     int ICMPSocket::getBytesAvailable() const {
+        LockGuard<SpinLock> guard(queueLock_);
         if (!receiveQueue_ || receiveQueue_->empty()) {
             return 0;
         }
         return receiveQueue_->front().size;
     }
 
+    bool ICMPSocket::hasPendingData() const {
+        LockGuard<SpinLock> guard(queueLock_);
+        return receiveQueue_ && !receiveQueue_->empty();
+    }
+
     int ICMPSocket::close() {
         state_ = State::Unbound;
         return 0;
@@ -249,12 +261,6 @@ namespace PalmyraOS::kernel {
             return;  // Ignore packets from other sources
         }
 
-        // Check queue size limit
-        if (receiveQueue_->size() >= MAX_QUEUE_SIZE) {
-            LOG_WARN("ICMPSocket: Receive queue full, dropping ICMP packet");
-            return;
-        }
-
         // Allocate packet data
         uint8_t* packetData = (uint8_t*)heapManager.alloc(length);
         if (!packetData) {
@@ -271,7 +277,18 @@ namespace PalmyraOS::kernel {
         pkt.data  = packetData;
         pkt.size  = length;
 
-        receiveQueue_->push(std::move(pkt));
+        // Enqueue unless the queue is full (a dropped packet frees its data)
+        bool queued;
+        {
+            LockGuard<SpinLock> guard(queueLock_);
+            queued = receiveQueue_->size() < MAX_QUEUE_SIZE;
+            if (queued) receiveQueue_->push(std::move(pkt));
+        }
+        if (!queued) {
+            LOG_WARN("ICMPSocket: Receive queue full, dropping ICMP packet");
+            return;
+        }
+        pollSource_.notify(POLLIN);
 
         LOG_DEBUG("ICMPSocket: Queued ICMP packet from %u.%u.%u.%u (%u bytes)", (srcIP >> 24) & 0xFF,
                   (srcIP >> 16) & 0xFF, (srcIP >> 8) & 0xFF, srcIP & 0xFF, length);
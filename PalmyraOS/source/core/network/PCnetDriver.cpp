@@ -1,5 +1,7 @@
 #include "core/network/PCnetDriver.h"
+#include "core/DeferredWork.h"
 #include "core/SystemClock.h"
+#include "core/Trace.h"
 #include "core/kernel.h"
 #include "core/network/ARP.h"
 #include "core/network/Ethernet.h"
@@ -43,33 +45,11 @@ namespace PalmyraOS::kernel {
         uint8_t irqPin = PCIe::readConfig8(bus_, device_, function_, 0x3D);  // Interrupt PIN
         LOG_INFO("PCnet: PCI Interrupt Line: IRQ%u, PIN: INT%c", irqLine_, 'A' + irqPin - 1);
 
-        // Register interrupt handler (IRQ x → interrupt vector 0x20 + x)
-        if (irqLine_ != 0 && irqLine_ < 16) {
-            uint8_t irqVector = 0x20 + irqLine_;
-            interrupts::InterruptController::setInterruptHandler(irqVector, &PCnetDriver::handleInterruptTrampoline);
+        // Register the interrupt handler and route the INTx line (I/O APIC, level-triggered, or the 8259 PIC)
+        uint8_t irqVector = interrupts::InterruptController::enablePCIInterrupt(irqLine_, &PCnetDriver::handleInterruptTrampoline);
+        if (irqVector != 0) {
             LOG_INFO("PCnet: Registered interrupt handler for IRQ%u (vector 0x%02X)", irqLine_, irqVector);
 
-            // Explicitly unmask this IRQ in the PIC
-            // IRQ 0-7: Master PIC (port 0x21), IRQ 8-15: Slave PIC (port 0xA1)
-            if (irqLine_ >= 8) {
-                // Slave PIC - unmask bit (irqLine_ - 8)
-                ports::BytePort picData(0xA1);
-                uint8_t maskBefore = picData.read();
-                uint8_t maskAfter  = maskBefore & ~(1 << (irqLine_ - 8));  // Clear bit to unmask
-                picData.write(maskAfter);
-                uint8_t maskVerify = picData.read();
-                LOG_INFO("PCnet: Slave PIC IRQ%u: mask before=0x%02X, after=0x%02X, verify=0x%02X", irqLine_, maskBefore, maskAfter, maskVerify);
-            }
-            else {
-                // Master PIC - unmask bit irqLine_
-                ports::BytePort picData(0x21);
-                uint8_t maskBefore = picData.read();
-                uint8_t maskAfter  = maskBefore & ~(1 << irqLine_);  // Clear bit to unmask
-                picData.write(maskAfter);
-                uint8_t maskVerify = picData.read();
-                LOG_INFO("PCnet: Master PIC IRQ%u: mask before=0x%02X, after=0x%02X, verify=0x%02X", irqLine_, maskBefore, maskAfter, maskVerify);
-            }
-
             // Diagnostic: Check PCI Command Register (bit 10 = Interrupt Disable)
             uint16_t pciCommand    = PCIe::readConfig16(bus_, device_, function_, 0x04);
             bool interruptDisabled = pciCommand & (1 << 10);
@@ -463,6 +443,7 @@ namespace PalmyraOS::kernel {
 
         // Update statistics (success) with actual transmitted length
         updateStatistics(txLen, true, false);
+        TRACE(PacketTx, txLen);
 
         // Advance to next descriptor (round-robin)
         currentTx_ = (currentTx_ + 1) % TX_RING_SIZE;
@@ -560,7 +541,7 @@ namespace PalmyraOS::kernel {
 
     uint32_t* PCnetDriver::handleInterruptTrampoline(interrupts::CPURegisters* regs) {
         // Get the default network interface (assumes single network interface)
-        LOG_INFO("PCnet: *** IRQ9 HARDWARE INTERRUPT FIRED! *** CSR0 check follows...");
+        LOG_DEBUG("PCnet: *** IRQ9 HARDWARE INTERRUPT FIRED! *** CSR0 check follows...");
         auto* networkInterface = NetworkManager::getDefaultInterface();
         if (networkInterface) { networkInterface->handleInterrupt(); }
         else { LOG_ERROR("PCnet: IRQ9 fired but no network interface available!"); }
@@ -591,10 +572,6 @@ namespace PalmyraOS::kernel {
         bool hasINTR  = csr0 & INTR;
         if (hasRINT || hasTINT) { LOG_DEBUG("PCnet: handleInterrupt() CSR0=0x%X (RINT=%d, TINT=%d, INTR=%d)", csr0, hasRINT, hasTINT, hasINTR); }
 
-        // ALWAYS poll for received packets (for ARP polling)
-        // In a real OS, this would only be called on actual interrupts
-        processReceivedPackets();
-
         // Handle RX interrupt (clear flag if set)
         if (csr0 & RINT) {
             writeCSR(CSR0, csr0 | RINT);  // Clear RX interrupt
@@ -611,6 +588,18 @@ namespace PalmyraOS::kernel {
             LOG_ERROR("PCnet: Error interrupt (CSR0=0x%X)", csr0);
             writeCSR(CSR0, csr0 | ERR);  // Clear error flag
         }
+
+        // ALWAYS poll for received packets (for ARP polling), but outside the interrupt:
+        // ARP/IPv4/UDP demux and socket delivery allocate and may take a while
+        if (!receiveWorkPending_) receiveWorkPending_ = DeferredWork::schedule(&PCnetDriver::receiveWork, this);
+    }
+
+    void PCnetDriver::receiveWork(void* context, [[maybe_unused]] uint32_t argument) {
+        auto* driver                = static_cast<PCnetDriver*>(context);
+
+        // Clear first: packets arriving while we walk the ring queue another pass
+        driver->receiveWorkPending_ = false;
+        driver->processReceivedPackets();
     }
 
     // ==================== Received Packet Processing ====================
@@ -647,6 +636,7 @@ namespace PalmyraOS::kernel {
 
                         // Update interface statistics (successful packet reception)
                         updateStatistics(frameLength, false, false);
+                        TRACE(PacketRx, frameLength);
                         packetsProcessedCount++;
                     }
                 }
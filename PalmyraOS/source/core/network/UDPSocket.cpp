@@ -4,6 +4,7 @@
 #include "core/peripherals/Logger.h"
 #include "libs/memory.h"
 #include "palmyraOS/errono.h"
+#include "palmyraOS/poll.h"
 #include "palmyraOS/socket.h"
 
 namespace PalmyraOS::kernel {
@@ -176,18 +177,23 @@ namespace PalmyraOS::kernel {
             return -EBADF;
         }
 
-        // Check if data available
-        if (receiveQueue_->empty()) {
-            if (nonBlocking_) {
-                return -EAGAIN;
+        // Pop packet from queue (the data is copied after releasing the lock)
+        Packet pkt;
+        {
+            LockGuard<SpinLock> guard(queueLock_);
+
+            // Check if data available
+            if (receiveQueue_->empty()) {
+                if (nonBlocking_) {
+                    return -EAGAIN;
+                }
+                // Blocking mode - return 0 for now (would need sleep/wake mechanism)
+                return 0;
             }
-            // Blocking mode - return 0 for now (would need sleep/wake mechanism)
-            return 0;
-        }
 
-        // Pop packet from queue
-        Packet pkt = std::move(receiveQueue_->front());
-        receiveQueue_->pop();
+            pkt = std::move(receiveQueue_->front());
+            receiveQueue_->pop();
+        }
 
         // Copy data to buffer
         size_t copySize = (pkt.size < length) ? pkt.size : length;
@@ -202,6 +208,7 @@ namespace PalmyraOS::kernel {
     }
 
     int UDPSocket::getBytesAvailable() const {
+        LockGuard<SpinLock> guard(queueLock_);
         if (!receiveQueue_ || receiveQueue_->empty()) {
             return 0;
         }
@@ -209,6 +216,11 @@ namespace PalmyraOS::kernel {
         return receiveQueue_->front().size;
     }
 
+    bool UDPSocket::hasPendingData() const {
+        LockGuard<SpinLock> guard(queueLock_);
+        return receiveQueue_ && !receiveQueue_->empty();
+    }
+
     int UDPSocket::close() {
         if (state_ != State::Unbound && localPort_ != 0) {
             UDP::unbindPort(localPort_);
@@ -325,12 +337,6 @@ namespace PalmyraOS::kernel {
             return;
         }
 
-        // Check queue size limit
-        if (receiveQueue_->size() >= MAX_QUEUE_SIZE) {
-            LOG_WARN("UDPSocket: Receive queue full, dropping packet");
-            return;
-        }
-
         // Allocate packet data
         uint8_t* packetData = (uint8_t*)heapManager.alloc(length);
         if (!packetData) {
@@ -348,7 +354,18 @@ namespace PalmyraOS::kernel {
         pkt.data    = packetData;
         pkt.size    = length;
 
-        receiveQueue_->push(std::move(pkt));
+        // Enqueue unless the queue is full (a dropped packet frees its data)
+        bool queued;
+        {
+            LockGuard<SpinLock> guard(queueLock_);
+            queued = receiveQueue_->size() < MAX_QUEUE_SIZE;
+            if (queued) receiveQueue_->push(std::move(pkt));
+        }
+        if (!queued) {
+            LOG_WARN("UDPSocket: Receive queue full, dropping packet");
+            return;
+        }
+        pollSource_.notify(POLLIN);
 
         LOG_INFO("UDPSocket: Queued packet from %u.%u.%u.%u:%u (%u bytes)", (srcIP >> 24) & 0xFF, (srcIP >> 16) & 0xFF,
                  (srcIP >> 8) & 0xFF, srcIP & 0xFF, srcPort, length);
@@ -1,6 +1,7 @@
 
 #include "core/peripherals/ATA.h"
 #include "core/SystemClock.h"
+#include "core/Trace.h"
 #include "core/cpu.h"
 #include "core/peripherals/Logger.h"
 #include "libs/memory.h"
@@ -81,7 +82,10 @@ namespace PalmyraOS::kernel {
             return false;
         }
 
-        return executeCommand(Command::ReadSectors, logicalBlockAddress, 1, buffer, timeout) && checkStatus();
+        TRACE(BlockIoStart, logicalBlockAddress, 1);
+        bool success = executeCommand(Command::ReadSectors, logicalBlockAddress, 1, buffer, timeout) && checkStatus();
+        TRACE(BlockIoEnd, logicalBlockAddress, success);
+        return success;
     }
 
     bool ATA::writeSector(uint32_t logicalBlockAddress, const uint8_t* buffer, uint32_t timeout) {
@@ -91,7 +95,10 @@ namespace PalmyraOS::kernel {
             return false;
         }
 
-        return executeCommand(Command::WriteSectors, logicalBlockAddress, 1, const_cast<uint8_t*>(buffer), timeout) && checkStatus();
+        TRACE(BlockIoStart, logicalBlockAddress, 1 | 0x80000000);
+        bool success = executeCommand(Command::WriteSectors, logicalBlockAddress, 1, const_cast<uint8_t*>(buffer), timeout) && checkStatus();
+        TRACE(BlockIoEnd, logicalBlockAddress, success);
+        return success;
     }
 
     bool ATA::waitForBusy(uint32_t timeout) {
@@ -1,5 +1,6 @@
 
 #include "core/peripherals/Keyboard.h"
+#include "core/DeferredWork.h"
 #include "core/tasks/WindowManager.h"
 
 
@@ -20,16 +21,13 @@ const char qwertzToAscii[128] = {0,
 PalmyraOS::kernel::ports::BytePort PalmyraOS::kernel::Keyboard::commandPort_(0x64);
 PalmyraOS::kernel::ports::BytePort PalmyraOS::kernel::Keyboard::dataPort_(0x60);
 
-size_t PalmyraOS::kernel::Keyboard::buffer_last_index_          = 0;
-char PalmyraOS::kernel::Keyboard::buffer_[Keyboard::bufferSize] = {0};
-
-bool PalmyraOS::kernel::Keyboard::isShiftPressed_               = false;
-bool PalmyraOS::kernel::Keyboard::isCtrlPressed_                = false;
-bool PalmyraOS::kernel::Keyboard::isAltPressed_                 = false;
-bool PalmyraOS::kernel::Keyboard::isCapsLockOn_                 = false;
-bool PalmyraOS::kernel::Keyboard::isNumLockOn_                  = false;
-bool PalmyraOS::kernel::Keyboard::isScrollLockOn_               = false;
-uint64_t PalmyraOS::kernel::Keyboard::counter_                  = 0;
+bool PalmyraOS::kernel::Keyboard::isShiftPressed_ = false;
+bool PalmyraOS::kernel::Keyboard::isCtrlPressed_  = false;
+bool PalmyraOS::kernel::Keyboard::isAltPressed_   = false;
+bool PalmyraOS::kernel::Keyboard::isCapsLockOn_   = false;
+bool PalmyraOS::kernel::Keyboard::isNumLockOn_    = false;
+bool PalmyraOS::kernel::Keyboard::isScrollLockOn_ = false;
+uint64_t PalmyraOS::kernel::Keyboard::counter_    = 0;
 
 bool PalmyraOS::kernel::Keyboard::initialize() {
     // Disable the keyboard
@@ -122,17 +120,30 @@ void PalmyraOS::kernel::Keyboard::initializeLockKeys() {
 }
 
 uint32_t* PalmyraOS::kernel::Keyboard::handleInterrupt(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    void* frame    = regs;  // Returned unchanged: the keyboard never switches tasks
 
     // Ensure the interrupt is for the keyboard (IRQ1 corresponds to interrupt vector 0x21)
     uint8_t status = commandPort_.read();
 
     // Check if the data is from the keyboard
-    if (status & 0x20) return (uint32_t*) regs;
+    if (status & 0x20) return static_cast<uint32_t*>(frame);
+
+    uint8_t scancode = dataPort_.read();
+
+    // Controller acknowledgements (e.g. after an LED update) are not keys
+    if (scancode == 0xFA) return static_cast<uint32_t*>(frame);
 
     counter_++;
 
-    uint8_t keyIndex = dataPort_.read();
-    KeyState state   = KeyState::PRESSED;
+    // Translation, lock LEDs and window dispatch run as a bottom half (FIFO keeps the key order)
+    DeferredWork::schedule(&processScancode, nullptr, scancode);
+
+    return static_cast<uint32_t*>(frame);
+}
+
+void PalmyraOS::kernel::Keyboard::processScancode([[maybe_unused]] void* context, uint32_t scancode) {
+    auto keyIndex  = static_cast<uint8_t>(scancode);
+    KeyState state = KeyState::PRESSED;
 
     if (keyIndex >= 0x80) {
         keyIndex -= 0x80;
@@ -156,16 +167,9 @@ uint32_t* PalmyraOS::kernel::Keyboard::handleInterrupt(PalmyraOS::kernel::interr
         if (state == KeyState::PRESSED) toggleLockKeys(keyIndex);
     }
 
-    buffer_last_index_++;
-    if (buffer_last_index_ >= bufferSize) buffer_last_index_ = 0;
-
-    buffer_[buffer_last_index_] = qwertzToAscii[keyIndex];
-
-    if (/*state == KeyState::RELEASED && */ buffer_[buffer_last_index_] != 0) {
-        WindowManager::queueKeyboardEvent({buffer_[buffer_last_index_], state == KeyState::PRESSED, isCtrlPressed_, isShiftPressed_, isAltPressed_, true});
-    }
-
-    return (uint32_t*) regs;
+    // No buffering here: every key goes straight to the window manager, which queues it in the ring of the focused window
+    char key = qwertzToAscii[keyIndex];
+    if (key != 0) WindowManager::queueKeyboardEvent({key, state == KeyState::PRESSED, isCtrlPressed_, isShiftPressed_, isAltPressed_, true});
 }
 
 void PalmyraOS::kernel::Keyboard::waitForInputBufferEmpty() {
@@ -1,5 +1,6 @@
 
 #include "core/peripherals/Mouse.h"
+#include "core/DeferredWork.h"
 #include "core/cpu.h"
 #include "core/tasks/WindowManager.h"
 
@@ -120,11 +121,13 @@ bool PalmyraOS::kernel::Mouse::initialize() {
 }
 
 uint32_t* PalmyraOS::kernel::Mouse::handleInterrupt(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    void* frame    = regs;  // Returned unchanged: the mouse never switches tasks
+
     // Check if data is available
     uint8_t status = commandPort_.read();
 
     // Check if the data is from the mouse
-    if (!(status & 0x20)) return (uint32_t*) regs;
+    if (!(status & 0x20)) return static_cast<uint32_t*>(frame);
 
     count_++;
 
@@ -158,26 +161,35 @@ uint32_t* PalmyraOS::kernel::Mouse::handleInterrupt(PalmyraOS::kernel::interrupt
     }
 
     // Early exist if TODO...
-    if (offset_ != 0) return (uint32_t*) regs;
+    if (offset_ != 0) return static_cast<uint32_t*>(frame);
+
+    // Decoding and cursor/window updates run as a bottom half (the 3-byte packet fits the argument)
+    DeferredWork::schedule(&processPacket, nullptr, buffer_[0] | (buffer_[1] << 8) | (buffer_[2] << 16));
+
+    return static_cast<uint32_t*>(frame);
+}
+
+void PalmyraOS::kernel::Mouse::processPacket([[maybe_unused]] void* context, uint32_t packet) {
+    uint8_t flags     = packet & 0xFF;
+    uint8_t rawX      = (packet >> 8) & 0xFF;
+    uint8_t rawY      = (packet >> 16) & 0xFF;
 
     // Handle overflow bits (Bit 6 and Bit 7 are the X and Y sign bits)
-    bool xOverflow    = (buffer_[0] & (1 << 6));  // X overflow (bit 6)
-    bool yOverflow    = (buffer_[0] & (1 << 7));  // Y overflow (bit 7)
+    bool xOverflow    = (flags & (1 << 6));  // X overflow (bit 6)
+    bool yOverflow    = (flags & (1 << 7));  // Y overflow (bit 7)
 
-    bool isLeftDown   = (buffer_[0] & (1 << 0));
-    bool isRightDown  = (buffer_[0] & (1 << 1));
-    bool isMiddleDown = (buffer_[0] & (1 << 2));
+    bool isLeftDown   = (flags & (1 << 0));
+    bool isRightDown  = (flags & (1 << 1));
+    bool isMiddleDown = (flags & (1 << 2));
 
-    int deltaX        = static_cast<int8_t>(buffer_[1]);  // NOLINT
-    int deltaY        = static_cast<int8_t>(buffer_[2]);  // NOLINT
+    int deltaX        = static_cast<int8_t>(rawX);  // NOLINT
+    int deltaY        = static_cast<int8_t>(rawY);  // NOLINT
 
     // Estimate velocity and apply smoothing
     if (xOverflow) deltaX = static_cast<int>(deltaX * 2);
     if (yOverflow) deltaY = static_cast<int>(deltaY * 2);
 
     WindowManager::queueMouseEvent({deltaX, -deltaY, isLeftDown, isRightDown, isMiddleDown, true});
-
-    return (uint32_t*) regs;
 }
 
 bool PalmyraOS::kernel::Mouse::expectACK() {
@@ -1,9 +1,12 @@
 
 #include "core/tasks/Descriptor.h"
 #include "core/kernel.h"  // For heapManager
+#include "palmyraOS/poll.h"
 
 namespace PalmyraOS::kernel {
 
+    uint32_t Descriptor::poll() { return POLLIN | POLLOUT; }
+
     // ==================== Custom Memory Management (Freestanding C++) ====================
 
     void* Descriptor::operator new(size_t size) { return heapManager.alloc(size); }
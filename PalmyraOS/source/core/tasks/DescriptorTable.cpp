@@ -1,24 +1,27 @@
 
 
 #include "core/tasks/DescriptorTable.h"
+#include "palmyraOS/errono.h"
 
 namespace PalmyraOS::kernel {
 
     // ===== Constructor and Destructor =====
 
     DescriptorTable::DescriptorTable()
-        : nextFd_(3)  // Reserve 0, 1, 2 for stdin, stdout, stderr
-    {}
+        : nextFd_(3),  // Reserve 0, 1, 2 for stdin, stdout, stderr
+          limit_(RLIM_INFINITY) {}
 
     DescriptorTable::~DescriptorTable() {
         // Clean up all remaining descriptors to prevent memory leaks
-        for (auto& [fd, descriptor]: table_) { delete descriptor; }
-        table_.clear();
+        releaseAll();
     }
 
     // ===== Public Methods =====
 
     fd_t DescriptorTable::allocate(Descriptor* descriptor) {
+        // The size of the map is kept by the map: the check is O(1)
+        if (table_.size() >= limit_) return -EMFILE;
+
         // Allocate next available fd
         fd_t fd    = nextFd_++;
 
@@ -43,6 +46,20 @@ namespace PalmyraOS::kernel {
         table_.erase(it);
     }
 
+    void DescriptorTable::install(fd_t fd, Descriptor* descriptor) {
+        // Close whatever was open there
+        release(fd);
+
+        table_[fd] = descriptor;
+        if (fd >= nextFd_) nextFd_ = fd + 1;
+    }
+
+    void DescriptorTable::releaseAll() {
+        for (auto& [fd, descriptor]: table_) { delete descriptor; }
+        table_.clear();
+        nextFd_ = 3;
+    }
+
     Descriptor* DescriptorTable::get(fd_t fd) const {
         auto it = table_.find(fd);
         return (it != table_.end()) ? it->second : nullptr;
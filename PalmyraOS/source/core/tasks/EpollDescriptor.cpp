@@ -0,0 +1,182 @@
+
+#include "core/tasks/EpollDescriptor.h"
+#include "core/Interrupts.h"
+#include "core/kernel.h"  // For heapManager
+#include "palmyraOS/errono.h"
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+namespace PalmyraOS::kernel {
+
+    // ===== Entry =====
+
+    EpollDescriptor::Entry::Entry(EpollDescriptor* owner, fd_t fd, Descriptor* target, const epoll_event& event)
+        : owner_(owner), fd_(fd), target_(target), events_(event.events), data_(event.data.u64) {}
+
+    void EpollDescriptor::Entry::notify(uint32_t events) {
+        if (events & (events_ | ALWAYS_REPORTED)) owner_->markReady(this);
+    }
+
+    void EpollDescriptor::Entry::detach() {
+        // The descriptor was closed: forget it
+        owner_->unlinkReady(this);
+        owner_->entries_.erase(fd_);
+        heapManager.free(this);
+    }
+
+    // ===== Descriptor interface implementation =====
+
+    EpollDescriptor::~EpollDescriptor() {
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+        for (auto& [fd, entry]: entries_) {
+            if (entry->getSource()) entry->getSource()->removeWatcher(entry);
+            heapManager.free(entry);
+        }
+        entries_.clear();
+        readyHead_ = nullptr;
+        readyTail_ = nullptr;
+        waiters_.wakeAll();
+
+        InterruptController::restoreInterrupts(flags);
+    }
+
+    Descriptor::Kind EpollDescriptor::kind() const { return Kind::Epoll; }
+
+    size_t EpollDescriptor::read(char* buffer, size_t size) { return -EINVAL; }
+
+    size_t EpollDescriptor::write(const char* buffer, size_t size) { return -EINVAL; }
+
+    int EpollDescriptor::ioctl(int request, void* arg) { return -ENOTTY; }
+
+    uint32_t EpollDescriptor::poll() { return readyHead_ ? POLLIN : 0; }
+
+    // ===== epoll_ctl =====
+
+    int EpollDescriptor::add(fd_t fd, Descriptor* target, const epoll_event& event) {
+        if (entries_.find(fd) != entries_.end()) return -EEXIST;
+
+        PollSource* source = target->getPollSource();
+        if (!source) return -EPERM;
+
+        auto* entry = heapManager.createInstance<Entry>(this, fd, target, event);
+        if (!entry) return -ENOMEM;
+
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        entries_[fd]   = entry;
+        source->addWatcher(entry);
+
+        // Already ready: report it without waiting for the next change
+        if (target->poll() & (entry->events_ | Entry::ALWAYS_REPORTED)) markReady(entry);
+        InterruptController::restoreInterrupts(flags);
+        return 0;
+    }
+
+    int EpollDescriptor::modify(fd_t fd, const epoll_event& event) {
+        auto it = entries_.find(fd);
+        if (it == entries_.end()) return -ENOENT;
+
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        Entry* entry   = it->second;
+        entry->events_ = event.events;
+        entry->data_   = event.data.u64;
+        entry->armed_  = true;
+
+        if (entry->target_->poll() & (entry->events_ | Entry::ALWAYS_REPORTED)) markReady(entry);
+        InterruptController::restoreInterrupts(flags);
+        return 0;
+    }
+
+    int EpollDescriptor::remove(fd_t fd) {
+        auto it = entries_.find(fd);
+        if (it == entries_.end()) return -ENOENT;
+
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        Entry* entry   = it->second;
+        entries_.erase(it);
+        if (entry->getSource()) entry->getSource()->removeWatcher(entry);
+        unlinkReady(entry);
+        heapManager.free(entry);
+        InterruptController::restoreInterrupts(flags);
+        return 0;
+    }
+
+    // ===== epoll_wait =====
+
+    uint32_t EpollDescriptor::collect(epoll_event* events, uint32_t maxEvents) {
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+        // Take the current ready list; level-triggered entries that are still ready go back to a new one
+        Entry* pending     = readyHead_;
+        Entry* pendingTail = readyTail_;
+        readyHead_         = nullptr;
+        readyTail_         = nullptr;
+
+        uint32_t count = 0;
+        while (pending && count < maxEvents) {
+            Entry* entry      = pending;
+            pending           = entry->readyNext_;
+            entry->readyNext_ = nullptr;
+            entry->queued_    = false;
+
+            // Notifications only say "may be ready": ask the descriptor (drained entries are dropped)
+            uint32_t ready = entry->target_->poll() & (entry->events_ | Entry::ALWAYS_REPORTED);
+            if (!entry->armed_ || ready == 0) continue;
+
+            events[count].events   = ready;
+            events[count].data.u64 = entry->data_;
+            count++;
+
+            if (entry->events_ & EPOLLONESHOT) entry->armed_ = false;
+            else if (!(entry->events_ & EPOLLET)) markReady(entry);
+        }
+
+        // Entries not visited (maxEvents reached) stay in front, in order
+        if (pending) {
+            pendingTail->readyNext_ = readyHead_;
+            if (!readyHead_) readyTail_ = pendingTail;
+            readyHead_ = pending;
+        }
+
+        InterruptController::restoreInterrupts(flags);
+        return count;
+    }
+
+    void EpollDescriptor::sleep(uint64_t deadlineTick) {
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        if (!readyHead_) waiters_.sleep(deadlineTick);
+        InterruptController::restoreInterrupts(flags);
+    }
+
+    // ===== Ready list =====
+
+    void EpollDescriptor::markReady(Entry* entry) {
+        if (entry->queued_ || !entry->armed_) return;
+
+        entry->queued_    = true;
+        entry->readyNext_ = nullptr;
+        if (readyTail_) readyTail_->readyNext_ = entry;
+        else readyHead_ = entry;
+        readyTail_ = entry;
+
+        waiters_.wakeAll();
+        pollSource_.notify(POLLIN);
+    }
+
+    void EpollDescriptor::unlinkReady(Entry* entry) {
+        if (!entry->queued_) return;
+
+        Entry* previous = nullptr;
+        for (Entry* current = readyHead_; current; previous = current, current = current->readyNext_) {
+            if (current != entry) continue;
+
+            if (previous) previous->readyNext_ = entry->readyNext_;
+            else readyHead_ = entry->readyNext_;
+            if (readyTail_ == entry) readyTail_ = previous;
+            break;
+        }
+        entry->readyNext_ = nullptr;
+        entry->queued_    = false;
+    }
+
+}  // namespace PalmyraOS::kernel
@@ -0,0 +1,70 @@
+
+#include "core/tasks/IoRingDescriptor.h"
+#include "palmyraOS/errono.h"
+
+namespace PalmyraOS::kernel {
+
+    namespace {
+        /// The arrays follow the header, each aligned for its entries
+        constexpr uint32_t SQES_OFFSET = 64;
+
+        uint32_t cqesOffset(uint32_t sqEntries) { return SQES_OFFSET + sqEntries * sizeof(io_uring_sqe); }
+    }  // namespace
+
+    IoRingDescriptor::IoRingDescriptor(io_uring_rings* rings, uint32_t sqEntries, uint32_t cqEntries)
+        : rings_(rings),
+          sqes_(reinterpret_cast<io_uring_sqe*>(reinterpret_cast<uint8_t*>(rings) + SQES_OFFSET)),
+          cqes_(reinterpret_cast<io_uring_cqe*>(reinterpret_cast<uint8_t*>(rings) + cqesOffset(sqEntries))),
+          sqEntries_(sqEntries),
+          cqEntries_(cqEntries) {}
+
+    // ===== Descriptor interface implementation =====
+
+    Descriptor::Kind IoRingDescriptor::kind() const { return Kind::IoRing; }
+
+    size_t IoRingDescriptor::read(char* buffer, size_t size) { return -EINVAL; }
+
+    size_t IoRingDescriptor::write(const char* buffer, size_t size) { return -EINVAL; }
+
+    int IoRingDescriptor::ioctl(int request, void* arg) { return -ENOTTY; }
+
+    // ===== Rings =====
+
+    bool IoRingDescriptor::takeSubmission(io_uring_sqe& entry) {
+        uint32_t head = rings_->sq_head;
+        if (head == rings_->sq_tail) return false;
+
+        // Keep the completion ring from overflowing: wait for the process to read completions
+        if (rings_->cq_tail - rings_->cq_head >= cqEntries_) return false;
+
+        entry           = sqes_[head & (sqEntries_ - 1)];
+        rings_->sq_head = head + 1;
+        return true;
+    }
+
+    void IoRingDescriptor::complete(uint64_t userData, int32_t result) {
+        uint32_t tail            = rings_->cq_tail;
+        io_uring_cqe& completion = cqes_[tail & (cqEntries_ - 1)];
+        completion.user_data     = userData;
+        completion.res           = result;
+        completion.flags         = 0;
+
+        // Publish the entry before the index that makes it visible
+        asm volatile("" ::: "memory");
+        rings_->cq_tail = tail + 1;
+    }
+
+    uint32_t IoRingDescriptor::ringSize(uint32_t sqEntries, uint32_t cqEntries) { return cqesOffset(sqEntries) + cqEntries * sizeof(io_uring_cqe); }
+
+    void IoRingDescriptor::initializeRings(io_uring_rings* rings, uint32_t sqEntries, uint32_t cqEntries) {
+        rings->sq_head     = 0;
+        rings->sq_tail     = 0;
+        rings->cq_head     = 0;
+        rings->cq_tail     = 0;
+        rings->sq_entries  = sqEntries;
+        rings->cq_entries  = cqEntries;
+        rings->sqes_offset = SQES_OFFSET;
+        rings->cqes_offset = cqesOffset(sqEntries);
+    }
+
+}  // namespace PalmyraOS::kernel
@@ -0,0 +1,219 @@
+
+#include "core/tasks/PipeDescriptor.h"
+#include "core/Interrupts.h"
+#include "core/kernel.h"  // For heapManager, kernelPagingDirectory_ptr
+#include "core/tasks/ProcessManager.h"
+#include "libs/memory.h"
+#include "palmyraOS/errono.h"
+#include "palmyraOS/poll.h"
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+namespace PalmyraOS::kernel {
+
+    // ===== Pipe =====
+
+    Pipe::Pipe(char* buffer) : buffer_(buffer) {}
+
+    Pipe::~Pipe() { kernelPagingDirectory_ptr->freePages(buffer_, BUFFER_PAGES); }
+
+    bool Pipe::create(bool nonBlocking, PipeDescriptor** readEnd, PipeDescriptor** writeEnd) {
+        auto* buffer = static_cast<char*>(kernelPagingDirectory_ptr->allocatePages(BUFFER_PAGES));
+        if (!buffer) return false;
+
+        void* memory = heapManager.alloc(sizeof(Pipe));
+        if (!memory) {
+            kernelPagingDirectory_ptr->freePages(buffer, BUFFER_PAGES);
+            return false;
+        }
+        auto* pipe = new (memory) Pipe(buffer);
+
+        // Each end links itself into the pipe; closing the only one that exists frees the pipe again
+        *readEnd = heapManager.createInstance<PipeDescriptor>(pipe, true, nonBlocking);
+        if (!*readEnd) {
+            pipe->releaseIfUnused();
+            return false;
+        }
+        *writeEnd = heapManager.createInstance<PipeDescriptor>(pipe, false, nonBlocking);
+        if (!*writeEnd) {
+            delete *readEnd;
+            return false;
+        }
+        return true;
+    }
+
+    size_t Pipe::read(char* buffer, size_t size, bool nonBlocking) {
+        if (size == 0) return 0;
+
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        enter();
+
+        while (count_ == 0 && writers_ > 0 && !nonBlocking) readWaiters_.sleep();
+
+        size_t result;
+        if (count_ == 0) result = writers_ > 0 ? -EAGAIN : 0;  // Empty: end of file once the last writer is gone
+        else {
+            uint32_t length = size < count_ ? size : count_;
+            uint32_t first  = length < CAPACITY - head_ ? length : CAPACITY - head_;
+            memcpy(buffer, buffer_ + head_, first);
+            memcpy(buffer + first, buffer_, length - first);
+
+            count_ -= length;
+            head_  = count_ ? (head_ + length) % CAPACITY : 0;  // Restart an empty ring at the front: the next copies do not wrap
+            result = length;
+
+            writeWaiters_.wakeAll();
+            notifyEnds(false, POLLOUT);
+        }
+
+        leave(TaskManager::getCurrentProcess());
+        InterruptController::restoreInterrupts(flags);
+        return result;
+    }
+
+    size_t Pipe::write(const char* buffer, size_t size, bool nonBlocking) {
+        if (size == 0) return 0;
+
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        enter();
+
+        size_t written = 0;
+        size_t result;
+        while (true) {
+            if (readers_ == 0) {
+                result = written ? written : -EPIPE;
+                break;
+            }
+
+            // Small writes go in one piece, larger ones fill whatever space there is
+            uint32_t remaining = size - written;
+            uint32_t space     = CAPACITY - count_;
+            bool fits          = size <= PIPE_ATOMIC ? space >= remaining : space > 0;
+            if (fits) {
+                uint32_t length = remaining < space ? remaining : space;
+                uint32_t tail   = (head_ + count_) % CAPACITY;
+                uint32_t first  = length < CAPACITY - tail ? length : CAPACITY - tail;
+                memcpy(buffer_ + tail, buffer + written, first);
+                memcpy(buffer_, buffer + written + first, length - first);
+
+                count_  += length;
+                written += length;
+
+                readWaiters_.wakeAll();
+                notifyEnds(true, POLLIN);
+
+                if (written == size) {
+                    result = written;
+                    break;
+                }
+                continue;
+            }
+
+            if (nonBlocking) {
+                result = written ? written : -EAGAIN;
+                break;
+            }
+            writeWaiters_.sleep();
+        }
+
+        leave(TaskManager::getCurrentProcess());
+        InterruptController::restoreInterrupts(flags);
+        return result;
+    }
+
+    uint32_t Pipe::poll(bool readEnd) const {
+        if (readEnd) return (count_ > 0 ? POLLIN : 0) | (writers_ == 0 ? POLLHUP : 0);
+
+        // Writable once a PIPE_ATOMIC write would not block
+        return (CAPACITY - count_ >= PIPE_ATOMIC ? POLLOUT : 0) | (readers_ == 0 ? POLLERR : 0);
+    }
+
+    void Pipe::attach(PipeDescriptor* end) {
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+        end->next_ = ends_;
+        ends_      = end;
+        if (end->readEnd_) readers_++;
+        else writers_++;
+
+        InterruptController::restoreInterrupts(flags);
+    }
+
+    void Pipe::detach(PipeDescriptor* end) {
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+        for (PipeDescriptor** link = &ends_; *link; link = &(*link)->next_) {
+            if (*link != end) continue;
+            *link = end->next_;
+            break;
+        }
+        end->next_ = nullptr;
+
+        // The last reader is gone: writers fail with -EPIPE; the last writer is gone: readers see end of file
+        if (end->readEnd_ && --readers_ == 0) {
+            writeWaiters_.wakeAll();
+            notifyEnds(false, POLLERR);
+        }
+        else if (!end->readEnd_ && --writers_ == 0) {
+            readWaiters_.wakeAll();
+            notifyEnds(true, POLLHUP);
+        }
+
+        releaseIfUnused();
+        InterruptController::restoreInterrupts(flags);
+    }
+
+    void Pipe::notifyEnds(bool readEnds, uint32_t events) {
+        for (PipeDescriptor* end = ends_; end; end = end->next_) {
+            if (end->readEnd_ == readEnds) end->pollSource_.notify(events);
+        }
+    }
+
+    void Pipe::enter() {
+        // The process remembers the pipe, so that a caller killed while sleeping still leaves it (see Process::kill)
+        TaskManager::getCurrentProcess()->pipe_ = this;
+        users_++;
+    }
+
+    void Pipe::leave(Process* process) {
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+        process->pipe_ = nullptr;
+        users_--;
+        releaseIfUnused();
+
+        InterruptController::restoreInterrupts(flags);
+    }
+
+    void Pipe::releaseIfUnused() {
+        if (ends_ || users_ > 0) return;
+
+        this->~Pipe();
+        heapManager.free(this);
+    }
+
+    // ===== PipeDescriptor =====
+
+    PipeDescriptor::PipeDescriptor(Pipe* pipe, bool readEnd, bool nonBlocking) : pipe_(pipe), readEnd_(readEnd), nonBlocking_(nonBlocking) { pipe_->attach(this); }
+
+    PipeDescriptor::~PipeDescriptor() { pipe_->detach(this); }
+
+    Descriptor::Kind PipeDescriptor::kind() const { return Kind::Pipe; }
+
+    size_t PipeDescriptor::read(char* buffer, size_t size) {
+        if (!readEnd_) return -EBADF;
+        return pipe_->read(buffer, size, nonBlocking_);
+    }
+
+    size_t PipeDescriptor::write(const char* buffer, size_t size) {
+        if (readEnd_) return -EBADF;
+        return pipe_->write(buffer, size, nonBlocking_);
+    }
+
+    int PipeDescriptor::ioctl(int request, void* arg) { return -ENOTTY; }
+
+    uint32_t PipeDescriptor::poll() { return pipe_->poll(readEnd_); }
+
+    PipeDescriptor* PipeDescriptor::duplicate() const { return heapManager.createInstance<PipeDescriptor>(pipe_, readEnd_, nonBlocking_); }
+
+}  // namespace PalmyraOS::kernel
@@ -4,25 +4,36 @@
 #include <elf.h>
 #include <new>
 
+#include "core/LocalPage.h"
+#include "core/Locks.h"
+#include "core/Poll.h"
+#include "core/Profiler.h"
 #include "core/SystemClock.h"
+#include "core/TimePage.h"
+#include "core/cpu.h"
 #include "core/tasks/Process.h"
+#include "core/tasks/PipeDescriptor.h"
+#include "core/tasks/ProcessManager.h"  // reaper queue
+#include "core/tasks/StreamBuffer.h"
 
 #include "libs/memory.h"
 #include "libs/stdio.h"
 #include "libs/stdlib.h"  // uitoa64
 #include "libs/string.h"
 
+#include "palmyraOS/errono.h"
 #include "palmyraOS/unistd.h"  // _exit()
 
 #include "core/tasks/WindowManager.h"  // for cleaning up windows upon terminating
 
 #include "core/files/VirtualFileSystem.h"
+#include "core/memory/PageCache.h"
 #include "core/peripherals/Logger.h"
 /// region Process
 
 
 PalmyraOS::kernel::Process::Process(ProcessEntry entryPoint, uint32_t pid, Mode mode, Priority priority, uint32_t argc, char* const* argv, char* const* envp, bool isInternal)
-    : pid_(pid), age_(2), state_(State::Ready), mode_(mode), priority_(priority) {
+    : pid_(pid), age_(2), state_(State::Ready), mode_(mode), priority_(priority), nice_(priorityToNice(priority)) {
 
     LOG_DEBUG("Constructing Process [pid %d] (%s) (mode: %s)", pid_, argv[0], mode_ == Mode::Kernel ? "kernel" : "user");
 
@@ -41,6 +52,9 @@ PalmyraOS::kernel::Process::Process(ProcessEntry entryPoint, uint32_t pid, Mode
                             kernel::kernelLastPage);
     }
 
+    // Default limits until the spawning process passes its own (see inheritResourceLimits)
+    descriptorTable_.setLimit(limits_.limits[RLIMIT_NOFILE].rlim_cur);
+
     // 1.  Create and initialize the paging directory for the process.
     initializePagingDirectory(mode_, isInternal);
 
@@ -71,8 +85,9 @@ PalmyraOS::kernel::Process::Process(ProcessEntry entryPoint, uint32_t pid, Mode
 
     debug_.entryEip = reinterpret_cast<uint32_t>(entryPoint);
 
-    // Record the time when this process was started (for /proc/pid/stat)
-    startTime_      = SystemClock::getTicks();
+    // Record the time when this process was started (for /proc/pid/stat), it waits for the CPU from now on
+    startTime_           = SystemClock::getTicks();
+    schedStats_.readyTsc = CPU::getTSC();
 
     // 5. Capture command-line arguments (safe copy for later access via /proc/{pid}/cmdline)
     captureCommandlineArguments(argc, argv);
@@ -99,6 +114,47 @@ PalmyraOS::kernel::Process::Process(ProcessEntry entryPoint, uint32_t pid, Mode
     LOG_DEBUG("  Kernel Space: 0x%X - 0x%X (Size: %d pages)", nullptr, nullptr, kernel::kernelLastPage);
 }
 
+PalmyraOS::kernel::Process::Process(Process& leader, uint32_t tid, const interrupts::CPURegisters& context, uint32_t userStackPointer)
+    : pid_(tid), age_(2), state_(State::Ready), mode_(leader.mode_), priority_(leader.priority_), policy_(leader.policy_), realtimePriority_(leader.realtimePriority_),
+      nice_(leader.nice_), threadGroupLeader_(&leader) {
+
+    LOG_DEBUG("Constructing Thread [tid %d] in thread group %d", pid_, leader.pid_);
+
+    // 1.  Share the address space of the group, but own a kernel stack.
+    pagingDirectory_ = leader.pagingDirectory_;
+    kernelStack_     = kernelPagingDirectory_ptr->allocatePages(PROCESS_KERNEL_STACK_SIZE);
+    registerPages(kernelStack_, PROCESS_KERNEL_STACK_SIZE);
+    pagingDirectory_->mapPages(kernelStack_, kernelStack_, PROCESS_KERNEL_STACK_SIZE, PageFlags::Present | PageFlags::ReadWrite);
+
+    // The user stack belongs to the caller (e.g. mmap'ed by the SDK), so there is no base to guard.
+    userStack_     = nullptr;
+
+    // 2.  Resume from the caller's context: clone() returns 0 in the new thread, on the new stack.
+    stack_         = context;
+    stack_.eax     = 0;
+    stack_.userEsp = userStackPointer;
+    stack_.esp     = reinterpret_cast<uint32_t>(kernelStack_) + PAGE_SIZE * PROCESS_KERNEL_STACK_SIZE;
+
+    // 3.  Initialize the kernel stack with CPU state (same layout as a new process).
+    {
+        stack_.esp -= sizeof(interrupts::CPURegisters);
+        auto* stack_ptr = reinterpret_cast<interrupts::CPURegisters*>(stack_.esp);
+        *stack_ptr      = stack_;
+        stack_.esp += offsetof(interrupts::CPURegisters, intNo);
+    }
+
+    debug_.entryEip      = context.eip;
+    startTime_           = SystemClock::getTicks();
+    schedStats_.readyTsc = CPU::getTSC();
+    commandName_         = leader.commandName_;
+    leader.threadCount_++;
+
+    // 4.  Initialize Virtual File System Hooks (/proc/<tid>)
+    initializeProcessInVFS();
+
+    LOG_DEBUG("Constructing Thread [tid %d] success (eip: 0x%X, userEsp: 0x%X)", pid_, stack_.eip, stack_.userEsp);
+}
+
 void PalmyraOS::kernel::Process::initializePagingDirectory(Process::Mode mode, bool isInternal) {
     // 1. Create and map the paging directory to itself based on the process mode.
     LOG_DEBUG("Creating Paging Directory. Mode: %s, Is Internal: %d", mode == Process::Mode::Kernel ? "Kernel" : "User", isInternal);
@@ -152,6 +208,13 @@ void PalmyraOS::kernel::Process::initializePagingDirectory(Process::Mode mode, b
         // The kernel is still mapped, but only accessed in user mode for internal applications.
         LOG_DEBUG("Mapping Kernel Space. Size: %d pages", kernel::kernelLastPage);
         pagingDirectory_->mapPages(nullptr, nullptr, kernel::kernelLastPage, kernelSpaceFlags);
+
+        // The shared time page is readable by every process (clock_gettime without a syscall).
+        TimePage::mapInto(pagingDirectory_);
+
+        // Private page at the same address in every process (per-process state of the SDK)
+        void* localFrame = LocalPage::mapInto(pagingDirectory_);
+        if (localFrame) registerPages(localFrame, 1);
     }
 }
 
@@ -293,24 +356,93 @@ void PalmyraOS::kernel::Process::initializeArguments(ProcessEntry entry, uint32_
 }
 
 void PalmyraOS::kernel::Process::terminate(int exitCode) {
-    state_    = Process::State::Terminated;
     exitCode_ = exitCode;
+    if (state_ == State::Terminated || state_ == State::Killed) return;
+
+    // resources are released by the reaper, outside of the scheduler tick
+    setState(State::Terminated);
+    TaskManager::queueForReaping(this);
 }
 
 void PalmyraOS::kernel::Process::kill() {
-    state_ = State::Killed;
-    age_   = 0;
     // exitCode_ is set by _exit syscall
+    using interrupts::InterruptController;
 
-    // clean up memory
-    for (auto& physicalPage: physicalPages_) { kernel::kernelPagingDirectory_ptr->freePage(physicalPage); }
-    physicalPages_.clear();
+    // a thread only owns its kernel stack: unmap it from the shared directory and release the group
+    if (threadGroupLeader_) {
+        if (pagingDirectory_ != kernel::kernelPagingDirectory_ptr) {
+            for (uint32_t i = 0; i < PROCESS_KERNEL_STACK_SIZE; ++i) { pagingDirectory_->unmapPage(reinterpret_cast<uint8_t*>(kernelStack_) + (i << PAGE_BITS)); }
+        }
+        if (threadGroupLeader_->threadCount_ > 0) threadGroupLeader_->threadCount_--;
+    }
+
+    // forget the FPU registers of this process
+    FPU::releaseState(this);
+
+    // leave the wait queue of a lock the process was sleeping on, and the descriptors it was polling
+    {
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        if (waitQueue_) waitQueue_->remove(this);
+        if (pollTable_) pollTable_->detachAll();
+        if (pipe_) pipe_->leave(this);
+        pollTable_  = nullptr;
+        wakeupTick_ = 0;
+        InterruptController::restoreInterrupts(flags);
+    }
+
+    // close the descriptors of the group now: a pipe reader sees end of file without waiting for the slot to be recycled
+    if (!threadGroupLeader_) descriptorTable_.releaseAll();
 
-    // clean up windows buffers
+    // same for a reader of the standard streams, which then drains what is left
+    for (StreamBuffer* stream: {stdin_, stdout_, stderr_}) {
+        if (stream) stream->close();
+    }
+
+    // clean up windows buffers (closeWindow takes the window list lock)
     for (auto windowID: windows_) { WindowManager::closeWindow(windowID); }
     windows_.clear();
 
+    // clean up memory: one freePages per contiguous run, interrupts are only held off for a run
+    std::sort(physicalPages_.begin(), physicalPages_.end());
+    size_t runStart = 0;
+    for (size_t i = 1; i <= physicalPages_.size(); ++i) {
+        if (i < physicalPages_.size() && (uint32_t) physicalPages_[i] == (uint32_t) physicalPages_[i - 1] + PAGE_SIZE) continue;
+
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        kernel::kernelPagingDirectory_ptr->freePages(physicalPages_[runStart], i - runStart);
+        InterruptController::restoreInterrupts(flags);
+        runStart = i;
+    }
+    physicalPages_.clear();
+
+    // shared image pages go back to the page cache (freed there once nobody maps them)
+    for (void* frame: sharedPages_) PageCache::release(frame);
+    sharedPages_.clear();
+    if (image_) PageCache::unpinFile(image_);
+    image_ = nullptr;
+
     // TODO free directory table arrays if user process
+
+    // last, so that waitpid() only returns once everything is released
+    age_ = 0;
+    setState(State::Killed);
+}
+
+void PalmyraOS::kernel::Process::removeProcessFromVFS() {
+    char buffer[50];
+    snprintf(buffer, sizeof(buffer), "/proc/%d", pid_);
+    KString directory = KString(buffer);
+
+    for (auto& [name, inode]: vfs::VirtualFileSystem::getContent(directory)) { vfs::VirtualFileSystem::removeInodeByPath(directory + KString("/") + name); }
+    vfs::VirtualFileSystem::removeInodeByPath(directory);
+
+    // kept past kill(), so that the profile and the last output of a finished process can still be read
+    Profiler::destroySamples(profileSamples_);
+    profileSamples_ = nullptr;
+    for (StreamBuffer** stream: {&stdin_, &stdout_, &stderr_}) {
+        delete *stream;
+        *stream = nullptr;
+    }
 }
 
 void PalmyraOS::kernel::Process::dispatcher(PalmyraOS::kernel::Process::Arguments* args) {
@@ -341,12 +473,63 @@ void PalmyraOS::kernel::Process::deregisterPages(void* physicalAddress, size_t c
     }
 }
 
+bool PalmyraOS::kernel::Process::unmapPages(void* address, size_t count) {
+    // Only whole mmap regions: other pages (stacks, window buffers) may still be used by the kernel
+    Process* leader = getThreadGroupLeader();
+    auto mapping    = leader->mappings_.find(reinterpret_cast<uint32_t>(address));
+    if (mapping == leader->mappings_.end() || mapping->second != count) return false;
+    leader->mappings_.erase(mapping);
+
+    for (size_t i = 0; i < count; ++i) pagingDirectory_->unmapPage(reinterpret_cast<uint8_t*>(address) + (i << PAGE_BITS));
+    leader->deregisterPages(address, count);
+    return true;
+}
+
+PalmyraOS::kernel::ResourceLimits::ResourceLimits() {
+    for (auto& limit: limits) limit = {RLIM_INFINITY, RLIM_INFINITY};
+
+    // The user stack is allocated at creation: its size is also the hard limit
+    limits[RLIMIT_STACK]  = {PROCESS_USER_STACK_SIZE * PAGE_SIZE, PROCESS_USER_STACK_SIZE * PAGE_SIZE};
+    limits[RLIMIT_NOFILE] = {1024, 4096};
+}
+
+bool PalmyraOS::kernel::Process::canAllocatePages(size_t count) {
+    Process* leader     = getThreadGroupLeader();
+    const rlimit& limit = leader->limits_.limits[RLIMIT_AS];
+    if (limit.rlim_cur == RLIM_INFINITY) return true;
+
+    // Private and page cache frames alike (threads only add their kernel stacks)
+    uint64_t pages = leader->physicalPages_.size() + leader->sharedPages_.size() + count;
+    return pages * PAGE_SIZE <= limit.rlim_cur;
+}
+
+void PalmyraOS::kernel::Process::setResourceLimit(int resource, const rlimit& limit) {
+    Process* leader                  = getThreadGroupLeader();
+    leader->limits_.limits[resource] = limit;
+
+    if (resource == RLIMIT_NOFILE) leader->descriptorTable_.setLimit(limit.rlim_cur);
+    if (resource == RLIMIT_CPU) leader->limits_.cpuLimitCycles = limit.rlim_cur == RLIM_INFINITY ? 0 : (uint64_t) limit.rlim_cur * CPU::getCPUFrequency() * 1000000;
+}
+
+void PalmyraOS::kernel::Process::inheritResourceLimits(Process& parent) {
+    Process* source = parent.getThreadGroupLeader();
+    for (int resource = 0; resource < RLIMIT_NLIMITS; ++resource) setResourceLimit(resource, source->limits_.limits[resource]);
+}
+
+bool PalmyraOS::kernel::Process::hasExceededCpuLimit() {
+    Process* leader = getThreadGroupLeader();
+    return leader->limits_.cpuLimitCycles != 0 && leader->cpuCycles_ >= leader->limits_.cpuLimitCycles;
+}
+
 void* PalmyraOS::kernel::Process::allocatePages(size_t count) {
+    if (!canAllocatePages(count)) return nullptr;
+
     // allocate the pages in kernel directory (so that they are accessible in syscalls)
     void* address = kernelPagingDirectory_ptr->allocatePages(count);
+    if (!address) return nullptr;
 
-    // register them to keep track of them when we terminate
-    registerPages(address, count);
+    // register them to keep track of them when we terminate (threads allocate on behalf of their group)
+    getThreadGroupLeader()->registerPages(address, count);
 
     // Make them accessible to the process
     pagingDirectory_->mapPages(address, address, count, PageFlags::Present | PageFlags::ReadWrite | PageFlags::UserSupervisor);
@@ -354,6 +537,25 @@ void* PalmyraOS::kernel::Process::allocatePages(size_t count) {
     return address;
 }
 
+void PalmyraOS::kernel::Process::setState(State state) {
+    // woken up: the scheduling latency runs until the scheduler picks the process
+    if (state == State::Ready && state_ == State::Waiting) schedStats_.readyTsc = CPU::getTSC();
+
+    State previous = state_;
+    state_         = state;
+    if (previous != state) TaskManager::updateRunQueue(this, previous);
+}
+
+int32_t PalmyraOS::kernel::Process::priorityToNice(Priority priority) {
+    switch (priority) {
+        case Priority::VeryLow: return 10;
+        case Priority::Low: return 5;
+        case Priority::High: return -5;
+        case Priority::VeryHigh: return -10;
+        default: return 0;
+    }
+}
+
 bool PalmyraOS::kernel::Process::checkStackOverflow() const {
     /*
      * Check for kernel stack overflow.
@@ -367,13 +569,15 @@ bool PalmyraOS::kernel::Process::checkStackOverflow() const {
      * When in user mode and executing in user space, we need to ensure that the user stack pointer (userEsp)
      * is above the base of the user stack (userStack_). This prevents user stack overflow.
      */
-    if (mode_ == Mode::User && (stack_.cs & 0x11) != 0) {
-        if (stack_.userEsp < (reinterpret_cast<uint32_t>(userStack_))) {
-
-            kernel::kernelPanic("User Stack Overflow detected for PID: %d. User ESP: 0x%x is below User Stack Base: 0x%x",
-                                pid_,
-                                stack_.userEsp,
-                                reinterpret_cast<uint32_t>(userStack_));
+    if (mode_ == Mode::User && (stack_.cs & 0x11) != 0 && userStack_) {
+        // RLIMIT_STACK (at most the allocated size) is measured down from the top of the stack
+        uint32_t stackSize  = PROCESS_USER_STACK_SIZE * PAGE_SIZE;
+        uint32_t limit      = limits_.limits[RLIMIT_STACK].rlim_cur < stackSize ? limits_.limits[RLIMIT_STACK].rlim_cur : stackSize;
+        uint32_t stackFloor = reinterpret_cast<uint32_t>(userStack_) + stackSize - limit;
+
+        // Only the process is at fault: the scheduler terminates it
+        if (stack_.userEsp < stackFloor) {
+            LOG_ERROR("User Stack Overflow detected for PID: %d. User ESP: 0x%x is below the stack limit: 0x%x", pid_, stack_.userEsp, stackFloor);
             return false;
         }
     }
@@ -382,11 +586,14 @@ bool PalmyraOS::kernel::Process::checkStackOverflow() const {
 }
 
 void* PalmyraOS::kernel::Process::allocatePagesAt(void* virtual_address, size_t count) {
+    if (!canAllocatePages(count)) return nullptr;
+
     // allocate the pages in kernel directory (so that they are accessible in syscalls)
     void* physicalAddress = kernelPagingDirectory_ptr->allocatePages(count);
+    if (!physicalAddress) return nullptr;
 
-    // register them to keep track of them when we terminate
-    registerPages(physicalAddress, count);
+    // register them to keep track of them when we terminate (threads allocate on behalf of their group)
+    getThreadGroupLeader()->registerPages(physicalAddress, count);
 
     // Make them accessible to the process
     pagingDirectory_->mapPages(physicalAddress, virtual_address, count, PageFlags::Present | PageFlags::ReadWrite | PageFlags::UserSupervisor);
@@ -394,6 +601,129 @@ void* PalmyraOS::kernel::Process::allocatePagesAt(void* virtual_address, size_t
     return physicalAddress;
 }
 
+const PalmyraOS::kernel::ImageSegment* PalmyraOS::kernel::Process::findImageSegment(uint32_t address) const {
+    for (const auto& segment: imageSegments_) {
+        if (address >= segment.start && address < segment.end) return &segment;
+    }
+    return nullptr;
+}
+
+namespace {
+    constexpr uint32_t FAULT_AROUND_PAGES = 16;  ///< Window of cached neighbours mapped along with a shared page
+
+    /// A page can be shared if it holds exactly one page of the file, all of it inside the segment's file part
+    bool isWholeFilePage(const PalmyraOS::kernel::ImageSegment& segment, uint32_t page) {
+        using PalmyraOS::kernel::PAGE_SIZE;
+        if ((segment.vaddr - segment.fileOffset) & (PAGE_SIZE - 1)) return false;
+        if (page < segment.vaddr - segment.fileOffset) return false;
+        return page + PAGE_SIZE <= segment.vaddr + segment.fileSize;
+    }
+
+    uint32_t filePageIndex(const PalmyraOS::kernel::ImageSegment& segment, uint32_t page) {
+        return (page - (segment.vaddr - segment.fileOffset)) >> PalmyraOS::kernel::PAGE_BITS;
+    }
+}  // namespace
+
+void PalmyraOS::kernel::Process::mapSharedPage(void* frame, uint32_t page) {
+    sharedPages_.push_back(frame);
+    pagingDirectory_->mapPage(frame, reinterpret_cast<void*>(page), PageFlags::Present | PageFlags::UserSupervisor);
+}
+
+void PalmyraOS::kernel::Process::mapAroundSharedPage(const ImageSegment& segment, uint32_t page) {
+    uint32_t windowStart = page & ~(FAULT_AROUND_PAGES * PAGE_SIZE - 1);
+    for (uint32_t i = 0; i < FAULT_AROUND_PAGES && canAllocatePages(1); ++i) {
+        uint32_t neighbour = windowStart + (i << PAGE_BITS);
+        if (neighbour == page || neighbour < segment.start || neighbour >= segment.end) continue;
+        if (!isWholeFilePage(segment, neighbour) || pagingDirectory_->isAddressValid(reinterpret_cast<void*>(neighbour))) continue;
+
+        void* frame = PageCache::lookup(image_, filePageIndex(segment, neighbour));
+        if (frame) mapSharedPage(frame, neighbour);
+    }
+}
+
+bool PalmyraOS::kernel::Process::mapPrivatePage(const ImageSegment& segment, uint32_t page) {
+    auto* frame = static_cast<uint8_t*>(kernelPagingDirectory_ptr->allocatePage());
+    if (!frame) return false;
+    memset(frame, 0, PAGE_SIZE);
+
+    // Copy the part of the page backed by the file, through the cache when the page is cached anyway
+    uint32_t from = page > segment.vaddr ? page : segment.vaddr;
+    uint32_t to   = segment.vaddr + segment.fileSize;
+    if (page + PAGE_SIZE < to) to = page + PAGE_SIZE;
+    if (from < to) {
+        if (isWholeFilePage(segment, page)) {
+            void* cached = PageCache::acquire(image_, filePageIndex(segment, page));
+            if (!cached) {
+                kernelPagingDirectory_ptr->freePage(frame);
+                return false;
+            }
+            memcpy(frame, cached, PAGE_SIZE);
+            PageCache::release(cached);
+        }
+        else image_->read(reinterpret_cast<char*>(frame + (from - page)), to - from, segment.fileOffset + (from - segment.vaddr));
+    }
+
+    registerPages(frame, 1);
+    PageFlags flags = PageFlags::Present | PageFlags::UserSupervisor;
+    if (segment.writable) flags = flags | PageFlags::ReadWrite;
+    pagingDirectory_->mapPage(frame, reinterpret_cast<void*>(page), flags);
+    return true;
+}
+
+bool PalmyraOS::kernel::Process::handleImageFault(uint32_t address, bool write) {
+    // threads fault on behalf of their group (same directory, same image)
+    if (threadGroupLeader_) return threadGroupLeader_->handleImageFault(address, write);
+
+    const ImageSegment* segment = findImageSegment(address);
+    if (!image_ || !segment) return false;
+
+    uint32_t page     = address & ~(PAGE_SIZE - 1);
+    auto* pageAddress = reinterpret_cast<void*>(page);
+
+    // Present: only a write to a shared page of a writable segment is legal (copy-on-write)
+    if (pagingDirectory_->isAddressValid(pageAddress)) {
+        if (!write || !segment->writable) return false;
+
+        void* shared = reinterpret_cast<void*>(reinterpret_cast<uint32_t>(pagingDirectory_->getPhysicalAddress(pageAddress)) & ~(PAGE_SIZE - 1));
+        auto it      = std::find(sharedPages_.begin(), sharedPages_.end(), shared);
+        if (it == sharedPages_.end()) return true;  // already private (another thread broke it first)
+
+        void* frame = kernelPagingDirectory_ptr->allocatePage();
+        if (!frame) return false;
+        memcpy(frame, shared, PAGE_SIZE);
+        registerPages(frame, 1);
+        pagingDirectory_->mapPage(frame, pageAddress, PageFlags::Present | PageFlags::ReadWrite | PageFlags::UserSupervisor);
+
+        sharedPages_.erase(it);
+        PageCache::release(shared);
+        return true;
+    }
+
+    // Not present: share whole file pages unless the first access already writes to them
+    if (!isWholeFilePage(*segment, page) || (write && segment->writable)) return mapPrivatePage(*segment, page);
+
+    void* frame = PageCache::acquire(image_, filePageIndex(*segment, page));
+    if (!frame) return false;
+
+    // acquire() may have slept on the cache lock while another thread mapped the page
+    if (pagingDirectory_->isAddressValid(pageAddress)) {
+        PageCache::release(frame);
+        return true;
+    }
+
+    mapSharedPage(frame, page);
+    mapAroundSharedPage(*segment, page);
+    return true;
+}
+
+bool PalmyraOS::kernel::Process::handlePageFault(uint32_t address, bool write) {
+    // A fault that needs a frame beyond RLIMIT_AS is an invalid access
+    if (!canAllocatePages(1)) return false;
+
+    // Further demand-paged regions (stack growth, lazy mmap) are resolved here as well
+    return handleImageFault(address, write);
+}
+
 /**
  * @brief Initializes arguments for ELF executables with Linux-compatible stack layout
  *
@@ -603,17 +933,21 @@ void PalmyraOS::kernel::Process::initializeProcessInVFS() {
                                           sizeof(output),
                                           ""
                                           "Pid: %d\n"
+                                          "Tgid: %d\n"
                                           "Name: %s\n"
                                           "State: %s\n"
                                           "Up Time: %s\n"
                                           "Pages: %d\n"
+                                          "Shared Pages: %d\n"
                                           "Windows: %d\n"
                                           "exitCode: %d\n",
                                           pid_,
+                                          getThreadGroupId(),
                                           commandName_.c_str(),
                                           stateToString(),
                                           uptime,
                                           physicalPages_.size(),
+                                          sharedPages_.size(),
                                           windows_.size(),
                                           exitCode_);
 
@@ -630,48 +964,21 @@ void PalmyraOS::kernel::Process::initializeProcessInVFS() {
             nullptr);
     vfs::VirtualFileSystem::setInodeByPath(directory + KString("/status"), statusNode);
 
-    auto stdoutNode = kernel::heapManager.createInstance<vfs::FunctionInode>(
-            // Read
-            [this](char* buffer, size_t size, size_t offset) -> size_t {
-                // Calculate the size of stdout_ vector
-                size_t stdout_size = stdout_.size();
+    /// Standard streams: reading stdout/stderr consumes the output, writing stdin feeds the process
+    stdin_  = kernel::heapManager.createInstance<StreamBuffer>();
+    stdout_ = kernel::heapManager.createInstance<StreamBuffer>();
+    stderr_ = kernel::heapManager.createInstance<StreamBuffer>();
 
-                // Ensure the offset is within the bounds of the stdout_ data
-                if (offset >= stdout_size) return 0;
+    auto stdinNode = kernel::heapManager.createInstance<vfs::FunctionInode>(
+            nullptr, [this](const char* buffer, size_t size, size_t offset) -> size_t { return stdin_ ? stdin_->write(buffer, size) : -EPIPE; }, nullptr);
+    vfs::VirtualFileSystem::setInodeByPath(directory + KString("/stdin"), stdinNode);
 
-                // Calculate the number of bytes to copy to the buffer
-                size_t available = stdout_size - offset;
-                size_t to_copy   = available < size ? available : size;
-
-                // Copy the data from stdout_ to the provided buffer
-                memcpy(buffer, stdout_.data() + offset, to_copy);
-
-                return to_copy;
-            },
-            nullptr,
-            nullptr);
+    auto stdoutNode = kernel::heapManager.createInstance<vfs::FunctionInode>(
+            [this](char* buffer, size_t size, size_t offset) -> size_t { return stdout_ ? stdout_->read(buffer, size, false) : 0; }, nullptr, nullptr);
     vfs::VirtualFileSystem::setInodeByPath(directory + KString("/stdout"), stdoutNode);
 
     auto stderrNode = kernel::heapManager.createInstance<vfs::FunctionInode>(
-            // Read
-            [this](char* buffer, size_t size, size_t offset) -> size_t {
-                // Calculate the size of stdout_ vector
-                size_t stderrsize = stderr_.size();
-
-                // Ensure the offset is within the bounds of the stdout_ data
-                if (offset >= stderrsize) return 0;
-
-                // Calculate the number of bytes to copy to the buffer
-                size_t available = stderrsize - offset;
-                size_t to_copy   = available < size ? available : size;
-
-                // Copy the data from stdout_ to the provided buffer
-                memcpy(buffer, stderr_.data() + offset, to_copy);
-
-                return to_copy;
-            },
-            nullptr,
-            nullptr);
+            [this](char* buffer, size_t size, size_t offset) -> size_t { return stderr_ ? stderr_->read(buffer, size, false) : 0; }, nullptr, nullptr);
     vfs::VirtualFileSystem::setInodeByPath(directory + KString("/stderr"), stderrNode);
 
     /// Command-line arguments file - Linux compatible format (null-terminated strings)
@@ -769,6 +1076,28 @@ void PalmyraOS::kernel::Process::initializeProcessInVFS() {
             nullptr,
             nullptr);
     vfs::VirtualFileSystem::setInodeByPath(directory + KString("/stat"), statNode);
+
+    /// Scheduler statistics: precise CPU time, context switches and scheduling latency
+    auto schedNode = kernel::heapManager.createInstance<vfs::FunctionInode>(
+            [this](char* buffer, size_t size, size_t offset) -> size_t {
+                char output[1024];
+                size_t written = TaskManager::formatSchedStats(TaskManager::getSchedStats(this), output, sizeof(output));
+                written        += snprintf(output + written, sizeof(output) - written, "nice: %d\nvruntime_us: %llu\n", nice_, TaskManager::cyclesToMicroseconds(vruntime_));
+
+                if (offset >= written) return 0;
+                size_t to_copy = written - offset < size ? written - offset : size;
+                memcpy(buffer, output + offset, to_copy);
+                return to_copy;
+            },
+            nullptr,
+            nullptr);
+    vfs::VirtualFileSystem::setInodeByPath(directory + KString("/sched"), schedNode);
+
+    /// Sampling profile: timer ticks spent per function
+    profileSamples_  = Profiler::createSamples();
+    auto profileNode = kernel::heapManager.createInstance<vfs::FunctionInode>(
+            [this](char* buffer, size_t size, size_t offset) -> size_t { return Profiler::readProfile(profileSamples_, buffer, size, offset); }, nullptr, nullptr);
+    vfs::VirtualFileSystem::setInodeByPath(directory + KString("/profile"), profileNode);
 }
 
 /// Helper Methods for Command-line Metadata
@@ -884,7 +1213,7 @@ void PalmyraOS::kernel::Process::captureEnvironment(char* const* envp) {
  * This implementation follows the Linux i386 ABI for compatibility with standard
  * toolchains and dynamically-linked executables.
  */
-void PalmyraOS::kernel::Process::buildAuxiliaryVectorForELF(const Elf32_Ehdr* elfHeader, const Elf32_Phdr* programHeaders) {
+void PalmyraOS::kernel::Process::buildAuxiliaryVectorForELF(const Elf32_Ehdr* elfHeader, uint32_t programHeadersAddress) {
     auxiliaryVector_.clear();
 
     /**
@@ -898,9 +1227,9 @@ void PalmyraOS::kernel::Process::buildAuxiliaryVectorForELF(const Elf32_Ehdr* el
     auxiliaryVector_.push_back({AT_CLKTCK, 100});        // Clock ticks per second (PIT frequency)
 
     // 2. ELF program header information (critical for dynamic linking)
-    auxiliaryVector_.push_back({AT_PHDR, reinterpret_cast<uint32_t>(programHeaders)});  // Program headers address
-    auxiliaryVector_.push_back({AT_PHENT, sizeof(Elf32_Phdr)});                         // Size of one program header
-    auxiliaryVector_.push_back({AT_PHNUM, elfHeader->e_phnum});                         // Number of program headers
+    auxiliaryVector_.push_back({AT_PHDR, programHeadersAddress});  // Program headers address (in the mapped image)
+    auxiliaryVector_.push_back({AT_PHENT, sizeof(Elf32_Phdr)});    // Size of one program header
+    auxiliaryVector_.push_back({AT_PHNUM, elfHeader->e_phnum});    // Number of program headers
 
     // 3. Entry point (useful for debuggers and profilers)
     auxiliaryVector_.push_back({AT_ENTRY, elfHeader->e_entry});
@@ -986,6 +1315,16 @@ size_t PalmyraOS::kernel::Process::serializeCmdline(char* buffer, size_t bufferS
 size_t PalmyraOS::kernel::Process::serializeStat(char* buffer, size_t bufferSize, uint64_t totalSystemTicks) const {
     if (!buffer || bufferSize == 0) return 0;
 
+    // Linux reports real-time tasks as -1 - rt_priority, the others as 20 + nice
+    int priority = isRealtime() ? -1 - static_cast<int>(realtimePriority_) : 20 + nice_;
+
+    // CPU time is accounted in TSC cycles, reported in clock ticks
+    SchedStats stats       = TaskManager::getSchedStats(this);
+    uint64_t cyclesPerTick = static_cast<uint64_t>(CPU::getCPUFrequency()) * (1000000 / SystemClockFrequency);
+    uint64_t userTicks     = cyclesPerTick ? stats.userCycles / cyclesPerTick : 0;
+    uint64_t kernelTicks   = cyclesPerTick ? stats.kernelCycles / cyclesPerTick : 0;
+    uint64_t residentPages = physicalPages_.size();
+
     // Use snprintf to safely format the stat line
     size_t written = snprintf(buffer,
                               bufferSize,
@@ -1003,17 +1342,17 @@ size_t PalmyraOS::kernel::Process::serializeStat(char* buffer, size_t bufferSize
                               0,                            // 11: cminflt
                               0,                            // 12: majflt
                               0,                            // 13: cmajflt
-                              cpuTimeTicks_,                // 14: utime (user CPU time in ticks)
-                              0,                            // 15: stime (system CPU time - not separated yet)
+                              userTicks,                    // 14: utime (user CPU time in ticks)
+                              kernelTicks,                  // 15: stime (system CPU time in ticks)
                               0,                            // 16: cutime
                               0,                            // 17: cstime
-                              static_cast<int>(priority_),  // 18: priority
-                              0,                            // 19: nice
+                              priority,                     // 18: priority
+                              nice_,                        // 19: nice
                               1,                            // 20: num_threads
                               0,                            // 21: itrealvalue (obsolete)
                               startTime_,                   // 22: starttime (ticks since boot)
-                              0,                            // 23: vsize (virtual memory size)
-                              physicalPages_.size());       // 24: rss (resident set size in pages)
+                              0ULL,                         // 23: vsize (virtual memory size)
+                              residentPages);               // 24: rss (resident set size in pages)
 
     // snprintf returns the number of characters that would have been written
     // Return actual bytes written (capped by bufferSize)
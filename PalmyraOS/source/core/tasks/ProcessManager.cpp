@@ -4,7 +4,11 @@
 #include <elf.h>
 #include <new>
 
+#include "core/DeferredWork.h"
+#include "core/FPU.h"
 #include "core/SystemClock.h"
+#include "core/Trace.h"
+#include "core/cpu.h"
 #include "core/tasks/ProcessManager.h"
 
 #include "libs/memory.h"
@@ -12,27 +16,94 @@
 #include "libs/stdlib.h"  // uitoa64
 #include "libs/string.h"
 
+#include "palmyraOS/errono.h"
 #include "palmyraOS/unistd.h"  // _exit()
 
 #include "core/tasks/WindowManager.h"  // for cleaning up windows upon terminating
 
 #include "core/files/VirtualFileSystem.h"
+#include "core/memory/PageCache.h"
 #include "core/peripherals/Logger.h"
 /// region Task Manager
 
 // Globals
 PalmyraOS::kernel::KVector<PalmyraOS::kernel::Process> PalmyraOS::kernel::TaskManager::processes_;
-uint32_t PalmyraOS::kernel::TaskManager::currentProcessIndex_ = MAX_PROCESSES;
+PalmyraOS::kernel::KVector<uint32_t> PalmyraOS::kernel::TaskManager::generations_;
+uint32_t PalmyraOS::kernel::TaskManager::capacity_            = 0;
+uint32_t PalmyraOS::kernel::TaskManager::currentProcessIndex_ = INVALID_SLOT;
 uint32_t PalmyraOS::kernel::TaskManager::atomicSectionLevel_  = 0;
-uint32_t PalmyraOS::kernel::TaskManager::pid_count            = 0;
-
-void PalmyraOS::kernel::TaskManager::initialize() {
+PalmyraOS::kernel::KVector<uint32_t> PalmyraOS::kernel::TaskManager::reapQueue_;
+volatile uint32_t PalmyraOS::kernel::TaskManager::reapHead_ = 0;
+volatile uint32_t PalmyraOS::kernel::TaskManager::reapTail_ = 0;
+PalmyraOS::kernel::KVector<uint32_t> PalmyraOS::kernel::TaskManager::freeSlots_;
+uint32_t PalmyraOS::kernel::TaskManager::freeSlotsHead_  = 0;
+uint32_t PalmyraOS::kernel::TaskManager::freeSlotsTail_  = 0;
+uint32_t PalmyraOS::kernel::TaskManager::reaperIndex_    = INVALID_SLOT;
+uint64_t PalmyraOS::kernel::TaskManager::nextWakeupTick_ = UINT64_MAX;
+PalmyraOS::kernel::SchedStats PalmyraOS::kernel::TaskManager::systemStats_;
+PalmyraOS::kernel::RunQueue PalmyraOS::kernel::TaskManager::runQueue_;
+uint32_t PalmyraOS::kernel::TaskManager::schedLatencyMicroseconds_   = 20000;  // 5 ticks
+uint32_t PalmyraOS::kernel::TaskManager::minGranularityMicroseconds_ = 4000;   // 1 tick
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+void PalmyraOS::kernel::TaskManager::initialize(uint32_t capacity) {
     // Attach the task switching interrupt handler to the system clock.
     SystemClock::attachHandler(interruptHandler);
 
-    // Clear and reserve space in the processes vector.
+    // Reserve every slot up front: processes never move, so Process* stays valid.
+    capacity_ = capacity;
     processes_.clear();
-    processes_.reserve(MAX_PROCESSES);
+    processes_.reserve(capacity_);
+    generations_.clear();
+    generations_.reserve(capacity_);
+
+    // Rings can never hold more than one entry per slot.
+    reapQueue_.resize(capacity_);
+    freeSlots_.resize(capacity_);
+    runQueue_.reserve(capacity_);
+
+    auto schedStatNode = kernel::heapManager.createInstance<vfs::FunctionInode>(&readSchedStat, nullptr, nullptr);
+    if (schedStatNode) vfs::VirtualFileSystem::setInodeByPath(KString("/proc/schedstat"), schedStatNode);
+
+    auto tunablesNode = kernel::heapManager.createInstance<vfs::FunctionInode>(&readSchedTunables, &writeSchedTunables, nullptr);
+    if (tunablesNode) vfs::VirtualFileSystem::setInodeByPath(KString("/proc/sched_tunables"), tunablesNode);
+}
+
+uint32_t PalmyraOS::kernel::TaskManager::getCapacity() { return capacity_; }
+
+template <typename First, typename... Rest>
+PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::emplaceProcess(First&& first, Rest&&... rest) {
+    // Fresh slots first, so that exit codes of recently reaped processes stay available to waitpid() as long as possible
+    if (processes_.size() < capacity_) {
+        auto slot = static_cast<uint32_t>(processes_.size());
+        generations_.push_back(0);
+        processes_.emplace_back(std::forward<First>(first), slot, std::forward<Rest>(rest)...);
+        updateRunQueue(&processes_.back(), Process::State::New);
+        return &processes_.back();
+    }
+
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+    if (freeSlotsHead_ == freeSlotsTail_) {
+        InterruptController::restoreInterrupts(flags);
+        return nullptr;
+    }
+    uint32_t slot = freeSlots_[freeSlotsHead_ % capacity_];
+    freeSlotsHead_++;
+    InterruptController::restoreInterrupts(flags);
+
+    // A new generation invalidates the PID of the previous occupant
+    generations_[slot]++;
+    uint32_t pid     = generations_[slot] * capacity_ + slot;
+
+    // Recycle the reaped slot in place
+    Process* process = &processes_[slot];
+    process->removeProcessFromVFS();
+    process->~Process();
+    new (process) Process(std::forward<First>(first), pid, std::forward<Rest>(rest)...);
+    updateRunQueue(process, Process::State::New);
+
+    return process;
 }
 
 /**
@@ -49,14 +120,69 @@ PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::newProcess(Process::
                                                                        char* const* argv,
                                                                        char* const* envp,
                                                                        bool isInternal) {
-    // Check if the maximum number of processes has been reached.
-    if (processes_.size() == MAX_PROCESSES - 1) return nullptr;
+    // Returns nullptr if the maximum number of processes has been reached.
+    return emplaceProcess(entryPoint, mode, priority, argc, argv, envp, isInternal);
+}
 
-    // Create a new process and add it to the processes vector.
-    processes_.emplace_back(entryPoint, pid_count++, mode, priority, argc, argv, envp, isInternal);
+PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::newThread(Process* leader, const interrupts::CPURegisters& context, uint32_t userStackPointer) {
+    // Threads take a slot (and an ID) from the process table.
+    return emplaceProcess(*leader, context, userStackPointer);
+}
 
-    // Return a pointer to the newly created process.
-    return &processes_.back();
+void PalmyraOS::kernel::TaskManager::terminateThreadGroup(Process* leader, int exitCode) {
+    for (auto& process: processes_) {
+        if (process.threadGroupLeader_ != leader) continue;
+        if (process.state_ == Process::State::Terminated || process.state_ == Process::State::Killed) continue;
+        process.terminate(exitCode);
+    }
+}
+
+void PalmyraOS::kernel::TaskManager::queueForReaping(Process* process) {
+    uint32_t flags                    = InterruptController::saveAndDisableInterrupts();
+
+    reapQueue_[reapTail_ % capacity_] = static_cast<uint32_t>(process - processes_.data());
+    reapTail_                         = reapTail_ + 1;
+
+    // wake up the reaper
+    if (reaperIndex_ != INVALID_SLOT && processes_[reaperIndex_].state_ == Process::State::Waiting) processes_[reaperIndex_].setState(Process::State::Ready);
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+int PalmyraOS::kernel::TaskManager::reaper(uint32_t argc, char** argv) {
+    reaperIndex_ = currentProcessIndex_;
+
+    while (true) {
+        // Only the entries queued before this pass (deferred leaders are queued again)
+        for (uint32_t pending = reapTail_ - reapHead_; pending > 0; --pending) {
+            uint32_t flags = InterruptController::saveAndDisableInterrupts();
+            uint32_t index = reapQueue_[reapHead_ % capacity_];
+            reapHead_      = reapHead_ + 1;
+            InterruptController::restoreInterrupts(flags);
+
+            Process& process = processes_[index];
+
+            // a leader owns the shared address space: stop its threads first and outlive them
+            if (process.threadCount_ > 0) {
+                terminateThreadGroup(&process, process.exitCode_);
+                queueForReaping(&process);
+                continue;
+            }
+
+            process.kill();
+
+            flags                                  = InterruptController::saveAndDisableInterrupts();
+            freeSlots_[freeSlotsTail_ % capacity_] = index;
+            freeSlotsTail_++;
+            InterruptController::restoreInterrupts(flags);
+        }
+
+        // Sleep until the next termination (queueForReaping sets us Ready)
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+        if (reapHead_ == reapTail_) processes_[reaperIndex_].setState(Process::State::Waiting);
+        InterruptController::restoreInterrupts(flags);
+        sched_yield();
+    }
 }
 
 /**
@@ -111,76 +237,119 @@ PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::execv_builtin(Proces
 }
 
 uint32_t* PalmyraOS::kernel::TaskManager::interruptHandler(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    void* frame = regs;  // Returned when the current process keeps running
 
     // If there are no processes, or we are in an atomic section, return the current registers.
-    if (processes_.empty()) return reinterpret_cast<uint32_t*>(regs);
-    if (atomicSectionLevel_ > 0) return reinterpret_cast<uint32_t*>(regs);
+    if (processes_.empty()) return static_cast<uint32_t*>(frame);
+    if (atomicSectionLevel_ > 0) return static_cast<uint32_t*>(frame);
+    if (DeferredWork::isRunning()) return static_cast<uint32_t*>(frame);  // nested in a bottom half: switch on the next tick
     /**
      * @Note TaskScheduler can be called in an atomicSection
-     * If the WindowsManager is composing windows, and here we kill the process -> close the window
-     * -> erase the window, memcpy would be writing to an illegal address.
-     * -> Hence Atomic Section guarantees that it is fully atomic
-     * @short Once should also implement deferred erasing.
+     * Terminated processes are not killed here: they are queued by Process::terminate()
+     * and released by the reaper thread with interrupts enabled.
      */
 
-    size_t nextProcessIndex;
-    uint32_t* result;
+    // End timed sleeps first, so a real-time sleeper can preempt right away
+    uint64_t now = SystemClock::getTicks();
+    if (now >= nextWakeupTick_) wakeTimedSleepers(now);
 
-    // Debug Information
-    processes_[currentProcessIndex_].debug_.lastWorkingEip = regs->eip;
-
-    // kill terminated processes
-    for (int i = 0; i < processes_.size(); ++i) {
-        if (i == currentProcessIndex_) continue;  // we cannot kill the process in its own stack (-> Page Fault)
-        if (processes_[i].state_ == Process::State::Terminated) { processes_[i].kill(); }
-    }
+    uint32_t skip  = INVALID_SLOT;
+    bool voluntary = true;
+    uint32_t* result;
 
     // Save the current process state if a process is running.
-    if (currentProcessIndex_ < MAX_PROCESSES) {
-        // Increment CPU time for the process that is about to yield
-        processes_[currentProcessIndex_].cpuTimeTicks_++;
+    if (currentProcessIndex_ != INVALID_SLOT) {
+        // Debug Information
+        processes_[currentProcessIndex_].debug_.lastWorkingEip = regs->eip;
 
         // save current process state
         processes_[currentProcessIndex_].stack_ = *regs;
 
-        // check stackOverflow
+        // A user stack overflow ends the thread group like an invalid access would (the kernel stack panics)
         if (!processes_[currentProcessIndex_].checkStackOverflow()) {
-            // TODO handle here e.g. .terminate(-3)
+            processes_[currentProcessIndex_].getThreadGroupLeader()->terminate(EXIT_PAGE_FAULT);
+            processes_[currentProcessIndex_].terminate(EXIT_PAGE_FAULT);
         }
 
-        // if the process is not terminated or killed
-        if (processes_[currentProcessIndex_].state_ != Process::State::Terminated && processes_[currentProcessIndex_].state_ != Process::State::Killed) {
-            // Decrease the age of the current process.
-            if (processes_[currentProcessIndex_].age_ > 0) processes_[currentProcessIndex_].age_--;
+        // RLIMIT_CPU used up (CPU time is charged at switches, system calls and fair-class ticks)
+        else if (processes_[currentProcessIndex_].hasExceededCpuLimit()) {
+            LOG_WARN("Process %d exceeded RLIMIT_CPU", processes_[currentProcessIndex_].pid_);
+            processes_[currentProcessIndex_].getThreadGroupLeader()->terminate(EXIT_CPU_LIMIT);
+            processes_[currentProcessIndex_].terminate(EXIT_CPU_LIMIT);
+        }
 
-            // If the age of the current process is still greater than 0, continue running it.
-            if (processes_[currentProcessIndex_].age_ > 0) return reinterpret_cast<uint32_t*>(regs);
+        // if the process is not terminated, killed or sleeping
+        Process& current = processes_[currentProcessIndex_];
 
-            // If the age reaches 0, set the current process state to Ready.
-            processes_[currentProcessIndex_].state_ = Process::State::Ready;
-            processes_[currentProcessIndex_].age_   = static_cast<uint32_t>(processes_[currentProcessIndex_].priority_);
+        // Sleeping, exiting and sched_yield() (age zeroed) give the CPU up, everything else is a preemption
+        voluntary = (current.state_ != Process::State::Running && current.state_ != Process::State::Ready) || current.age_ == 0;
+        if (current.state_ == Process::State::Running || current.state_ == Process::State::Ready) {
+            if (current.isRealtime()) {
+                // Woken before it got to sleep: it is still the running one, not a queued one
+                if (current.state_ == Process::State::Ready) current.setState(Process::State::Running);
+
+                // sched_yield() zeroes the age; RoundRobin also rotates among equal priorities when its slice is used up
+                bool yielded      = current.age_ == 0;
+                bool sliceExpired = !yielded && current.policy_ == Process::Policy::RoundRobin && --current.age_ == 0;
+
+                // Otherwise keep running unless a higher real-time priority became ready
+                if (!yielded && !sliceExpired && !isRealtimeReady(current.realtimePriority_ + 1)) return static_cast<uint32_t*>(frame);
+
+                // A yielding real-time process steps aside for the rest of this tick, lower classes included
+                if (yielded) skip = currentProcessIndex_;
+
+                current.setState(Process::State::Ready);
+                current.age_ = Process::REALTIME_TIME_SLICE;
+            }
+            else {
+                // Woken before it got to sleep: it is still the running one, not a queued one
+                if (current.state_ == Process::State::Ready) current.setState(Process::State::Running);
+
+                // Charge the slice so far, so that its virtual runtime is up to date
+                uint64_t tsc = CPU::getTSC();
+                chargeCpuTime(current, tsc);
+                runQueue_.updateMinVruntime(&current);
+
+                // Continue running until its fair share is used up, unless a real-time process is waiting (preempted within one tick)
+                bool yielded = current.age_ == 0;
+                if (!yielded && !isRealtimeReady(Process::REALTIME_PRIORITY_MIN) && !shouldPreemptFair(current, tsc)) return static_cast<uint32_t*>(frame);
+
+                // sched_yield() lets the other fair processes go first, even those with a larger virtual runtime
+                if (yielded) skip = currentProcessIndex_;
+
+                current.setState(Process::State::Ready);
+            }
         }
     }
 
-    // Find the next process in the "Ready" state.
-    {
-        nextProcessIndex = currentProcessIndex_;
+    // Find the next process to run
+    uint32_t previousIndex = currentProcessIndex_;
+    currentProcessIndex_   = selectNextProcess(skip);
+    if (currentProcessIndex_ != previousIndex) {
+        TRACE(ContextSwitch, previousIndex != INVALID_SLOT ? processes_[previousIndex].pid_ : Trace::NO_PID, processes_[currentProcessIndex_].pid_);
+        accountSwitch(previousIndex != INVALID_SLOT ? &processes_[previousIndex] : nullptr, processes_[currentProcessIndex_], voluntary);
+    }
+    else processes_[currentProcessIndex_].schedStats_.readyTsc = 0;  // Nothing else to run: it did not wait
 
-        for (size_t i = 0; i < processes_.size(); ++i) {
-            nextProcessIndex = (currentProcessIndex_ + 1 + i) % processes_.size();
-            if (processes_[nextProcessIndex].getState() == Process::State::Ready) break;
-        }
-        currentProcessIndex_ = nextProcessIndex;
+    // A real-time process coming back from a yield or a sleep starts with a full slice (the fair class only uses age_ to flag a yield)
+    if (processes_[currentProcessIndex_].age_ == 0) {
+        processes_[currentProcessIndex_].age_ = processes_[currentProcessIndex_].isRealtime() ? Process::REALTIME_TIME_SLICE : 1;
     }
 
-    // Set the new process state to running.
-    processes_[currentProcessIndex_].state_ = Process::State::Running;
+    // Set the new process state to running (it leaves the run queue), its slice starts now
+    processes_[currentProcessIndex_].setState(Process::State::Running);
+    processes_[currentProcessIndex_].sliceStartTsc_ = CPU::getTSC();
+    FPU::onContextSwitch(&processes_[currentProcessIndex_]);
     processes_[currentProcessIndex_].upTime_++;
 
     // If the new process is in user mode, set the kernel stack.
     if (processes_[currentProcessIndex_].mode_ == Process::Mode::User) {
         // set the kernel stack at the top of the kernel stack
         kernel::gdt_ptr->setKernelStack(reinterpret_cast<uint32_t>(processes_[currentProcessIndex_].kernelStack_) + PAGE_SIZE * PROCESS_KERNEL_STACK_SIZE - 1);
+
+        // load the thread's TLS segment (picked up when GS is popped on return)
+        const auto& tls = processes_[currentProcessIndex_].tls_;
+        kernel::gdt_ptr->setThreadLocalStorage(tls.base, tls.limitRaw, tls.limitInPages ? GDT::Granularity::Page : GDT::Granularity::Byte);
     }
 
     // Return the new process's stack pointer.
@@ -190,11 +359,311 @@ uint32_t* PalmyraOS::kernel::TaskManager::interruptHandler(PalmyraOS::kernel::in
     return result;
 }
 
+uint32_t PalmyraOS::kernel::TaskManager::selectNextProcess(uint32_t skip) {
+    size_t count          = processes_.size();
+    uint32_t bestRealtime = INVALID_SLOT;
+    uint32_t bestPriority = 0;
+
+    // Circular scan for real-time processes starting after the current slot (the current one comes last)
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t index   = (currentProcessIndex_ + 1 + i) % count;
+        Process& process = processes_[index];
+        if (index == skip || process.state_ != Process::State::Ready || !process.isRealtime()) continue;
+
+        if (process.realtimePriority_ > bestPriority) {
+            bestRealtime = index;
+            bestPriority = process.realtimePriority_;
+        }
+    }
+    if (bestRealtime != INVALID_SLOT) return bestRealtime;
+
+    // Then the fair process that had the least CPU time for its weight
+    Process* fair = runQueue_.first(skip != INVALID_SLOT ? &processes_[skip] : nullptr);
+    if (fair) return static_cast<uint32_t>(fair - processes_.data());
+
+    // Nothing else is ready: the yielding process continues, otherwise keep the current slot
+    if (skip != INVALID_SLOT) return skip;
+    return currentProcessIndex_ == INVALID_SLOT ? 0 : currentProcessIndex_;
+}
+
+bool PalmyraOS::kernel::TaskManager::isRealtimeReady(uint32_t minimumPriority) {
+    for (auto& process: processes_) {
+        if (process.state_ == Process::State::Ready && process.isRealtime() && process.realtimePriority_ >= minimumPriority) return true;
+    }
+    return false;
+}
+
+void PalmyraOS::kernel::TaskManager::wakeTimedSleepers(uint64_t now) {
+    nextWakeupTick_ = UINT64_MAX;
+    for (auto& process: processes_) {
+        if (process.wakeupTick_ == 0) continue;
+
+        // A process that set its deadline but has not gone to sleep yet keeps it
+        if (process.wakeupTick_ <= now && process.state_ == Process::State::Waiting) {
+            process.wakeupTick_ = 0;
+            process.setState(Process::State::Ready);
+        }
+        else if (process.wakeupTick_ < nextWakeupTick_) nextWakeupTick_ = process.wakeupTick_;
+    }
+}
+
+void PalmyraOS::kernel::TaskManager::chargeCpuTime(Process& process, uint64_t now) {
+    SchedStats& stats  = process.schedStats_;
+    uint64_t elapsed   = now - stats.accountedTsc;
+    stats.accountedTsc = now;
+
+    // The whole thread group counts against RLIMIT_CPU
+    process.getThreadGroupLeader()->cpuCycles_ += elapsed;
+
+    // Kernel processes never leave the kernel, user processes only during system calls
+    if (process.mode_ == Process::Mode::Kernel || stats.kernelDepth > 0) {
+        stats.kernelCycles        += elapsed;
+        systemStats_.kernelCycles += elapsed;
+    }
+    else {
+        stats.userCycles        += elapsed;
+        systemStats_.userCycles += elapsed;
+    }
+
+    // Virtual runtime: real time for nice 0, slower for heavier (lower nice) processes
+    if (process.isRealtime()) return;
+    uint32_t weight = RunQueue::weightOf(process.nice_);
+    process.vruntime_ += weight == RunQueue::NICE_0_WEIGHT ? elapsed : elapsed * RunQueue::NICE_0_WEIGHT / weight;
+}
+
+bool PalmyraOS::kernel::TaskManager::shouldPreemptFair(const Process& current, uint64_t now) {
+    const Process* first = runQueue_.first();
+    if (!first) return false;
+
+    uint64_t mhz            = CPU::getCPUFrequency();
+    uint64_t latency        = schedLatencyMicroseconds_ * mhz;
+    uint64_t minGranularity = minGranularityMicroseconds_ * mhz;
+
+    // Every ready process runs once per period, the period stretches so that no slice is below the min granularity
+    uint64_t ready  = runQueue_.size() + 1;
+    uint64_t period = ready * minGranularity > latency ? ready * minGranularity : latency;
+    uint32_t weight = RunQueue::weightOf(current.nice_);
+    uint64_t ideal  = period * weight / (runQueue_.getTotalWeight() + weight);
+    if (ideal < minGranularity) ideal = minGranularity;
+
+    uint64_t ran = now - current.sliceStartTsc_;
+    if (ran >= ideal) return true;
+    return ran >= minGranularity && current.vruntime_ > first->vruntime_ && current.vruntime_ - first->vruntime_ > ideal;
+}
+
+void PalmyraOS::kernel::TaskManager::accountSwitch(Process* previous, Process& next, bool voluntary) {
+    uint64_t now = CPU::getTSC();
+
+    if (previous) {
+        chargeCpuTime(*previous, now);
+        if (voluntary) {
+            previous->schedStats_.voluntarySwitches++;
+            systemStats_.voluntarySwitches++;
+        }
+        else {
+            previous->schedStats_.involuntarySwitches++;
+            systemStats_.involuntarySwitches++;
+        }
+
+        // Preempted or yielding: it waits for the CPU from now on (sleepers start waiting when woken)
+        if (previous->state_ == Process::State::Ready) previous->schedStats_.readyTsc = now;
+    }
+
+    SchedStats& stats = next.schedStats_;
+    if (stats.readyTsc != 0 && now > stats.readyTsc) {
+        recordWait(stats, now - stats.readyTsc);
+        recordWait(systemStats_, now - stats.readyTsc);
+    }
+    stats.readyTsc     = 0;
+    stats.accountedTsc = now;
+    stats.runs++;
+    systemStats_.runs++;
+}
+
+void PalmyraOS::kernel::TaskManager::recordWait(SchedStats& stats, uint64_t cycles) {
+    stats.waitCycles += cycles;
+    if (cycles > stats.maxWaitCycles) stats.maxWaitCycles = cycles;
+
+    // Power-of-two buckets of microseconds, found without dividing
+    uint64_t cyclesPerMicrosecond = CPU::getCPUFrequency();
+    uint32_t bucket               = 0;
+    while (bucket + 1 < SchedStats::LATENCY_BUCKETS && cycles >= cyclesPerMicrosecond << bucket) bucket++;
+    stats.latency[bucket]++;
+}
+
+void PalmyraOS::kernel::TaskManager::enterSystemCall() {
+    if (!hasCurrentProcess()) return;
+    Process& current = processes_[currentProcessIndex_];
+    chargeCpuTime(current, CPU::getTSC());
+    current.schedStats_.kernelDepth++;
+}
+
+void PalmyraOS::kernel::TaskManager::exitSystemCall() {
+    if (!hasCurrentProcess()) return;
+    Process& current = processes_[currentProcessIndex_];
+    chargeCpuTime(current, CPU::getTSC());
+    if (current.schedStats_.kernelDepth > 0) current.schedStats_.kernelDepth--;
+}
+
+bool PalmyraOS::kernel::TaskManager::isInUserCopy(uint32_t address) {
+    if (!hasCurrentProcess() || atomicSectionLevel_ > 0) return false;
+    const Process& current = processes_[currentProcessIndex_];
+    return address >= current.userCopyStart_ && address < current.userCopyEnd_;
+}
+
+PalmyraOS::kernel::SchedStats PalmyraOS::kernel::TaskManager::getSchedStats(const Process* process) {
+    uint32_t flags   = InterruptController::saveAndDisableInterrupts();
+    SchedStats stats = process ? process->schedStats_ : systemStats_;
+
+    // The running slice of the current process is only charged at its next switch or system call
+    if (hasCurrentProcess()) {
+        const Process& current = processes_[currentProcessIndex_];
+        if (!process || process == &current) {
+            uint64_t elapsed = CPU::getTSC() - current.schedStats_.accountedTsc;
+            if (current.mode_ == Process::Mode::Kernel || current.schedStats_.kernelDepth > 0) stats.kernelCycles += elapsed;
+            else stats.userCycles += elapsed;
+        }
+    }
+
+    InterruptController::restoreInterrupts(flags);
+    return stats;
+}
+
+uint64_t PalmyraOS::kernel::TaskManager::cyclesToMicroseconds(uint64_t cycles) {
+    uint32_t mhz = CPU::getCPUFrequency();
+    return mhz ? cycles / mhz : 0;
+}
+
+size_t PalmyraOS::kernel::TaskManager::formatSchedStats(const SchedStats& stats, char* buffer, size_t size) {
+    size_t written = snprintf(buffer,
+                              size,
+                              "user_us: %llu\nkernel_us: %llu\nwait_us: %llu\nwait_max_us: %llu\nruns: %u\nvoluntary_switches: %u\ninvoluntary_switches: %u\n",
+                              cyclesToMicroseconds(stats.userCycles),
+                              cyclesToMicroseconds(stats.kernelCycles),
+                              cyclesToMicroseconds(stats.waitCycles),
+                              cyclesToMicroseconds(stats.maxWaitCycles),
+                              stats.runs,
+                              stats.voluntarySwitches,
+                              stats.involuntarySwitches);
+
+    // Latency histogram: "<limit:count" per bucket, the last one open-ended
+    written += snprintf(buffer + written, size - written, "latency_us:");
+    for (uint32_t i = 0; i < SchedStats::LATENCY_BUCKETS && written < size; ++i) {
+        if (i + 1 < SchedStats::LATENCY_BUCKETS) written += snprintf(buffer + written, size - written, " <%u:%u", 1u << i, stats.latency[i]);
+        else written += snprintf(buffer + written, size - written, " >=%u:%u", 1u << (i - 1), stats.latency[i]);
+    }
+    if (written + 1 < size) buffer[written++] = '\n';
+    buffer[written] = '\0';
+    return written;
+}
+
+size_t PalmyraOS::kernel::TaskManager::readSchedStat(char* buffer, size_t size, size_t offset) {
+    char output[1024];
+    SchedStats stats = getSchedStats(nullptr);
+    size_t written   = snprintf(output, sizeof(output), "cpu_mhz: %u\nswitches: %u\n", CPU::getCPUFrequency(), stats.voluntarySwitches + stats.involuntarySwitches);
+
+    written += formatSchedStats(stats, output + written, sizeof(output) - written);
+
+    if (offset >= written) return 0;
+    size_t copied = written - offset < size ? written - offset : size;
+    memcpy(buffer, output + offset, copied);
+    return copied;
+}
+
+void PalmyraOS::kernel::TaskManager::setWakeupTick(Process* process, uint64_t deadlineTick) {
+    uint32_t flags       = InterruptController::saveAndDisableInterrupts();
+    process->wakeupTick_ = deadlineTick;
+    if (deadlineTick != 0 && deadlineTick < nextWakeupTick_) nextWakeupTick_ = deadlineTick;
+    InterruptController::restoreInterrupts(flags);
+}
+
+bool PalmyraOS::kernel::TaskManager::setScheduler(Process* process, Process::Policy policy, uint32_t realtimePriority) {
+    bool realtime = policy != Process::Policy::Normal;
+    if (realtime && (realtimePriority < Process::REALTIME_PRIORITY_MIN || realtimePriority > Process::REALTIME_PRIORITY_MAX)) return false;
+    if (!realtime && realtimePriority != 0) return false;
+
+    uint32_t flags             = InterruptController::saveAndDisableInterrupts();
+    process->policy_           = policy;
+    process->realtimePriority_ = realtimePriority;
+    process->age_              = realtime ? Process::REALTIME_TIME_SLICE : 1;
+
+    // Joining the fair class counts as a new process (it starts at the queue's minimum), leaving it dequeues
+    updateRunQueue(process, Process::State::New);
+    InterruptController::restoreInterrupts(flags);
+
+    return true;
+}
+
+void PalmyraOS::kernel::TaskManager::setNice(Process* process, int32_t nice) {
+    if (nice < -20) nice = -20;
+    if (nice > 19) nice = 19;
+
+    // The weight is part of the queue's total: requeue around the change
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+    bool queued    = process->runQueueIndex_ != RunQueue::NOT_QUEUED;
+    if (queued) runQueue_.dequeue(process);
+    process->nice_ = nice;
+    if (queued) runQueue_.enqueue(process);
+    InterruptController::restoreInterrupts(flags);
+}
+
+void PalmyraOS::kernel::TaskManager::updateRunQueue(Process* process, Process::State previous) {
+    uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+    if (process->isRealtime() || process->state_ != Process::State::Ready) runQueue_.dequeue(process);
+    else if (process->runQueueIndex_ == RunQueue::NOT_QUEUED) {
+        // Sleepers get a bonus of half a latency, but may not bank CPU time while asleep; preempted processes keep their place
+        uint64_t floor = runQueue_.getMinVruntime();
+        if (previous == Process::State::Waiting) {
+            uint64_t bonus = static_cast<uint64_t>(schedLatencyMicroseconds_ / 2) * CPU::getCPUFrequency();
+            floor          = floor > bonus ? floor - bonus : 0;
+        }
+        if (previous != Process::State::Running && process->vruntime_ < floor) process->vruntime_ = floor;
+        runQueue_.enqueue(process);
+    }
+
+    InterruptController::restoreInterrupts(flags);
+}
+
+size_t PalmyraOS::kernel::TaskManager::readSchedTunables(char* buffer, size_t size, size_t offset) {
+    char output[128];
+    size_t written = snprintf(output, sizeof(output), "latency_us: %u\nmin_granularity_us: %u\n", schedLatencyMicroseconds_, minGranularityMicroseconds_);
+
+    if (offset >= written) return 0;
+    size_t copied = written - offset < size ? written - offset : size;
+    memcpy(buffer, output + offset, copied);
+    return copied;
+}
+
+size_t PalmyraOS::kernel::TaskManager::writeSchedTunables(const char* buffer, size_t size, size_t offset) {
+    // "latency_us 20000" or "min_granularity_us 4000"
+    char input[64];
+    size_t length = size < sizeof(input) - 1 ? size : sizeof(input) - 1;
+    memcpy(input, buffer, length);
+    input[length] = '\0';
+
+    char* value = strchr(input, ' ');
+    if (!value) return -EINVAL;
+    *value++ = '\0';
+
+    uint32_t number = strtoul(value, nullptr, 10);
+    if (number < 1000 || number > 1000000) return -EINVAL;  // 1 ms .. 1 s
+
+    if (strcmp(input, "latency_us") == 0) schedLatencyMicroseconds_ = number;
+    else if (strcmp(input, "min_granularity_us") == 0) minGranularityMicroseconds_ = number;
+    else return -EINVAL;
+    return size;
+}
+
 PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::getCurrentProcess() { return &processes_[currentProcessIndex_]; }
 
 PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::getProcess(uint32_t pid) {
-    if (pid >= processes_.size()) return nullptr;
-    return &processes_[pid];
+    if (capacity_ == 0) return nullptr;
+
+    // The slot is encoded in the PID, the generation check rejects stale PIDs
+    uint32_t slot = pid % capacity_;
+    if (slot >= processes_.size() || processes_[slot].pid_ != pid) return nullptr;
+    return &processes_[slot];
 }
 
 void PalmyraOS::kernel::TaskManager::startAtomicOperation() {
@@ -206,18 +675,28 @@ void PalmyraOS::kernel::TaskManager::endAtomicOperation() {
     if (atomicSectionLevel_ > 0) atomicSectionLevel_--;
 }
 
-PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::execv_elf(KVector<uint8_t>& elfFileContent,
+PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::execv_elf(vfs::InodeBase* image,
                                                                       PalmyraOS::kernel::Process::Mode mode,
                                                                       PalmyraOS::kernel::Process::Priority priority,
                                                                       uint32_t argc,
                                                                       char* const* argv,
                                                                       char* const* envp) {
     // Ensure the ELF file is large enough to contain the header
-    if (elfFileContent.size() < EI_NIDENT) return nullptr;
+    size_t fileSize = image->getSize();
+    if (fileSize < sizeof(Elf32_Ehdr)) return nullptr;
+
+    // The headers come from the first file page, through the page cache: it usually starts the text segment as well
+    KVector<uint8_t> headers(fileSize < PAGE_SIZE ? fileSize : PAGE_SIZE);
+    {
+        void* firstPage = PageCache::acquire(image, 0);
+        if (!firstPage) return nullptr;
+        memcpy(headers.data(), firstPage, headers.size());
+        PageCache::release(firstPage);
+    }
 
     // Read the ELF identification bytes
     unsigned char e_ident[EI_NIDENT];
-    memcpy(e_ident, elfFileContent.data(), EI_NIDENT);
+    memcpy(e_ident, headers.data(), EI_NIDENT);
 
     // Verify the ELF magic number
     if (e_ident[EI_MAG0] != ELFMAG0 || e_ident[EI_MAG1] != ELFMAG1) return nullptr;
@@ -232,8 +711,8 @@ PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::execv_elf(KVector<ui
     // Check the ELF version (1)
     if (e_ident[EI_VERSION] != EV_CURRENT) return nullptr;
 
-    // Now cast the elfFileContent data to an Elf32_Ehdr structure for easier access to the fields
-    const auto* elfHeader = reinterpret_cast<const Elf32_Ehdr*>(elfFileContent.data());
+    // Now cast the header data to an Elf32_Ehdr structure for easier access to the fields
+    const auto* elfHeader = reinterpret_cast<const Elf32_Ehdr*>(headers.data());
 
     // Check if the ELF file is an executable
     if (elfHeader->e_type != ET_EXEC) return nullptr;
@@ -241,6 +720,12 @@ PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::execv_elf(KVector<ui
     // Check if the ELF file is for the Intel 80386 architecture
     if (elfHeader->e_machine != EM_386) return nullptr;
 
+    // The program headers must be in the first page (as laid out by the linker)
+    if (elfHeader->e_phoff + elfHeader->e_phnum * sizeof(Elf32_Phdr) > headers.size()) {
+        LOG_WARN("ELF program headers outside of the first page are not supported");
+        return nullptr;
+    }
+
     // Validations are successful.
     LOG_DEBUG("Elf Validations successful. Loading headers..");
 
@@ -248,46 +733,50 @@ PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::execv_elf(KVector<ui
     Process* process = newProcess(nullptr, mode, priority, argc, argv, envp, false);
     if (!process) return nullptr;
 
-    // Temporarily set process as killed, in case of invalid initialization
-    process->setState(Process::State::Killed);
+    // Not runnable until the image is set up; a failed load is terminated so that the reaper frees the slot
+    process->setState(Process::State::New);
 
     uint32_t highest_vaddr     = 0;  // To track the highest loaded segment's address for initializing current_brk
+    uint32_t programHeadersVA  = 0;  // Where the program headers appear in the image (AT_PHDR)
 
-    // Load program headers
-    const auto* programHeaders = reinterpret_cast<const Elf32_Phdr*>(elfFileContent.data() + elfHeader->e_phoff);
+    // Record the PT_LOAD segments: nothing is mapped before the first access
+    const auto* programHeaders = reinterpret_cast<const Elf32_Phdr*>(headers.data() + elfHeader->e_phoff);
     for (int i = 0; i < elfHeader->e_phnum; ++i) {
         const Elf32_Phdr& ph = programHeaders[i];
 
-        // Only load PT_LOAD segments
-        if (ph.p_type != PT_LOAD) continue;
-
-        // Align the virtual address down to the nearest page boundary
-        uint32_t aligned_vaddr = ph.p_vaddr & ~(PAGE_SIZE - 1);
-
-        // Calculate the page offset
-        uint32_t page_offset   = ph.p_vaddr - aligned_vaddr;
+        if (ph.p_type == PT_PHDR) programHeadersVA = ph.p_vaddr;
 
-        // Adjust the size to include the page offset
-        uint32_t segment_size  = ph.p_memsz + page_offset;
-
-        // Calculate the number of pages needed
-        size_t num_pages       = (segment_size + PAGE_SIZE - 1) >> PAGE_BITS;
+        // Only load PT_LOAD segments
+        if (ph.p_type != PT_LOAD || ph.p_memsz == 0) continue;
 
-        LOG_DEBUG("Loading Section %d: at 0x%X for %d pages", i, aligned_vaddr, num_pages);
-        void* segmentAddress = process->allocatePagesAt(reinterpret_cast<void*>(aligned_vaddr), num_pages);
-        if (!segmentAddress) return nullptr;
+        // The file part must exist and fit in the segment
+        if (ph.p_filesz > ph.p_memsz || ph.p_offset + ph.p_filesz > fileSize) {
+            process->terminate(-ENOEXEC);
+            return nullptr;
+        }
 
-        // Copy the segment into memory
-        memcpy(reinterpret_cast<uint8_t*>(segmentAddress) + page_offset, elfFileContent.data() + ph.p_offset, ph.p_filesz);
+        ImageSegment segment{};
+        segment.start      = ph.p_vaddr & ~(PAGE_SIZE - 1);
+        segment.end        = (ph.p_vaddr + ph.p_memsz + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+        segment.vaddr      = ph.p_vaddr;
+        segment.fileOffset = ph.p_offset;
+        segment.fileSize   = ph.p_filesz;
+        segment.writable   = ph.p_flags & PF_W;
+        process->imageSegments_.push_back(segment);
 
-        // Zero the remaining memory if p_memsz > p_filesz
-        if (ph.p_memsz > ph.p_filesz) { memset(reinterpret_cast<uint8_t*>(segmentAddress) + page_offset + ph.p_filesz, 0, ph.p_memsz - ph.p_filesz); }
+        LOG_DEBUG("Section %d: 0x%X - 0x%X (%s, on demand)", i, segment.start, segment.end, segment.writable ? "copy-on-write" : "shared");
 
+        // Without PT_PHDR, the headers are visible if a segment maps the start of the file
+        if (!programHeadersVA && elfHeader->e_phoff >= ph.p_offset && elfHeader->e_phoff < ph.p_offset + ph.p_filesz) {
+            programHeadersVA = ph.p_vaddr + (elfHeader->e_phoff - ph.p_offset);
+        }
 
         // Update the highest virtual address to track the end of the loaded segments
         uint32_t segment_end = ph.p_vaddr + ph.p_memsz;
         if (segment_end > highest_vaddr) { highest_vaddr = segment_end; }
     }
+    process->image_ = image;
+    PageCache::pinFile(image);
     LOG_DEBUG("Loading headers completed.");
 
     // Initialize the program break to the end of the last loaded segment
@@ -305,7 +794,7 @@ PalmyraOS::kernel::Process* PalmyraOS::kernel::TaskManager::execv_elf(KVector<ui
      * The constructor skipped stack initialization for ELF processes, so this is
      * the ONLY time the stack is set up (avoiding double allocation).
      */
-    process->buildAuxiliaryVectorForELF(elfHeader, programHeaders);
+    process->buildAuxiliaryVectorForELF(elfHeader, programHeadersVA);
 
     // Initialize the stack with argc, argv, envp, and auxv (one-time setup)
     process->initializeArgumentsForELF(argc, argv, envp);
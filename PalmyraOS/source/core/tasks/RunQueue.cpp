@@ -0,0 +1,105 @@
+
+#include "core/tasks/RunQueue.h"
+#include "core/tasks/Process.h"
+
+namespace PalmyraOS::kernel {
+
+    namespace {
+        // Weight of nice -20 .. 19: consecutive values differ by ~1.25, so one nice step moves ~10% of the CPU
+        constexpr uint32_t NICE_WEIGHTS[40] = {
+                88761, 71755, 56483, 46273, 36291,  // -20 .. -16
+                29154, 23254, 18705, 14949, 11916,  // -15 .. -11
+                9548,  7620,  6100,  4904,  3906,   // -10 .. -6
+                3121,  2501,  1991,  1586,  1277,   //  -5 .. -1
+                1024,  820,   655,   526,   423,    //   0 .. 4
+                335,   272,   215,   172,   137,    //   5 .. 9
+                110,   87,    70,    56,    45,     //  10 .. 14
+                36,    29,    23,    18,    15,     //  15 .. 19
+        };
+    }  // namespace
+
+    uint32_t RunQueue::weightOf(int32_t nice) {
+        if (nice < -20) nice = -20;
+        if (nice > 19) nice = 19;
+        return NICE_WEIGHTS[nice + 20];
+    }
+
+    void RunQueue::reserve(uint32_t capacity) { heap_.reserve(capacity); }
+
+    void RunQueue::enqueue(Process* process) {
+        if (process->runQueueIndex_ != NOT_QUEUED) return;
+
+        heap_.push_back(process);
+        process->runQueueIndex_ = heap_.size() - 1;
+        totalWeight_ += weightOf(process->nice_);
+        siftUp(process->runQueueIndex_);
+    }
+
+    void RunQueue::dequeue(Process* process) {
+        uint32_t index = process->runQueueIndex_;
+        if (index == NOT_QUEUED) return;
+
+        process->runQueueIndex_ = NOT_QUEUED;
+        totalWeight_ -= weightOf(process->nice_);
+
+        // Move the last element into the hole and restore the heap around it
+        Process* last = heap_.back();
+        heap_.pop_back();
+        if (last == process) return;
+
+        place(index, last);
+        siftUp(index);
+        siftDown(last->runQueueIndex_);
+    }
+
+    Process* RunQueue::first(const Process* skip) const {
+        if (heap_.empty()) return nullptr;
+        if (heap_[0] != skip) return heap_[0];
+
+        // The root is skipped: the next smallest is one of its children
+        Process* best = nullptr;
+        for (uint32_t child = 1; child <= 2 && child < heap_.size(); ++child) {
+            if (!best || heap_[child]->vruntime_ < best->vruntime_) best = heap_[child];
+        }
+        return best;
+    }
+
+    void RunQueue::updateMinVruntime(const Process* running) {
+        if (!running && heap_.empty()) return;
+
+        uint64_t floor = running ? running->vruntime_ : heap_[0]->vruntime_;
+        if (!heap_.empty() && heap_[0]->vruntime_ < floor) floor = heap_[0]->vruntime_;
+        if (floor > minVruntime_) minVruntime_ = floor;
+    }
+
+    void RunQueue::siftUp(uint32_t index) {
+        Process* process = heap_[index];
+        while (index > 0) {
+            uint32_t parent = (index - 1) / 2;
+            if (heap_[parent]->vruntime_ <= process->vruntime_) break;
+            place(index, heap_[parent]);
+            index = parent;
+        }
+        place(index, process);
+    }
+
+    void RunQueue::siftDown(uint32_t index) {
+        Process* process = heap_[index];
+        uint32_t count   = heap_.size();
+        while (true) {
+            uint32_t child = 2 * index + 1;
+            if (child >= count) break;
+            if (child + 1 < count && heap_[child + 1]->vruntime_ < heap_[child]->vruntime_) ++child;
+            if (process->vruntime_ <= heap_[child]->vruntime_) break;
+            place(index, heap_[child]);
+            index = child;
+        }
+        place(index, process);
+    }
+
+    void RunQueue::place(uint32_t index, Process* process) {
+        heap_[index]            = process;
+        process->runQueueIndex_ = index;
+    }
+
+}  // namespace PalmyraOS::kernel
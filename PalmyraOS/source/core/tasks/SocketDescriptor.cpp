@@ -6,6 +6,7 @@
 #include "core/peripherals/Logger.h"
 #include "libs/memory.h"
 #include "palmyraOS/errono.h"
+#include "palmyraOS/poll.h"
 #include "palmyraOS/socket.h"  // For socket constants (AF_INET, SOCK_DGRAM, etc.)
 
 namespace PalmyraOS::kernel {
@@ -149,6 +150,17 @@ namespace PalmyraOS::kernel {
         }
     }
 
+    uint32_t SocketDescriptor::poll() {
+        if (!protocolSocket_) return POLLERR;
+
+        // Datagrams are sent right away: writing never blocks
+        uint32_t events = POLLOUT;
+        if (protocolSocket_->hasPendingData()) events |= POLLIN;
+        return events;
+    }
+
+    PollSource* SocketDescriptor::getPollSource() { return protocolSocket_ ? &protocolSocket_->getPollSource() : nullptr; }
+
     // ==================== Socket-Specific Operations ====================
 
     int SocketDescriptor::bind(const void* addr, uint32_t addrlen) {
@@ -0,0 +1,115 @@
+
+#include "core/tasks/StreamBuffer.h"
+#include "core/Interrupts.h"
+#include "core/SystemClock.h"
+#include "core/kernel.h"  // For kernelPagingDirectory_ptr
+#include "libs/memory.h"
+#include "palmyraOS/errono.h"
+#include "palmyraOS/poll.h"
+
+using PalmyraOS::kernel::interrupts::InterruptController;
+
+namespace PalmyraOS::kernel {
+
+    StreamBuffer::~StreamBuffer() {
+        if (buffer_) kernelPagingDirectory_ptr->freePages(buffer_, BUFFER_PAGES);
+    }
+
+    size_t StreamBuffer::read(char* buffer, size_t size, bool nonBlocking) {
+        if (size == 0) return 0;
+
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+        // Waiting counts as following: writers hold on to their data meanwhile
+        readerTick_ = SystemClock::getTicks();
+        while (count_ == 0 && !closed_ && !nonBlocking) {
+            readWaiters_.sleep();
+            readerTick_ = SystemClock::getTicks();
+        }
+
+        size_t result;
+        if (count_ == 0) result = closed_ ? 0 : -EAGAIN;
+        else {
+            uint32_t length = size < count_ ? size : count_;
+            uint32_t first  = length < CAPACITY - head_ ? length : CAPACITY - head_;
+            memcpy(buffer, buffer_ + head_, first);
+            memcpy(buffer + first, buffer_, length - first);
+
+            count_ -= length;
+            head_  = count_ ? (head_ + length) % CAPACITY : 0;  // Restart an empty ring at the front: the next copies do not wrap
+            result = length;
+
+            writeWaiters_.wakeAll();
+            pollSource_.notify(POLLOUT);
+        }
+
+        InterruptController::restoreInterrupts(flags);
+        return result;
+    }
+
+    size_t StreamBuffer::write(const char* buffer, size_t size) {
+        if (size == 0) return 0;
+
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+        if (!buffer_) buffer_ = static_cast<char*>(kernelPagingDirectory_ptr->allocatePages(BUFFER_PAGES));
+
+        size_t written = 0;
+        while (!closed_ && buffer_ && written < size) {
+            uint32_t remaining = size - written;
+            uint32_t space     = CAPACITY - count_;
+
+            // Full: wait for a following reader, or make room by dropping the oldest bytes
+            if (space == 0) {
+                if (hasFollowingReader()) {
+                    writeWaiters_.sleep(readerTick_ + READER_TIMEOUT);
+                    continue;
+                }
+                uint32_t drop = remaining < CAPACITY ? remaining : CAPACITY;
+                head_         = (head_ + drop) % CAPACITY;
+                count_        -= drop;
+                dropped_      += drop;
+                space         = drop;
+            }
+
+            uint32_t length = remaining < space ? remaining : space;
+            uint32_t tail   = (head_ + count_) % CAPACITY;
+            uint32_t first  = length < CAPACITY - tail ? length : CAPACITY - tail;
+            memcpy(buffer_ + tail, buffer + written, first);
+            memcpy(buffer_, buffer + written + first, length - first);
+
+            count_  += length;
+            written += length;
+
+            readWaiters_.wakeAll();
+            pollSource_.notify(POLLIN);
+        }
+
+        // Out of memory for the ring: the output is lost, as if nobody had read it
+        if (!buffer_) dropped_ += size;
+
+        size_t result = !closed_ ? size : written ? written : -EPIPE;
+        InterruptController::restoreInterrupts(flags);
+        return result;
+    }
+
+    void StreamBuffer::close() {
+        uint32_t flags = InterruptController::saveAndDisableInterrupts();
+
+        closed_ = true;
+        readWaiters_.wakeAll();
+        writeWaiters_.wakeAll();
+        pollSource_.notify(POLLIN | POLLHUP);
+
+        InterruptController::restoreInterrupts(flags);
+    }
+
+    uint32_t StreamBuffer::poll() const {
+        uint32_t events = count_ > 0 ? POLLIN : 0;
+        if (closed_) return events | POLLHUP;
+        return events | (count_ < CAPACITY || !hasFollowingReader() ? POLLOUT : 0);
+    }
+
+    bool StreamBuffer::hasFollowingReader() const { return readerTick_ != 0 && SystemClock::getTicks() < readerTick_ + READER_TIMEOUT; }
+
+}  // namespace PalmyraOS::kernel
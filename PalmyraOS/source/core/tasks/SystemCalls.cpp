@@ -3,88 +3,222 @@
 #include "core/tasks/SystemCalls.h"
 #include "core/Interrupts.h"
 #include "core/cpu.h"
+#include "core/kernel.h"
 #include "libs/memory.h"
 
 // API Headers
 #include "palmyraOS/errono.h"
+#include "palmyraOS/io_uring.h"
 #include "palmyraOS/time.h"
 #include "palmyraOS/unistd.h"
 
 // System Objects
 #include "core/SystemClock.h"
+#include "core/TimePage.h"
+#include "core/Trace.h"
 #include "core/files/BuiltinExecutableInode.h"
 #include "core/files/VirtualFileSystem.h"
+#include "core/Futex.h"
+#include "core/LocalPage.h"
+#include "core/Poll.h"
+#include "core/tasks/EpollDescriptor.h"
 #include "core/tasks/FileDescriptor.h"
+#include "core/tasks/IoRingDescriptor.h"
+#include "core/tasks/PipeDescriptor.h"
 #include "core/tasks/ProcessManager.h"
 #include "core/tasks/SocketDescriptor.h"
+#include "core/tasks/StreamBuffer.h"
 #include "core/tasks/WindowManager.h"
 
 #include "core/peripherals/Logger.h"
 #include "userland/userland.h"
 
 
-// Define the static member systemCallHandlers_
-PalmyraOS::kernel::KMap<uint32_t, PalmyraOS::kernel::SystemCallsManager::SystemCallHandler> PalmyraOS::kernel::SystemCallsManager::systemCallHandlers_;
+// Dispatch table, constant-initialized (lives in .rodata, no setup at boot)
+const PalmyraOS::kernel::SystemCallsManager::DispatchTable PalmyraOS::kernel::SystemCallsManager::dispatchTable_ = [] {
+    DispatchTable table{};
 
-void PalmyraOS::kernel::SystemCallsManager::initialize() {
-    // Setting the interrupt handler for system calls (interrupt 0x80)
-    interrupts::InterruptController::setInterruptHandler(0x80, &handleInterrupt);
-
-    // Map system call numbers to their respective handler functions
     // POSIX
-    systemCallHandlers_[POSIX_INT_EXIT]               = &SystemCallsManager::handleExit;
-    systemCallHandlers_[POSIX_INT_GET_PID]            = &SystemCallsManager::handleGetPid;
-    systemCallHandlers_[POSIX_INT_YIELD]              = &SystemCallsManager::handleYield;
-    systemCallHandlers_[POSIX_INT_MMAP]               = &SystemCallsManager::handleMmap;
-    systemCallHandlers_[POSIX_INT_GETTIME]            = &SystemCallsManager::handleGetTime;
-    systemCallHandlers_[POSIX_INT_CLOCK_NANOSLEEP_64] = &SystemCallsManager::handleClockNanoSleep64;
-    systemCallHandlers_[POSIX_INT_BRK]                = &SystemCallsManager::handleBrk;
-    systemCallHandlers_[POSIX_INT_SETTHREADAREA]      = &SystemCallsManager::handleSetThreadArea;
-    systemCallHandlers_[POSIX_INT_GETUID]             = &SystemCallsManager::handleGetUID;
-    systemCallHandlers_[POSIX_INT_GETGID]             = &SystemCallsManager::handleGetGID;
-    systemCallHandlers_[POSIX_INT_GETEUID32]          = &SystemCallsManager::handleGetEUID;
-    systemCallHandlers_[POSIX_INT_GETEGID32]          = &SystemCallsManager::handleGetEUID;
-    systemCallHandlers_[POSIX_INT_REBOOT]             = &SystemCallsManager::handleReboot;
+    table.dense[POSIX_INT_EXIT]               = {&handleExit, "exit"};
+    table.dense[POSIX_INT_GET_PID]            = {&handleGetPid, "getpid"};
+    table.dense[POSIX_INT_YIELD]              = {&handleYield, "sched_yield"};
+    table.dense[POSIX_INT_SCHED_SETSCHEDULER] = {&handleSchedSetScheduler, "sched_setscheduler"};
+    table.dense[POSIX_INT_SCHED_GETSCHEDULER] = {&handleSchedGetScheduler, "sched_getscheduler"};
+    table.dense[POSIX_INT_GETPRIORITY]        = {&handleGetPriority, "getpriority"};
+    table.dense[POSIX_INT_SETPRIORITY]        = {&handleSetPriority, "setpriority"};
+    table.dense[POSIX_INT_GETRLIMIT]          = {&handleGetRlimit, "ugetrlimit"};
+    table.dense[POSIX_INT_SETRLIMIT]          = {&handleSetRlimit, "setrlimit"};
+    table.dense[POSIX_INT_MMAP]               = {&handleMmap, "mmap"};
+    table.dense[POSIX_INT_MUNMAP]             = {&handleMunmap, "munmap"};
+    table.dense[POSIX_INT_GETTIME]            = {&handleGetTime, "clock_gettime"};
+    table.dense[POSIX_INT_CLOCK_NANOSLEEP_64] = {&handleClockNanoSleep64, "clock_nanosleep"};
+    table.dense[POSIX_INT_BRK]                = {&handleBrk, "brk"};
+    table.dense[POSIX_INT_SETTHREADAREA]      = {&handleSetThreadArea, "set_thread_area"};
+    table.dense[POSIX_INT_CLONE]              = {&handleClone, "clone"};
+    table.dense[POSIX_INT_GETTID]             = {&handleGetTid, "gettid"};
+    table.dense[POSIX_INT_EXIT_GROUP]         = {&handleExitGroup, "exit_group"};
+    table.dense[POSIX_INT_GETUID]             = {&handleGetUID, "getuid"};
+    table.dense[POSIX_INT_GETGID]             = {&handleGetGID, "getgid"};
+    table.dense[POSIX_INT_GETEUID32]          = {&handleGetEUID, "geteuid32"};
+    table.dense[POSIX_INT_GETEGID32]          = {&handleGetEUID, "getegid32"};
+    table.dense[POSIX_INT_REBOOT]             = {&handleReboot, "reboot"};
 
     // VFS
-    systemCallHandlers_[POSIX_INT_OPEN]               = &SystemCallsManager::handleOpen;
-    systemCallHandlers_[POSIX_INT_CLOSE]              = &SystemCallsManager::handleClose;
-    systemCallHandlers_[POSIX_INT_WRITE]              = &SystemCallsManager::handleWrite;
-    systemCallHandlers_[POSIX_INT_READ]               = &SystemCallsManager::handleRead;
-    systemCallHandlers_[POSIX_INT_IOCTL]              = &SystemCallsManager::handleIoctl;
-    systemCallHandlers_[POSIX_INT_LSEEK]              = &SystemCallsManager::handleLongSeek;
-    systemCallHandlers_[POSIX_INT_MKDIR]              = &SystemCallsManager::handleMkdir;
-    systemCallHandlers_[POSIX_INT_RMDIR]              = &SystemCallsManager::handleRmdir;
-    systemCallHandlers_[POSIX_INT_UNLINK]             = &SystemCallsManager::handleUnlink;
+    table.dense[POSIX_INT_OPEN]               = {&handleOpen, "open"};
+    table.dense[POSIX_INT_CLOSE]              = {&handleClose, "close"};
+    table.dense[POSIX_INT_WRITE]              = {&handleWrite, "write"};
+    table.dense[POSIX_INT_READ]               = {&handleRead, "read"};
+    table.dense[POSIX_INT_IOCTL]              = {&handleIoctl, "ioctl"};
+    table.dense[POSIX_INT_LSEEK]              = {&handleLongSeek, "lseek"};
+    table.dense[POSIX_INT_MKDIR]              = {&handleMkdir, "mkdir"};
+    table.dense[POSIX_INT_RMDIR]              = {&handleRmdir, "rmdir"};
+    table.dense[POSIX_INT_UNLINK]             = {&handleUnlink, "unlink"};
 
     // Interprocess
-    systemCallHandlers_[POSIX_INT_WAITPID]            = &SystemCallsManager::handleWaitPID;
-    systemCallHandlers_[POSIX_INT_POSIX_SPAWN]        = &SystemCallsManager::handleSpawn;
-
-    // Custom
-    systemCallHandlers_[INT_INIT_WINDOW]              = &SystemCallsManager::handleInitWindow;
-    systemCallHandlers_[INT_CLOSE_WINDOW]             = &SystemCallsManager::handleCloseWindow;
-    systemCallHandlers_[INT_NEXT_KEY_EVENT]           = &SystemCallsManager::handleNextKeyboardEvent;
-    systemCallHandlers_[INT_NEXT_MOUSE_EVENT]         = &SystemCallsManager::handleNextMouseEvent;
-    systemCallHandlers_[INT_GET_WINDOW_STATUS]        = &SystemCallsManager::handleGetWindowStatus;
+    table.dense[POSIX_INT_WAITPID]            = {&handleWaitPID, "waitpid"};
+    table.dense[POSIX_INT_FUTEX]              = {&handleFutex, "futex"};
 
     // Adopted from Linux
-    systemCallHandlers_[LINUX_INT_GETDENTS]           = &SystemCallsManager::handleGetdents;
-    systemCallHandlers_[LINUX_INT_PRCTL]              = &SystemCallsManager::handleArchPrctl;
+    table.dense[LINUX_INT_GETDENTS]           = {&handleGetdents, "getdents"};
+    table.dense[LINUX_INT_PRCTL]              = {&handleArchPrctl, "arch_prctl"};
 
     // Socket syscalls
-    systemCallHandlers_[POSIX_INT_SOCKET]             = &SystemCallsManager::handleSocket;
-    systemCallHandlers_[POSIX_INT_BIND]               = &SystemCallsManager::handleBind;
-    systemCallHandlers_[POSIX_INT_CONNECT]            = &SystemCallsManager::handleConnect;
-    systemCallHandlers_[POSIX_INT_LISTEN]             = &SystemCallsManager::handleListen;
-    systemCallHandlers_[POSIX_INT_ACCEPT]             = &SystemCallsManager::handleAccept;
-    systemCallHandlers_[POSIX_INT_SENDTO]             = &SystemCallsManager::handleSendto;
-    systemCallHandlers_[POSIX_INT_RECVFROM]           = &SystemCallsManager::handleRecvfrom;
-    systemCallHandlers_[POSIX_INT_SETSOCKOPT]         = &SystemCallsManager::handleSetsockopt;
-    systemCallHandlers_[POSIX_INT_GETSOCKOPT]         = &SystemCallsManager::handleGetsockopt;
-    systemCallHandlers_[POSIX_INT_GETSOCKNAME]        = &SystemCallsManager::handleGetsockname;
-    systemCallHandlers_[POSIX_INT_GETPEERNAME]        = &SystemCallsManager::handleGetpeername;
-    systemCallHandlers_[POSIX_INT_SHUTDOWN]           = &SystemCallsManager::handleShutdown;
+    table.dense[POSIX_INT_SOCKET]             = {&handleSocket, "socket"};
+    table.dense[POSIX_INT_BIND]               = {&handleBind, "bind"};
+    table.dense[POSIX_INT_CONNECT]            = {&handleConnect, "connect"};
+    table.dense[POSIX_INT_LISTEN]             = {&handleListen, "listen"};
+    table.dense[POSIX_INT_ACCEPT]             = {&handleAccept, "accept"};
+    table.dense[POSIX_INT_SENDTO]             = {&handleSendto, "sendto"};
+    table.dense[POSIX_INT_RECVFROM]           = {&handleRecvfrom, "recvfrom"};
+    table.dense[POSIX_INT_SETSOCKOPT]         = {&handleSetsockopt, "setsockopt"};
+    table.dense[POSIX_INT_GETSOCKOPT]         = {&handleGetsockopt, "getsockopt"};
+    table.dense[POSIX_INT_GETSOCKNAME]        = {&handleGetsockname, "getsockname"};
+    table.dense[POSIX_INT_GETPEERNAME]        = {&handleGetpeername, "getpeername"};
+    table.dense[POSIX_INT_SHUTDOWN]           = {&handleShutdown, "shutdown"};
+
+    // I/O multiplexing
+    table.dense[POSIX_INT_POLL]               = {&handlePoll, "poll"};
+    table.dense[POSIX_INT_EPOLL_CREATE]       = {&handleEpollCreate, "epoll_create"};
+    table.dense[POSIX_INT_EPOLL_CREATE1]      = {&handleEpollCreate1, "epoll_create1"};
+    table.dense[POSIX_INT_EPOLL_CTL]          = {&handleEpollCtl, "epoll_ctl"};
+    table.dense[POSIX_INT_EPOLL_WAIT]         = {&handleEpollWait, "epoll_wait"};
+
+    // Pipes
+    table.dense[POSIX_INT_PIPE]               = {&handlePipe, "pipe"};
+    table.dense[POSIX_INT_PIPE2]              = {&handlePipe2, "pipe2"};
+
+    // Batched system calls
+    table.dense[POSIX_INT_IO_URING_SETUP]     = {&handleIoUringSetup, "io_uring_setup"};
+    table.dense[POSIX_INT_IO_URING_ENTER]     = {&handleIoUringEnter, "io_uring_enter"};
+
+    // Custom (numbers outside the dense range)
+    table.sparse[0]                           = {INT_INIT_WINDOW, {&handleInitWindow, "init_window"}};
+    table.sparse[1]                           = {INT_CLOSE_WINDOW, {&handleCloseWindow, "close_window"}};
+    table.sparse[2]                           = {INT_NEXT_KEY_EVENT, {&handleNextKeyboardEvent, "next_key_event"}};
+    table.sparse[3]                           = {INT_NEXT_MOUSE_EVENT, {&handleNextMouseEvent, "next_mouse_event"}};
+    table.sparse[4]                           = {INT_GET_WINDOW_STATUS, {&handleGetWindowStatus, "get_window_status"}};
+    table.sparse[5]                           = {POSIX_INT_POSIX_SPAWN, {&handleSpawn, "posix_spawn"}};
+    table.sparse[6]                           = {INT_GET_TIME_PAGE, {&handleGetTimePage, "get_time_page"}};
+    table.sparse[7]                           = {INT_WAIT_WINDOW_EVENTS, {&handleWaitWindowEvents, "wait_window_events"}};
+    table.sparse[8]                           = {INT_GET_LOCAL_PAGE, {&handleGetLocalPage, "get_local_page"}};
+
+    return table;
+}();
+
+PalmyraOS::kernel::SystemCallsManager::SystemCallStats PalmyraOS::kernel::SystemCallsManager::stats_[DENSE_TABLE_SIZE + SPARSE_TABLE_SIZE] = {};
+
+// Fast system call entry (interrupts.asm)
+extern "C" void sysenter_entry();
+
+namespace {
+    /// poll/epoll_wait timeout in milliseconds to a SystemClock deadline (0: no deadline, for negative timeouts)
+    uint64_t timeoutToDeadline(int32_t milliseconds) {
+        if (milliseconds < 0) return 0;
+        uint64_t ticks = (static_cast<uint64_t>(milliseconds) * PalmyraOS::kernel::SystemClockFrequency + 999) / 1000;
+        return PalmyraOS::kernel::SystemClock::getTicks() + ticks;
+    }
+
+    bool isPastDeadline(uint64_t deadlineTick) { return deadlineTick != 0 && PalmyraOS::kernel::SystemClock::getTicks() >= deadlineTick; }
+
+    /// getrlimit/setrlimit: the resources that are enforced
+    bool isSupportedLimit(int resource) { return resource == RLIMIT_CPU || resource == RLIMIT_STACK || resource == RLIMIT_NOFILE || resource == RLIMIT_AS; }
+}  // namespace
+
+void PalmyraOS::kernel::SystemCallsManager::initialize() {
+    // Setting the interrupt handler for system calls (interrupt 0x80)
+    interrupts::InterruptController::setInterruptHandler(0x80, &handleInterrupt);
+
+    // SYSENTER builds the same frame as `int 0x80` and dispatches through the same handler
+    if (CPU::isSysenterAvailable()) {
+        CPU::initializeSysenter(gdt_ptr->getKernelCodeSegmentSelector().raw, gdt_ptr->getKernelStackAddress(), &sysenter_entry);
+        LOG_INFO("SYSENTER/SYSEXIT enabled for system calls.");
+    }
+    else LOG_INFO("SYSENTER not supported, system calls use int 0x80 only.");
+
+    // Per-syscall counters and cycles
+    auto statsNode = kernel::heapManager.createInstance<vfs::FunctionInode>(&readStatistics, nullptr, nullptr);
+    if (statsNode) vfs::VirtualFileSystem::setInodeByPath(KString("/proc/syscalls"), statsNode);
+}
+
+const PalmyraOS::kernel::SystemCallsManager::SystemCallEntry* PalmyraOS::kernel::SystemCallsManager::lookup(uint32_t number, uint32_t& statsIndex) {
+    // Common case: a single indexed load
+    if (number < DENSE_TABLE_SIZE) {
+        statsIndex = number;
+        return dispatchTable_.dense[number].handler ? &dispatchTable_.dense[number] : nullptr;
+    }
+
+    for (uint32_t i = 0; i < SPARSE_TABLE_SIZE; ++i) {
+        if (dispatchTable_.sparse[i].number != number) continue;
+        statsIndex = DENSE_TABLE_SIZE + i;
+        return &dispatchTable_.sparse[i].entry;
+    }
+    return nullptr;
+}
+
+bool PalmyraOS::kernel::SystemCallsManager::dispatch(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    uint32_t statsIndex          = 0;
+    const SystemCallEntry* entry = lookup(regs->eax, statsIndex);
+    if (!entry) return false;
+
+    // Call the handler function (counted before the call: exit does not come back here)
+    SystemCallStats& stats = stats_[statsIndex];
+    stats.count++;
+    uint64_t start = CPU::getTSC();
+    entry->handler(regs);
+    stats.cycles += CPU::getTSC() - start;
+    return true;
+}
+
+size_t PalmyraOS::kernel::SystemCallsManager::readStatistics(char* buffer, size_t size, size_t offset) {
+    // Lines are generated one at a time and only the part inside [offset, offset + size) is copied
+    char line[96];
+    size_t position = 0;
+    size_t written  = 0;
+
+    auto emit       = [&](size_t length) {
+        size_t lineLength = length < sizeof(line) ? length : sizeof(line) - 1;
+        size_t lineEnd    = position + lineLength;
+        if (lineEnd > offset && written < size) {
+            size_t skip  = offset > position ? offset - position : 0;
+            size_t count = lineLength - skip;
+            if (count > size - written) count = size - written;
+            memcpy(buffer + written, line + skip, count);
+            written += count;
+        }
+        position = lineEnd;
+    };
+
+    auto emitEntry = [&](uint32_t number, const SystemCallEntry& entry, const SystemCallStats& stats) {
+        if (!entry.handler) return;
+        uint64_t average = stats.count ? stats.cycles / stats.count : 0;
+        emit(snprintf(line, sizeof(line), "%s %u %llu %llu %llu\n", entry.name, number, stats.count, stats.cycles, average));
+    };
+
+    emit(snprintf(line, sizeof(line), "%s\n", "name nr calls cycles avg_cycles"));
+    for (uint32_t i = 0; i < DENSE_TABLE_SIZE; ++i) emitEntry(i, dispatchTable_.dense[i], stats_[i]);
+    for (uint32_t i = 0; i < SPARSE_TABLE_SIZE; ++i) emitEntry(dispatchTable_.sparse[i].number, dispatchTable_.sparse[i].entry, stats_[DENSE_TABLE_SIZE + i]);
+
+    return written;
 }
 
 // TODO isValidAddress(void* addr, size_t size) this way we are sure for more than one byte!!
@@ -94,8 +228,8 @@ bool PalmyraOS::kernel::SystemCallsManager::isValidAddress(void* addr) {
     // Retrieve the current process
     auto* proc = TaskManager::getCurrentProcess();
 
-    // Check if the address is valid in the current process's paging directory
-    if (!proc->pagingDirectory_->isAddressValid(addr)) {
+    // Check if the address is valid in the current process's paging directory (some pages are mapped on demand)
+    if (!proc->pagingDirectory_->isAddressValid(addr) && !proc->handlePageFault(reinterpret_cast<uint32_t>(addr), false)) {
         // If the address is invalid, terminate the process with a BAD ADDRESS error code
         proc->terminate(-EFAULT);
         return false;
@@ -103,18 +237,46 @@ bool PalmyraOS::kernel::SystemCallsManager::isValidAddress(void* addr) {
     return true;
 }
 
+bool PalmyraOS::kernel::SystemCallsManager::loadSysenterReturn(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    auto* proc      = TaskManager::getCurrentProcess();
+    auto* directory = proc->pagingDirectory_;
+    auto* slot      = reinterpret_cast<uint32_t*>(regs->userEsp);
+
+    // Both ends of the slot: ebp is whatever the caller put there (null, kernel memory, a page boundary)
+    for (auto* byte: {reinterpret_cast<uint8_t*>(slot), reinterpret_cast<uint8_t*>(slot) + sizeof(uint32_t) - 1}) {
+        if (directory->isUserAccessible(byte)) continue;
+        if (!proc->handlePageFault(reinterpret_cast<uint32_t>(byte), false) || !directory->isUserAccessible(byte)) return false;
+    }
+
+    // Checked above; the window only guards against the check missing a case
+    proc->userCopyStart_ = regs->userEsp;
+    proc->userCopyEnd_   = regs->userEsp + sizeof(uint32_t);
+    regs->eip            = *slot;
+    proc->userCopyEnd_   = proc->userCopyStart_;
+
+    regs->userEsp += sizeof(uint32_t);
+    return true;
+}
+
 uint32_t* PalmyraOS::kernel::SystemCallsManager::handleInterrupt(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
-    // Find the appropriate system call handler based on the syscall number in regs->eax
-    auto it = systemCallHandlers_.find(regs->eax);
-    if (it != systemCallHandlers_.end()) {
-        // Call the handler function
-        it->second(regs);
+    // A bad stack pointer passed to SYSENTER: there is nowhere to return to
+    if (regs->errorCode == SYSENTER_FRAME && !loadSysenterReturn(regs)) {
+        LOG_WARN("SYSENTER with an invalid user stack 0x%X", regs->userEsp);
+        TaskManager::getCurrentProcess()->terminate(-EFAULT);
+        return TaskManager::interruptHandler(regs);
     }
-    else {
+
+    // Find the appropriate system call handler based on the syscall number in regs->eax
+    uint32_t number = regs->eax;
+    TRACE(SyscallEnter, number);
+    TaskManager::enterSystemCall();
+    if (!dispatch(regs)) {
         // unsupported syscall!!
         LOG_WARN("Unknown SYSCALL (%d) at 0x%X", regs->eax, regs->eip);
         regs->eax = -EINVAL;
     }
+    TaskManager::exitSystemCall();
+    TRACE(SyscallExit, number, regs->eax);
 
     // Retrieve the current process
     auto* proc        = TaskManager::getCurrentProcess();
@@ -128,14 +290,80 @@ uint32_t* PalmyraOS::kernel::SystemCallsManager::handleInterrupt(PalmyraOS::kern
 
 void PalmyraOS::kernel::SystemCallsManager::handleExit(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
     // void _exit(int)
-    TaskManager::getCurrentProcess()->terminate((int) regs->ebx);
+    auto* proc = TaskManager::getCurrentProcess();
+
+    // A thread exits alone (the main thread takes the whole group down through the scheduler)
+    if (proc->isThread() && proc->clearChildTid_ && proc->pagingDirectory_->isAddressValid(proc->clearChildTid_)) { *proc->clearChildTid_ = 0; }
+
+    proc->terminate((int) regs->ebx);
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleExitGroup(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // void exit_group(int)
+    auto* proc = TaskManager::getCurrentProcess();
+
+    // Terminating the leader terminates its threads before its memory is released
+    proc->getThreadGroupLeader()->terminate((int) regs->ebx);
+    proc->terminate((int) regs->ebx);
 }
 
 void PalmyraOS::kernel::SystemCallsManager::handleGetPid(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
     // uint32_t getpid()
+    regs->eax = TaskManager::getCurrentProcess()->getThreadGroupId();
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleGetTid(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // uint32_t gettid()
     regs->eax = TaskManager::getCurrentProcess()->getPid();
 }
 
+void PalmyraOS::kernel::SystemCallsManager::handleClone(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int clone(uint32_t flags, void* child_stack, uint32_t* ptid, struct user_desc* tls, uint32_t* ctid)
+
+    // Extract arguments from registers (Linux i386 order)
+    uint32_t flags      = regs->ebx;
+    uint32_t childStack = regs->ecx;
+    auto* ptid          = reinterpret_cast<uint32_t*>(regs->edx);
+    auto* tls           = reinterpret_cast<user_desc*>(regs->esi);
+    auto* ctid          = reinterpret_cast<uint32_t*>(regs->edi);
+
+    auto* proc          = TaskManager::getCurrentProcess();
+
+    // Only threads are supported (no fork): they must share the address space and the thread group
+    if ((flags & (CLONE_VM | CLONE_THREAD)) != (CLONE_VM | CLONE_THREAD) || proc->getMode() != Process::Mode::User || childStack == 0) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    // Validate the user pointers before creating anything
+    if (!isValidAddress(reinterpret_cast<void*>(childStack - sizeof(uint32_t)))) return;
+    if ((flags & CLONE_SETTLS) && !isValidAddress(tls)) return;
+    if ((flags & CLONE_PARENT_SETTID) && !isValidAddress(ptid)) return;
+    if ((flags & (CLONE_CHILD_SETTID | CLONE_CHILD_CLEARTID)) && !isValidAddress(ctid)) return;
+
+    Process* thread = TaskManager::newThread(proc->getThreadGroupLeader(), *regs, childStack);
+    if (!thread) {
+        regs->eax = -EAGAIN;  // Process table is full
+        return;
+    }
+
+    // The thread inherits the caller's TLS unless a new one is provided
+    thread->tls_ = proc->tls_;
+    if ((flags & CLONE_SETTLS) && !loadThreadArea(tls, thread->tls_)) {
+        thread->terminate(-EINVAL);
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    if (flags & CLONE_PARENT_SETTID) *ptid = thread->getPid();
+    if (flags & CLONE_CHILD_SETTID) *ctid = thread->getPid();
+    if (flags & CLONE_CHILD_CLEARTID) thread->clearChildTid_ = ctid;
+
+    LOG_DEBUG("SYSCALL clone -> thread %d in group %d (userEsp: 0x%X)", thread->getPid(), proc->getThreadGroupId(), childStack);
+
+    regs->eax = thread->getPid();
+}
+
 void PalmyraOS::kernel::SystemCallsManager::handleYield(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
     // int sched_yield();
 
@@ -143,6 +371,187 @@ void PalmyraOS::kernel::SystemCallsManager::handleYield(PalmyraOS::kernel::inter
     TaskManager::getCurrentProcess()->age_ = 0;  // Reset the age to yield the CPU
 }
 
+void PalmyraOS::kernel::SystemCallsManager::handleSchedSetScheduler(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int sched_setscheduler(uint32_t pid, int policy, const struct sched_param* param)
+
+    // Extract arguments from registers
+    uint32_t pid = regs->ebx;
+    auto policy  = static_cast<int>(regs->ecx);
+    auto* param  = reinterpret_cast<sched_param*>(regs->edx);
+
+    if (!param || !isValidAddress(param)) {
+        regs->eax = -EINVAL;
+        return;
+    }
+    if (policy != SCHED_OTHER && policy != SCHED_FIFO && policy != SCHED_RR) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    // pid 0 is the calling thread
+    Process* target = pid == 0 ? TaskManager::getCurrentProcess() : TaskManager::getProcess(pid);
+    if (!target || target->getState() == Process::State::Killed) {
+        regs->eax = -ESRCH;
+        return;
+    }
+
+    // Negative priorities are rejected by the range check
+    auto policyValue = static_cast<Process::Policy>(policy);
+    auto priority    = static_cast<uint32_t>(param->sched_priority);
+    if (!TaskManager::setScheduler(target, policyValue, priority)) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    LOG_DEBUG("SYSCALL sched_setscheduler -> PID %d policy %d priority %d", target->getPid(), policy, priority);
+    regs->eax = 0;
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleSchedGetScheduler(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int sched_getscheduler(uint32_t pid)
+    uint32_t pid    = regs->ebx;
+
+    Process* target = pid == 0 ? TaskManager::getCurrentProcess() : TaskManager::getProcess(pid);
+    if (!target || target->getState() == Process::State::Killed) {
+        regs->eax = -ESRCH;
+        return;
+    }
+
+    regs->eax = static_cast<uint32_t>(target->getPolicy());
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleGetPriority(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int getpriority(int which, uint32_t who)
+    auto which   = static_cast<int>(regs->ebx);
+    uint32_t who = regs->ecx;
+
+    if (which != PRIO_PROCESS) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    Process* target = who == 0 ? TaskManager::getCurrentProcess() : TaskManager::getProcess(who);
+    if (!target || target->getState() == Process::State::Killed) {
+        regs->eax = -ESRCH;
+        return;
+    }
+
+    // Linux ABI: 20 - nice, so that the result is never negative
+    regs->eax = 20 - target->getNice();
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleSetPriority(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int setpriority(int which, uint32_t who, int prio)
+    auto which   = static_cast<int>(regs->ebx);
+    uint32_t who = regs->ecx;
+    auto nice    = static_cast<int32_t>(regs->edx);
+
+    if (which != PRIO_PROCESS) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    Process* target = who == 0 ? TaskManager::getCurrentProcess() : TaskManager::getProcess(who);
+    if (!target || target->getState() == Process::State::Killed) {
+        regs->eax = -ESRCH;
+        return;
+    }
+
+    TaskManager::setNice(target, nice);
+    LOG_DEBUG("SYSCALL setpriority -> PID %d nice %d", target->getPid(), target->getNice());
+    regs->eax = 0;
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleGetRlimit(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int getrlimit(int resource, struct rlimit* rlim)
+    auto resource = static_cast<int>(regs->ebx);
+    auto* rlim    = reinterpret_cast<rlimit*>(regs->ecx);
+
+    if (!isSupportedLimit(resource)) {
+        regs->eax = -EINVAL;
+        return;
+    }
+    if (!isValidAddress(rlim) || !isValidAddress(reinterpret_cast<uint8_t*>(rlim + 1) - 1)) {
+        regs->eax = -EFAULT;
+        return;
+    }
+
+    *rlim     = TaskManager::getCurrentProcess()->getResourceLimit(resource);
+    regs->eax = 0;
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleSetRlimit(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int setrlimit(int resource, const struct rlimit* rlim)
+    auto resource    = static_cast<int>(regs->ebx);
+    auto* rlim       = reinterpret_cast<rlimit*>(regs->ecx);
+    Process* process = TaskManager::getCurrentProcess();
+
+    if (!isSupportedLimit(resource)) {
+        regs->eax = -EINVAL;
+        return;
+    }
+    if (!isValidAddress(rlim) || !isValidAddress(reinterpret_cast<uint8_t*>(rlim + 1) - 1)) {
+        regs->eax = -EFAULT;
+        return;
+    }
+
+    rlimit limit = *rlim;
+    if (limit.rlim_cur > limit.rlim_max) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    // Every process runs as root, but a hard limit that could be raised again would not bound anything
+    if (limit.rlim_max > process->getResourceLimit(resource).rlim_max) {
+        regs->eax = -EPERM;
+        return;
+    }
+
+    process->setResourceLimit(resource, limit);
+    LOG_DEBUG("SYSCALL setrlimit -> PID %d resource %d: %u / %u", process->getPid(), resource, limit.rlim_cur, limit.rlim_max);
+    regs->eax = 0;
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleFutex(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int futex(uint32_t* uaddr, int op, uint32_t val, const struct timespec* timeout)
+    auto* address = reinterpret_cast<uint32_t*>(regs->ebx);
+    int operation = static_cast<int>(regs->ecx) & ~FUTEX_PRIVATE_FLAG;
+    uint32_t val  = regs->edx;
+    auto* timeout = reinterpret_cast<const timespec*>(regs->esi);
+
+    if (reinterpret_cast<uint32_t>(address) & 3) {
+        regs->eax = -EINVAL;
+        return;
+    }
+    if (!isValidAddress(address)) {
+        regs->eax = -EFAULT;
+        return;
+    }
+
+    if (operation == FUTEX_WAKE) {
+        regs->eax = Futex::wake(address, val);
+        return;
+    }
+    if (operation != FUTEX_WAIT) {
+        regs->eax = -ENOSYS;
+        return;
+    }
+
+    // Relative timeout, rounded up to whole ticks
+    uint64_t deadline = 0;
+    if (timeout) {
+        if (!isValidAddress(const_cast<timespec*>(timeout))) {
+            regs->eax = -EFAULT;
+            return;
+        }
+        uint64_t nanoseconds = timeout->tv_sec * 1000000000ULL + timeout->tv_nsec;
+        uint64_t tickLength  = 1000000000ULL / SystemClockFrequency;
+        deadline             = SystemClock::getTicks() + (nanoseconds + tickLength - 1) / tickLength;
+    }
+
+    regs->eax = Futex::wait(address, val, deadline);
+}
+
 void PalmyraOS::kernel::SystemCallsManager::handleMmap(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
     // void* mmap(void* addr, uint32_t length, int prot, int flags, int fd, uint32_t offset)
 
@@ -156,14 +565,39 @@ void PalmyraOS::kernel::SystemCallsManager::handleMmap(PalmyraOS::kernel::interr
     // Check if addr is a valid pointer
     //	if (!isValidAddress(addr)) return;
 
+    if (length == 0) {
+        regs->eax = (uint32_t) MAP_FAILED;
+        return;
+    }
+
     // Allocate memory pages for the current process based on the requested length
-    void* allocatedAddr      = TaskManager::getCurrentProcess()->allocatePages((length >> 12) + 1);
+    Process* proc       = TaskManager::getCurrentProcess();
+    uint32_t pages      = CEIL_DIV_PAGE_SIZE(length);
+    void* allocatedAddr = proc->allocatePages(pages);
 
     // Set eax to the allocated address or MAP_FAILED
-    if (allocatedAddr != nullptr) { regs->eax = (uint32_t) allocatedAddr; }
+    if (allocatedAddr != nullptr) {
+        proc->getThreadGroupLeader()->mappings_[(uint32_t) allocatedAddr] = pages;  // for munmap
+        regs->eax                                                         = (uint32_t) allocatedAddr;
+    }
     else { regs->eax = (uint32_t) MAP_FAILED; }
 }
 
+void PalmyraOS::kernel::SystemCallsManager::handleMunmap(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int munmap(void* addr, uint32_t length)
+    auto address    = regs->ebx;
+    uint32_t length = regs->ecx;
+
+    // Whole mmap regions only (see Process::unmapPages)
+    if ((address & (PAGE_SIZE - 1)) != 0 || length == 0) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    bool unmapped = TaskManager::getCurrentProcess()->unmapPages(reinterpret_cast<void*>(address), CEIL_DIV_PAGE_SIZE(length));
+    regs->eax     = unmapped ? 0 : -EINVAL;
+}
+
 void PalmyraOS::kernel::SystemCallsManager::handleGetTime(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
     // int clock_gettime(uint32_t clk_id, struct timespec *tp)
 
@@ -174,16 +608,36 @@ void PalmyraOS::kernel::SystemCallsManager::handleGetTime(PalmyraOS::kernel::int
     // Check if timeSpec is a valid pointer
     if (!isValidAddress(timeSpec)) return;
 
-    // Get the current time in ticks and frequency
-    uint64_t ticks     = SystemClock::getTicks();
-    uint64_t frequency = SystemClockFrequency;
+    // Same source as the syscall-free path in userland
+    const auto* page = TimePage::getPage();
+    if (!page) {
+        regs->eax = -EAGAIN;
+        return;
+    }
+
+    uint64_t realtimeOffset;
+    uint64_t nanoseconds = types::readTimePage(page, &realtimeOffset);
+    if (clockId == CLOCK_REALTIME) nanoseconds += realtimeOffset;
 
-    // Convert ticks to seconds and nanoseconds
-    timeSpec->tv_nsec  = (ticks * 1'000'000) / frequency;
-    timeSpec->tv_sec   = timeSpec->tv_nsec / 1'000'000;
+    // Convert nanoseconds to seconds and nanoseconds
+    timeSpec->tv_sec     = nanoseconds / 1'000'000'000;
+    timeSpec->tv_nsec    = nanoseconds % 1'000'000'000;
 
     // Set eax to 0 to indicate success
-    regs->eax          = 0;
+    regs->eax            = 0;
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleGetTimePage(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // const void* get_time_page()
+    // Mapped read-only into every user process at creation (see Process::initializePagingDirectory)
+    regs->eax = reinterpret_cast<uint32_t>(TimePage::getPage());
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleGetLocalPage(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // void* get_local_page()
+    // Same address in every process, private contents (see LocalPage); kernel-mode processes have none
+    bool isUser = TaskManager::getCurrentProcess()->getMode() == Process::Mode::User;
+    regs->eax   = isUser ? reinterpret_cast<uint32_t>(LocalPage::getAddress()) : 0;
 }
 
 void PalmyraOS::kernel::SystemCallsManager::handleOpen(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
@@ -256,8 +710,9 @@ void PalmyraOS::kernel::SystemCallsManager::handleOpen(PalmyraOS::kernel::interr
 
     // Create a new FileDescriptor and allocate a file descriptor number
     auto* fileDesc      = heapManager.createInstance<FileDescriptor>(inode, flags);
-    fd_t fileDescriptor = TaskManager::getCurrentProcess()->descriptorTable_.allocate(fileDesc);
-    regs->eax           = fileDescriptor;
+    fd_t fileDescriptor = TaskManager::getCurrentProcess()->getDescriptorTable().allocate(fileDesc);
+    if (static_cast<int>(fileDescriptor) < 0) delete fileDesc;  // RLIMIT_NOFILE reached
+    regs->eax = fileDescriptor;
 }
 
 void PalmyraOS::kernel::SystemCallsManager::handleMkdir(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
@@ -425,7 +880,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleClose(PalmyraOS::kernel::inter
     uint32_t fd = regs->ebx;
 
     // Release the descriptor (works for all descriptor types)
-    TaskManager::getCurrentProcess()->descriptorTable_.release(fd);
+    TaskManager::getCurrentProcess()->getDescriptorTable().release(fd);
 
     // Set eax to 0 to indicate success
     regs->eax = 0;
@@ -442,57 +897,62 @@ void PalmyraOS::kernel::SystemCallsManager::handleWrite(PalmyraOS::kernel::inter
     // Check if bufferPointer is a valid pointer
     if (!isValidAddress(bufferPointer)) return;
 
-    // Get the current process
-    auto* proc    = TaskManager::getCurrentProcess();
-    bufferPointer = (char*) proc->pagingDirectory_->getPhysicalAddress(bufferPointer);
-
-    // TODO move to actual
-    // TODO 0
-
-    // Handle writing to stdout (file descriptor 1) and stderr (file descriptor 2)
-    if (fileDescriptor == 1) {
-        // Initialize the number of bytes written to 0
-        regs->eax = 0;
-        for (size_t i = 0; i < size; ++i) {
-            if (bufferPointer[i] == '\0') break;        // Stop at null terminator
-            proc->stdout_.push_back(bufferPointer[i]);  // Write to stdout
-            regs->eax++;                                // Increment the byte count
+    // Get the current process (threads write to the streams of their group)
+    auto* proc       = TaskManager::getCurrentProcess()->getThreadGroupLeader();
+    Descriptor* desc = proc->getDescriptorTable().get(fileDescriptor);
+
+    // Handle writing to stdout (file descriptor 1) and stderr (file descriptor 2), unless redirected to a pipe
+    if (!desc && (fileDescriptor == 1 || fileDescriptor == 2)) {
+        StreamBuffer* stream = proc->getStandardStream(fileDescriptor);
+
+        // Text up to a null terminator (kept from the byte-wise copy), one page at a time through the process directory:
+        // the ELF segments are not identity-mapped. The stream copies each piece in bulk, sleeping only for a following reader
+        size_t written = 0;
+        while (written < size) {
+            char* source = bufferPointer + written;
+            if (!isValidAddress(source)) return;
+
+            auto* text    = static_cast<char*>(proc->pagingDirectory_->getPhysicalAddress(source));
+            size_t inPage = PAGE_SIZE - (reinterpret_cast<uint32_t>(source) & (PAGE_SIZE - 1));
+            size_t limit  = size - written < inPage ? size - written : inPage;
+            size_t length = 0;
+            while (length < limit && text[length] != '\0') length++;
+
+            if (stream && length > 0) {
+                auto result = static_cast<int>(stream->write(text, length));
+                if (result < 0) {
+                    regs->eax = written ? written : result;
+                    return;
+                }
+            }
+            written += length;
+            if (length < limit) break;
         }
+        regs->eax = written;
+        return;
     }
-    else if (fileDescriptor == 2) {
-        // Initialize the number of bytes written to 0
-        regs->eax = 0;
-        for (size_t i = 0; i < size; ++i) {
-            if (bufferPointer[i] == '\0') break;        // Stop at null terminator
-            proc->stderr_.push_back(bufferPointer[i]);  // Write to stdout
-            regs->eax++;                                // Increment the byte count
-        }
+
+    if (!desc) {
+        // If the descriptor is not open, set the number of bytes written to 0
+        regs->eax = 0;  // we wrote 0 bytes
+        return;
     }
-    else {
-        // Handle writing to regular files
-        Descriptor* desc = proc->descriptorTable_.get(fileDescriptor);
-        if (!desc) {
-            // If the descriptor is not open, set the number of bytes written to 0
-            regs->eax = 0;  // we wrote 0 bytes
-            return;
-        }
 
-        // Check if it's a file descriptor (pipes/sockets would have different logic)
-        if (desc->kind() != Descriptor::Kind::File) {
-            regs->eax = -EINVAL;  // Invalid descriptor type for this operation
-            return;
-        }
+    // Pipes and sockets: the descriptor copies the data itself (a pipe sleeps while it is full)
+    if (desc->kind() != Descriptor::Kind::File) {
+        regs->eax = desc->write(bufferPointer, size);
+        return;
+    }
 
-        // Safe to cast since we checked the kind
-        auto* file     = static_cast<FileDescriptor*>(desc);
+    // Safe to cast since we checked the kind
+    auto* file     = static_cast<FileDescriptor*>(desc);
 
-        // Write data to the file and update the file offset
-        auto bytesRead = file->getInode()->write(bufferPointer, size, file->getOffset());
-        file->advanceOffset(bytesRead);
+    // Write data to the file and update the file offset
+    auto bytesRead = file->getInode()->write(bufferPointer, size, file->getOffset());
+    file->advanceOffset(bytesRead);
 
-        // Set eax to the number of bytes written
-        regs->eax = bytesRead;
-    }
+    // Set eax to the number of bytes written
+    regs->eax = bytesRead;
 }
 
 void PalmyraOS::kernel::SystemCallsManager::handleRead(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
@@ -507,16 +967,24 @@ void PalmyraOS::kernel::SystemCallsManager::handleRead(PalmyraOS::kernel::interr
     if (!isValidAddress(bufferPointer)) return;
 
     // Get the descriptor associated with the file descriptor
-    Descriptor* desc = TaskManager::getCurrentProcess()->descriptorTable_.get(fileDescriptor);
+    auto* proc       = TaskManager::getCurrentProcess()->getThreadGroupLeader();
+    Descriptor* desc = proc->getDescriptorTable().get(fileDescriptor);
+
+    // Handle reading stdin (file descriptor 0) unless redirected: sleeps until /proc/<pid>/stdin is written
+    if (!desc && fileDescriptor == 0 && proc->stdin_) {
+        regs->eax = proc->stdin_->read(bufferPointer, size, false);
+        return;
+    }
+
     if (!desc) {
         // If the descriptor is not open, set the number of bytes read to 0
         regs->eax = 0;  // we read 0 bytes
         return;
     }
 
-    // Check if it's a file descriptor (pipes/sockets would have different logic)
+    // Pipes and sockets: the descriptor copies the data itself (a pipe sleeps while it is empty)
     if (desc->kind() != Descriptor::Kind::File) {
-        regs->eax = -EINVAL;  // Invalid descriptor type for this operation
+        regs->eax = desc->read(bufferPointer, size);
         return;
     }
 
@@ -549,7 +1017,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleIoctl(PalmyraOS::kernel::inter
     auto* proc       = TaskManager::getCurrentProcess();
 
     // Get the descriptor associated with the file descriptor
-    Descriptor* desc = proc->descriptorTable_.get(fileDescriptor);
+    Descriptor* desc = proc->getDescriptorTable().get(fileDescriptor);
     if (!desc) {
         regs->eax = -EBADF;
         return;
@@ -595,24 +1063,32 @@ void PalmyraOS::kernel::SystemCallsManager::handleInitWindow(PalmyraOS::kernel::
         return;
     }
 
-    // Allocate memory pages for the window buffer
-    auto* proc          = TaskManager::getCurrentProcess();
+    // Allocate memory pages for the window buffer (windows belong to the thread group)
+    auto* proc          = TaskManager::getCurrentProcess()->getThreadGroupLeader();
     auto* allocatedAddr = reinterpret_cast<uint32_t*>(proc->allocatePages(requiredPages));
 
     // Set the user buffer to the allocated address
     *userBuffer         = allocatedAddr;
 
+    // Event rings shared with the compositor (returned through the window information)
+    auto* events        = reinterpret_cast<WindowEvents*>(proc->allocatePages(CEIL_DIV_PAGE_SIZE(sizeof(WindowEvents))));
+    if (!allocatedAddr || !events) {
+        regs->eax = -ENOMEM;  // Out of memory or RLIMIT_AS (the pages are released with the process)
+        return;
+    }
+    memset(events, 0, sizeof(WindowEvents));
+    windowInfo->events = events;
+
     // Request a window with the extracted parameters and title
-    auto* window        = WindowManager::requestWindow(allocatedAddr, x, y, width, height);
-    if (!window) {
+    uint32_t windowId  = WindowManager::requestWindow(allocatedAddr, x, y, width, height, windowInfo->movable, events);
+    if (windowId == 0) {
         regs->eax = -ENOMEM;  // Error: Could not create the window
         return;
     }
-    window->setMovable(windowInfo->movable);
 
     // Add the window ID to the process's list of windows and return the window ID in eax
-    proc->windows_.push_back(window->getID());
-    regs->eax = window->getID();  // Return the window ID
+    proc->windows_.push_back(windowId);
+    regs->eax = windowId;  // Return the window ID
 }
 
 void PalmyraOS::kernel::SystemCallsManager::handleCloseWindow(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
@@ -620,7 +1096,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleCloseWindow(PalmyraOS::kernel:
     uint32_t windowId = regs->ebx;
 
     // Get the current process and remove the window ID from its list of windows
-    auto* proc        = TaskManager::getCurrentProcess();
+    auto* proc        = TaskManager::getCurrentProcess()->getThreadGroupLeader();
     for (auto it = proc->windows_.begin(); it != proc->windows_.end(); ++it) {
         if (*it == windowId) {
             proc->windows_.erase(it);
@@ -662,14 +1138,34 @@ void PalmyraOS::kernel::SystemCallsManager::handleGetWindowStatus(PalmyraOS::ker
     if (!isValidAddress(status)) return;
 
     // TODO check if the window belongs actually to current process
-    auto window = WindowManager::getWindowById(windowId);
-    if (!window) return;
+    palmyra_window_status windowStatus;
+    if (!WindowManager::getWindowStatus(windowId, windowStatus)) return;
+
+    *status = windowStatus;
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleWaitWindowEvents(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int waitWindowEvents(uint32_t windowID, int timeoutMs)
+    uint32_t windowId = regs->ebx;
+    auto timeoutMs    = static_cast<int32_t>(regs->ecx);
 
-    auto [x, y]          = window->getPosition();
-    auto [width, height] = window->getSize();
-    bool isActive        = WindowManager::getActiveWindowId() == windowId;
+    // Only the windows of the thread group can be waited on
+    auto* proc        = TaskManager::getCurrentProcess()->getThreadGroupLeader();
+    bool owned        = false;
+    for (uint32_t id: proc->windows_) owned |= id == windowId;
+    if (!owned) {
+        regs->eax = -EINVAL;
+        return;
+    }
 
-    *status              = {.x = x, .y = y, .width = width, .height = height, .isActive = isActive};
+    // Rounded up to whole ticks (a deadline of now only checks the rings)
+    uint64_t deadline = 0;
+    if (timeoutMs >= 0) {
+        uint64_t tickLength = 1000000000ULL / SystemClockFrequency;
+        deadline            = SystemClock::getTicks() + (timeoutMs * 1000000ULL + tickLength - 1) / tickLength;
+    }
+
+    regs->eax = WindowManager::waitForEvents(windowId, deadline);
 }
 
 void PalmyraOS::kernel::SystemCallsManager::handleGetdents(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
@@ -688,7 +1184,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleGetdents(PalmyraOS::kernel::in
     count            = count > 4096 ? 4096 : count;
 
     // Get the descriptor associated with the file descriptor
-    Descriptor* desc = TaskManager::getCurrentProcess()->descriptorTable_.get(fileDescriptor);
+    Descriptor* desc = TaskManager::getCurrentProcess()->getDescriptorTable().get(fileDescriptor);
     if (!desc) {
         regs->eax = -EBADF;
         return;
@@ -797,7 +1293,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleLongSeek(PalmyraOS::kernel::in
     auto* proc       = TaskManager::getCurrentProcess();
 
     // Get the descriptor associated with the file descriptor
-    Descriptor* desc = proc->descriptorTable_.get(fd);
+    Descriptor* desc = proc->getDescriptorTable().get(fd);
     if (!desc) {
         regs->eax = -EBADF;
         return;
@@ -867,8 +1363,8 @@ void PalmyraOS::kernel::SystemCallsManager::handleWaitPID(PalmyraOS::kernel::int
     // Enable interrupts to allow the system to handle other tasks while sleeping
     interrupts::InterruptController::enableInterrupts();
 
-    // Busy-wait loop until the child process is terminated
-    while (childProcess->getState() != Process::State::Killed) {
+    // Busy-wait loop until the child process is terminated (or its slot was recycled)
+    while (childProcess->getPid() == pid && childProcess->getState() != Process::State::Killed) {
         // Yield the CPU to allow other processes to run
         sched_yield();
     }
@@ -876,6 +1372,12 @@ void PalmyraOS::kernel::SystemCallsManager::handleWaitPID(PalmyraOS::kernel::int
     // Disable interrupts
     interrupts::InterruptController::disableInterrupts();
 
+    // The slot was reaped and reused before we saw the exit code
+    if (childProcess->getPid() != pid) {
+        regs->eax = -ECHILD;
+        return;
+    }
+
     // If a status pointer is provided, write the child's exit status to it
     if (status) *status = childProcess->getExitCode();
 
@@ -900,15 +1402,15 @@ void PalmyraOS::kernel::SystemCallsManager::handleSpawn(PalmyraOS::kernel::inter
      * ECX: path to executable
      * EDX: argv array
      * ESI: envp array (environment variables)
+     * EDI: file actions (pipe ends to install in the child, may be nullptr)
      */
     auto* pid         = reinterpret_cast<uint32_t*>(regs->ebx);
     const char* path  = reinterpret_cast<const char*>(regs->ecx);
     char* const* argv = reinterpret_cast<char* const*>(regs->edx);
     char* const* envp = reinterpret_cast<char* const*>(regs->esi);
+    auto* fileActions = reinterpret_cast<const posix_spawn_file_actions_t*>(regs->edi);
 
-    // file_actions and attrp are not yet implemented (TODO for future)
-    // void* file_actions = reinterpret_cast<void*>(regs->esi);
-    // void* attrp = reinterpret_cast<void*>(regs->edi);
+    // attrp is not yet implemented (TODO for future)
 
     /**
      * Step 1: Validate path pointer
@@ -918,6 +1420,32 @@ void PalmyraOS::kernel::SystemCallsManager::handleSpawn(PalmyraOS::kernel::inter
         return;
     }
 
+    /**
+     * Step 1b: Validate file actions (only pipe ends can be handed over)
+     */
+    auto& descriptors = TaskManager::getCurrentProcess()->getDescriptorTable();
+    if (fileActions) {
+        if (!isValidAddress(const_cast<posix_spawn_file_actions_t*>(fileActions))) {
+            regs->eax = -EFAULT;
+            return;
+        }
+        if (fileActions->count > SPAWN_MAX_FILE_ACTIONS) {
+            regs->eax = -EINVAL;
+            return;
+        }
+        for (uint32_t i = 0; i < fileActions->count; ++i) {
+            Descriptor* desc = descriptors.get(fileActions->dup2[i].fd);
+            if (!desc) {
+                regs->eax = -EBADF;
+                return;
+            }
+            if (desc->kind() != Descriptor::Kind::Pipe || fileActions->dup2[i].newfd < 0) {
+                regs->eax = -EINVAL;
+                return;
+            }
+        }
+    }
+
     /**
      * Step 2: Count arguments in argv
      */
@@ -955,19 +1483,10 @@ void PalmyraOS::kernel::SystemCallsManager::handleSpawn(PalmyraOS::kernel::inter
     }
     // Type 2: External ELF binary
     else if (inode->getType() == vfs::InodeBase::Type::File) {
-        // Read ELF file from disk
-        auto fileSize = inode->getSize();
-        KVector<uint8_t> fileContent(fileSize);
-
-        if (inode->read((char*) fileContent.data(), fileSize, 0) != fileSize) {
-            regs->eax = -EIO;  // I/O error
-            return;
-        }
-
         LOG_INFO("EXEC ELF: %s (argc=%d, envp=%s)", path, argc, envp ? "provided" : "nullptr");
 
-        // Execute the ELF file as a new process (with environment and auxiliary vector)
-        proc = kernel::TaskManager::execv_elf(fileContent, kernel::Process::Mode::User, kernel::Process::Priority::Low, argc, argv, envp);
+        // Execute the ELF file as a new process: its pages are read on first access, through the page cache
+        proc = kernel::TaskManager::execv_elf(inode, kernel::Process::Mode::User, kernel::Process::Priority::Low, argc, argv, envp);
     }
     else {
         // Not a regular file or built-in executable
@@ -984,7 +1503,25 @@ void PalmyraOS::kernel::SystemCallsManager::handleSpawn(PalmyraOS::kernel::inter
     }
 
     /**
-     * Step 6: Store the new process ID if caller provided output pointer
+     * Step 6: Install the pipe ends (the child does not run before this system call returns)
+     */
+    if (fileActions) {
+        for (uint32_t i = 0; i < fileActions->count; ++i) {
+            auto* source = static_cast<PipeDescriptor*>(descriptors.get(fileActions->dup2[i].fd));
+            auto* end    = source->duplicate();
+            if (!end) {
+                LOG_ERROR("posix_spawn: out of memory for descriptor %d of PID %d", fileActions->dup2[i].newfd, proc->getPid());
+                continue;
+            }
+            proc->getDescriptorTable().install(fileActions->dup2[i].newfd, end);
+        }
+    }
+
+    // The child starts with the resource limits of its parent
+    proc->inheritResourceLimits(*TaskManager::getCurrentProcess());
+
+    /**
+     * Step 7: Store the new process ID if caller provided output pointer
      */
     if (isValidAddress(pid)) {
         *pid = proc->getPid();
@@ -1048,7 +1585,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleBrk(PalmyraOS::kernel::interru
     LOG_WARN("SYSCALL brk(0x%X)", requested_brk);
 
     // Get the current process
-    Process* currentProcess = TaskManager::getCurrentProcess();
+    Process* currentProcess = TaskManager::getCurrentProcess()->getThreadGroupLeader();
 
     // If the requested break is 0, return the current break
     if (requested_brk == 0) {
@@ -1118,15 +1655,38 @@ void PalmyraOS::kernel::SystemCallsManager::handleGetEGID(PalmyraOS::kernel::int
     regs->eax = 1000;
 }
 
+bool PalmyraOS::kernel::SystemCallsManager::loadThreadArea(user_desc* userDescriptor, Process::ThreadLocalStorage& tls) {
+    // A single TLS entry exists in the GDT; -1 asks the kernel to pick it
+    uint32_t entry = gdt_ptr->getThreadLocalStorageSegmentSelector().index;
+    if (userDescriptor->entry_number != static_cast<unsigned int>(-1) && userDescriptor->entry_number != entry) return false;
+    if (userDescriptor->seg_not_present || !userDescriptor->seg_32bit) return false;
+
+    // Report the chosen entry back (user space loads GS with (entry << 3) | 3)
+    userDescriptor->entry_number = entry;
+
+    tls.base                     = userDescriptor->base_addr;
+    tls.limitRaw                 = userDescriptor->limit & 0xFFFFF;
+    tls.limitInPages             = userDescriptor->limit_in_pages;
+    return true;
+}
+
 void PalmyraOS::kernel::SystemCallsManager::handleSetThreadArea(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int set_thread_area(struct user_desc* u_info)
 
     // Extract the pointer to the user descriptor (TLS descriptor) from the registers
-    //	auto* userDescriptor = reinterpret_cast<UserDescriptor*>(regs->ebx);
+    auto* userDescriptor = reinterpret_cast<user_desc*>(regs->ebx);
+    if (!isValidAddress(userDescriptor)) return;
 
-    LOG_WARN("SYSCALL set_thread_area(0x%X) ", regs->ebx);
+    auto* proc = TaskManager::getCurrentProcess();
+    if (!loadThreadArea(userDescriptor, proc->tls_)) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    // Apply it right away, the scheduler reloads it on every switch to this thread
+    gdt_ptr->setThreadLocalStorage(proc->tls_.base, proc->tls_.limitRaw, proc->tls_.limitInPages ? GDT::Granularity::Page : GDT::Granularity::Byte);
 
-    // Make the process think it was successful TODO far-future implement TLS and threading inside processes
-    regs->eax = (uint32_t) 0;
+    regs->eax = 0;
 }
 
 void PalmyraOS::kernel::SystemCallsManager::handleReboot(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
@@ -1225,8 +1785,8 @@ void PalmyraOS::kernel::SystemCallsManager::handleSocket(PalmyraOS::kernel::inte
     }
 
     // Allocate file descriptor
-    fd_t sockfd = proc->descriptorTable_.allocate(socketDesc);
-    if (sockfd < 0) {
+    fd_t sockfd = proc->getDescriptorTable().allocate(socketDesc);
+    if (static_cast<int>(sockfd) < 0) {
         LOG_ERROR("SYSCALL socket() -> failed to allocate descriptor");
         delete socketDesc;
         regs->eax = -EMFILE;
@@ -1259,7 +1819,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleBind(PalmyraOS::kernel::interr
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL bind() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1298,7 +1858,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleConnect(PalmyraOS::kernel::int
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL connect() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1347,7 +1907,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleSendto(PalmyraOS::kernel::inte
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL sendto() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1402,7 +1962,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleRecvfrom(PalmyraOS::kernel::in
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL recvfrom() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1444,7 +2004,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleSetsockopt(PalmyraOS::kernel::
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL setsockopt() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1492,7 +2052,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleGetsockopt(PalmyraOS::kernel::
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL getsockopt() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1537,7 +2097,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleGetsockname(PalmyraOS::kernel:
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL getsockname() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1582,7 +2142,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleGetpeername(PalmyraOS::kernel:
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL getpeername() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1614,7 +2174,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleListen(PalmyraOS::kernel::inte
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL listen() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1659,7 +2219,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleAccept(PalmyraOS::kernel::inte
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL accept() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1678,8 +2238,8 @@ void PalmyraOS::kernel::SystemCallsManager::handleAccept(PalmyraOS::kernel::inte
     }
 
     // Allocate file descriptor for new socket
-    fd_t newSockfd = proc->descriptorTable_.allocate(newSocket);
-    if (newSockfd < 0) {
+    fd_t newSockfd = proc->getDescriptorTable().allocate(newSocket);
+    if (static_cast<int>(newSockfd) < 0) {
         LOG_ERROR("SYSCALL accept() -> failed to allocate descriptor");
         delete newSocket;
         regs->eax = -EMFILE;
@@ -1705,7 +2265,7 @@ void PalmyraOS::kernel::SystemCallsManager::handleShutdown(PalmyraOS::kernel::in
     }
 
     // Get descriptor
-    Descriptor* desc = proc->descriptorTable_.get(sockfd);
+    Descriptor* desc = proc->getDescriptorTable().get(sockfd);
     if (!desc || desc->kind() != Descriptor::Kind::Socket) {
         LOG_ERROR("SYSCALL shutdown() -> invalid socket descriptor %d", sockfd);
         regs->eax = -EBADF;
@@ -1721,3 +2281,340 @@ void PalmyraOS::kernel::SystemCallsManager::handleShutdown(PalmyraOS::kernel::in
 
     LOG_INFO("SYSCALL shutdown() -> %d", result);
 }
+
+void PalmyraOS::kernel::SystemCallsManager::handlePoll(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int poll(struct pollfd *fds, nfds_t nfds, int timeout);
+    auto* fds         = reinterpret_cast<pollfd*>(regs->ebx);
+    uint32_t nfds     = regs->ecx;
+    int32_t timeout   = static_cast<int32_t>(regs->edx);
+
+    auto* proc        = TaskManager::getCurrentProcess();
+    auto& descriptors = proc->getDescriptorTable();
+
+    if (nfds > MAX_POLL_DESCRIPTORS) {
+        regs->eax = -EINVAL;
+        return;
+    }
+    if (nfds > 0 && (!isValidAddress(fds) || !isValidAddress(fds + nfds - 1))) {
+        regs->eax = -EFAULT;
+        return;
+    }
+
+    // Watch every polled descriptor while sleeping, woken by the first notification
+    uint64_t deadline = timeoutToDeadline(timeout);
+    bool watching     = false;
+    PollTable pollTable(proc);
+
+    while (true) {
+        int ready = 0;
+        for (uint32_t i = 0; i < nfds; ++i) {
+            fds[i].revents = 0;
+            if (fds[i].fd < 0) continue;
+
+            // Standard streams that are not redirected are polled on their ring
+            Descriptor* desc     = descriptors.get(fds[i].fd);
+            StreamBuffer* stream = desc ? nullptr : proc->getStandardStream(fds[i].fd);
+            if (!desc && !stream) {
+                fds[i].revents = POLLNVAL;
+                ready++;
+                continue;
+            }
+
+            uint32_t readiness = desc ? desc->poll() : stream->poll();
+            PollSource* source = desc ? desc->getPollSource() : stream->getPollSource();
+            uint32_t events    = readiness & (static_cast<uint16_t>(fds[i].events) | POLLERR | POLLHUP);
+            if (events) {
+                fds[i].revents = static_cast<int16_t>(events);
+                ready++;
+            }
+            else if (!watching && timeout != 0 && source && !pollTable.watch(source)) {
+                regs->eax = -ENOMEM;
+                return;
+            }
+        }
+        watching = true;
+
+        if (ready > 0 || timeout == 0 || isPastDeadline(deadline)) {
+            regs->eax = ready;
+            return;
+        }
+        pollTable.sleep(deadline);
+    }
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleEpollCreate(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int epoll_create(int size);
+    if (static_cast<int32_t>(regs->ebx) <= 0) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    regs->ebx = 0;
+    handleEpollCreate1(regs);
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleEpollCreate1(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int epoll_create1(int flags);
+    uint32_t flags = regs->ebx;
+    if (flags & ~EPOLL_CLOEXEC) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    auto* proc  = TaskManager::getCurrentProcess();
+    auto* epoll = heapManager.createInstance<EpollDescriptor>();
+    if (!epoll) {
+        regs->eax = -ENOMEM;
+        return;
+    }
+
+    fd_t epfd = proc->getDescriptorTable().allocate(epoll);
+    if (static_cast<int>(epfd) < 0) {
+        delete epoll;
+        regs->eax = -EMFILE;
+        return;
+    }
+    regs->eax = epfd;
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleEpollCtl(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+    fd_t epfd          = (fd_t) regs->ebx;
+    int op             = (int) regs->ecx;
+    fd_t fd            = (fd_t) regs->edx;
+    auto* event        = reinterpret_cast<epoll_event*>(regs->esi);
+
+    auto& descriptors  = TaskManager::getCurrentProcess()->getDescriptorTable();
+    Descriptor* desc   = descriptors.get(epfd);
+    Descriptor* target = descriptors.get(fd);
+    if (!desc || !target) {
+        regs->eax = -EBADF;
+        return;
+    }
+    if (desc->kind() != Descriptor::Kind::Epoll || target == desc) {
+        regs->eax = -EINVAL;
+        return;
+    }
+    if (op != EPOLL_CTL_DEL && !isValidAddress(event)) {
+        regs->eax = -EFAULT;
+        return;
+    }
+
+    auto* epoll = static_cast<EpollDescriptor*>(desc);
+    switch (op) {
+        case EPOLL_CTL_ADD: regs->eax = epoll->add(fd, target, *event); break;
+        case EPOLL_CTL_MOD: regs->eax = epoll->modify(fd, *event); break;
+        case EPOLL_CTL_DEL: regs->eax = epoll->remove(fd); break;
+        default: regs->eax = -EINVAL; break;
+    }
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleEpollWait(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout);
+    fd_t epfd         = (fd_t) regs->ebx;
+    auto* events      = reinterpret_cast<epoll_event*>(regs->ecx);
+    int32_t maxEvents = static_cast<int32_t>(regs->edx);
+    int32_t timeout   = static_cast<int32_t>(regs->esi);
+
+    auto& descriptors = TaskManager::getCurrentProcess()->getDescriptorTable();
+    Descriptor* desc  = descriptors.get(epfd);
+    if (!desc) {
+        regs->eax = -EBADF;
+        return;
+    }
+    if (desc->kind() != Descriptor::Kind::Epoll || maxEvents <= 0) {
+        regs->eax = -EINVAL;
+        return;
+    }
+    if (!isValidAddress(events) || !isValidAddress(events + maxEvents - 1)) {
+        regs->eax = -EFAULT;
+        return;
+    }
+
+    uint64_t deadline = timeoutToDeadline(timeout);
+    while (true) {
+        uint32_t count = static_cast<EpollDescriptor*>(desc)->collect(events, maxEvents);
+        if (count > 0 || timeout == 0 || isPastDeadline(deadline)) {
+            regs->eax = count;
+            return;
+        }
+        static_cast<EpollDescriptor*>(desc)->sleep(deadline);
+
+        // Another thread may have closed the epoll descriptor meanwhile
+        if (descriptors.get(epfd) != desc) {
+            regs->eax = -EBADF;
+            return;
+        }
+    }
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handlePipe(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int pipe(int pipefd[2]);
+    regs->ecx = 0;
+    handlePipe2(regs);
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handlePipe2(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int pipe2(int pipefd[2], int flags);
+    auto* pipefd   = reinterpret_cast<int32_t*>(regs->ebx);
+    uint32_t flags = regs->ecx;
+
+    if (!isValidAddress(pipefd) || !isValidAddress(pipefd + 1)) {
+        regs->eax = -EFAULT;
+        return;
+    }
+    if (flags & ~(O_NONBLOCK | O_CLOEXEC)) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    PipeDescriptor* readEnd  = nullptr;
+    PipeDescriptor* writeEnd = nullptr;
+    if (!Pipe::create(flags & O_NONBLOCK, &readEnd, &writeEnd)) {
+        regs->eax = -ENOMEM;
+        return;
+    }
+
+    auto& descriptors = TaskManager::getCurrentProcess()->getDescriptorTable();
+    fd_t readFd       = descriptors.allocate(readEnd);
+    fd_t writeFd      = static_cast<int>(readFd) < 0 ? readFd : descriptors.allocate(writeEnd);
+
+    // RLIMIT_NOFILE reached: both ends are closed again
+    if (static_cast<int>(writeFd) < 0) {
+        if (static_cast<int>(readFd) < 0) delete readEnd;
+        else descriptors.release(readFd);
+        delete writeEnd;
+        regs->eax = -EMFILE;
+        return;
+    }
+
+    pipefd[0] = readFd;
+    pipefd[1] = writeFd;
+    regs->eax = 0;
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleIoUringSetup(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int io_uring_setup(uint32_t entries, struct io_uring_params* params);
+    uint32_t entries = regs->ebx;
+    auto* params     = reinterpret_cast<io_uring_params*>(regs->ecx);
+
+    if (!isValidAddress(params) || !isValidAddress(reinterpret_cast<uint8_t*>(params + 1) - 1)) {
+        regs->eax = -EFAULT;
+        return;
+    }
+    if (entries == 0 || entries > IORING_MAX_ENTRIES || params->flags != 0) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    uint32_t sqEntries = 1;
+    while (sqEntries < entries) sqEntries <<= 1;
+    uint32_t cqEntries = sqEntries * 2;
+
+    // The rings go in process pages, identity-mapped like every allocatePages() block
+    auto* proc     = TaskManager::getCurrentProcess();
+    uint32_t pages = CEIL_DIV_PAGE_SIZE(IoRingDescriptor::ringSize(sqEntries, cqEntries));
+    auto* rings    = static_cast<io_uring_rings*>(proc->allocatePages(pages));
+    if (!rings) {
+        regs->eax = -ENOMEM;
+        return;
+    }
+    memset(rings, 0, pages * PAGE_SIZE);
+    IoRingDescriptor::initializeRings(rings, sqEntries, cqEntries);
+
+    auto* ring = heapManager.createInstance<IoRingDescriptor>(rings, sqEntries, cqEntries);
+    if (!ring) {
+        regs->eax = -ENOMEM;
+        return;
+    }
+
+    fd_t fd = proc->getDescriptorTable().allocate(ring);
+    if (static_cast<int>(fd) < 0) {
+        delete ring;
+        regs->eax = fd;
+        return;
+    }
+
+    params->sq_entries = sqEntries;
+    params->cq_entries = cqEntries;
+    params->rings      = rings;
+    regs->eax          = fd;
+}
+
+void PalmyraOS::kernel::SystemCallsManager::handleIoUringEnter(PalmyraOS::kernel::interrupts::CPURegisters* regs) {
+    // int io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags);
+    fd_t fd           = (fd_t) regs->ebx;
+    uint32_t toSubmit = regs->ecx;
+    uint32_t flags    = regs->esi;
+
+    if (flags & ~IORING_ENTER_GETEVENTS) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    auto* proc        = TaskManager::getCurrentProcess();
+    auto& descriptors = proc->getDescriptorTable();
+    Descriptor* desc  = descriptors.get(fd);
+    if (!desc) {
+        regs->eax = -EBADF;
+        return;
+    }
+    if (desc->kind() != Descriptor::Kind::IoRing) {
+        regs->eax = -EINVAL;
+        return;
+    }
+
+    auto* ring         = static_cast<IoRingDescriptor*>(desc);
+    uint32_t completed = 0;
+    int32_t openedFd   = -EBADF;  // Result of the latest IORING_OP_OPEN (for IOSQE_OPENED_FD)
+    io_uring_sqe entry{};
+    while (completed < toSubmit && ring->takeSubmission(entry)) {
+        int32_t result = runRingEntry(entry, openedFd);
+        if (entry.opcode == IORING_OP_OPEN) openedFd = result;
+
+        // A bad address terminated the process; a sleeping operation may have seen another thread close the ring
+        if (proc->getState() == Process::State::Terminated || descriptors.get(fd) != desc) break;
+
+        ring->complete(entry.user_data, result);
+        completed++;
+    }
+    regs->eax = completed;
+}
+
+int32_t PalmyraOS::kernel::SystemCallsManager::runRingEntry(const io_uring_sqe& entry, int32_t openedFd) {
+    if (entry.flags & ~IOSQE_OPENED_FD) return -EINVAL;
+
+    int32_t fd = entry.fd;
+    if (entry.flags & IOSQE_OPENED_FD) {
+        if (openedFd < 0) return -ECANCELED;
+        fd = openedFd;
+    }
+
+    // Every operation runs through its regular handler, as if the process had trapped for it
+    interrupts::CPURegisters regs{};
+    regs.ebx = fd;
+    regs.ecx = entry.addr;
+    regs.edx = entry.len;
+    regs.esi = entry.arg;
+    regs.edi = entry.addr2;
+    regs.ebp = entry.addr3;
+
+    switch (entry.opcode) {
+        case IORING_OP_NOP: return 0;
+        case IORING_OP_READ: regs.eax = POSIX_INT_READ; break;
+        case IORING_OP_WRITE: regs.eax = POSIX_INT_WRITE; break;
+        case IORING_OP_CLOSE: regs.eax = POSIX_INT_CLOSE; break;
+        case IORING_OP_SENDTO: regs.eax = POSIX_INT_SENDTO; break;
+        case IORING_OP_RECVFROM: regs.eax = POSIX_INT_RECVFROM; break;
+        case IORING_OP_GETDENTS: regs.eax = LINUX_INT_GETDENTS; break;
+        case IORING_OP_OPEN:
+            regs.eax = POSIX_INT_OPEN;
+            regs.ebx = entry.addr;  // open(path, flags)
+            regs.ecx = entry.len;
+            break;
+        default: return -EINVAL;
+    }
+
+    dispatch(&regs);
+    return static_cast<int32_t>(regs.eax);
+}
@@ -1,10 +1,13 @@
 
 #include "core/tasks/WindowManager.h"
+#include "core/Futex.h"
 #include "core/SystemClock.h"
 #include "core/cpu.h"
 #include "core/peripherals/RTC.h"
 #include "core/tasks/ProcessManager.h"
 #include "libs/memory.h"
+#include "palmyraOS/errono.h"
+#include "palmyraOS/unistd.h"  // palmyra_window_status
 #include <algorithm>
 
 // Only for debugging TODO
@@ -14,7 +17,8 @@
 
 uint32_t PalmyraOS::kernel::Window::count = 0;
 
-PalmyraOS::kernel::Window::Window(uint32_t* buffer, uint32_t x, uint32_t y, uint32_t width, uint32_t heigh) : x_(x), y_(y), z_(0), width_(width), height_(heigh), buffer_(buffer) {
+PalmyraOS::kernel::Window::Window(uint32_t* buffer, uint32_t x, uint32_t y, uint32_t width, uint32_t heigh, WindowEvents* events)
+    : x_(x), y_(y), z_(0), width_(width), height_(heigh), buffer_(buffer), events_(events) {
     id_ = ++count;
 
     char str_buffer[50];
@@ -30,36 +34,51 @@ void PalmyraOS::kernel::Window::setPosition(uint32_t x, uint32_t y) {
 
 void PalmyraOS::kernel::Window::queueKeyboardEvent(KeyboardEvent event) {
     if (!event.isValid) kernelPanic("Invalid Keyboard event!!");
-    if (keyboardsEvents_.size() > 20) keyboardsEvents_.pop();
-    keyboardsEvents_.push(event);
+    if (!events_) return;
+
+    // A full ring keeps the oldest events: the process sees a gap rather than reordered input
+    if (pushInputEvent(events_->keyboard, event)) hasNewEvents_ = true;
 }
 
 KeyboardEvent PalmyraOS::kernel::Window::popKeyboardEvent() {
-    if (keyboardsEvents_.empty()) return {};
-
-    KeyboardEvent front = keyboardsEvents_.front();
-    keyboardsEvents_.pop();
-    return front;
+    KeyboardEvent event;
+    if (!events_ || !popInputEvent(events_->keyboard, event)) return {};
+    return event;
 }
 
 void PalmyraOS::kernel::Window::queueMouseEvent(MouseEvent event) {
-    if (mouseEvents_.size() > 20) mouseEvents_.pop();
+    if (!events_) return;
 
     // Windows must get the position in window coordinates
     event.x -= x_;
     event.y -= y_;
 
-    mouseEvents_.push(event);
+    if (pushInputEvent(events_->mouse, event)) hasNewEvents_ = true;
 }
 
 MouseEvent PalmyraOS::kernel::Window::popMouseEvent() {
+    MouseEvent event;
+    if (events_ && popInputEvent(events_->mouse, event)) return event;
+
     auto [x, y] = WindowManager::getMousePosition();
-    if (mouseEvents_.empty()) return {.x = static_cast<int>(x - x_), .y = static_cast<int>(y - y_), .isLeftDown = WindowManager::isLeftButtonDown()};
+    return {.x = static_cast<int>(x - x_), .y = static_cast<int>(y - y_), .isLeftDown = WindowManager::isLeftButtonDown()};
+}
 
-    MouseEvent front = mouseEvents_.front();
-    mouseEvents_.pop();
+void PalmyraOS::kernel::Window::publishEvents(int mouseX, int mouseY, bool isLeftDown, bool isActive) {
+    if (!events_) return;
 
-    return front;
+    // Lets the process draw its frame and follow the cursor (even outside of the window) without a system call
+    events_->isActive = isActive;
+    events_->x        = static_cast<int32_t>(x_);
+    events_->y        = static_cast<int32_t>(y_);
+    events_->cursor   = {.x = mouseX - static_cast<int>(x_), .y = mouseY - static_cast<int>(y_), .isLeftDown = isLeftDown};
+
+    if (!hasNewEvents_) return;
+    hasNewEvents_ = false;
+
+    // The rings are identity-mapped, so the word has the same physical address (futex key) here
+    __atomic_add_fetch(&events_->sequence, 1, __ATOMIC_RELEASE);
+    Futex::wake(&events_->sequence, 0xFFFFFFFF);
 }
 
 void PalmyraOS::kernel::Window::setMovable(bool status) { isMovable_ = status; }
@@ -84,6 +103,8 @@ PalmyraOS::kernel::DragState PalmyraOS::kernel::WindowManager::dragState_;
 uint32_t PalmyraOS::kernel::WindowManager::update_ns_ = 4'000L;  // 250Hz cap (in VBX)
 uint64_t PalmyraOS::kernel::WindowManager::fps_       = 0;
 bool PalmyraOS::kernel::WindowManager::sortingNeeded_ = false;
+PalmyraOS::kernel::Mutex PalmyraOS::kernel::WindowManager::windowsLock_;
+PalmyraOS::kernel::SpinLock PalmyraOS::kernel::WindowManager::inputLock_;
 
 /***********************************************************************************************/
 
@@ -104,20 +125,27 @@ void PalmyraOS::kernel::WindowManager::initialize() {
     mouseY_                   = screenBuffer.getHeight() / 2;
 }
 
-PalmyraOS::kernel::Window* PalmyraOS::kernel::WindowManager::requestWindow(uint32_t* buffer_, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    // Add the new window to the vector
-    windows_.emplace_back(buffer_, x, y, width, height);
+uint32_t PalmyraOS::kernel::WindowManager::requestWindow(uint32_t* buffer_, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool movable, WindowEvents* events) {
+    LockGuard<Mutex> guard(windowsLock_);
+
+    // Add the new window to the vector (may reallocate: only the ID is handed out)
+    windows_.emplace_back(buffer_, x, y, width, height, events);
+    windows_.back().setMovable(movable);
 
-    setActiveWindow(windows_.back().getID());  // Set the newly created window as active
+    uint32_t id = windows_.back().getID();
+    setActiveWindow(id);  // Set the newly created window as active
 
-    // Return a pointer to the new window
-    return &windows_.back();
+    return id;
 }
 
 void PalmyraOS::kernel::WindowManager::closeWindow(uint32_t id) {
+    // Once this returns the compositor no longer reads the window buffer, so it may be freed
+    LockGuard<Mutex> guard(windowsLock_);
+
     for (auto& window: windows_) {
         if (window.id_ == id) {
             window.visible_ = false;
+            window.events_  = nullptr;  // The process may free the rings as soon as this returns
             deletedWindows_->push(window.id_);
             break;  // Exit the loop once the window is found and erased
         }
@@ -126,77 +154,74 @@ void PalmyraOS::kernel::WindowManager::closeWindow(uint32_t id) {
 }
 
 void PalmyraOS::kernel::WindowManager::queueMouseEvent(MouseEvent event) {
-    FrameBuffer& screenBuffer = PalmyraOS::kernel::display_ptr->getFrameBuffer();
-    size_t screenWidth        = screenBuffer.getWidth();
-    size_t screenHeight       = screenBuffer.getHeight();
-
-    // Update mouse position
-    updateMousePosition(event, screenWidth, screenHeight);
-    updateMouseButtonState(event);
-
-    // we get delta X, Y from mouse, but the event should have it in screen coordinates.
-    event.x = mouseX_;
-    event.y = mouseY_;
-
-    // Optionally pass event to active window
+    // Raw deltas: the compositor moves the cursor and forwards the event (forwardMouseEvents)
+    LockGuard<SpinLock> guard(inputLock_);
     if (mouseEvents_) mouseEvents_->push(event);
 }
 
 void PalmyraOS::kernel::WindowManager::queueKeyboardEvent(KeyboardEvent event) {
-    if (event.key == '\t' && event.isAltDown && !event.pressed) {
-        // Find the index of the current active window
-        auto currentIt = std::find_if(windows_.begin(), windows_.end(), [](const Window& window) { return window.getID() == activeWindowId_; });
-
-        if (currentIt != windows_.end()) {
-            // Loop to find the next visible window
-            auto nextIt = currentIt;
-            do {
-                ++nextIt;
-
-                // Wrap around to the first window
-                if (nextIt == windows_.end()) nextIt = windows_.begin();
-            } while (nextIt != currentIt && !nextIt->visible_);
-
-            // If a visible window is found, set it as active
-            if (nextIt->visible_) { setActiveWindow(nextIt->getID()); }
-        }
-        else { setActiveWindow(0); };
+    // Focus changes (Alt+Tab) are applied by the compositor (forwardKeyboardEvents)
+    LockGuard<SpinLock> guard(inputLock_);
+    if (keyboardsEvents_) keyboardsEvents_->push(event);
+}
 
-        // Do not pass event to windows
-        return;
-    }
+void PalmyraOS::kernel::WindowManager::cycleActiveWindow() {
+    // Find the index of the current active window
+    auto currentIt = std::find_if(windows_.begin(), windows_.end(), [](const Window& window) { return window.getID() == activeWindowId_; });
 
-    // Pass event
-    if (keyboardsEvents_) keyboardsEvents_->push(event);
+    if (currentIt != windows_.end()) {
+        // Loop to find the next visible window
+        auto nextIt = currentIt;
+        do {
+            ++nextIt;
+
+            // Wrap around to the first window
+            if (nextIt == windows_.end()) nextIt = windows_.begin();
+        } while (nextIt != currentIt && !nextIt->visible_);
+
+        // If a visible window is found, set it as active
+        if (nextIt->visible_) { setActiveWindow(nextIt->getID()); }
+    }
+    else { setActiveWindow(0); };
 }
 
 void PalmyraOS::kernel::WindowManager::composite() {
     FrameBuffer& screenBuffer  = PalmyraOS::kernel::display_ptr->getFrameBuffer();
     TextRenderer& textRenderer = *kernel::textRenderer_ptr;
 
-
-    TaskManager::startAtomicOperation();
     screenBuffer.fill(Color::DarkestGray);  // Background
 
-    // Erase deleted windows before sorting
-    doEraseWindows();
+    size_t windowCount;
+    {
+        // Processes only wait here if they touch a window while a frame is being composed
+        LockGuard<Mutex> guard(windowsLock_);
 
-    // Sort windows by z index MUST be here, so that mouse click doesn't affect it
-    if (sortingNeeded_) {
-        std::sort(windows_.begin(), windows_.end(), [](const Window& a, const Window& b) { return a.z_ < b.z_; });
-        sortingNeeded_ = false;
-    }
+        // Apply input first, so that focus, dragging and the cursor are current for this frame
+        forwardKeyboardEvents();
+        forwardMouseEvents();
+        publishEvents();
+
+        // Erase deleted windows before sorting
+        doEraseWindows();
+
+        // Sort windows by z index MUST be here, so that mouse click doesn't affect it
+        if (sortingNeeded_) {
+            std::sort(windows_.begin(), windows_.end(), [](const Window& a, const Window& b) { return a.z_ < b.z_; });
+            sortingNeeded_ = false;
+        }
 
-    // Composite each window onto the back buffer
+        // Composite each window onto the back buffer
+        for (const auto& window: windows_) { composeWindow(screenBuffer, window); }
 
-    for (const auto& window: windows_) { composeWindow(screenBuffer, window); }
+        windowCount = windows_.size();
+    }
 
     // draw mouse cursor
     renderMouseCursor();
 
     // TODO Window Manager Resources for Realtime Debugging
     textRenderer.setPosition(20, screenBuffer.getHeight() - 20);
-    textRenderer << "[Window " << activeWindowId_ << "]" << "[FPS: " << fps_ << "]" << "[Wins: " << windows_.size() << "]"
+    textRenderer << "[Window " << activeWindowId_ << "]" << "[FPS: " << fps_ << "]" << "[Wins: " << windowCount << "]"
                  << "[Mem: " << (PhysicalMemory::getAllocatedFrames() >> 8)  // pages to MiB
                  << "/" << (PhysicalMemory::size() >> 8) << " MiB]" << "[M/K: " << Mouse::getCounter() << "/" << Keyboard::getCount() << "]" << "[HSC: " << SystemClock::getTicks()
                  << "]" << "[TSC: " << CPU::getTSC() << "]" << "[At: " << TaskManager::getAtomicLevel() << "]";
@@ -204,14 +229,10 @@ void PalmyraOS::kernel::WindowManager::composite() {
 
     // Atomically Swap the buffers
     screenBuffer.swapBuffers();
-
-    // Forward Events
-    forwardKeyboardEvents();
-    forwardMouseEvents();
-    TaskManager::endAtomicOperation();
 }
 
 KeyboardEvent PalmyraOS::kernel::WindowManager::popKeyboardEvent(uint32_t id) {
+    LockGuard<Mutex> guard(windowsLock_);
     for (auto& window: windows_) {
         if (window.id_ == id) { return window.popKeyboardEvent(); }
     }
@@ -219,12 +240,46 @@ KeyboardEvent PalmyraOS::kernel::WindowManager::popKeyboardEvent(uint32_t id) {
 }
 
 MouseEvent PalmyraOS::kernel::WindowManager::popMouseEvent(uint32_t id) {
+    LockGuard<Mutex> guard(windowsLock_);
     for (auto& window: windows_) {
         if (window.id_ == id) { return window.popMouseEvent(); }
     }
     return {};
 }
 
+int PalmyraOS::kernel::WindowManager::waitForEvents(uint32_t id, uint64_t deadlineTick) {
+    uint32_t* sequence;
+    uint32_t expected;
+    {
+        LockGuard<Mutex> guard(windowsLock_);
+
+        Window* window = getWindowById(id);
+        if (!window || !window->events_) return -EINVAL;
+
+        // Read the sequence before checking the rings: a batch published after the check changes it
+        WindowEvents* events = window->events_;
+        sequence             = &events->sequence;
+        expected             = __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+        if (!isInputRingEmpty(events->keyboard) || !isInputRingEmpty(events->mouse)) return 0;
+    }
+
+    if (deadlineTick != 0 && deadlineTick <= SystemClock::getTicks()) return -ETIMEDOUT;
+
+    // -EAGAIN: events were published in between
+    int result = Futex::wait(sequence, expected, deadlineTick);
+    return result == -EAGAIN ? 0 : result;
+}
+
+bool PalmyraOS::kernel::WindowManager::getWindowStatus(uint32_t id, palmyra_window_status& status) {
+    LockGuard<Mutex> guard(windowsLock_);
+
+    Window* window = getWindowById(id);
+    if (!window) return false;
+
+    status = {.x = window->x_, .y = window->y_, .width = window->width_, .height = window->height_, .isActive = activeWindowId_ == id};
+    return true;
+}
+
 void PalmyraOS::kernel::WindowManager::setActiveWindow(uint32_t id) {
     for (auto& window: windows_) {
         if (window.id_ == id) {
@@ -244,8 +299,6 @@ void PalmyraOS::kernel::WindowManager::composeWindow(PalmyraOS::kernel::FrameBuf
 
     if (!window.visible_) return;
 
-    TaskManager::startAtomicOperation();
-
     size_t screenWidth   = buffer.getWidth();
     size_t screenHeight  = buffer.getHeight();
     uint32_t* backBuffer = buffer.getBackBuffer();  // RBGA (A not used)
@@ -282,7 +335,6 @@ void PalmyraOS::kernel::WindowManager::composeWindow(PalmyraOS::kernel::FrameBuf
         // Copy the entire line at once
         memcpy(destPtr, srcPtr, copyWidth);
     }
-    TaskManager::endAtomicOperation();
 }
 
 uint32_t PalmyraOS::kernel::WindowManager::getWindowAtPosition(int x, int y) {
@@ -387,51 +439,62 @@ PalmyraOS::kernel::Window* PalmyraOS::kernel::WindowManager::getWindowById(uint3
 }
 
 void PalmyraOS::kernel::WindowManager::forwardMouseEvents() {
-    // Empty events if no window is available to receive them.
-    if (windows_.empty()) {
-        while (!mouseEvents_->empty()) mouseEvents_->pop();
-        return;
-    }
+    FrameBuffer& screenBuffer = PalmyraOS::kernel::display_ptr->getFrameBuffer();
+    size_t screenWidth        = screenBuffer.getWidth();
+    size_t screenHeight       = screenBuffer.getHeight();
+
+    while (true) {
+        MouseEvent event;
+        {
+            LockGuard<SpinLock> guard(inputLock_);
+            if (mouseEvents_->empty()) break;
+            event = mouseEvents_->front();
+            mouseEvents_->pop();
+        }
 
-    size_t eventCount = mouseEvents_->size();
+        // Update mouse position
+        updateMousePosition(event, screenWidth, screenHeight);
+        updateMouseButtonState(event);
 
-    for (int i = 0; i < eventCount; ++i) {
-        // Get the topmost window at the mouse position
-        MouseEvent event = mouseEvents_->front();
-        mouseEvents_->pop();
+        // we get delta X, Y from mouse, but the event should have it in screen coordinates.
+        event.x = mouseX_;
+        event.y = mouseY_;
 
+        // Pass the event to the topmost window at the mouse position (dropped if there is none)
         uint32_t topWindowId = getWindowAtPosition(event.x, event.y);
         if (topWindowId == 0) continue;  // No window with id 0
 
-        for (auto& window: windows_) {
-            if (window.getID() == topWindowId) {
-                window.queueMouseEvent(event);
-                break;  // Stop Search
-            }
-        }
-        // Continue forwarding.
+        Window* window = getWindowById(topWindowId);
+        if (window) window->queueMouseEvent(event);
     }
 }
 
 void PalmyraOS::kernel::WindowManager::forwardKeyboardEvents() {
-    // Empty events if no window is available to receive them.
-    if (windows_.empty()) {
-        while (!keyboardsEvents_->empty()) keyboardsEvents_->pop();
-        return;
-    }
+    while (true) {
+        KeyboardEvent event;
+        {
+            LockGuard<SpinLock> guard(inputLock_);
+            if (keyboardsEvents_->empty()) break;
+            event = keyboardsEvents_->front();
+            keyboardsEvents_->pop();
+        }
 
-    size_t size = keyboardsEvents_->size();
-    for (int i = 0; i < size; ++i) {
-        for (auto& window: windows_) {
-            if (window.getID() == activeWindowId_) {
-                window.queueKeyboardEvent(keyboardsEvents_->front());
-                keyboardsEvents_->pop();
-                break;
-            }
+        // Alt+Tab switches the focus and is not passed to windows
+        if (event.key == '\t' && event.isAltDown && !event.pressed) {
+            cycleActiveWindow();
+            continue;
         }
+
+        // Pass the event to the active window (dropped if there is none)
+        Window* window = getWindowById(activeWindowId_);
+        if (window) window->queueKeyboardEvent(event);
     }
 }
 
+void PalmyraOS::kernel::WindowManager::publishEvents() {
+    for (auto& window: windows_) { window.publishEvents(mouseX_, mouseY_, isLeftButtonDown_, window.id_ == activeWindowId_); }
+}
+
 void PalmyraOS::kernel::WindowManager::renderMouseCursor() {
     constexpr uint32_t cursorWidth  = 8;
     constexpr uint32_t cursorHeight = 12;
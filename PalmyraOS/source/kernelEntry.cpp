@@ -2,13 +2,19 @@
 #include "core/Display.h"
 #include "core/FrameBuffer.h"
 #include "core/Interrupts.h"
+#include "core/LocalPage.h"
+#include "core/Profiler.h"
 #include "core/SystemClock.h"
+#include "core/TimePage.h"
+#include "core/Trace.h"
 #include "core/acpi/ACPI.h"
+#include "core/acpi/APIC.h"
 #include "core/acpi/HPET.h"
 #include "core/acpi/PowerManagement.h"
 #include "core/boot/multiboot2.h"
 #include "core/cpu.h"
 #include "core/kernel.h"
+#include "core/memory/PageCache.h"
 #include "core/panic.h"
 #include "core/pcie/PCIe.h"
 #include "core/peripherals/Keyboard.h"
@@ -192,7 +198,8 @@ void callConstructors() {
 
 
     enable_sse();
-    LOG_INFO("Enabled SSE.");
+    kernel::FPU::initialize();
+    LOG_INFO("Enabled SSE (lazy FPU context switching).");
 
     // ----------------------- Initialize Graphics ----------------------------
     // Initialize graphics using native Multiboot 2 information
@@ -286,6 +293,13 @@ void callConstructors() {
                 console << "HPET not available (using PIT)\n" << SWAP_BUFF();
             }
 
+            // Discover Local APIC / I/O APICs from the MADT (registers are mapped with virtual memory)
+            if (kernel::APIC::initialize()) {
+                LOG_INFO("APIC discovered (%u I/O APIC(s))", kernel::APIC::getIOAPICCount());
+                console << "APIC discovered (" << kernel::APIC::getIOAPICCount() << " I/O APICs)\n" << SWAP_BUFF();
+            }
+            else { LOG_WARN("APIC not available (will use 8259 PIC)"); }
+
             // Initialize PCIe (PCI Express Configuration Space) - DISCOVERY ONLY, NO HEAP!
             // This just reads the MCFG table and sets up the base address for configuration space access.
             // Actual device enumeration and driver initialization happens AFTER paging is enabled.
@@ -347,6 +361,19 @@ void callConstructors() {
     console << " Done.\n" << SWAP_BUFF();
     kernel::CPU::delay(SHORT_DELAY);
 
+    // ----------------------- Switch to APIC Interrupt Routing -------------------------------
+    if (kernel::APIC::isInitialized() && kernel::APIC::enable()) {
+        console << "APIC enabled (8259 PIC masked)\n" << SWAP_BUFF();
+
+        // Move the system tick from the PIT to the Local APIC timer (same vector 0x20)
+        if (kernel::APIC::calibrateTimer() && PalmyraOS::kernel::SystemClock::setFrequency(kernel::SystemClockFrequency)) {
+            LOG_INFO("System Clock moved to the Local APIC timer at %d Hz.", kernel::SystemClockFrequency);
+            console << "LAPIC timer: " << kernel::APIC::getTimerFrequency() << " Hz base\n" << SWAP_BUFF();
+        }
+        else { LOG_WARN("LAPIC timer unavailable, System Clock stays on the PIT (via I/O APIC)"); }
+    }
+    kernel::CPU::delay(SHORT_DELAY);
+
     //	kernel::testMemory();
     //	textRenderer << "Passed Heap Tests\n" << SWAP_BUFF();
 
@@ -416,8 +443,18 @@ void callConstructors() {
         LOG_INFO("Initialized Partitions.");
     }
 
+    // Shared time page (needs the RTC and the final timer frequency)
+    if (kernel::TimePage::initialize()) LOG_INFO("Initialized the shared time page.");
+    else kernel::kernelPanic("Failed to initialize the shared time page");
+
+    // Per-process page of the SDK (before the first user process)
+    if (!kernel::LocalPage::initialize()) kernel::kernelPanic("Failed to reserve the process-local page");
+
     console << "Initializing SystemCallsManager...\n" << SWAP_BUFF();
     kernel::SystemCallsManager::initialize();
+    kernel::PageCache::initialize();
+    kernel::Profiler::initialize();  // samples the interrupted process: attached to the timer before the scheduler
+    if (!kernel::Trace::initialize()) LOG_WARN("Failed to allocate the trace ring, tracepoints are disabled.");
     kernel::CPU::delay(SHORT_DELAY);
 
     console << "Initializing WindowManager...\n" << SWAP_BUFF();
@@ -478,8 +515,17 @@ void callConstructors() {
 
         // Initialize the Window Manager in Kernel Mode
         {
-            char* argv[] = {const_cast<char*>("/bin/windowsManager.elf"), nullptr};
-            kernel::TaskManager::execv_builtin(kernel::WindowManager::thread, kernel::Process::Mode::Kernel, kernel::Process::Priority::Medium, 0, argv, nullptr);
+            char* argv[]     = {const_cast<char*>("/bin/windowsManager.elf"), nullptr};
+            auto* compositor = kernel::TaskManager::execv_builtin(kernel::WindowManager::thread, kernel::Process::Mode::Kernel, kernel::Process::Priority::Medium, 0, argv, nullptr);
+
+            // The compositor also delivers input to windows: keep frames and the cursor responsive under load
+            if (compositor) kernel::TaskManager::setScheduler(compositor, kernel::Process::Policy::FIFO, kernel::WindowManager::REALTIME_PRIORITY);
+        }
+
+        // Release terminated processes outside of the scheduler tick
+        {
+            char* argv[] = {const_cast<char*>("/bin/reaper.elf"), nullptr};
+            kernel::TaskManager::execv_builtin(kernel::TaskManager::reaper, kernel::Process::Mode::Kernel, kernel::Process::Priority::Low, 0, argv, nullptr);
         }
 
         // Initialize the menu bar
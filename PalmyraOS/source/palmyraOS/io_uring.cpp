@@ -0,0 +1,34 @@
+
+#include "palmyraOS/io_uring.h"
+#include "libs/memory.h"
+#include "palmyraOS/unistd.h"
+
+
+struct io_uring_sqe* io_uring_get_sqe(struct io_uring_rings* rings) {
+    uint32_t tail = rings->sq_tail;
+    if (tail - rings->sq_head >= rings->sq_entries) return nullptr;
+
+    auto* entries = reinterpret_cast<io_uring_sqe*>(reinterpret_cast<uint8_t*>(rings) + rings->sqes_offset);
+    auto* entry   = &entries[tail & (rings->sq_entries - 1)];
+    memset(entry, 0, sizeof(io_uring_sqe));
+
+    // The kernel only runs entries below sq_tail once io_uring_submit() traps
+    rings->sq_tail = tail + 1;
+    return entry;
+}
+
+int io_uring_submit(int ring_fd, struct io_uring_rings* rings) {
+    uint32_t pending = rings->sq_tail - rings->sq_head;
+    if (pending == 0) return 0;
+    return io_uring_enter(ring_fd, pending, 0, IORING_ENTER_GETEVENTS);
+}
+
+struct io_uring_cqe* io_uring_peek_cqe(struct io_uring_rings* rings) {
+    uint32_t head = rings->cq_head;
+    if (head == rings->cq_tail) return nullptr;
+
+    auto* entries = reinterpret_cast<io_uring_cqe*>(reinterpret_cast<uint8_t*>(rings) + rings->cqes_offset);
+    return &entries[head & (rings->cq_entries - 1)];
+}
+
+void io_uring_cqe_seen(struct io_uring_rings* rings) { rings->cq_head = rings->cq_head + 1; }
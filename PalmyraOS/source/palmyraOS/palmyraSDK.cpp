@@ -119,7 +119,7 @@ int PalmyraOS::SDK::isElf(PalmyraOS::types::UserHeapManager& heap, const Palmyra
 /**********************************************************/
 
 PalmyraOS::SDK::Window::Window(uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool isMovable, const char* title) {
-    window_info_ = {.x = x, .y = y, .width = width, .height = height, .movable = isMovable, .title = ""};
+    window_info_ = {.x = x, .y = y, .width = width, .height = height, .movable = isMovable, .title = "", .events = nullptr};
     strncpy(window_info_.title, title, sizeof(window_info_.title));
 
     // initialize Window
@@ -141,6 +141,33 @@ uint32_t* PalmyraOS::SDK::Window::getFrontBuffer() const { return frontBuffer_;
 const char* PalmyraOS::SDK::Window::getTitle() const { return window_info_.title; }
 uint32_t PalmyraOS::SDK::Window::getID() const { return window_id_; }
 
+palmyra_window_status PalmyraOS::SDK::Window::getStatus() const {
+    WindowEvents* events = window_info_.events;
+    if (!events) return ::getStatus(window_id_);
+
+    return {.x        = static_cast<uint32_t>(events->x),
+            .y        = static_cast<uint32_t>(events->y),
+            .width    = window_info_.width,
+            .height   = window_info_.height,
+            .isActive = events->isActive != 0};
+}
+
+KeyboardEvent PalmyraOS::SDK::Window::nextKeyboardEvent() {
+    KeyboardEvent event;
+    if (!window_info_.events || !popInputEvent(window_info_.events->keyboard, event)) return {};
+    return event;
+}
+
+MouseEvent PalmyraOS::SDK::Window::nextMouseEvent() {
+    if (!window_info_.events) return {};
+
+    MouseEvent event;
+    if (popInputEvent(window_info_.events->mouse, event)) return event;
+    return window_info_.events->cursor;
+}
+
+int PalmyraOS::SDK::Window::waitForEvents(int timeoutMs) { return waitWindowEvents(window_id_, timeoutMs); }
+
 /**********************************************************/
 
 
@@ -155,7 +182,7 @@ PalmyraOS::SDK::WindowGUI::WindowGUI(Window& window)
 void PalmyraOS::SDK::WindowGUI::render() {
     textRenderer_.setPosition(5, 0);
     textRenderer_.setSize(frameBuffer_.getWidth(), frameBuffer_.getHeight());
-    currentWindowStatus_ = getStatus(window_.getID());
+    currentWindowStatus_ = window_.getStatus();
     Color barColor       = currentWindowStatus_.isActive ? PalmyraOS::Color::DarkerGray : PalmyraOS::Color::Black;
     Color borderColor    = currentWindowStatus_.isActive ? PalmyraOS::Color::Gray500 : PalmyraOS::Color::DarkerGray;
     Color stripesColor   = currentWindowStatus_.isActive ? PalmyraOS::Color::Gray700 : PalmyraOS::Color::DarkGray;
@@ -196,10 +223,14 @@ PalmyraOS::kernel::Brush& PalmyraOS::SDK::WindowGUI::brush() { return brush_; }
 PalmyraOS::kernel::TextRenderer& PalmyraOS::SDK::WindowGUI::text() { return textRenderer_; }
 
 void PalmyraOS::SDK::WindowGUI::pollEvents() {
-    // as for now, we only
-    wasLeftDown_       = currentMouseEvent_.isLeftDown;
+    // as for now, we only handle the mouse
+    wasLeftDown_ = currentMouseEvent_.isLeftDown;
+
+    // Queued motion is skipped up to the current cursor; a button event stops the scan, so every click gets its own frame
+    MouseEvent event = window_.nextMouseEvent();
+    while (event.isEvent && event.isLeftDown == wasLeftDown_ && !event.isRightDown && !event.isMiddleDown) event = window_.nextMouseEvent();
 
-    currentMouseEvent_ = nextMouseEvent(window_.getID());  // Fetch the next event
+    currentMouseEvent_ = event;
 }
 
 bool PalmyraOS::SDK::WindowGUI::button(const char* text,
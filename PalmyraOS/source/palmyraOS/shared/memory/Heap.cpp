@@ -46,6 +46,13 @@ bool PalmyraOS::types::HeapChunk::isPhysicallyContiguous(PalmyraOS::types::HeapC
 }
 
 void* PalmyraOS::types::HeapManagerBase::alloc(uint32_t size, bool page_align) {
+    lock();
+    void* result = allocUnlocked(size, page_align);
+    unlock();
+    return result;
+}
+
+void* PalmyraOS::types::HeapManagerBase::allocUnlocked(uint32_t size, bool page_align) {
     // Calculate the total size needed, including the chunk header
     uint32_t actualSize = size;
 
@@ -114,6 +121,12 @@ void* PalmyraOS::types::HeapManagerBase::requestMoreMemory(size_t size) {
 
 void PalmyraOS::types::HeapManagerBase::free(void* p) {
     if (!p) return;
+    lock();
+    freeUnlocked(p);
+    unlock();
+}
+
+void PalmyraOS::types::HeapManagerBase::freeUnlocked(void* p) {
 
     // Calculate the address of the chunk header
     auto* chunk         = (HeapChunk*) ((uintptr_t) p - sizeof(HeapChunk));
@@ -1,13 +1,232 @@
 
 #include "palmyraOS/stdlib.h"
+#include "libs/memory.h"
+#include "palmyraOS/thread.h"
 #include "palmyraOS/unistd.h"
 
 
+/*
+ * Size-class allocator
+ *
+ * Requests up to MAX_CLASS_SIZE are rounded up to one of CLASS_COUNT size classes: 16-byte
+ * steps up to 128 bytes, then four classes per power of two. Each class keeps a free list of
+ * blocks of exactly its size behind its own mutex, so malloc and free are a list push or pop
+ * and threads only contend when they use the same class. Empty lists are refilled with a
+ * batch of blocks carved from the heap region, which grows by GROWTH_STEP at a time through
+ * brk (or mmap for programs without a program break). Larger requests are mapped on their own
+ * and returned to the kernel by free.
+ *
+ * Every block starts with a BlockHeader; freed blocks keep it and store the list link in
+ * their payload. The state lives in the process-local page, because the globals of internal
+ * applications are shared by all processes.
+ */
+
+namespace {
+
+    constexpr uint32_t CLASS_COUNT    = 40;          // 16 bytes .. 32 KiB
+    constexpr uint32_t MAX_CLASS_SIZE = 32 * 1024;   // Largest block served from a size class
+    constexpr uint32_t LARGE_BLOCK    = 0xFFFFFFFF;  // BlockHeader::sizeClass of a block mapped on its own
+    constexpr uint32_t GROWTH_STEP    = 256 * 1024;  // Minimum heap growth
+    constexpr uint32_t REFILL_BYTES   = 16 * 1024;   // Carved at once into blocks of a size class
+    constexpr uint32_t PAGE_BYTES     = 4096;
+
+    enum class HeapSource : uint32_t { Unknown = 0, Brk, Mmap };
+
+    struct BlockHeader {
+        uint32_t sizeClass;  // Index into the classes, or LARGE_BLOCK
+        uint32_t size;       // Bytes of the block, header included
+    };
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Bin {
+        thread_mutex_t lock;
+        FreeBlock* freeList;  // Payloads of free blocks
+    };
+
+    // All zero is a valid empty state: the process-local page starts zeroed
+    struct MallocState {
+        thread_mutex_t heapLock;  // Protects source and the region
+        HeapSource source;        // Where the heap grows from (probed on the first growth)
+        uintptr_t regionStart;    // Unused part of the heap region
+        uintptr_t regionEnd;      // End of the heap region
+        Bin bins[CLASS_COUNT];    // Free lists, one per size class
+    };
+
+    static_assert(sizeof(MallocState) <= PAGE_BYTES, "The allocator state must fit in the process-local page");
+    static_assert(sizeof(BlockHeader) == 8, "Payloads must stay 8-byte aligned");
+
+    /// Same address in every process (contents differ), so one cached pointer serves all of them
+    MallocState* localState = nullptr;
+
+    MallocState* getState() {
+        if (!localState) localState = static_cast<MallocState*>(getLocalPage());
+        return localState;
+    }
+
+    // Block size (header included) to size class
+    uint32_t classOf(uint32_t bytes) {
+        if (bytes <= 128) return (bytes + 15) / 16 - 1;
+
+        // bytes lies in (2^shift, 2^(shift + 1)], split into four steps of 2^(shift - 2)
+        uint32_t shift = 31 - __builtin_clz(bytes - 1);
+        uint32_t step  = (bytes - 1 - (1u << shift)) >> (shift - 2);
+        return 8 + (shift - 7) * 4 + step;
+    }
+
+    uint32_t classSize(uint32_t sizeClass) {
+        if (sizeClass < 8) return (sizeClass + 1) * 16;
+
+        uint32_t shift = 7 + (sizeClass - 8) / 4;
+        uint32_t step  = (sizeClass - 8) % 4;
+        return (1u << shift) + ((step + 1) << (shift - 2));
+    }
+
+    // Makes room for at least `bytes` in the region (heapLock held)
+    bool growHeap(MallocState* state, uint32_t bytes) {
+        uint32_t growth = bytes > GROWTH_STEP ? (bytes + PAGE_BYTES - 1) & ~(PAGE_BYTES - 1) : GROWTH_STEP;
+
+        // Internal applications have no program break (brk(0) returns 0)
+        if (state->source == HeapSource::Unknown) {
+            auto current  = static_cast<uintptr_t>(brk(nullptr));
+            state->source = current != 0 && current != static_cast<uintptr_t>(-1) ? HeapSource::Brk : HeapSource::Mmap;
+        }
+
+        if (state->source == HeapSource::Brk) {
+            auto current = static_cast<uintptr_t>(brk(nullptr));
+            auto target  = current + growth;
+            if (static_cast<uintptr_t>(brk(reinterpret_cast<void*>(target))) == target) {
+                // Contiguous with the region unless somebody else moved the break
+                if (current != state->regionEnd) state->regionStart = current;
+                state->regionEnd = target;
+                return true;
+            }
+            state->source = HeapSource::Mmap;
+        }
+
+        void* chunk = mmap(nullptr, growth, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (chunk == MAP_FAILED) return false;
+
+        // The rest of the previous region (smaller than one refill) is abandoned
+        state->regionStart = reinterpret_cast<uintptr_t>(chunk);
+        state->regionEnd   = state->regionStart + growth;
+        return true;
+    }
+
+    uint8_t* carve(MallocState* state, uint32_t bytes) {
+        thread_mutex_lock(&state->heapLock);
+
+        uint8_t* memory = nullptr;
+        if (state->regionEnd - state->regionStart >= bytes || growHeap(state, bytes)) {
+            memory = reinterpret_cast<uint8_t*>(state->regionStart);
+            state->regionStart += bytes;
+        }
+
+        thread_mutex_unlock(&state->heapLock);
+        return memory;
+    }
+
+    // Fills an empty bin with a batch of blocks (bin lock held)
+    void refill(MallocState* state, uint32_t sizeClass) {
+        uint32_t blockSize = classSize(sizeClass);
+        uint32_t count     = REFILL_BYTES / blockSize;
+        if (count == 0) count = 1;
+
+        uint8_t* memory = carve(state, count * blockSize);
+        if (!memory) return;
+
+        Bin& bin = state->bins[sizeClass];
+        for (uint32_t i = count; i-- > 0;) {
+            auto* header      = reinterpret_cast<BlockHeader*>(memory + i * blockSize);
+            header->sizeClass = sizeClass;
+            header->size      = blockSize;
+
+            auto* block  = reinterpret_cast<FreeBlock*>(header + 1);
+            block->next  = bin.freeList;
+            bin.freeList = block;
+        }
+    }
+
+    void* allocateLarge(uint32_t size) {
+        if (size > 0xFFFFFFFF - sizeof(BlockHeader) - PAGE_BYTES) return nullptr;
+        uint32_t bytes = (size + sizeof(BlockHeader) + PAGE_BYTES - 1) & ~(PAGE_BYTES - 1);
+
+        void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (memory == MAP_FAILED) return nullptr;
+
+        auto* header      = static_cast<BlockHeader*>(memory);
+        header->sizeClass = LARGE_BLOCK;
+        header->size      = bytes;
+        return header + 1;
+    }
+
+}  // namespace
+
+
 void* malloc(size_t size) {
-    auto address = (uint32_t*) mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
-    return address;
+    if (size > MAX_CLASS_SIZE - sizeof(BlockHeader)) return allocateLarge(size);
+
+    MallocState* state = getState();
+    if (!state) return nullptr;
+
+    uint32_t sizeClass = classOf((size ? size : 1) + sizeof(BlockHeader));
+    Bin& bin           = state->bins[sizeClass];
+
+    thread_mutex_lock(&bin.lock);
+    if (!bin.freeList) refill(state, sizeClass);
+    FreeBlock* block = bin.freeList;
+    if (block) bin.freeList = block->next;
+    thread_mutex_unlock(&bin.lock);
+
+    return block;
 }
 
 void free(void* ptr) {
-    // TODO
+    if (!ptr) return;
+
+    auto* header = static_cast<BlockHeader*>(ptr) - 1;
+    if (header->sizeClass == LARGE_BLOCK) {
+        munmap(header, header->size);
+        return;
+    }
+
+    MallocState* state = getState();
+    if (!state || header->sizeClass >= CLASS_COUNT) return;  // Not a block of this allocator
+
+    Bin& bin    = state->bins[header->sizeClass];
+    auto* block = static_cast<FreeBlock*>(ptr);
+
+    thread_mutex_lock(&bin.lock);
+    block->next  = bin.freeList;
+    bin.freeList = block;
+    thread_mutex_unlock(&bin.lock);
+}
+
+void* calloc(size_t num, size_t size) {
+    if (size != 0 && num > 0xFFFFFFFF / size) return nullptr;
+
+    void* memory = malloc(num * size);
+    if (memory) memset(memory, 0, num * size);
+    return memory;
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (!ptr) return malloc(size);
+    if (size == 0) {
+        free(ptr);
+        return nullptr;
+    }
+
+    // Grow in place while the block (whose class was rounded up) is large enough
+    uint32_t capacity = (static_cast<BlockHeader*>(ptr) - 1)->size - sizeof(BlockHeader);
+    if (size <= capacity) return ptr;
+
+    void* memory = malloc(size);
+    if (!memory) return nullptr;
+
+    memcpy(memory, ptr, capacity);
+    free(ptr);
+    return memory;
 }
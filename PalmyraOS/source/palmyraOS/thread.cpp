@@ -0,0 +1,152 @@
+
+
+#include "palmyraOS/thread.h"
+#include "palmyraOS/errono.h"
+#include "palmyraOS/unistd.h"
+
+
+int thread_create(thread_t* thread, thread_entry_t entry, void* arg, uint32_t stackSize) {
+    if (!thread || !entry) return -EINVAL;
+    if (stackSize == 0) stackSize = THREAD_STACK_SIZE;
+
+    // Allocate the user stack (released by thread_join, or with the process)
+    void* stack = mmap(nullptr, stackSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (stack == MAP_FAILED) return -ENOMEM;
+
+    /**
+     * Prepare the top of the new stack: [entry][arg] with arg 16-byte aligned,
+     * so that after popping entry the call below sees arg as its first parameter.
+     */
+    auto top             = (reinterpret_cast<uint32_t>(stack) + stackSize - 16) & ~0xFu;
+    auto* frame          = reinterpret_cast<uint32_t*>(top) - 1;
+    frame[0]             = reinterpret_cast<uint32_t>(entry);
+    frame[1]             = reinterpret_cast<uint32_t>(arg);
+
+    constexpr auto flags = CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD | CLONE_SYSVSEM;
+
+    /**
+     * Both threads return from the same int 0x80. The new thread (eax = 0) runs on the new stack,
+     * so it must not touch this frame: it calls entry(arg) and exits with its return value.
+     */
+    int tid;
+    asm volatile("int $0x80\n\t"
+                 "test %%eax, %%eax\n\t"
+                 "jnz 1f\n\t"
+                 "pop %%eax\n\t"       // entry
+                 "call *%%eax\n\t"     // entry(arg)
+                 "mov %%eax, %%ebx\n\t"
+                 "mov %[exit], %%eax\n\t"
+                 "int $0x80\n\t"       // _exit(result), does not return
+                 "1:"
+                 : "=a"(tid)
+                 : "a"(POSIX_INT_CLONE), "b"(flags), "c"(frame), "d"(0), "S"(0), "D"(0), [exit] "i"(POSIX_INT_EXIT)
+                 : "memory");
+
+    if (tid < 0) return tid;
+
+    thread->tid   = tid;
+    thread->stack = stack;
+    thread->size  = stackSize;
+    return 0;
+}
+
+int thread_join(const thread_t& thread, int* exitCode) {
+    int status   = 0;
+    uint32_t ret = waitpid(thread.tid, &status, 0);
+    if (static_cast<int>(ret) < 0) return static_cast<int>(ret);
+
+    // The thread is gone: nothing runs on its stack anymore
+    munmap(thread.stack, thread.size);
+
+    if (exitCode) *exitCode = status;
+    return 0;
+}
+
+void thread_exit(int exitCode) {
+    _exit(exitCode);
+    while (true) {}
+}
+
+uint32_t thread_self() { return gettid(); }
+
+namespace {
+    inline uint32_t* word(volatile uint32_t* value) { return const_cast<uint32_t*>(value); }
+
+    inline void futexWait(volatile uint32_t* value, uint32_t expected) { futex(word(value), FUTEX_WAIT | FUTEX_PRIVATE_FLAG, expected, nullptr); }
+
+    inline void futexWake(volatile uint32_t* value, uint32_t count) { futex(word(value), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, count, nullptr); }
+}  // namespace
+
+void thread_mutex_init(thread_mutex_t* mutex) { mutex->state = 0; }
+
+void thread_mutex_lock(thread_mutex_t* mutex) {
+    // Uncontended: 0 -> 1 without entering the kernel
+    uint32_t state = 0;
+    if (__atomic_compare_exchange_n(word(&mutex->state), &state, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return;
+
+    // Contended: mark it 2 so that the holder wakes us, sleep until we took it as 0
+    if (state != 2) state = __atomic_exchange_n(word(&mutex->state), 2, __ATOMIC_ACQUIRE);
+    while (state != 0) {
+        futexWait(&mutex->state, 2);
+        state = __atomic_exchange_n(word(&mutex->state), 2, __ATOMIC_ACQUIRE);
+    }
+}
+
+int thread_mutex_trylock(thread_mutex_t* mutex) {
+    uint32_t state = 0;
+    return __atomic_compare_exchange_n(word(&mutex->state), &state, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ? 0 : -EBUSY;
+}
+
+void thread_mutex_unlock(thread_mutex_t* mutex) {
+    // 1 -> 0 nobody sleeps; 2 -> somebody may, hand the lock back and wake one
+    if (__atomic_fetch_sub(word(&mutex->state), 1, __ATOMIC_RELEASE) == 1) return;
+    __atomic_store_n(word(&mutex->state), 0, __ATOMIC_RELEASE);
+    futexWake(&mutex->state, 1);
+}
+
+void thread_cond_init(thread_cond_t* cond) { cond->sequence = 0; }
+
+void thread_cond_wait(thread_cond_t* cond, thread_mutex_t* mutex) {
+    // A signal between the unlock and the sleep changes the sequence, so the sleep returns at once
+    uint32_t sequence = __atomic_load_n(word(&cond->sequence), __ATOMIC_ACQUIRE);
+    thread_mutex_unlock(mutex);
+    futexWait(&cond->sequence, sequence);
+    thread_mutex_lock(mutex);
+}
+
+void thread_cond_signal(thread_cond_t* cond) {
+    __atomic_fetch_add(word(&cond->sequence), 1, __ATOMIC_RELEASE);
+    futexWake(&cond->sequence, 1);
+}
+
+void thread_cond_broadcast(thread_cond_t* cond) {
+    __atomic_fetch_add(word(&cond->sequence), 1, __ATOMIC_RELEASE);
+    futexWake(&cond->sequence, 0x7FFFFFFF);
+}
+
+void thread_sem_init(thread_sem_t* sem, uint32_t value) {
+    sem->value   = value;
+    sem->waiters = 0;
+}
+
+void thread_sem_wait(thread_sem_t* sem) {
+    while (thread_sem_trywait(sem) != 0) {
+        // Announce ourselves before sleeping, so that a post in between enters the kernel and the sleep returns
+        __atomic_fetch_add(word(&sem->waiters), 1, __ATOMIC_ACQUIRE);
+        futexWait(&sem->value, 0);
+        __atomic_fetch_sub(word(&sem->waiters), 1, __ATOMIC_RELEASE);
+    }
+}
+
+int thread_sem_trywait(thread_sem_t* sem) {
+    uint32_t value = __atomic_load_n(word(&sem->value), __ATOMIC_RELAXED);
+    while (value > 0) {
+        if (__atomic_compare_exchange_n(word(&sem->value), &value, value - 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return 0;
+    }
+    return -EAGAIN;
+}
+
+void thread_sem_post(thread_sem_t* sem) {
+    __atomic_fetch_add(word(&sem->value), 1, __ATOMIC_RELEASE);
+    if (__atomic_load_n(word(&sem->waiters), __ATOMIC_ACQUIRE) > 0) futexWake(&sem->value, 1);
+}
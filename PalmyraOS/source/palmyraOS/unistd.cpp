@@ -1,15 +1,77 @@
 
 
 #include "palmyraOS/unistd.h"
+#include "palmyraOS/errono.h"
+#include "palmyraOS/poll.h"
+#include "palmyraOS/shared/time/TimePage.h"
 #include "palmyraOS/time.h"
 #include <cstdarg>
 #include <cstddef>
 
 
+/*
+ * Fast system calls
+ *
+ * The wrappers below `call palmyra_syscall` with the usual int 0x80 registers
+ * (eax = number, ebx/ecx/edx/esi/edi = arguments, result in eax).
+ * If the CPU supports SYSENTER the stub uses it, otherwise (and in ring 0,
+ * e.g. kernel-mode processes) it falls back to int 0x80. Only ebp is unusable
+ * as an argument: sysenter_entry expects the user stack pointer in it.
+ */
+
+extern "C" {
+    /// 0: not probed yet, 1: SYSENTER available, 2: int 0x80 only
+    volatile uint8_t palmyra_sysenter_state = 0;
+
+    void palmyra_detect_sysenter() {
+        uint32_t eax, ebx, ecx, edx;
+        asm volatile("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(1), "c"(0));
+
+        uint32_t family   = (eax >> 8) & 0xF;
+        uint32_t model    = (eax >> 4) & 0xF;
+        uint32_t stepping = eax & 0xF;
+
+        // Same check as the kernel (CPU::isSysenterAvailable): the Pentium Pro reports SEP without supporting it
+        bool available         = (edx & (1 << 11)) && !(family == 6 && model < 3 && stepping < 3);
+        palmyra_sysenter_state = available ? 1 : 2;
+    }
+}
+
+asm(".text\n"
+    ".globl palmyra_syscall\n"
+    ".type palmyra_syscall, @function\n"
+    "palmyra_syscall:\n"
+    "    pushl %eax\n"  // Ring 0 cannot SYSENTER
+    "    movl %cs, %eax\n"
+    "    testb $3, %al\n"
+    "    popl %eax\n"
+    "    jz 1f\n"
+    "0:  cmpb $1, palmyra_sysenter_state\n"
+    "    je 2f\n"
+    "    ja 1f\n"
+    "    pushal\n"  // First call: probe CPUID
+    "    call palmyra_detect_sysenter\n"
+    "    popal\n"
+    "    jmp 0b\n"
+    "1:  int $0x80\n"
+    "    ret\n"
+    "2:  pushl %ecx\n"  // SYSEXIT clobbers ecx (esp) and edx (eip)
+    "    pushl %edx\n"
+    "    pushl %ebp\n"
+    "    pushl $3f\n"  // Return address for SYSEXIT, read by sysenter_entry from [ebp]
+    "    movl %esp, %ebp\n"
+    "    sysenter\n"
+    "3:  popl %ebp\n"
+    "    popl %edx\n"
+    "    popl %ecx\n"
+    "    ret\n"
+    ".size palmyra_syscall, .-palmyra_syscall\n");
+
+
 uint32_t get_pid() {
     uint32_t pid;
     register uint32_t syscall_no asm("eax") = POSIX_INT_GET_PID;
-    asm volatile("int $0x80\n\t"  // Interrupt to trigger system call
+    asm volatile("call palmyra_syscall\n\t"  // Trigger the system call
                  "mov %%eax, %0"
                  : "=r"(pid)        // Output: store the result in pid
                  : "r"(syscall_no)  // Input: system call number
@@ -21,7 +83,7 @@ uint32_t get_pid() {
 void _exit(uint32_t exitCode) {
     register uint32_t syscall_no asm("eax") = POSIX_INT_EXIT;
     register uint32_t code asm("ebx")       = exitCode;
-    asm volatile("int $0x80"                   // Interrupt to trigger system call
+    asm volatile("call palmyra_syscall"        // Trigger the system call
                  :                             // No outputs
                  : "r"(syscall_no), "r"(code)  // Inputs
                  : "memory"                    // Clobbered memory
@@ -37,7 +99,7 @@ int write(uint32_t fd, const void* buf, uint32_t count) {
     register const void* buffer asm("ecx")  = buf;
     register uint32_t byte_count asm("edx") = count;
 
-    asm volatile("int $0x80"                                                      // Interrupt to trigger system call
+    asm volatile("call palmyra_syscall"                                           // Trigger the system call
                  : "=a"(result)                                                   // Output: store the result (number of bytes written or error code) in result
                  : "r"(syscall_no), "r"(file_desc), "r"(buffer), "r"(byte_count)  // Inputs
                  : "memory"                                                       // Clobbered memory
@@ -55,8 +117,20 @@ void* mmap(void* addr, uint32_t length, int prot, int flags, int fd, uint32_t of
     register int flags_reg asm("esi")     = flags;
     register int fd_reg asm("edi")        = fd;
 
-    asm volatile("int $0x80" : "=a"(result) : "r"(syscall_no), "r"(addr_reg), "r"(length_reg), "r"(prot_reg), "r"(flags_reg), "r"(fd_reg), "m"(offset) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "r"(syscall_no), "r"(addr_reg), "r"(length_reg), "r"(prot_reg), "r"(flags_reg), "r"(fd_reg), "m"(offset) : "memory");
+
+    return result;
+}
+
+int munmap(void* addr, uint32_t length) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_MUNMAP), "b"(addr), "c"(length) : "memory");
+    return result;
+}
 
+void* getLocalPage() {
+    void* result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(INT_GET_LOCAL_PAGE) : "memory");
     return result;
 }
 
@@ -65,7 +139,7 @@ void closeWindow(uint32_t windowID) {
     register uint32_t windowId asm("ebx")   = windowID;
 
     // TODO
-    asm volatile("int $0x80"                       // Software interrupt to trigger the syscall
+    asm volatile("call palmyra_syscall"            // Trigger the system call
                  :                                 // No output operands
                  : "r"(syscall_no), "r"(windowId)  // Input operands
                  : "memory"                        // Clobbered registers
@@ -80,8 +154,8 @@ KeyboardEvent nextKeyboardEvent(uint32_t windowID) {
     register uint32_t eventPtr asm("ecx") = reinterpret_cast<uint32_t>(&event);
 
     // TODO
-    asm volatile("int $0x80"  // Software interrupt to trigger the syscall
-                 :            // No output operands
+    asm volatile("call palmyra_syscall"  // Trigger the system call
+                 :                       // No output operands
                  : "a"(syscall_no),
                    "b"(windowId),
                    "c"(eventPtr)
@@ -99,8 +173,8 @@ MouseEvent nextMouseEvent(uint32_t windowID) {
     register uint32_t eventPtr asm("ecx") = reinterpret_cast<uint32_t>(&event);
 
     // TODO
-    asm volatile("int $0x80"  // Software interrupt to trigger the syscall
-                 :            // No output operands
+    asm volatile("call palmyra_syscall"  // Trigger the system call
+                 :                       // No output operands
                  : "a"(syscall_no),
                    "b"(windowId),
                    "c"(eventPtr)
@@ -118,8 +192,8 @@ palmyra_window_status getStatus(uint32_t windowID) {
     register uint32_t eventPtr asm("ecx") = reinterpret_cast<uint32_t>(&status);
 
     // TODO
-    asm volatile("int $0x80"  // Software interrupt to trigger the syscall
-                 :            // No output operands
+    asm volatile("call palmyra_syscall"  // Trigger the system call
+                 :                       // No output operands
                  : "a"(syscall_no),
                    "b"(windowId),
                    "c"(eventPtr)
@@ -129,10 +203,16 @@ palmyra_window_status getStatus(uint32_t windowID) {
     return status;
 }
 
+int waitWindowEvents(uint32_t windowID, int timeoutMs) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(INT_WAIT_WINDOW_EVENTS), "b"(windowID), "c"(timeoutMs) : "memory");
+    return result;
+}
+
 int sched_yield() {
     int result;
     register uint32_t syscall_no asm("eax") = POSIX_INT_YIELD;
-    asm volatile("int $0x80\n\t"  // Interrupt to trigger system call
+    asm volatile("call palmyra_syscall\n\t"  // Trigger the system call
                  "mov %%eax, %0"
                  : "=r"(result)     // Output: store the result in result
                  : "r"(syscall_no)  // Input
@@ -141,21 +221,106 @@ int sched_yield() {
     return result;
 }
 
+int sched_setscheduler(uint32_t pid, int policy, const struct sched_param* param) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_SCHED_SETSCHEDULER), "b"(pid), "c"(policy), "d"(param) : "memory");
+    return result;
+}
+
+int sched_getscheduler(uint32_t pid) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_SCHED_GETSCHEDULER), "b"(pid) : "memory");
+    return result;
+}
+
+int futex(uint32_t* uaddr, int op, uint32_t val, const struct timespec* timeout) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_FUTEX), "b"(uaddr), "c"(op), "d"(val), "S"(timeout) : "memory");
+    return result;
+}
+
+int getpriority(int which, uint32_t who) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_GETPRIORITY), "b"(which), "c"(who) : "memory");
+
+    // The kernel returns 20 - nice (1..40) like Linux, so that errors stay negative
+    return result < 0 ? result - 20 : 20 - result;
+}
+
+int setpriority(int which, uint32_t who, int prio) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_SETPRIORITY), "b"(which), "c"(who), "d"(prio) : "memory");
+    return result;
+}
+
+int nice(int inc) {
+    int current = getpriority(PRIO_PROCESS, 0);
+    if (current < PRIO_MIN) return current;
+
+    int result = setpriority(PRIO_PROCESS, 0, current + inc);
+    if (result < 0) return result - 20;
+    return getpriority(PRIO_PROCESS, 0);
+}
+
+int getrlimit(int resource, struct rlimit* rlim) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_GETRLIMIT), "b"(resource), "c"(rlim) : "memory");
+    return result;
+}
+
+int setrlimit(int resource, const struct rlimit* rlim) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_SETRLIMIT), "b"(resource), "c"(rlim) : "memory");
+    return result;
+}
+
+/// Shared time page: nullptr until the first clock_gettime, then either the page or `timePageUnavailable`
+static const PalmyraOS::types::TimePageData* timePage = nullptr;
+static const PalmyraOS::types::TimePageData timePageUnavailable{};
+
+static const PalmyraOS::types::TimePageData* getTimePage() {
+    if (!timePage) {
+        uint32_t address;
+        asm volatile("call palmyra_syscall" : "=a"(address) : "a"(INT_GET_TIME_PAGE) : "memory");
+        timePage = address ? reinterpret_cast<const PalmyraOS::types::TimePageData*>(address) : &timePageUnavailable;
+    }
+    return timePage != &timePageUnavailable ? timePage : nullptr;
+}
+
 int clock_gettime(uint32_t clk_id, struct timespec* tp) {
+    // Monotonic and wall-clock time are read from the shared page, without entering the kernel
+    const auto* page = (clk_id == CLOCK_MONOTONIC || clk_id == CLOCK_REALTIME) ? getTimePage() : nullptr;
+    if (page && tp) {
+        uint64_t realtimeOffset;
+        uint64_t nanoseconds = PalmyraOS::types::readTimePage(page, &realtimeOffset);
+        if (clk_id == CLOCK_REALTIME) nanoseconds += realtimeOffset;
+
+        tp->tv_sec  = nanoseconds / 1'000'000'000;
+        tp->tv_nsec = nanoseconds % 1'000'000'000;
+        return 0;
+    }
+
     int ret;
-    asm volatile("int $0x80" : "=a"(ret) : "a"(POSIX_INT_GETTIME), "D"(clk_id), "S"(tp) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(ret) : "a"(POSIX_INT_GETTIME), "D"(clk_id), "S"(tp) : "memory");
     return ret;
 }
 
+uint64_t time(uint64_t* tloc) {
+    timespec now{};
+    if (clock_gettime(CLOCK_REALTIME, &now) != 0) return static_cast<uint64_t>(-1);
+    if (tloc) *tloc = now.tv_sec;
+    return now.tv_sec;
+}
+
 int open(const char* pathname, int flags) {
     int fd;
-    asm volatile("int $0x80" : "=a"(fd) : "a"(POSIX_INT_OPEN), "b"(pathname), "c"(flags) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(fd) : "a"(POSIX_INT_OPEN), "b"(pathname), "c"(flags) : "memory");
     return fd;
 }
 
 int close(uint32_t fd) {
     int ret;
-    asm volatile("int $0x80" : "=a"(ret) : "a"(POSIX_INT_CLOSE), "b"(fd) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(ret) : "a"(POSIX_INT_CLOSE), "b"(fd) : "memory");
     return ret;
 }
 
@@ -166,7 +331,7 @@ int ioctl(uint32_t fd, uint32_t request, ...) {
     va_end(args);
 
     int ret;
-    asm volatile("int $0x80" : "=a"(ret) : "a"(POSIX_INT_IOCTL), "b"(fd), "c"(request), "d"(argp) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(ret) : "a"(POSIX_INT_IOCTL), "b"(fd), "c"(request), "d"(argp) : "memory");
     return ret;
 }
 
@@ -178,7 +343,7 @@ int read(uint32_t fileDescriptor, void* buffer, uint32_t count) {
     register void* buf asm("ecx")           = buffer;
     register uint32_t n asm("edx")          = count;
 
-    asm volatile("int $0x80"                                   // Interrupt to trigger system call
+    asm volatile("call palmyra_syscall"                        // Trigger the system call
                  : "=a"(result)                                // Output: store the result (number of bytes read or error code) in result
                  : "r"(syscall_no), "r"(fd), "r"(buf), "r"(n)  // Inputs
                  : "memory"                                    // Clobbered memory
@@ -194,7 +359,7 @@ int getdents(unsigned int fileDescriptor, linux_dirent* dirp, unsigned int count
     register void* buf asm("ecx")           = dirp;
     register uint32_t n asm("edx")          = count;
 
-    asm volatile("int $0x80" : "=a"(result) : "r"(syscall_no), "r"(fd), "r"(buf), "r"(n) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "r"(syscall_no), "r"(fd), "r"(buf), "r"(n) : "memory");
     return result;
 }
 
@@ -208,7 +373,7 @@ int32_t lseek(uint32_t fd, int32_t offset, int whence) {
     register int whence_val asm("edx")      = whence;
 
     // Perform the system call using inline assembly
-    asm volatile("int $0x80"                                                          // Interrupt to trigger system call
+    asm volatile("call palmyra_syscall"                                               // Trigger the system call
                  : "=a"(result)                                                       // Output: store the result (new offset or error code) in result
                  : "r"(syscall_no), "r"(file_desc), "r"(offset_val), "r"(whence_val)  // Inputs
                  : "memory"                                                           // Clobbered memory
@@ -217,16 +382,37 @@ int32_t lseek(uint32_t fd, int32_t offset, int whence) {
     return result;  // Return the new file offset or -1 if an error occurred
 }
 
-int posix_spawn(uint32_t* pid, const char* path, void* file_actions, void* attrp, char* const* argv, char* const* envp) {
+int posix_spawn_file_actions_init(posix_spawn_file_actions_t* actions) {
+    actions->count = 0;
+    return 0;
+}
+
+int posix_spawn_file_actions_destroy(posix_spawn_file_actions_t* actions) {
+    actions->count = 0;
+    return 0;
+}
+
+int posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t* actions, int fd, int newfd) {
+    if (fd < 0 || newfd < 0) return -EINVAL;
+    if (actions->count >= SPAWN_MAX_FILE_ACTIONS) return -ENOMEM;
+
+    actions->dup2[actions->count].fd    = fd;
+    actions->dup2[actions->count].newfd = newfd;
+    actions->count++;
+    return 0;
+}
+
+int posix_spawn(uint32_t* pid, const char* path, const posix_spawn_file_actions_t* file_actions, void* attrp, char* const* argv, char* const* envp) {
     int result;
 
-    register uint32_t syscall_no asm("eax")   = POSIX_INT_POSIX_SPAWN;
-    register uint32_t pid_reg asm("ebx")      = reinterpret_cast<uint32_t>(pid);
-    register const char* path_reg asm("ecx")  = path;
-    register char* const* argv_reg asm("edx") = argv;
-    register char* const* envp_reg asm("esi") = envp;
+    register uint32_t syscall_no asm("eax")                           = POSIX_INT_POSIX_SPAWN;
+    register uint32_t pid_reg asm("ebx")                              = reinterpret_cast<uint32_t>(pid);
+    register const char* path_reg asm("ecx")                          = path;
+    register char* const* argv_reg asm("edx")                         = argv;
+    register char* const* envp_reg asm("esi")                         = envp;
+    register const posix_spawn_file_actions_t* actions_reg asm("edi") = file_actions;
 
-    asm volatile("int $0x80" : "=a"(result) : "r"(syscall_no), "r"(pid_reg), "r"(path_reg), "r"(argv_reg), "r"(envp_reg) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "r"(syscall_no), "r"(pid_reg), "r"(path_reg), "r"(argv_reg), "r"(envp_reg), "r"(actions_reg) : "memory");
 
     return result;
 }
@@ -239,7 +425,7 @@ uint32_t waitpid(uint32_t pid, int* status, int options) {
     register int* status_reg asm("ecx")     = status;
     register int options_reg asm("edx")     = options;
 
-    asm volatile("int $0x80" : "=a"(ret) : "r"(syscall_no), "r"(pid_reg), "r"(status_reg), "r"(options_reg) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(ret) : "r"(syscall_no), "r"(pid_reg), "r"(status_reg), "r"(options_reg) : "memory");
 
     return ret;
 }
@@ -252,7 +438,7 @@ int clock_nanosleep(uint32_t clock_id, int flags, const struct timespec* req, st
     register const struct timespec* req_ptr asm("edx") = req;
     register struct timespec* rem_ptr asm("esi")       = rem;
 
-    asm volatile("int $0x80"                                                           // Software interrupt to trigger the syscall
+    asm volatile("call palmyra_syscall"                                                // Trigger the system call
                  : "=a"(result)                                                        // Output: store the result in result
                  : "r"(syscall_no), "r"(clk_id), "r"(flg), "r"(req_ptr), "r"(rem_ptr)  // Inputs
                  : "memory"                                                            // Clobbered memory
@@ -268,7 +454,7 @@ int arch_prctl(int code, unsigned long addr) {
     register int arg1 asm("ebx")           = code;  // First argument (operation code)
     register unsigned long arg2 asm("ecx") = addr;  // Second argument (address or value)
 
-    asm volatile("int $0x80"                              // Trigger syscall interrupt
+    asm volatile("call palmyra_syscall"                   // Trigger the system call
                  : "=a"(result)                           // Output the result (return value)
                  : "r"(syscall_no), "r"(arg1), "r"(arg2)  // Inputs
                  : "memory");
@@ -286,7 +472,7 @@ int brk(void* end_data_segment) {
     register void* new_end asm("ebx")       = end_data_segment;
 
     // Perform the system call using inline assembly
-    asm volatile("int $0x80"                      // Trigger interrupt 0x80 (system call entry point)
+    asm volatile("call palmyra_syscall"           // Trigger the system call
                  : "=a"(result)                   // Output: store the result of the system call
                  : "r"(syscall_no), "r"(new_end)  // Input: system call number and new program break
                  : "memory"                       // Clobber: memory might be affected
@@ -299,7 +485,7 @@ int brk(void* end_data_segment) {
 uint32_t getuid() {
     uint32_t uid;
     register uint32_t syscall_no asm("eax") = POSIX_INT_GETUID;
-    asm volatile("int $0x80\n\t"  // Trigger the system call
+    asm volatile("call palmyra_syscall\n\t"  // Trigger the system call
                  "mov %%eax, %0"
                  : "=r"(uid)        // Output: store the result in uid
                  : "r"(syscall_no)  // Input: system call number
@@ -311,7 +497,7 @@ uint32_t getuid() {
 uint32_t getgid() {
     uint32_t gid;
     register uint32_t syscall_no asm("eax") = POSIX_INT_GETGID;
-    asm volatile("int $0x80\n\t"  // Trigger the system call
+    asm volatile("call palmyra_syscall\n\t"  // Trigger the system call
                  "mov %%eax, %0"
                  : "=r"(gid)        // Output: store the result in gid
                  : "r"(syscall_no)  // Input: system call number
@@ -323,7 +509,7 @@ uint32_t getgid() {
 uint32_t geteuid32() {
     uint32_t euid;
     register uint32_t syscall_no asm("eax") = POSIX_INT_GETEUID32;
-    asm volatile("int $0x80\n\t"  // Trigger the system call
+    asm volatile("call palmyra_syscall\n\t"  // Trigger the system call
                  "mov %%eax, %0"
                  : "=r"(euid)       // Output: store the result in euid
                  : "r"(syscall_no)  // Input: system call number
@@ -335,7 +521,7 @@ uint32_t geteuid32() {
 uint32_t getegid32() {
     uint32_t egid;
     register uint32_t syscall_no asm("eax") = POSIX_INT_GETEGID32;
-    asm volatile("int $0x80\n\t"  // Trigger the system call
+    asm volatile("call palmyra_syscall\n\t"  // Trigger the system call
                  "mov %%eax, %0"
                  : "=r"(egid)       // Output: store the result in egid
                  : "r"(syscall_no)  // Input: system call number
@@ -344,6 +530,31 @@ uint32_t getegid32() {
     return egid;
 }
 
+int set_thread_area(struct user_desc* u_info) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_SETTHREADAREA), "b"(u_info) : "memory");
+    return result;
+}
+
+int clone(uint32_t flags, void* child_stack, uint32_t* ptid, struct user_desc* tls, uint32_t* ctid) {
+    // The new thread also returns here, but on child_stack: only usable from code that does not
+    // rely on its stack frame afterwards (see thread_create)
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(POSIX_INT_CLONE), "b"(flags), "c"(child_stack), "d"(ptid), "S"(tls), "D"(ctid) : "memory");
+    return result;
+}
+
+uint32_t gettid() {
+    uint32_t tid;
+    asm volatile("call palmyra_syscall" : "=a"(tid) : "a"(POSIX_INT_GETTID) : "memory");
+    return tid;
+}
+
+void exit_group(uint32_t exitCode) {
+    asm volatile("call palmyra_syscall" : : "a"(POSIX_INT_EXIT_GROUP), "b"(exitCode) : "memory");
+    // The function will not return as the process will be terminated.
+}
+
 uint32_t initializeWindow(uint32_t** buffer, palmyra_window* palmyraWindow) {
     uint32_t result;
 
@@ -353,12 +564,12 @@ uint32_t initializeWindow(uint32_t** buffer, palmyra_window* palmyraWindow) {
     uint32_t ecx = reinterpret_cast<uint32_t>(palmyraWindow);  // Address of palmyra_window structure
 
     // Perform the system call using inline assembly
-    asm volatile("int $0x80"     // Trigger interrupt 0x80
-                 : "=a"(result)  // Output: store result in 'result' from 'eax'
-                 : "a"(eax),     // Input: system call number
-                   "b"(ebx),     // Input: buffer
-                   "c"(ecx)      // Input: palmyra_window structure
-                 : "memory"      // Clobber: memory might be affected
+    asm volatile("call palmyra_syscall"  // Trigger the system call
+                 : "=a"(result)          // Output: store result in 'result' from 'eax'
+                 : "a"(eax),             // Input: system call number
+                   "b"(ebx),             // Input: buffer
+                   "c"(ecx)              // Input: palmyra_window structure
+                 : "memory"              // Clobber: memory might be affected
     );
 
     return result;  // Return the result of the system call (window ID)
@@ -370,7 +581,7 @@ int mkdir(const char* pathname, uint16_t mode) {
     register const char* path_reg asm("ebx") = pathname;
     register uint16_t mode_reg asm("ecx")    = mode;
 
-    asm volatile("int $0x80" : "=a"(result) : "r"(syscall_no), "r"(path_reg), "r"(mode_reg) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "r"(syscall_no), "r"(path_reg), "r"(mode_reg) : "memory");
     return result;
 }
 
@@ -379,7 +590,7 @@ int unlink(const char* pathname) {
     register uint32_t syscall_no asm("eax")  = POSIX_INT_UNLINK;
     register const char* path_reg asm("ebx") = pathname;
 
-    asm volatile("int $0x80" : "=a"(result) : "r"(syscall_no), "r"(path_reg) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "r"(syscall_no), "r"(path_reg) : "memory");
     return result;
 }
 
@@ -388,7 +599,7 @@ int rmdir(const char* pathname) {
     register uint32_t syscall_no asm("eax")  = POSIX_INT_RMDIR;
     register const char* path_reg asm("ebx") = pathname;
 
-    asm volatile("int $0x80" : "=a"(result) : "r"(syscall_no), "r"(path_reg) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "r"(syscall_no), "r"(path_reg) : "memory");
     return result;
 }
 
@@ -400,7 +611,7 @@ int reboot(int magic, int magic2, int cmd, void* arg) {
     register int cmd_reg asm("edx")         = cmd;
     register void* arg_reg asm("esi")       = arg;
 
-    asm volatile("int $0x80" : "=a"(result) : "r"(syscall_no), "r"(magic_reg), "r"(magic2_reg), "r"(cmd_reg), "r"(arg_reg) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "r"(syscall_no), "r"(magic_reg), "r"(magic2_reg), "r"(cmd_reg), "r"(arg_reg) : "memory");
     return result;
 }
 
@@ -408,19 +619,19 @@ int reboot(int magic, int magic2, int cmd, void* arg) {
 
 int socket(int domain, int type, int protocol) {
     int result;
-    asm volatile("int $0x80" : "=a"(result) : "a"(POSIX_INT_SOCKET), "b"(domain), "c"(type), "d"(protocol) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_SOCKET), "b"(domain), "c"(type), "d"(protocol) : "memory");
     return result;
 }
 
 int bind(int sockfd, const struct sockaddr* addr, uint32_t addrlen) {
     int result;
-    asm volatile("int $0x80" : "=a"(result) : "a"(POSIX_INT_BIND), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_BIND), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
     return result;
 }
 
 int connect(int sockfd, const struct sockaddr* addr, uint32_t addrlen) {
     int result;
-    asm volatile("int $0x80" : "=a"(result) : "a"(POSIX_INT_CONNECT), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_CONNECT), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
     return result;
 }
 
@@ -463,7 +674,7 @@ int setsockopt(int sockfd, int level, int optname, const void* optval, uint32_t
     register const void* optval_reg asm("esi") = optval;
     register uint32_t optlen_reg asm("edi") = optlen;
 
-    asm volatile("int $0x80" : "=a"(result) : "r"(syscall_no), "r"(sockfd_reg), "r"(level_reg), "r"(optname_reg), "r"(optval_reg), "r"(optlen_reg) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "r"(syscall_no), "r"(sockfd_reg), "r"(level_reg), "r"(optname_reg), "r"(optval_reg), "r"(optlen_reg) : "memory");
     return result;
 }
 
@@ -476,36 +687,92 @@ int getsockopt(int sockfd, int level, int optname, void* optval, uint32_t* optle
     register void* optval_reg asm("esi")    = optval;
     register uint32_t* optlen_reg asm("edi") = optlen;
 
-    asm volatile("int $0x80" : "=a"(result) : "r"(syscall_no), "r"(sockfd_reg), "r"(level_reg), "r"(optname_reg), "r"(optval_reg), "r"(optlen_reg) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "r"(syscall_no), "r"(sockfd_reg), "r"(level_reg), "r"(optname_reg), "r"(optval_reg), "r"(optlen_reg) : "memory");
     return result;
 }
 
 int getsockname(int sockfd, struct sockaddr* addr, uint32_t* addrlen) {
     int result;
-    asm volatile("int $0x80" : "=a"(result) : "a"(POSIX_INT_GETSOCKNAME), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_GETSOCKNAME), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
     return result;
 }
 
 int getpeername(int sockfd, struct sockaddr* addr, uint32_t* addrlen) {
     int result;
-    asm volatile("int $0x80" : "=a"(result) : "a"(POSIX_INT_GETPEERNAME), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_GETPEERNAME), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
     return result;
 }
 
 int listen(int sockfd, int backlog) {
     int result;
-    asm volatile("int $0x80" : "=a"(result) : "a"(POSIX_INT_LISTEN), "b"(sockfd), "c"(backlog) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_LISTEN), "b"(sockfd), "c"(backlog) : "memory");
     return result;
 }
 
 int accept(int sockfd, struct sockaddr* addr, uint32_t* addrlen) {
     int result;
-    asm volatile("int $0x80" : "=a"(result) : "a"(POSIX_INT_ACCEPT), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_ACCEPT), "b"(sockfd), "c"(addr), "d"(addrlen) : "memory");
     return result;
 }
 
 int shutdown(int sockfd, int how) {
     int result;
-    asm volatile("int $0x80" : "=a"(result) : "a"(POSIX_INT_SHUTDOWN), "b"(sockfd), "c"(how) : "memory");
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_SHUTDOWN), "b"(sockfd), "c"(how) : "memory");
+    return result;
+}
+
+// ==================== I/O Multiplexing ====================
+
+int poll(struct pollfd* fds, uint32_t nfds, int timeout) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_POLL), "b"(fds), "c"(nfds), "d"(timeout) : "memory");
+    return result;
+}
+
+int epoll_create(int size) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_EPOLL_CREATE), "b"(size) : "memory");
+    return result;
+}
+
+int epoll_create1(int flags) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_EPOLL_CREATE1), "b"(flags) : "memory");
+    return result;
+}
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event* event) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_EPOLL_CTL), "b"(epfd), "c"(op), "d"(fd), "S"(event) : "memory");
+    return result;
+}
+
+int epoll_wait(int epfd, struct epoll_event* events, int maxevents, int timeout) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_EPOLL_WAIT), "b"(epfd), "c"(events), "d"(maxevents), "S"(timeout) : "memory");
+    return result;
+}
+
+int pipe(int pipefd[2]) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_PIPE), "b"(pipefd) : "memory");
+    return result;
+}
+
+int pipe2(int pipefd[2], int flags) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_PIPE2), "b"(pipefd), "c"(flags) : "memory");
+    return result;
+}
+
+int io_uring_setup(uint32_t entries, struct io_uring_params* params) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_IO_URING_SETUP), "b"(entries), "c"(params) : "memory");
+    return result;
+}
+
+int io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+    int result;
+    asm volatile("call palmyra_syscall" : "=a"(result) : "a"(POSIX_INT_IO_URING_ENTER), "b"(fd), "c"(to_submit), "d"(min_complete), "S"(flags) : "memory");
     return result;
 }
@@ -118,6 +118,103 @@ namespace PalmyraOS::Userland::builtin::KernelTerminal {
         // Remove trailing '/.' or '/..' should already be normalized by logic above
     }
 
+    // Helper: Spawn tokens[first, last) as "<path> <args...>" with the terminal environment
+    static int spawnFromTokens(UserHeapManager& heap,
+                               types::UVector<types::UString<char>>& tokens,
+                               size_t first,
+                               size_t last,
+                               const posix_spawn_file_actions_t* actions,
+                               uint32_t* pid) {
+        // Convert the tokens to a format suitable for posix_spawn
+        char resolvedPath[kPathMax];
+        resolvePathToBuffer(tokens[first].c_str(), resolvedPath, sizeof(resolvedPath));
+        size_t argc = last - first;
+
+        // Prepare argv array for the new process
+        char** argv = (char**) heap.alloc((argc + 1) * sizeof(char*));
+        if (!argv) return -ENOMEM;
+
+        for (size_t i = 0; i < argc; ++i) { argv[i] = const_cast<char*>(tokens[first + i].c_str()); }
+        argv[argc] = nullptr;  // Null-terminate the argv array
+
+        // Prepare environment array with PWD
+        char pwdEnv[kPathMax + 16];
+        snprintf(pwdEnv, sizeof(pwdEnv), "PWD=%s", g_cwd);
+
+        char* envp[] = {const_cast<char*>("PATH=/bin"), const_cast<char*>("HOME=/"), const_cast<char*>("USER=root"), pwdEnv, nullptr};
+
+        // Spawn the new process with environment
+        int status = posix_spawn(pid, resolvedPath, actions, nullptr, argv, envp);
+
+        // Free allocated memory for argv
+        heap.free(argv);
+        return status;
+    }
+
+    // Helper: Run "exec a [args] | b [args] | ..." with each stdout piped into the next stdin.
+    // The terminal reads the last stdout while the stages run, so a stage that produces faster
+    // than the next one consumes sleeps on its full pipe instead of buffering everything.
+    static void runPipeline(UserHeapManager& heap, types::UVector<types::UString<char>>& tokens, StdoutType& output) {
+        constexpr size_t kMaxStages = 8;
+        uint32_t pids[kMaxStages];
+        size_t stages    = 0;
+        int previousRead = -1;  // Read end of the pipe feeding the next stage
+        size_t first     = 1;
+
+        for (size_t i = 1; i <= tokens.size(); ++i) {
+            if (i < tokens.size() && tokens[i] != "|") continue;
+            if (i == first || stages == kMaxStages) {
+                output.append("exec: Invalid pipeline.\n", 25);
+                break;
+            }
+
+            int pipefd[2];
+            if (pipe(pipefd) != 0) {
+                output.append("exec: Failed to create a pipe.\n", 32);
+                break;
+            }
+
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            if (previousRead >= 0) posix_spawn_file_actions_adddup2(&actions, previousRead, STDIN);
+            posix_spawn_file_actions_adddup2(&actions, pipefd[1], STDOUT);
+
+            uint32_t pid;
+            int status = spawnFromTokens(heap, tokens, first, i, &actions, &pid);
+            posix_spawn_file_actions_destroy(&actions);
+
+            // Keep no write end ourselves: readers see end of file once the stages exit
+            close(pipefd[1]);
+            if (previousRead >= 0) close(previousRead);
+            previousRead = pipefd[0];
+
+            if (status != 0) {
+                output.append("exec: Failed to start process.\n", 32);
+                break;
+            }
+            pids[stages++] = pid;
+            first          = i + 1;
+        }
+
+        // Collect the output of the last stage until it exits
+        if (previousRead >= 0) {
+            char buffer[kPathMax];
+            int bytesRead = 0;
+            while ((bytesRead = read(previousRead, buffer, sizeof(buffer))) > 0) { output.append(buffer, bytesRead); }
+            close(previousRead);
+        }
+
+        for (size_t i = 0; i < stages; ++i) {
+            int wait_status;
+            if (waitpid(pids[i], &wait_status, 0) != pids[i] || wait_status == 0) continue;
+
+            char statusBuffer[32];
+            snprintf(statusBuffer, sizeof(statusBuffer), "%d terminated with status %d.\n", pids[i], wait_status);
+            output.append("Process with PID ", 17);
+            output.append(statusBuffer, strlen(statusBuffer));
+        }
+    }
+
     // Function declarations for command parsing and execution
     void parseCommand(UserHeapManager& heap, CircularBuffer<char>& input, types::UVector<types::UString<char>>& tokens);
     void executeCommand(UserHeapManager& heap, StdinType& input, StdoutType& output);
@@ -203,7 +300,7 @@ namespace PalmyraOS::Userland::builtin::KernelTerminal {
             // Another loop to catch all keyboard events
             KeyboardEvent event;
             while (true) {
-                event = nextKeyboardEvent(window.getID());       // Fetch the next event
+                event = window.nextKeyboardEvent();              // Fetch the next event
                 if (!event.isValid || event.key == '\0') break;  // If no key is pressed, break the loop
                 if (event.pressed) break;                        // only handle releases
                 else if (event.key == 8)
@@ -273,7 +370,7 @@ namespace PalmyraOS::Userland::builtin::KernelTerminal {
 
             // Handle mouse scrolling
             {
-                MouseEvent mouseEvent = nextMouseEvent(window.getID());
+                MouseEvent mouseEvent = window.nextMouseEvent();
                 if (mouseEvent.isEvent) {
                     // Middle button scroll: positive deltaX = scroll up, negative = scroll down
                     if (mouseEvent.isMiddleDown) {
@@ -578,6 +675,74 @@ namespace PalmyraOS::Userland::builtin::KernelTerminal {
             return;
         }
 
+        // TRACE - Control kernel tracepoints: trace on|off|clear|<hex event mask> (records are read from /proc/trace)
+        if (tokens[0] == "trace") {
+            if (tokens.size() < 2) {
+                output.append("Usage: trace on|off|clear|<mask>\n", 33);
+                return;
+            }
+
+            int fileDescriptor = open("/proc/trace", O_WRONLY);
+            if (fileDescriptor < 0 || write(fileDescriptor, tokens[1].c_str(), tokens[1].size()) < 0) output.append("trace: /proc/trace is not available\n", 36);
+            if (fileDescriptor >= 0) close(fileDescriptor);
+            return;
+        }
+
+        // ULIMIT - Show or lower the soft resource limits (inherited by the commands started afterwards)
+        if (tokens[0] == "ulimit") {
+            struct LimitOption {
+                const char* flag;
+                int resource;
+                uint32_t unit;  // Bytes or counts per displayed unit
+                const char* name;
+            };
+            static constexpr LimitOption kLimits[] = {
+                    {"-t", RLIMIT_CPU, 1, "cpu time (seconds)"},
+                    {"-s", RLIMIT_STACK, 1024, "stack size (KiB)"},
+                    {"-n", RLIMIT_NOFILE, 1, "open files"},
+                    {"-v", RLIMIT_AS, 1024, "virtual memory (KiB)"},
+            };
+
+            char line[64];
+            if (tokens.size() == 1) {
+                for (const auto& option: kLimits) {
+                    rlimit limit{};
+                    if (getrlimit(option.resource, &limit) != 0) continue;
+                    if (limit.rlim_cur == RLIM_INFINITY) snprintf(line, sizeof(line), "%s %s: unlimited\n", option.flag, option.name);
+                    else snprintf(line, sizeof(line), "%s %s: %u\n", option.flag, option.name, limit.rlim_cur / option.unit);
+                    output.append(line, strlen(line));
+                }
+                return;
+            }
+
+            const LimitOption* option = nullptr;
+            for (const auto& candidate: kLimits) {
+                if (tokens[1] == candidate.flag) option = &candidate;
+            }
+            if (!option || tokens.size() != 3) {
+                output.append("Usage: ulimit [-t|-s|-n|-v <value|unlimited>]\n", 46);
+                return;
+            }
+
+            rlimit limit{};
+            getrlimit(option->resource, &limit);
+            if (tokens[2] == "unlimited") limit.rlim_cur = limit.rlim_max;
+            else {
+                char* end;
+                long int value = strtol(tokens[2].c_str(), &end, 10);
+                if (*end != '\0' || value < 0 || (uint64_t) value * option->unit >= RLIM_INFINITY) {
+                    output.append("ulimit: invalid value\n", 22);
+                    return;
+                }
+                limit.rlim_cur = value * option->unit;
+            }
+
+            int result = setrlimit(option->resource, &limit);
+            if (result == -EINVAL) output.append("ulimit: above the hard limit\n", 29);
+            else if (result != 0) output.append("ulimit: failed to set the limit\n", 32);
+            return;
+        }
+
         // TOUCH - Create an empty file or truncate existing file
         if (tokens[0] == "touch") {
             if (tokens.size() < 2) {
@@ -901,54 +1066,27 @@ namespace PalmyraOS::Userland::builtin::KernelTerminal {
                 return;
             }
 
-            // Convert the tokens to a format suitable for posix_spawn
-            char resolvedPath[kPathMax];
-            resolvePathToBuffer(tokens[1].c_str(), resolvedPath, sizeof(resolvedPath));
-            const char* path = resolvedPath;
-            size_t argc      = tokens.size() - 1;
-
-            // Prepare argv array for the new process
-            char** argv      = (char**) heap.alloc((argc + 1) * sizeof(char*));
-            if (!argv) {
-                output.append("exec: Failed to allocate memory for arguments.\n", 48);
+            // Pipelines: exec a | b | c
+            for (size_t i = 2; i < tokens.size(); ++i) {
+                if (tokens[i] != "|") continue;
+                runPipeline(heap, tokens, output);
                 return;
             }
 
-            for (int i = 0; i < argc; ++i) { argv[i] = const_cast<char*>(tokens[i + 1].c_str()); }
-            argv[argc] = nullptr;  // Null-terminate the argv array
-
-            // Prepare environment array with PWD
-            char pwdEnv[kPathMax + 16];
-            snprintf(pwdEnv, sizeof(pwdEnv), "PWD=%s", g_cwd);
-
-            char* envp[] = {const_cast<char*>("PATH=/bin"), const_cast<char*>("HOME=/"), const_cast<char*>("USER=root"), pwdEnv, nullptr};
-
             // Spawn the new process with environment
             uint32_t child_pid;
-            int status = posix_spawn(&child_pid, path, nullptr, nullptr, argv, envp);
-
-            // Free allocated memory for argv
-            heap.free(argv);
+            int status = spawnFromTokens(heap, tokens, 1, tokens.size(), nullptr, &child_pid);
 
             if (status != 0) {
                 output.append("exec: Failed to start process.\n", 32);
                 return;
             }
 
-            // Wait for the process to finish
-            int wait_status;
-            uint32_t wait_result = waitpid(child_pid, &wait_status, 0);
-
-            if (wait_result != child_pid) {
-                output.append("waitpid: Failed to wait for the process.\n", 42);
-                return;
-            }
-
             // Now get the process PID
             char pidBuffer[12];
             snprintf(pidBuffer, sizeof(pidBuffer), "%d", child_pid);
 
-            // Flush its output
+            // Collect its output while it runs: the stream is bounded, and holds the process back only while we read
             {
                 // Construct the path /proc/<pid>/stdout
                 char procPath[64];
@@ -960,16 +1098,25 @@ namespace PalmyraOS::Userland::builtin::KernelTerminal {
                     output.append("Failed to open ", 15);
                     output.append(procPath, strlen(procPath));
                     output.append(".\n", 2);
-                    return;
                 }
+                else {
+                    // Read until end of file (the process exited and its output is drained)
+                    char buffer[kPathMax];
+                    int bytesRead = 0;
+                    while ((bytesRead = read(fd, buffer, sizeof(buffer))) > 0) { output.append(buffer, bytesRead); }
+
+                    // Close the file
+                    close(fd);
+                }
+            }
 
-                // Read the file content
-                char buffer[kPathMax];
-                int bytesRead = 0;
-                while ((bytesRead = read(fd, buffer, sizeof(buffer))) > 0) { output.append(buffer, bytesRead); }
+            // Wait for the process to finish
+            int wait_status;
+            uint32_t wait_result = waitpid(child_pid, &wait_status, 0);
 
-                // Close the file
-                close(fd);
+            if (wait_result != child_pid) {
+                output.append("waitpid: Failed to wait for the process.\n", 42);
+                return;
             }
 
             // Process with PID 6 terminated with status 0.
@@ -90,7 +90,7 @@ void openAppLauncher(AppLauncherState& launcher) {
     int windowHeight      = launcher.appCount * launcher.itemHeight + 4;  // Just 2px top + 2px bottom
 
     // Setup window info
-    launcher.windowInfo   = {.x = 90, .y = 25, .width = 150, .height = (uint32_t) windowHeight, .movable = false, .title = "Apps"};
+    launcher.windowInfo   = {.x = 90, .y = 25, .width = 150, .height = (uint32_t) windowHeight, .movable = false, .title = "Apps", .events = nullptr};
 
     // Allocate back buffer
     size_t requiredMemory = launcher.windowInfo.width * launcher.windowInfo.height * sizeof(uint32_t);
@@ -236,7 +236,7 @@ void closeAppLauncher(AppLauncherState& launcher) {
     PalmyraOS::SDK::getScreenDimensions(&screenWidth, &screenHeight);
 
     // Define dimensions and required memory for the window
-    palmyra_window w      = {.x = 0, .y = 0, .width = screenWidth, .height = 20, .movable = false, .title = "MenuBar"};
+    palmyra_window w      = {.x = 0, .y = 0, .width = screenWidth, .height = 20, .movable = false, .title = "MenuBar", .events = nullptr};
     size_t requiredMemory = w.width * w.height * sizeof(uint32_t);
 
     // Allocate memory for the back buffer
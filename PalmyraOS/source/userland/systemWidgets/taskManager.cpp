@@ -5,6 +5,7 @@
 #define _BITS_TYPES_STRUCT_TIMESPEC_H
 #define _SYS_TYPES_H
 
+#include "palmyraOS/io_uring.h"
 #include "palmyraOS/unistd.h"
 
 namespace PalmyraOS::Userland::builtin::taskManager {
@@ -33,9 +34,9 @@ namespace PalmyraOS::Userland::builtin::taskManager {
         uint32_t pid;
         char name[64];
         char state;
-        uint64_t cpuTicks;
-        uint64_t previousCpuTicks;  // For delta calculation
-        uint32_t cpuPercent;        // Calculated CPU percentage
+        uint64_t cpuMicros;          // User and kernel time, from /proc/{pid}/sched
+        uint64_t previousCpuMicros;  // For delta calculation
+        uint32_t cpuPermille;        // Share of the refresh interval, in tenths of a percent
         uint32_t rssPages;
     };
 
@@ -84,21 +85,12 @@ namespace PalmyraOS::Userland::builtin::taskManager {
         }
     }
 
-    // Parse a single /proc/{pid}/stat file and extract process info
-    bool parseProcessStat(uint32_t pid, ProcessInfo& info) {
-        char statPath[32];
-        snprintf(statPath, sizeof(statPath), "/proc/%u/stat", pid);
-
-        int fd = open(statPath, O_RDONLY);
-        if (fd < 0) return false;
-
-        char buffer[512];
-        int bytesRead = read(fd, buffer, sizeof(buffer) - 1);
-        close(fd);
-
-        if (bytesRead <= 0) return false;
-        buffer[bytesRead]   = '\0';
+    constexpr uint32_t STAT_BUFFER_SIZE       = 512;   // Bytes read from one /proc/{pid}/stat or /proc/{pid}/sched
+    constexpr uint32_t STAT_PATH_SIZE         = 32;    // Bytes of one "/proc/{pid}/stat" path
+    constexpr uint32_t STAT_TICK_MICROSECONDS = 4000;  // /proc/{pid}/stat counts CPU time in 250 Hz clock ticks
 
+    // Parse the contents of a /proc/{pid}/stat file (null-terminated) and extract process info
+    bool parseStatBuffer(const char* buffer, ProcessInfo& info) {
         // Manual parsing: pid (name) state ... utime stime ... rss
         // Format: %d (%s) %c followed by many fields
 
@@ -172,14 +164,145 @@ namespace PalmyraOS::Userland::builtin::taskManager {
         strncpy(info.name, parsed_name, sizeof(info.name) - 1);
         info.name[sizeof(info.name) - 1] = '\0';
         info.state                       = parsed_state;
-        info.cpuTicks                    = utime + stime;
+        info.cpuMicros                   = (utime + stime) * STAT_TICK_MICROSECONDS;  // Until /proc/{pid}/sched refines it
         info.rssPages                    = rss;
 
         return true;
     }
 
+    // Value of a "name: value" line of /proc/{pid}/sched (0 if missing)
+    uint64_t findSchedField(const char* buffer, const char* name) {
+        size_t length = strlen(name);
+        for (const char* line = buffer; *line;) {
+            if (strncmp(line, name, length) == 0 && line[length] == ':') {
+                const char* p  = line + length + 1;
+                uint64_t value = 0;
+                while (*p == ' ') p++;
+                while (*p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+                return value;
+            }
+            while (*line && *line != '\n') line++;
+            if (*line) line++;
+        }
+        return 0;
+    }
+
+    // Precise CPU time (microseconds) from the contents of /proc/{pid}/sched
+    void parseSchedBuffer(const char* buffer, ProcessInfo& info) { info.cpuMicros = findSchedField(buffer, "user_us") + findSchedField(buffer, "kernel_us"); }
+
+    // Read a small /proc file into a null-terminated buffer
+    bool readProcFile(const char* path, char* buffer, uint32_t size) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return false;
+
+        int bytesRead = read(fd, buffer, size - 1);
+        close(fd);
+
+        if (bytesRead <= 0) return false;
+        buffer[bytesRead] = '\0';
+        return true;
+    }
+
+    // Parse the /proc/{pid}/stat and /proc/{pid}/sched files of a single process
+    bool parseProcessStat(uint32_t pid, ProcessInfo& info) {
+        char path[STAT_PATH_SIZE];
+        char buffer[STAT_BUFFER_SIZE];
+
+        snprintf(path, sizeof(path), "/proc/%u/stat", pid);
+        if (!readProcFile(path, buffer, sizeof(buffer)) || !parseStatBuffer(buffer, info)) return false;
+
+        snprintf(path, sizeof(path), "/proc/%u/sched", pid);
+        if (readProcFile(path, buffer, sizeof(buffer))) parseSchedBuffer(buffer, info);
+        return true;
+    }
+
+    // Submission/completion ring shared by every refresh
+    struct StatRing {
+        static constexpr uint32_t FILES     = 2;                    // stat and sched of every process
+        static constexpr uint32_t ENTRIES   = 192;                  // Open, read and close per file
+        static constexpr uint32_t PER_BATCH = ENTRIES / 3 / FILES;  // Processes per io_uring_enter()
+
+        int fd{-1};
+        io_uring_rings* rings{nullptr};
+    };
+
+    // Read the stat and sched files of many processes at once: one system call per PER_BATCH processes instead of six per process
+    bool readStatsBatched(types::UserHeapManager& heap, StatRing& ring, const uint32_t* pids, uint32_t count, types::UVector<ProcessInfo>& processes) {
+        if (ring.fd < 0) {
+            io_uring_params params{};
+            ring.fd = io_uring_setup(StatRing::ENTRIES, &params);
+            if (ring.fd < 0) return false;
+            ring.rings = params.rings;
+        }
+
+        // File f of process i uses slot i * FILES + f
+        const char* files[StatRing::FILES] = {"stat", "sched"};
+        constexpr uint32_t SLOTS           = StatRing::PER_BATCH * StatRing::FILES;
+
+        auto* buffers = static_cast<char*>(heap.alloc(SLOTS * (STAT_BUFFER_SIZE + STAT_PATH_SIZE + sizeof(int32_t))));
+        if (!buffers) return false;
+        char* paths   = buffers + SLOTS * STAT_BUFFER_SIZE;
+        auto* results = reinterpret_cast<int32_t*>(paths + SLOTS * STAT_PATH_SIZE);
+
+        for (uint32_t first = 0; first < count; first += StatRing::PER_BATCH) {
+            uint32_t batch = count - first < StatRing::PER_BATCH ? count - first : StatRing::PER_BATCH;
+
+            // Each read and close uses the descriptor of the open just before it
+            for (uint32_t slot = 0; slot < batch * StatRing::FILES; ++slot) {
+                char* path = paths + slot * STAT_PATH_SIZE;
+                snprintf(path, STAT_PATH_SIZE, "/proc/%u/%s", pids[first + slot / StatRing::FILES], files[slot % StatRing::FILES]);
+                results[slot] = 0;
+
+                io_uring_sqe* openEntry = io_uring_get_sqe(ring.rings);
+                openEntry->opcode       = IORING_OP_OPEN;
+                openEntry->addr         = reinterpret_cast<uint32_t>(path);
+                openEntry->len          = O_RDONLY;
+
+                io_uring_sqe* readEntry = io_uring_get_sqe(ring.rings);
+                readEntry->opcode       = IORING_OP_READ;
+                readEntry->flags        = IOSQE_OPENED_FD;
+                readEntry->addr         = reinterpret_cast<uint32_t>(buffers + slot * STAT_BUFFER_SIZE);
+                readEntry->len          = STAT_BUFFER_SIZE - 1;
+                readEntry->user_data    = slot + 1;  // Only reads are looked at (0: open or close)
+
+                io_uring_sqe* closeEntry = io_uring_get_sqe(ring.rings);
+                closeEntry->opcode       = IORING_OP_CLOSE;
+                closeEntry->flags        = IOSQE_OPENED_FD;
+            }
+            io_uring_submit(ring.fd, ring.rings);
+
+            while (io_uring_cqe* cqe = io_uring_peek_cqe(ring.rings)) {
+                uint32_t index = static_cast<uint32_t>(cqe->user_data);
+                int32_t result = cqe->res;
+                io_uring_cqe_seen(ring.rings);
+                if (index != 0) results[index - 1] = result;
+            }
+
+            // Processes that exited in between fail their open and are skipped
+            for (uint32_t i = 0; i < batch; ++i) {
+                uint32_t slot = i * StatRing::FILES;
+                if (results[slot] <= 0) continue;
+
+                char* stat          = buffers + slot * STAT_BUFFER_SIZE;
+                stat[results[slot]] = '\0';
+                ProcessInfo info;
+                if (!parseStatBuffer(stat, info)) continue;
+
+                if (results[slot + 1] > 0) {
+                    char* sched              = buffers + (slot + 1) * STAT_BUFFER_SIZE;
+                    sched[results[slot + 1]] = '\0';
+                    parseSchedBuffer(sched, info);
+                }
+                processes.push_back(info);
+            }
+        }
+
+        heap.free(buffers);
+        return true;
+    }
+
     // List all processes in /proc/
-    void collectProcesses(types::UserHeapManager& heap, types::UVector<ProcessInfo>& processes) {
+    void collectProcesses(types::UserHeapManager& heap, StatRing& ring, types::UVector<ProcessInfo>& processes) {
         processes.clear();
 
         int dirFd = open("/proc", O_RDONLY);
@@ -194,19 +317,26 @@ namespace PalmyraOS::Userland::builtin::taskManager {
         // Parse directory entries
         linux_dirent* dirent = (linux_dirent*) buffer;
         char* endPtr         = buffer + bytesRead;
+        types::UVector<uint32_t> pids(heap);
 
         while ((char*) dirent < endPtr && dirent->d_reclen != 0) {
             // Check if this is a numeric PID directory
             if (dirent->d_name[0] >= '0' && dirent->d_name[0] <= '9') {
                 uint32_t pid = 0;
                 for (const char* p = dirent->d_name; *p && *p >= '0' && *p <= '9'; p++) { pid = pid * 10 + (*p - '0'); }
-
-                ProcessInfo info;
-                if (parseProcessStat(pid, info)) { processes.push_back(info); }
+                pids.push_back(pid);
             }
 
             dirent = (linux_dirent*) ((char*) dirent + dirent->d_reclen);
         }
+
+        if (pids.empty() || readStatsBatched(heap, ring, pids.data(), pids.size(), processes)) return;
+
+        // No ring (out of memory): one open/read/close per process
+        for (uint32_t pid: pids) {
+            ProcessInfo info;
+            if (parseProcessStat(pid, info)) { processes.push_back(info); }
+        }
     }
 
     // Sort comparison functions
@@ -215,7 +345,7 @@ namespace PalmyraOS::Userland::builtin::taskManager {
     bool sortByName(const ProcessInfo& a, const ProcessInfo& b) { return strcmp(a.name, b.name) < 0; }
 
     bool sortByCPU(const ProcessInfo& a, const ProcessInfo& b) {
-        return a.cpuPercent > b.cpuPercent;  // Descending: higher percentage first
+        return a.cpuPermille > b.cpuPermille;  // Descending: higher percentage first
     }
 
     bool sortByMemory(const ProcessInfo& a, const ProcessInfo& b) {
@@ -231,6 +361,7 @@ namespace PalmyraOS::Userland::builtin::taskManager {
         windowGui.text().setFont(PalmyraOS::Font::Poppins12);
 
         types::UVector<ProcessInfo> processes(heap);
+        StatRing statRing;
         SortColumn currentSort         = SortColumn::CPU;
         RefreshRate currentRefreshRate = RefreshRate::TWO_SEC;  // Start with 2s refresh
         int scrollY                    = 0;
@@ -240,16 +371,15 @@ namespace PalmyraOS::Userland::builtin::taskManager {
         const int TABLE_PADDING        = 10;
 
         // Initial process collection
-        collectProcesses(heap, processes);
+        collectProcesses(heap, statRing, processes);
         sortVector(processes, sortByCPU);
 
         // Time-based refresh tracking for accurate CPU percentage calculation
         timespec lastRefreshTime{};
         clock_gettime(CLOCK_MONOTONIC, &lastRefreshTime);
 
-        // System constants for CPU calculation
-        constexpr uint32_t SYSTEM_HZ      = 100;  // Linux standard: 100 ticks/second
-        constexpr uint32_t MIN_REFRESH_MS = 500;  // Minimum 500ms between refreshes for stable readings
+        // Minimum time between refreshes for stable readings
+        constexpr uint32_t MIN_REFRESH_MS = 500;
 
         while (true) {
             windowGui.render();
@@ -265,7 +395,7 @@ namespace PalmyraOS::Userland::builtin::taskManager {
                 clock_gettime(CLOCK_MONOTONIC, &currentTime);
 
                 // Calculate elapsed time in milliseconds
-                uint64_t elapsedMs       = ((currentTime.tv_sec - lastRefreshTime.tv_sec) * 1000ULL) + ((currentTime.tv_nsec - lastRefreshTime.tv_nsec) / 1000000ULL);
+                uint64_t elapsedMs       = (currentTime.tv_sec * 1000ULL + currentTime.tv_nsec / 1000000ULL) - (lastRefreshTime.tv_sec * 1000ULL + lastRefreshTime.tv_nsec / 1000000ULL);
 
                 // Only refresh if enough time has passed (prevents unstable readings)
                 uint32_t targetRefreshMs = refreshSeconds * 1000;
@@ -276,10 +406,9 @@ namespace PalmyraOS::Userland::builtin::taskManager {
                     for (const auto& proc: processes) { previousProcesses.push_back(proc); }
 
                     // Collect new process data
-                    collectProcesses(heap, processes);
+                    collectProcesses(heap, statRing, processes);
 
-                    // STEP 1: Calculate delta ticks for each process and sum total delta
-                    uint64_t totalDeltaTicks = 0;
+                    // CPU share of every process: microseconds it ran per millisecond of the interval gives tenths of a percent
                     for (auto& currentProc: processes) {
                         // Find matching previous process data by PID
                         ProcessInfo* prevProc = nullptr;
@@ -290,46 +419,13 @@ namespace PalmyraOS::Userland::builtin::taskManager {
                             }
                         }
 
-                        if (prevProc != nullptr && currentProc.cpuTicks >= prevProc->cpuTicks) {
-                            // Calculate delta: how many ticks this process used in this interval
-                            uint64_t deltaTicks          = currentProc.cpuTicks - prevProc->cpuTicks;
-                            currentProc.previousCpuTicks = deltaTicks;  // Store delta temporarily
-                            totalDeltaTicks += deltaTicks;
-                        }
-                        else {
-                            // First measurement or counter reset
-                            currentProc.previousCpuTicks = 0;
+                        // First measurement or counter reset: no share yet
+                        currentProc.cpuPermille = 0;
+                        if (prevProc != nullptr && currentProc.cpuMicros >= prevProc->cpuMicros) {
+                            uint64_t permille       = (currentProc.cpuMicros - prevProc->cpuMicros) / elapsedMs;
+                            currentProc.cpuPermille = permille < 1000 ? static_cast<uint32_t>(permille) : 1000;
                         }
-                    }
-
-                    // STEP 2: Calculate relative CPU percentages based on share of total delta
-                    for (auto& currentProc: processes) {
-                        uint64_t thisProcDelta = currentProc.previousCpuTicks;
-
-                        if (totalDeltaTicks > 0 && thisProcDelta > 0) {
-                            // Relative CPU% = (this process's delta / total delta) * 100
-                            currentProc.cpuPercent = (thisProcDelta * 100) / totalDeltaTicks;
-                        }
-                        else {
-                            // No activity or first measurement
-                            currentProc.cpuPercent = 0;
-                        }
-
-                        // DEBUG: Show calculation for first process
-                        if (currentProc.pid == processes[0].pid) {
-                            char debugMsg[200];
-                            snprintf(debugMsg,
-                                     sizeof(debugMsg),
-                                     "[RELATIVE CPU] PID=%d delta=%llu, total=%llu, percent=%u%%",
-                                     currentProc.pid,
-                                     thisProcDelta,
-                                     totalDeltaTicks,
-                                     currentProc.cpuPercent);
-                            windowGui.text() << debugMsg << "\n";
-                        }
-
-                        // Update previousCpuTicks with actual current value for next cycle
-                        currentProc.previousCpuTicks = currentProc.cpuTicks;
+                        currentProc.previousCpuMicros = currentProc.cpuMicros;
                     }
 
                     // Sort by current column
@@ -398,7 +494,7 @@ namespace PalmyraOS::Userland::builtin::taskManager {
                 uint32_t col5 = col4 + 80;
 
                 char headerText[256];
-                snprintf(headerText, sizeof(headerText), "  ID      Name                  State    CPU        Memory");
+                snprintf(headerText, sizeof(headerText), "  ID      Name                  State    CPU      Time       Memory");
                 windowGui.text() << headerText;
             }
 
@@ -411,6 +507,7 @@ namespace PalmyraOS::Userland::builtin::taskManager {
                 int maxNameOffset     = 0;
                 int maxStateOffset    = 0;
                 int maxCpuOffset      = 0;
+                int maxTimeOffset     = 0;
                 int yOffset           = 2;
                 int rowHeight         = 20;
 
@@ -469,26 +566,40 @@ namespace PalmyraOS::Userland::builtin::taskManager {
                     windowGui.text() << "\n";
                 }
 
-                // Fourth column: CPU Ticks
+                // Fourth column: CPU share
                 windowGui.text().setCursor(maxStateOffset + 15, scrollY);
                 for (size_t i = 0; i < processes.size(); i++) {
                     const ProcessInfo& proc = processes[i];
                     windowGui.text().setCursor(maxStateOffset + 15, windowGui.text().getCursorY() + yOffset);
 
                     char cpuText[32];
-                    snprintf(cpuText, sizeof(cpuText), "%u%%", proc.cpuPercent);
+                    snprintf(cpuText, sizeof(cpuText), "%u.%u%%", proc.cpuPermille / 10, proc.cpuPermille % 10);
                     windowGui.text() << cpuText;
 
                     maxCpuOffset = (windowGui.text().getCursorX() > maxCpuOffset) ? windowGui.text().getCursorX() : maxCpuOffset;
                     windowGui.text() << "\n";
                 }
 
-                // Fifth column: Memory
+                // Fifth column: CPU time (user and kernel) in milliseconds
                 windowGui.text().setCursor(maxCpuOffset + 15, scrollY);
                 for (size_t i = 0; i < processes.size(); i++) {
                     const ProcessInfo& proc = processes[i];
                     windowGui.text().setCursor(maxCpuOffset + 15, windowGui.text().getCursorY() + yOffset);
 
+                    char timeText[32];
+                    snprintf(timeText, sizeof(timeText), "%llu ms", proc.cpuMicros / 1000);
+                    windowGui.text() << timeText;
+
+                    maxTimeOffset = (windowGui.text().getCursorX() > maxTimeOffset) ? windowGui.text().getCursorX() : maxTimeOffset;
+                    windowGui.text() << "\n";
+                }
+
+                // Sixth column: Memory
+                windowGui.text().setCursor(maxTimeOffset + 15, scrollY);
+                for (size_t i = 0; i < processes.size(); i++) {
+                    const ProcessInfo& proc = processes[i];
+                    windowGui.text().setCursor(maxTimeOffset + 15, windowGui.text().getCursorY() + yOffset);
+
                     char memText[32];
                     snprintf(memText, sizeof(memText), "%u KB", proc.rssPages * 4);
                     windowGui.text() << memText;
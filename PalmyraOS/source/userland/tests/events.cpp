@@ -25,7 +25,7 @@ int PalmyraOS::Userland::Tests::events::main(uint32_t argc, char** argv) {
 
         // manually fetch keyboard events
         while (true) {
-            KeyboardEvent event = nextKeyboardEvent(window.getID());  // Fetch the next event
+            KeyboardEvent event = window.nextKeyboardEvent();  // Fetch the next event
             if (!event.isValid) break;
             keyboardEvent = event;  // get last valid event
         }
@@ -35,7 +35,7 @@ int PalmyraOS::Userland::Tests::events::main(uint32_t argc, char** argv) {
 
         // manually fetch mouse events
         while (true) {
-            MouseEvent event = nextMouseEvent(window.getID());  // Fetch the next event
+            MouseEvent event = window.nextMouseEvent();  // Fetch the next event
             if (!event.isEvent) break;
             mouseEvent = event;  // get last valid event
         }
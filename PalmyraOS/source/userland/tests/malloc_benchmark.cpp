@@ -0,0 +1,156 @@
+/**
+ * @file malloc_benchmark.cpp
+ * @brief malloc/free latency and correctness under threads
+ *
+ * - Small pairs: malloc(32) immediately freed (the free-list fast path)
+ * - Mixed sizes: batches of random sizes, filled and checked before they are freed
+ * - Threads: the mixed workload on several threads at once (bins are locked separately)
+ * - Large blocks: allocations mapped on their own and returned by free
+ * - Realloc: a buffer doubled until 1 MiB
+ */
+
+#include "userland/tests/malloc_benchmark.h"
+#include "libs/memory.h"
+#include "palmyraOS/stdio.h"
+#include "palmyraOS/stdlib.h"
+#include "palmyraOS/thread.h"
+#include "palmyraOS/time.h"
+
+namespace PalmyraOS::Userland::tests::MallocBenchmark {
+
+    constexpr uint32_t kSmallPairs   = 100000;       // malloc(32)/free pairs
+    constexpr uint32_t kBatchSize    = 256;          // Live blocks per mixed batch
+    constexpr uint32_t kBatches      = 200;          // Mixed batches per thread
+    constexpr uint32_t kMaxMixedSize = 4096;         // Largest mixed allocation
+    constexpr uint32_t kThreads      = 4;            // Threads running the mixed workload
+    constexpr uint32_t kLargeSize    = 64 * 1024;    // Bytes per large allocation
+    constexpr uint32_t kLargeBlocks  = 200;          // Large malloc/free pairs
+    constexpr uint32_t kReallocLimit = 1024 * 1024;  // Realloc doubles up to this size
+
+    uint64_t nowMicroseconds() {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    // xorshift32: the threads need their own sequence without shared state
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    void printLatency(const char* label, uint32_t operations, uint64_t microseconds) {
+        if (operations == 0) operations = 1;
+        printf("%s: %u operations in %u ms (%u ns/op)\n", label, operations, (uint32_t) (microseconds / 1000), (uint32_t) (microseconds * 1000 / operations));
+    }
+
+    // Allocates batches of random sizes, tags every byte with its block, and checks the tags before freeing
+    int mixedWorkload(void* arg) {
+        uint32_t seed = reinterpret_cast<uintptr_t>(arg) * 2654435761u + 1;
+        uint8_t* blocks[kBatchSize];
+        uint32_t sizes[kBatchSize];
+
+        for (uint32_t batch = 0; batch < kBatches; ++batch) {
+            for (uint32_t i = 0; i < kBatchSize; ++i) {
+                sizes[i]  = nextRandom(seed) % kMaxMixedSize + 1;
+                blocks[i] = static_cast<uint8_t*>(malloc(sizes[i]));
+                if (!blocks[i]) return 1;
+                memset(blocks[i], static_cast<uint8_t>(i ^ batch), sizes[i]);
+            }
+
+            // Free in a scrambled order so the free lists do not stay sorted
+            for (uint32_t i = 0; i < kBatchSize; ++i) {
+                uint32_t index = (i * 97) % kBatchSize;
+                auto tag       = static_cast<uint8_t>(index ^ batch);
+                for (uint32_t byte = 0; byte < sizes[index]; ++byte) {
+                    if (blocks[index][byte] != tag) return 2;
+                }
+                free(blocks[index]);
+            }
+        }
+        return 0;
+    }
+
+    int main(uint32_t argc, char** argv) {
+        // Small pairs
+        uint64_t start = nowMicroseconds();
+        for (uint32_t i = 0; i < kSmallPairs; ++i) {
+            void* block = malloc(32);
+            if (!block) {
+                printf("ERROR: malloc(32) failed at pair %u\n", i);
+                return -1;
+            }
+            free(block);
+        }
+        printLatency("Small pairs", kSmallPairs, nowMicroseconds() - start);
+
+        // Mixed sizes, one thread
+        start = nowMicroseconds();
+        if (mixedWorkload(nullptr) != 0) {
+            printf("ERROR: mixed workload failed\n");
+            return -1;
+        }
+        printLatency("Mixed sizes", kBatches * kBatchSize, nowMicroseconds() - start);
+
+        // Mixed sizes, several threads
+        thread_t workers[kThreads]{};
+        start = nowMicroseconds();
+        for (uint32_t i = 0; i < kThreads; ++i) {
+            if (thread_create(&workers[i], mixedWorkload, reinterpret_cast<void*>(i + 1)) != 0) {
+                printf("ERROR: thread_create() failed\n");
+                return -1;
+            }
+        }
+        int failures = 0;
+        for (uint32_t i = 0; i < kThreads; ++i) {
+            int exitCode = 0;
+            thread_join(workers[i], &exitCode);
+            if (exitCode != 0) ++failures;
+        }
+        printLatency("Threads", kThreads * kBatches * kBatchSize, nowMicroseconds() - start);
+        if (failures) {
+            printf("ERROR: %d threads saw corrupted or missing blocks\n", failures);
+            return -1;
+        }
+
+        // Large blocks
+        start = nowMicroseconds();
+        for (uint32_t i = 0; i < kLargeBlocks; ++i) {
+            auto* block = static_cast<uint8_t*>(malloc(kLargeSize));
+            if (!block) {
+                printf("ERROR: malloc(%u) failed at block %u\n", kLargeSize, i);
+                return -1;
+            }
+            block[0] = block[kLargeSize - 1] = 1;
+            free(block);
+        }
+        printLatency("Large blocks", kLargeBlocks, nowMicroseconds() - start);
+
+        // Realloc: the contents must survive every move
+        start          = nowMicroseconds();
+        uint32_t steps = 0;
+        auto* data     = static_cast<uint8_t*>(malloc(16));
+        if (!data) return -1;
+        for (uint32_t i = 0; i < 16; ++i) data[i] = i;
+        for (uint32_t size = 32; size <= kReallocLimit; size *= 2, ++steps) {
+            data = static_cast<uint8_t*>(realloc(data, size));
+            if (!data) {
+                printf("ERROR: realloc(%u) failed\n", size);
+                return -1;
+            }
+            for (uint32_t i = 0; i < 16; ++i) {
+                if (data[i] != i) {
+                    printf("ERROR: realloc(%u) lost the contents\n", size);
+                    return -1;
+                }
+            }
+        }
+        free(data);
+        printLatency("Realloc doubling", steps, nowMicroseconds() - start);
+
+        return 0;
+    }
+
+}  // namespace PalmyraOS::Userland::tests::MallocBenchmark
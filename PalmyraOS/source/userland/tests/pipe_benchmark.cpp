@@ -0,0 +1,197 @@
+/**
+ * @file pipe_benchmark.cpp
+ * @brief Pipe latency and throughput benchmark
+ *
+ * Without arguments, measures two threads of one process:
+ * - Ping-pong: a small message goes back and forth over two pipes (latency of a wake-up)
+ * - Streaming: one thread writes large blocks that the other reads (bulk copy throughput)
+ *
+ * As pipeline stages, measures a producer held back by its consumer:
+ *   exec /bin/pipebench.elf produce 4096 | /bin/pipebench.elf consume
+ */
+
+#include "userland/tests/pipe_benchmark.h"
+#include "libs/memory.h"
+#include "libs/string.h"
+#include "palmyraOS/errono.h"
+#include "palmyraOS/stdio.h"
+#include "palmyraOS/stdlib.h"
+#include "palmyraOS/thread.h"
+#include "palmyraOS/time.h"
+#include "palmyraOS/unistd.h"
+
+namespace PalmyraOS::Userland::tests::PipeBenchmark {
+
+    constexpr uint32_t kRoundTrips   = 10000;             // Ping-pong messages
+    constexpr uint32_t kMessageSize  = 64;                // Bytes per ping-pong message
+    constexpr uint32_t kBlockSize    = 16 * 1024;         // Bytes per streaming write
+    constexpr uint32_t kStreamedSize = 16 * 1024 * 1024;  // Bytes streamed in total
+
+    struct Channel {
+        int ping[2];  // main -> worker
+        int pong[2];  // worker -> main
+    };
+
+    uint64_t nowMicroseconds() {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    // Pipes return what is available: loop until the whole message moved (false on end of file or error)
+    bool readFully(int fd, char* buffer, uint32_t size) {
+        for (uint32_t done = 0; done < size;) {
+            int bytesRead = read(fd, buffer + done, size - done);
+            if (bytesRead <= 0) return false;
+            done += bytesRead;
+        }
+        return true;
+    }
+
+    bool writeFully(int fd, const char* buffer, uint32_t size) {
+        for (uint32_t done = 0; done < size;) {
+            int bytesWritten = write(fd, buffer + done, size - done);
+            if (bytesWritten <= 0) return false;
+            done += bytesWritten;
+        }
+        return true;
+    }
+
+    void printRate(const char* label, uint64_t bytes, uint64_t microseconds) {
+        if (microseconds == 0) microseconds = 1;
+        printf("%s: %u KiB in %u ms (%u KiB/s)\n", label, (uint32_t) (bytes / 1024), (uint32_t) (microseconds / 1000), (uint32_t) (bytes * 1000000 / 1024 / microseconds));
+    }
+
+    int echoWorker(void* arg) {
+        auto* channel = static_cast<Channel*>(arg);
+        char message[kMessageSize];
+        for (uint32_t i = 0; i < kRoundTrips; ++i) {
+            if (!readFully(channel->ping[0], message, kMessageSize)) return 1;
+            if (!writeFully(channel->pong[1], message, kMessageSize)) return 2;
+        }
+        return 0;
+    }
+
+    int streamWorker(void* arg) {
+        auto* channel = static_cast<Channel*>(arg);
+        auto* block   = static_cast<char*>(malloc(kBlockSize));
+        if (!block) return 1;
+        memset(block, 'x', kBlockSize);
+
+        int result = 0;
+        for (uint32_t sent = 0; sent < kStreamedSize; sent += kBlockSize) {
+            if (!writeFully(channel->pong[1], block, kBlockSize)) {
+                result = 2;
+                break;
+            }
+        }
+        free(block);
+        return result;
+    }
+
+    int runThreads() {
+        Channel channel{};
+        if (pipe(channel.ping) != 0 || pipe(channel.pong) != 0) {
+            printf("ERROR: pipe() failed\n");
+            return -1;
+        }
+
+        // Ping-pong: every round trip is two writes, two reads and two wake-ups
+        thread_t worker{};
+        if (thread_create(&worker, echoWorker, &channel) != 0) {
+            printf("ERROR: thread_create() failed\n");
+            return -1;
+        }
+
+        char message[kMessageSize];
+        memset(message, 'p', kMessageSize);
+        uint64_t start = nowMicroseconds();
+        for (uint32_t i = 0; i < kRoundTrips; ++i) {
+            if (!writeFully(channel.ping[1], message, kMessageSize) || !readFully(channel.pong[0], message, kMessageSize)) {
+                printf("ERROR: ping-pong failed at round trip %u\n", i);
+                return -1;
+            }
+        }
+        uint64_t elapsed = nowMicroseconds() - start;
+        thread_join(worker, nullptr);
+
+        if (elapsed == 0) elapsed = 1;
+        printf("Ping-pong: %u round trips of %u bytes in %u ms (%u round trips/s)\n",
+               kRoundTrips,
+               kMessageSize,
+               (uint32_t) (elapsed / 1000),
+               (uint32_t) ((uint64_t) kRoundTrips * 1000000 / elapsed));
+
+        // Streaming: the writer fills the ring and sleeps until the reader drains it
+        if (thread_create(&worker, streamWorker, &channel) != 0) {
+            printf("ERROR: thread_create() failed\n");
+            return -1;
+        }
+
+        auto* block = static_cast<char*>(malloc(kBlockSize));
+        if (!block) return -1;
+
+        start             = nowMicroseconds();
+        uint64_t received = 0;
+        while (received < kStreamedSize) {
+            int bytesRead = read(channel.pong[0], block, kBlockSize);
+            if (bytesRead <= 0) break;
+            received += bytesRead;
+        }
+        elapsed = nowMicroseconds() - start;
+        thread_join(worker, nullptr);
+        free(block);
+
+        printRate("Streaming", received, elapsed);
+
+        close(channel.ping[0]);
+        close(channel.ping[1]);
+        close(channel.pong[0]);
+        close(channel.pong[1]);
+        return received == kStreamedSize ? 0 : -1;
+    }
+
+    // Pipeline stage: writes KiB of data to stdout (sleeps whenever the consumer falls behind)
+    int produce(uint32_t kibibytes) {
+        auto* block = static_cast<char*>(malloc(kBlockSize));
+        if (!block) return -1;
+        memset(block, 'x', kBlockSize);
+
+        uint64_t total = (uint64_t) kibibytes * 1024;
+        for (uint64_t sent = 0; sent < total; sent += kBlockSize) {
+            uint32_t size = total - sent < kBlockSize ? (uint32_t) (total - sent) : kBlockSize;
+            if (!writeFully(STDOUT, block, size)) {
+                free(block);
+                return -EPIPE;
+            }
+        }
+        free(block);
+        return 0;
+    }
+
+    // Pipeline stage: reads stdin until end of file
+    int consume() {
+        auto* block = static_cast<char*>(malloc(kBlockSize));
+        if (!block) return -1;
+
+        uint64_t start    = nowMicroseconds();
+        uint64_t received = 0;
+        int bytesRead;
+        while ((bytesRead = read(STDIN, block, kBlockSize)) > 0) received += bytesRead;
+        free(block);
+
+        printRate("Consumed", received, nowMicroseconds() - start);
+        return 0;
+    }
+
+    int main(uint32_t argc, char** argv) {
+        if (argc > 1 && strcmp(argv[1], "produce") == 0) return produce(argc > 2 ? atoi(argv[2]) : 1024);
+        if (argc > 1 && strcmp(argv[1], "consume") == 0) return consume();
+        if (argc > 1) {
+            printf("Usage: %s [produce <KiB> | consume]\n", argv[0]);
+            return -1;
+        }
+        return runThreads();
+    }
+
+}  // namespace PalmyraOS::Userland::tests::PipeBenchmark
@@ -17,6 +17,7 @@
 #include "userland/tests/udp_echo_server.h"
 #include "palmyraOS/errono.h"
 #include "palmyraOS/network.h"
+#include "palmyraOS/poll.h"
 #include "palmyraOS/socket.h"
 #include "palmyraOS/stdio.h"
 #include "palmyraOS/stdlib.h"
@@ -83,7 +84,18 @@ namespace PalmyraOS::Userland::tests::UDPEchoServer {
         uint32_t clientLen;
         uint32_t packetCount = 0;
 
+        // Sleep in poll() until a datagram arrives instead of spinning on recvfrom()
+        struct pollfd pfd;
+        pfd.fd     = sockfd;
+        pfd.events = POLLIN;
+
         while (1) {
+            int ready = poll(&pfd, 1, -1);
+            if (ready < 0) {
+                printf("ERROR: poll() returned %d\n", ready);
+                break;
+            }
+
             clientLen        = sizeof(client);
 
             // Receive datagram
@@ -132,12 +144,9 @@ namespace PalmyraOS::Userland::tests::UDPEchoServer {
                 // Real error (not just "no data available")
                 printf("ERROR: recvfrom() returned %d\n", (int) received);
             }
-
-            // Yield CPU to other processes (be a good citizen)
-            sched_yield();
         }
 
-        // Cleanup (unreachable for now - would need signal handling)
+        // Cleanup (only reached if poll() fails - otherwise would need signal handling)
         close(sockfd);
         printf("Server stopped.\n");
         return 0;
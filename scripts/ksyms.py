@@ -0,0 +1,71 @@
+"""
+Builds the kernel symbol table embedded in kernel.bin (see Profiler.h).
+
+Usage: nm -n -C --defined-only kernel.tmp | python3 ksyms.py ksyms.bin
+
+Layout (little endian):
+    uint32 magic ('KSYM'), uint32 count
+    count x { uint32 address, uint32 name offset from the start of the table }
+    null-terminated names
+
+Without input it writes an empty table (for the first link).
+"""
+
+import struct
+import sys
+
+MAGIC = 0x4D59534B  # 'KSYM'
+TEXT_TYPES = "tTwW"
+
+
+def read_symbols(lines):
+    symbols = {}
+    for line in lines:
+        parts = line.rstrip("\n").split(" ", 2)
+        if len(parts) != 3 or parts[1] not in TEXT_TYPES:
+            continue
+
+        address = int(parts[0], 16)
+        name = parts[2]
+
+        # Several names for one address (aliases, clones): keep the first
+        symbols.setdefault(address, strip_parameters(name))
+    return sorted(symbols.items())
+
+
+def strip_parameters(name):
+    """Drops the trailing parameter list of a demangled name (lambdas keep theirs)"""
+    if name.endswith(" const"):
+        name = name[:-len(" const")]
+    if not name.endswith(")"):
+        return name
+
+    depth = 0
+    for i in range(len(name) - 1, -1, -1):
+        if name[i] == ")":
+            depth += 1
+        elif name[i] == "(":
+            depth -= 1
+            if depth == 0:
+                return name[:i]
+    return name
+
+
+def build_table(symbols):
+    header_size = 8 + 8 * len(symbols)
+    entries = bytearray()
+    names = bytearray()
+    for address, name in symbols:
+        entries += struct.pack("<II", address, header_size + len(names))
+        names += name.encode("ascii", "replace") + b"\0"
+    return struct.pack("<II", MAGIC, len(symbols)) + entries + names
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print(__doc__)
+        sys.exit(1)
+
+    table = build_table(read_symbols(sys.stdin))
+    with open(sys.argv[1], "wb") as output:
+        output.write(table)
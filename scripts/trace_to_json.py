@@ -0,0 +1,94 @@
+"""
+Converts a PalmyraOS kernel trace (the contents of /proc/trace) into the Chrome
+trace event format, which chrome://tracing and ui.perfetto.dev open directly.
+
+Usage: python3 trace_to_json.py trace.txt trace.json
+
+Enable recording in the terminal with `trace on`, run the workload, then copy
+/proc/trace to the host. Every process gets a track; interrupts, context
+switches and packets get tracks of their own, since they do not belong to the
+process they interrupt.
+"""
+
+import json
+import sys
+
+NO_PID = 0xFFFFFFFF
+
+# Thread ids of the tracks that do not belong to a process
+KERNEL_TRACK = 0x7FFFFF00
+IRQ_TRACK = 0x7FFFFF01
+SCHED_TRACK = 0x7FFFFF02
+NET_TRACK = 0x7FFFFF03
+TRACK_NAMES = {KERNEL_TRACK: "kernel", IRQ_TRACK: "interrupts", SCHED_TRACK: "scheduler", NET_TRACK: "network"}
+
+
+def parse(lines):
+    cpu_mhz = 0
+    events = {}
+    records = []
+    for line in lines:
+        line = line.strip()
+        if not line:
+            continue
+        if line.startswith("#"):
+            fields = line[1:].split()
+            if fields[0] == "cpu_mhz":
+                cpu_mhz = int(fields[1])
+            elif fields[0] == "event":
+                events[int(fields[1])] = fields[2]
+            continue
+
+        tsc, pid, event, arg0, arg1 = (int(field, 16) for field in line.split())
+        records.append((tsc, pid, events.get(event, "event_%d" % event), arg0, arg1))
+
+    if cpu_mhz == 0:
+        raise ValueError("missing '# cpu_mhz' header")
+    return cpu_mhz, records
+
+
+def convert(cpu_mhz, records):
+    if not records:
+        return []
+
+    start = records[0][0]
+    output = [{"ph": "M", "name": "thread_name", "pid": 0, "tid": tid, "args": {"name": name}} for tid, name in TRACK_NAMES.items()]
+    for tsc, pid, name, arg0, arg1 in records:
+        event = {"ts": (tsc - start) / cpu_mhz, "pid": 0, "tid": KERNEL_TRACK if pid == NO_PID else pid}
+
+        if name == "syscall_enter":
+            event.update(ph="B", name="syscall %d" % arg0)
+        elif name == "syscall_exit":
+            event.update(ph="E", args={"result": arg1 - (1 << 32) if arg1 & 0x80000000 else arg1})
+        elif name == "irq_enter":
+            event.update(ph="B", tid=IRQ_TRACK, name="irq 0x%x" % arg0)
+        elif name == "irq_exit":
+            event.update(ph="E", tid=IRQ_TRACK)
+        elif name == "block_io_start":
+            kind = "write" if arg1 & 0x80000000 else "read"
+            event.update(ph="B", name="ata %s" % kind, args={"lba": arg0, "sectors": arg1 & 0x7FFFFFFF})
+        elif name == "block_io_end":
+            event.update(ph="E", args={"ok": arg1})
+        elif name == "context_switch":
+            previous = "none" if arg0 == NO_PID else arg0
+            event.update(ph="i", s="t", tid=SCHED_TRACK, name="switch %s -> %d" % (previous, arg1))
+        elif name == "page_fault":
+            event.update(ph="i", s="t", name="page fault", args={"address": "0x%08x" % arg0, "error": arg1})
+        elif name in ("packet_rx", "packet_tx"):
+            event.update(ph="i", s="t", tid=NET_TRACK, name=name, args={"length": arg0})
+        else:
+            event.update(ph="i", s="t", name=name, args={"arg0": arg0, "arg1": arg1})
+        output.append(event)
+    return output
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print(__doc__)
+        sys.exit(1)
+
+    with open(sys.argv[1]) as trace:
+        mhz, parsed = parse(trace)
+
+    with open(sys.argv[2], "w") as output_file:
+        json.dump({"traceEvents": convert(mhz, parsed), "displayTimeUnit": "ns"}, output_file)